@@ -58,6 +58,11 @@ void audio_subsystem_request_rearm(void)
     audio_rearm_requested = true;
 }
 
+uint32_t audio_subsystem_capture_position(void)
+{
+    return i2s_capture_dma_position(&audio_pipeline.capture);
+}
+
 static void audio_subsystem_flush_processing_state(void)
 {
     ap_ring_init(&audio_pipeline.capture_ring);
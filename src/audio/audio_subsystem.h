@@ -39,6 +39,13 @@ void audio_subsystem_set_muted(bool muted);
  */
 void audio_subsystem_request_rearm(void);
 
+/**
+ * Position of the I2S capture DMA, for any core. It stays put while the
+ * source's I2S clock is stopped, so two equal readings some time apart mean
+ * the clock stopped in between. 0 while capture is not running.
+ */
+uint32_t audio_subsystem_capture_position(void);
+
 /**
  * Background task for audio subsystem (call from Core 1 only).
  */
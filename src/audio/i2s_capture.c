@@ -244,3 +244,10 @@ uint32_t i2s_capture_get_sample_rate(i2s_capture_t *cap)
 {
     return cap->measured_rate;
 }
+
+uint32_t i2s_capture_dma_position(const i2s_capture_t *cap)
+{
+    if (!cap->running)
+        return 0;
+    return dma_hw->ch[cap->dma_chan].write_addr;
+}
@@ -63,4 +63,8 @@ uint32_t i2s_capture_poll(i2s_capture_t *cap);
 // Get measured sample rate (updated by poll)
 uint32_t i2s_capture_get_sample_rate(i2s_capture_t *cap);
 
+// Current DMA write address, 0 while stopped. It moves only while the I2S
+// clocks run and may be read from either core.
+uint32_t i2s_capture_dma_position(const i2s_capture_t *cap);
+
 #endif // I2S_CAPTURE_H
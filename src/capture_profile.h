@@ -17,6 +17,14 @@
 #define CAPTURE_ACTIVE_WIDTH 320
 #define CAPTURE_ACTIVE_HEIGHT 224
 #define CAPTURE_ACTIVE_X_OFFSET 0
+#define CAPTURE_BORDER_COLOR_RGB565 0x0000
+
+// Input line period (384 dots at 6 MHz) and the worst case from the capture
+// loop's line_ring_vsync() to its commit of line 0: 16 skipped border lines,
+// the first active line, and up to one more while the trigger waits for the
+// next line start.
+#define CAPTURE_LINE_NS 64000U
+#define CAPTURE_FIRST_COMMIT_LINES 18U
 
 // Neo Geo MV1C: 8 MHz / 144 = 55,555.555... Hz.
 #define CAPTURE_AUDIO_INPUT_RATE 55556
@@ -32,6 +40,14 @@
 #define CAPTURE_ACTIVE_WIDTH 256
 #define CAPTURE_ACTIVE_HEIGHT 224
 #define CAPTURE_ACTIVE_X_OFFSET ((CAPTURE_FRAME_WIDTH - CAPTURE_ACTIVE_WIDTH) / 2)
+// The 32 columns either side of the 256-dot picture (line_ring.h).
+#define CAPTURE_BORDER_COLOR_RGB565 0x0000
+
+// 1364 master clocks at 21.477 MHz; line 0 starts right at the VBLANK
+// falling edge the capture loop waits for, and the loop's line_ring_vsync()
+// comes after that edge, so line 0 is in within two lines of it.
+#define CAPTURE_LINE_NS 63510U
+#define CAPTURE_FIRST_COMMIT_LINES 2U
 
 // SNES S-DSP nominal rate from DCK/256, about 32.04 kHz.
 #define CAPTURE_AUDIO_INPUT_RATE 32040
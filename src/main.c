@@ -93,6 +93,8 @@ static void combined_background_task(void)
     }
 #endif
 #endif
+    // The output follows the input's frame rate; a no-op until it changes.
+    video_pipeline_set_standard(video_capture_get_standard(NULL));
     menu_diag_experiment_tick_background();
 }
 
@@ -270,6 +272,9 @@ int main(void)
     video_pipeline_init(FRAME_WIDTH, FRAME_HEIGHT);
     video_output_set_background_task(combined_background_task);
 
+    // Reset the ring and paint its borders before either core uses it
+    line_ring_init();
+
     // Initialize video capture
     video_capture_init(SOURCE_HEIGHT);
     sleep_ms(200);
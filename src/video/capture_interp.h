@@ -0,0 +1,82 @@
+#ifndef NEOPICO_HD_CAPTURE_INTERP_H
+#define NEOPICO_HD_CAPTURE_INTERP_H
+
+#include <stdint.h>
+
+#include "hardware/interp.h"
+
+#include "capture_line.h"
+
+// LUT addressing through the SIO interpolators for the capture conversion
+// loops. A lane shifts, masks and adds its base in the single bus read that
+// returns the result, so a pixel's LUT entry address costs one store and one
+// load instead of the extract, index and add the compiler emits for
+// lut[(raw >> 2) & 0x7FFF]. Interpolators are per core: everything here must
+// run on the core that runs the capture loop (Core 0), and nothing else on
+// that core may reprogram the lanes it claims.
+#ifndef NEOPICO_EXP_INTERP_LUT
+#define NEOPICO_EXP_INTERP_LUT 0
+#endif
+
+// Raw capture words carry RGB555 in bits 16:2, so a 16-bit LUT entry's byte
+// offset is the raw word shifted right once, bits 15:1.
+#define CAPTURE_INTERP_RGB555_SHIFT 1U
+#define CAPTURE_INTERP_RGB555_MASK_LSB 1U
+#define CAPTURE_INTERP_RGB555_MASK_MSB 15U
+
+// Claims both lanes of interp0 and sets them up to turn a raw capture word
+// into the address of its entry in a 32768-entry RGB555-indexed table. Lane
+// 0 converts the accumulator 0 word, lane 1 the accumulator 1 word.
+static inline void capture_interp_lut15_init(void)
+{
+    interp_config cfg = interp_default_config();
+    interp_config_set_shift(&cfg, CAPTURE_INTERP_RGB555_SHIFT);
+    interp_config_set_mask(&cfg, CAPTURE_INTERP_RGB555_MASK_LSB, CAPTURE_INTERP_RGB555_MASK_MSB);
+    for (uint lane = 0; lane < 2U; lane++) {
+        interp_claim_lane(interp0, lane);
+        interp_set_config(interp0, lane, &cfg);
+    }
+}
+
+static inline void capture_interp_lut15_set_table(const uint16_t *lut)
+{
+    interp_set_base(interp0, 0, (uint32_t)(uintptr_t)lut);
+    interp_set_base(interp0, 1, (uint32_t)(uintptr_t)lut);
+}
+
+static inline uint16_t capture_interp_load16(uintptr_t address)
+{
+    return *(const uint16_t *)address;
+}
+
+// dst[i] = lut[(src[i] >> 2) & 0x7FFF] for the table last set, two pixels per
+// pair of lane reads. Returns the AND and OR of the source words and the line hash.
+static inline capture_line_bits_t capture_interp_lut15_convert(uint16_t *dst, const uint32_t *src, int count)
+{
+    capture_line_bits_t bits = {~0U, 0U, CAPTURE_HASH_SEED};
+    int remaining = count;
+    while (remaining >= 2) {
+        capture_line_fold_all(&bits, src[0] & src[1]);
+        capture_line_fold_any(&bits, src[0] | src[1]);
+        interp_set_accumulator(interp0, 0, src[0]);
+        interp_set_accumulator(interp0, 1, src[1]);
+        const uint16_t pixel0 = capture_interp_load16(interp_peek_lane_result(interp0, 0));
+        const uint16_t pixel1 = capture_interp_load16(interp_peek_lane_result(interp0, 1));
+        dst[0] = pixel0;
+        dst[1] = pixel1;
+        bits.hash = capture_line_hash_step(bits.hash, (uint32_t)pixel0 | ((uint32_t)pixel1 << 16));
+        dst += 2;
+        src += 2;
+        remaining -= 2;
+    }
+    if (remaining > 0) {
+        capture_line_fold_all(&bits, src[0]);
+        capture_line_fold_any(&bits, src[0]);
+        interp_set_accumulator(interp0, 0, src[0]);
+        dst[0] = capture_interp_load16(interp_peek_lane_result(interp0, 0));
+        bits.hash = capture_line_hash_step(bits.hash, dst[0]);
+    }
+    return bits;
+}
+
+#endif // NEOPICO_HD_CAPTURE_INTERP_H
@@ -0,0 +1,148 @@
+#ifndef NEOPICO_HD_CAPTURE_LINE_H
+#define NEOPICO_HD_CAPTURE_LINE_H
+
+#include <stdint.h>
+
+#include "hardware/sync.h"
+
+// What a capture conversion loop learns about its line on the way through,
+// as reductions over the words it already has in registers.
+typedef struct {
+    uint32_t all;  // AND of every raw word: bits no pixel lacked
+    uint32_t any;  // OR of every raw word: bits some pixel had
+    uint32_t hash; // capture_hash_line() of the converted pixels
+} capture_line_bits_t;
+
+// Each reduction costs the conversion loops work per pixel pair on Core 0,
+// so each is built in only with the feature that reads it. A reduction that
+// is not built in keeps its initial value.
+#ifndef NEOPICO_EXP_LINE_INTEGRITY
+#define NEOPICO_EXP_LINE_INTEGRITY 0 // `all`: MVS CSYNC/PCLK line check
+#endif
+#ifndef NEOPICO_EXP_CONTENT_BOUNDS
+#define NEOPICO_EXP_CONTENT_BOUNDS 0 // `any`: black lines skip the bounds scan
+#endif
+#ifndef NEOPICO_EXP_FRAME_HASH
+#define NEOPICO_EXP_FRAME_HASH 0 // `hash`: video_capture_get_frame_hash()
+#endif
+
+static inline void capture_line_fold_all(capture_line_bits_t *bits, uint32_t words_and)
+{
+#if NEOPICO_EXP_LINE_INTEGRITY
+    bits->all &= words_and;
+#else
+    (void)bits;
+    (void)words_and;
+#endif
+}
+
+// `any` for a loop that keeps it outside capture_line_bits_t.
+static inline uint32_t capture_line_or(uint32_t any, uint32_t words_or)
+{
+#if NEOPICO_EXP_CONTENT_BOUNDS
+    return any | words_or;
+#else
+    (void)words_or;
+    return any;
+#endif
+}
+
+static inline void capture_line_fold_any(capture_line_bits_t *bits, uint32_t words_or)
+{
+    bits->any = capture_line_or(bits->any, words_or);
+}
+
+// RGB555 in a raw capture word, on both targets. Black is all zero with the
+// shipped wiring, so a line whose `any` has none of these bits is black.
+#define CAPTURE_RAW_COLOR_BITS (0x7FFFU << 2)
+
+// Content hash of converted ring pixels: a multiply-xor over little-endian
+// pixel pairs, the words the conversion loops store, with a rotate so that
+// flips in the high bits of two pairs cannot cancel. Two cycles per pair on
+// the M33. A line is hashed from CAPTURE_HASH_SEED; a frame folds its line
+// hashes in order with the same step, from the same seed. Not cryptographic:
+// it tells repeated frames apart from new ones, and lets a test match a known
+// pattern at the output.
+#define CAPTURE_HASH_SEED 0x811C9DC5U
+#define CAPTURE_HASH_MUL 0x9E3779B1U
+
+static inline uint32_t capture_hash_step(uint32_t hash, uint32_t word)
+{
+    return (word ^ ((hash << 5) | (hash >> 27))) * CAPTURE_HASH_MUL;
+}
+
+// Continues `hash` over `count` pixels starting at an even pixel of the line;
+// an odd last pixel is hashed on its own.
+static inline uint32_t capture_hash_pixels(uint32_t hash, const uint16_t *pixels, int count)
+{
+    int i = 0;
+    for (; i + 1 < count; i += 2) {
+        hash = capture_hash_step(hash, (uint32_t)pixels[i] | ((uint32_t)pixels[i + 1] << 16));
+    }
+    if (i < count) {
+        hash = capture_hash_step(hash, pixels[i]);
+    }
+    return hash;
+}
+
+static inline uint32_t capture_hash_line(const uint16_t *pixels, int count)
+{
+    return capture_hash_pixels(CAPTURE_HASH_SEED, pixels, count);
+}
+
+// The conversion loops' `hash` steps: the above when the frame hash is built
+// in, otherwise nothing.
+static inline uint32_t capture_line_hash_step(uint32_t hash, uint32_t word)
+{
+#if NEOPICO_EXP_FRAME_HASH
+    return capture_hash_step(hash, word);
+#else
+    (void)word;
+    return hash;
+#endif
+}
+
+static inline uint32_t capture_line_hash_pixels(uint32_t hash, const uint16_t *pixels, int count)
+{
+#if NEOPICO_EXP_FRAME_HASH
+    return capture_hash_pixels(hash, pixels, count);
+#else
+    (void)pixels;
+    (void)count;
+    return hash;
+#endif
+}
+
+// Last complete frame's hash and its capture frame number, published by
+// Core 0 for any core. `seq` is odd while an update is being written.
+typedef struct {
+    volatile uint32_t seq;
+    uint32_t frame;
+    uint32_t hash;
+} capture_frame_hash_t;
+
+static inline void capture_frame_hash_publish(capture_frame_hash_t *p, uint32_t frame, uint32_t hash)
+{
+    p->seq++;
+    __dmb();
+    p->frame = frame;
+    p->hash = hash;
+    __dmb();
+    p->seq++;
+}
+
+static inline uint32_t capture_frame_hash_read(const capture_frame_hash_t *p, uint32_t *frame)
+{
+    uint32_t seq;
+    uint32_t hash;
+    do {
+        seq = p->seq;
+        __dmb();
+        *frame = p->frame;
+        hash = p->hash;
+        __dmb();
+    } while ((seq & 1U) != 0U || seq != p->seq);
+    return hash;
+}
+
+#endif // NEOPICO_HD_CAPTURE_LINE_H
@@ -0,0 +1,176 @@
+#ifndef NEOPICO_HD_CONTENT_BOUNDS_H
+#define NEOPICO_HD_CONTENT_BOUNDS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "hardware/sync.h"
+
+// Content bounds: the first and last non-black column and row of the captured
+// picture, so a scaler can spend output pixels on the picture instead of its
+// borders (many Neo Geo titles draw 304 of 320 columns; SNES content is 256
+// wide in the 320 frame).
+//
+// Core 0 feeds the tracker from the capture loop. The conversion's OR over a
+// line's raw words says whether the line has anything but black; only such a
+// line is passed in, and it is scanned from each end of the ring line inward,
+// only as far as the frame's bounds so far. Once the frame's widest line is
+// seen, the rest cost a compare or two each.
+//
+// Published bounds move with hysteresis. An edge that grows is published at
+// the end of the frame that showed it, so content is never cropped. An edge
+// that shrinks waits for CONTENT_BOUNDS_SHRINK_FRAMES consecutive frames
+// inside it, and then takes the widest of them, so fades and dark scenes do
+// not zoom in and out. All-black frames change nothing.
+// Only the capture loop writes a tracker. Other cores read the published
+// bounds through content_bounds_read(), which retries while `seq` shows a
+// publication in progress.
+
+#define CONTENT_BOUNDS_SHRINK_FRAMES 30U
+
+typedef struct {
+    uint16_t left;   // first non-black column
+    uint16_t right;  // last non-black column
+    uint16_t top;    // first non-black row
+    uint16_t bottom; // last non-black row
+} content_bounds_t;
+
+typedef struct {
+    uint16_t width;
+    uint16_t height;
+
+    // Frame being captured. `end` is one past the last non-black column so
+    // far; left >= end until a non-black pixel is found.
+    uint16_t left;
+    uint16_t end;
+    uint16_t top;
+    uint16_t bottom;
+
+    // Shrink waiting out the hysteresis: the widest of the frames so far.
+    content_bounds_t pending;
+    uint32_t pending_frames;
+
+    // Published to Core 1. `seq` is odd while an update is being written.
+    content_bounds_t bounds;
+    volatile uint32_t seq;
+    uint32_t changes;
+} content_bounds_tracker_t;
+
+// Starts with the full frame published.
+static inline void content_bounds_init(content_bounds_tracker_t *t, uint16_t width, uint16_t height)
+{
+    memset(t, 0, sizeof *t);
+    t->width = width;
+    t->height = height;
+    t->bounds.right = (uint16_t)(width - 1U);
+    t->bounds.bottom = (uint16_t)(height - 1U);
+}
+
+static inline void content_bounds_frame_start(content_bounds_tracker_t *t)
+{
+    t->left = t->width;
+    t->end = 0;
+    t->top = t->height;
+    t->bottom = 0;
+}
+
+// A line whose raw words were not all black. `pixels` is its ring line,
+// `color_mask` the bits of a ring pixel that are zero only for black.
+static inline void content_bounds_line(content_bounds_tracker_t *t, uint16_t line, const uint16_t *pixels,
+                                       uint16_t color_mask)
+{
+    if (line < t->top) {
+        t->top = line;
+    }
+    t->bottom = line;
+    for (uint16_t x = 0; x < t->left; x++) {
+        if ((pixels[x] & color_mask) != 0U) {
+            t->left = x;
+            break;
+        }
+    }
+    for (uint16_t x = t->width; x > t->end; x--) {
+        if ((pixels[x - 1U] & color_mask) != 0U) {
+            t->end = x;
+            break;
+        }
+    }
+}
+
+static inline void content_bounds_publish(content_bounds_tracker_t *t, const content_bounds_t *bounds)
+{
+    t->seq++;
+    __dmb();
+    t->bounds = *bounds;
+    t->changes++;
+    __dmb();
+    t->seq++;
+}
+
+// Ends a complete frame. Returns true when the published bounds changed.
+static inline bool content_bounds_frame_end(content_bounds_tracker_t *t)
+{
+    if (t->left >= t->end || t->top > t->bottom) {
+        return false;
+    }
+    const content_bounds_t frame = {t->left, (uint16_t)(t->end - 1U), t->top, t->bottom};
+    content_bounds_t next = t->bounds;
+    bool grew = false;
+    if (frame.left < next.left) {
+        next.left = frame.left;
+        grew = true;
+    }
+    if (frame.right > next.right) {
+        next.right = frame.right;
+        grew = true;
+    }
+    if (frame.top < next.top) {
+        next.top = frame.top;
+        grew = true;
+    }
+    if (frame.bottom > next.bottom) {
+        next.bottom = frame.bottom;
+        grew = true;
+    }
+
+    bool changed = grew;
+    if (memcmp(&frame, &next, sizeof frame) == 0) {
+        t->pending_frames = 0;
+    } else {
+        if (t->pending_frames == 0U) {
+            t->pending = frame;
+        } else {
+            t->pending.left = frame.left < t->pending.left ? frame.left : t->pending.left;
+            t->pending.right = frame.right > t->pending.right ? frame.right : t->pending.right;
+            t->pending.top = frame.top < t->pending.top ? frame.top : t->pending.top;
+            t->pending.bottom = frame.bottom > t->pending.bottom ? frame.bottom : t->pending.bottom;
+        }
+        if (++t->pending_frames >= CONTENT_BOUNDS_SHRINK_FRAMES) {
+            next = t->pending;
+            t->pending_frames = 0;
+            changed = true;
+        }
+    }
+    if (changed) {
+        content_bounds_publish(t, &next);
+    }
+    return changed;
+}
+
+// Any core. Returns the number of changes published so far.
+static inline uint32_t content_bounds_read(const content_bounds_tracker_t *t, content_bounds_t *bounds)
+{
+    uint32_t seq;
+    uint32_t changes;
+    do {
+        seq = t->seq;
+        __dmb();
+        *bounds = t->bounds;
+        changes = t->changes;
+        __dmb();
+    } while ((seq & 1U) != 0U || seq != t->seq);
+    return changes;
+}
+
+#endif // NEOPICO_HD_CONTENT_BOUNDS_H
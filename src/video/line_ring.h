@@ -4,7 +4,9 @@
 #include "hardware/sync.h"
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "capture_profile.h"
 
@@ -12,12 +14,44 @@
 // variant (was NEOPICO_LINE_RING_SIZE; see AGENTS.md flag-sunset notes).
 #define NEOPICO_LINE_RING_SIZE 256
 
+// Ring simulator only: run the depth line_ring_init_shallow() was given
+// instead of LINE_RING_SIZE. Off, slots are the compile-time mask the
+// scratch_x scanline callback was sized with.
+#ifndef NEOPICO_LINE_RING_SHALLOW
+#define NEOPICO_LINE_RING_SHALLOW 0
+#endif
+
 #define LINE_RING_SIZE NEOPICO_LINE_RING_SIZE
 #define LINE_WIDTH CAPTURE_FRAME_WIDTH
 #define LINES_PER_FRAME CAPTURE_ACTIVE_HEIGHT
 
+// Each line's active window. The columns outside it never change, so the
+// producer writes only the window: line_ring_init() paints the rest
+// LINE_BORDER_COLOR once, for readers that take the whole line, and the
+// scanout's plain path fills them itself without reading the ring.
+#define LINE_ACTIVE_X CAPTURE_ACTIVE_X_OFFSET
+#define LINE_ACTIVE_WIDTH CAPTURE_ACTIVE_WIDTH
+#define LINE_BORDER_COLOR CAPTURE_BORDER_COLOR_RGB565
+
+#ifndef NEOPICO_EXP_BEAM_RACE
+#define NEOPICO_EXP_BEAM_RACE 0
+#endif
+
+#ifndef NEOPICO_DIAG_LINE_LATENCY
+#define NEOPICO_DIAG_LINE_LATENCY 0
+#endif
+
+#if NEOPICO_DIAG_LINE_LATENCY
+#include "hardware/timer.h"
+
+// Commit-to-first-fetch latency histogram, log2 microsecond buckets: [0] is
+// under 1 us, [k] is [2^(k-1), 2^k) us, and the last one is open-ended
+// (65.5 ms and up, four frames).
+#define LINE_RING_LATENCY_BUCKETS 18U
+#endif
+
 typedef struct {
-    uint16_t lines[LINE_RING_SIZE][LINE_WIDTH]; // ~25KB line buffer
+    uint16_t lines[LINE_RING_SIZE][LINE_WIDTH]; // 160 KiB line buffer
 
 #if NEOPICO_EXP_RGB888_SCANOUT
     // RGB888 scanout stores raw entropy (DARK + raw RGB555) in the 16 bits
@@ -35,10 +69,94 @@ typedef struct {
 
     // Resync flag - Core 0 requests, Core 1 executes
     volatile bool resync_pending;
+
+#if NEOPICO_LINE_RING_SHALLOW
+    uint32_t depth; // lines in use, a power of two (line_ring_init_shallow())
+#endif
+
+#if NEOPICO_EXP_BEAM_RACE
+    // Input VSYNC timing for line_ring_output_vsync_race(), published by
+    // Core 0 before the frame base it belongs to.
+    volatile uint32_t frame_base_us;   // when the current frame base was published
+    volatile uint32_t frame_period_us; // since the previous one
+    int32_t race_slack_us;             // boot-time, line_ring_race_init()
+#endif
+
+#if NEOPICO_DIAG_LINE_LATENCY
+    // Per-slot timestamps (timer_hw->timerawl): when Core 0 committed the
+    // line and when Core 1 first fetched it, plus the global index that fetch
+    // was for, so rows scaled from the same line and repeated frames are not
+    // counted again. Written by one core each; the histogram is Core 1's.
+    uint32_t commit_us[LINE_RING_SIZE];
+    uint32_t read_us[LINE_RING_SIZE];
+    uint32_t read_idx[LINE_RING_SIZE];
+    volatile uint32_t latency_hist[LINE_RING_LATENCY_BUCKETS];
+#endif
 } line_ring_t;
 
 extern line_ring_t g_line_ring;
 
+_Static_assert((LINE_RING_SIZE & (LINE_RING_SIZE - 1U)) == 0U, "line ring size must be a power of two");
+
+#if NEOPICO_LINE_RING_SHALLOW
+#define LINE_RING_DEPTH g_line_ring.depth
+#else
+#define LINE_RING_DEPTH LINE_RING_SIZE
+#endif
+
+// Slot of global line index `idx`: a mask, never a divide.
+#define LINE_RING_SLOT(idx) ((idx) & (LINE_RING_DEPTH - 1U))
+
+// Boot-time, before either core touches the ring: reset the indices and
+// paint the borders.
+static inline void line_ring_init(void)
+{
+    g_line_ring.write_idx = 0;
+    g_line_ring.frame_base_idx = 0;
+    g_line_ring.read_frame_start = 0;
+    g_line_ring.resync_pending = false;
+#if LINE_ACTIVE_WIDTH < LINE_WIDTH
+    for (uint32_t i = 0; i < LINE_RING_SIZE; i++) {
+        for (uint32_t x = 0; x < LINE_ACTIVE_X; x++) {
+            g_line_ring.lines[i][x] = LINE_BORDER_COLOR;
+        }
+        for (uint32_t x = LINE_ACTIVE_X + LINE_ACTIVE_WIDTH; x < LINE_WIDTH; x++) {
+            g_line_ring.lines[i][x] = LINE_BORDER_COLOR;
+        }
+    }
+#endif
+#if NEOPICO_DIAG_LINE_LATENCY
+    for (uint32_t i = 0; i < LINE_RING_SIZE; i++) {
+        g_line_ring.read_idx[i] = UINT32_MAX;
+    }
+    for (uint32_t i = 0; i < LINE_RING_LATENCY_BUCKETS; i++) {
+        g_line_ring.latency_hist[i] = 0;
+    }
+#endif
+}
+
+#if NEOPICO_LINE_RING_SHALLOW
+// Shallowest ring line_ring_init_shallow() accepts: enough for the output to
+// trail the input by a couple of milliseconds.
+#define LINE_RING_MIN_DEPTH 32U
+
+// line_ring_init() for a ring simulator study of `depth` lines, clamped to
+// [LINE_RING_MIN_DEPTH, LINE_RING_SIZE] and rounded up to a power of two.
+static inline void line_ring_init_shallow(uint32_t depth)
+{
+    if (depth < LINE_RING_MIN_DEPTH) {
+        depth = LINE_RING_MIN_DEPTH;
+    } else if (depth > LINE_RING_SIZE) {
+        depth = LINE_RING_SIZE;
+    }
+    while ((depth & (depth - 1U)) != 0U) {
+        depth = (depth | (depth - 1U)) + 1U;
+    }
+    line_ring_init();
+    g_line_ring.depth = depth;
+}
+#endif
+
 // ============================================================================
 // Diagnostic counters (NEOPICO_DIAG_COUNTERS, default OFF) — capture-health
 // instrumentation for the 720p glitch investigation. Dumped over USB-serial.
@@ -48,11 +166,39 @@ extern line_ring_t g_line_ring;
 #endif
 
 #if NEOPICO_DIAG_COUNTERS
+// Frame-pacing timeline: one entry per output VSYNC that did not show the
+// input frame after the previous one. Power of two.
+#define LINE_RING_PACE_LOG 64U
+
+typedef struct {
+    uint32_t out_frame; // out_frames at the event
+    uint32_t skipped;   // input frames jumped over; 0: the previous frame was repeated
+} line_ring_pace_event_t;
+
 typedef struct {
-    volatile uint32_t not_written; // Core 1 wanted a line the producer hadn't written yet
-    volatile uint32_t overrun;     // Core 1 wanted a line already overwritten (ring wrap)
-    volatile uint32_t out_frames;  // Core 1 output VSYNCs
-    volatile uint32_t sync_resets; // Core 0 capture hardware resets (MVS signal loss)
+    volatile uint32_t not_written;     // Core 1 wanted a line the producer hadn't written yet
+    volatile uint32_t overrun;         // Core 1 wanted a line already overwritten (ring wrap)
+    volatile uint32_t out_frames;      // Core 1 output VSYNCs
+    volatile uint32_t sync_resets;     // Core 0 capture hardware resets (MVS signal loss)
+    volatile uint32_t line_dma_lapped; // Core 0 converted a line buffer the pixel DMA had moved back into
+#if NEOPICO_EXP_BEAM_RACE
+    volatile uint32_t raced; // output frames that raced the frame being written
+#endif
+
+    // Frame pacing, per output VSYNC: the next input frame (new), the same
+    // one again (repeated), or a later one (new, plus the ones jumped over).
+    // Free-running, repeats or skips recur at the input/output beat; a locked
+    // output has neither.
+    volatile uint32_t new_frames;
+    volatile uint32_t repeated_frames;
+    volatile uint32_t skipped_frames;  // input frames never shown
+    volatile uint32_t run_frames;      // new frames since the last repeat or skip
+    volatile uint32_t last_run_frames; // the cadence run the last repeat or skip ended
+    volatile uint32_t beat_frames;     // output frames between the last two repeats or skips
+    volatile uint32_t pace_events;     // entries written to pace_log, ever (index mod LINE_RING_PACE_LOG)
+    line_ring_pace_event_t pace_log[LINE_RING_PACE_LOG];
+    uint32_t last_shown;       // Core 1 only: read_frame_start at the previous output VSYNC
+    uint32_t last_event_frame; // Core 1 only: out_frames at the last event
 } line_ring_diag_t;
 extern line_ring_diag_t g_line_ring_diag;
 #endif
@@ -71,20 +217,74 @@ static inline void line_ring_vsync(void)
     g_line_ring.resync_pending = true;
 }
 
+#if NEOPICO_EXP_BEAM_RACE
+// line_ring_vsync() for the beam-racing read policy: `t_us` is the time the
+// frame base is published (timer_hw->timerawl), stamped before the base so
+// that a Core 1 that sees the new base also sees its time.
+static inline void line_ring_vsync_at(uint32_t t_us)
+{
+    g_line_ring.frame_period_us = t_us - g_line_ring.frame_base_us;
+    g_line_ring.frame_base_us = t_us;
+    __dmb();
+    line_ring_vsync();
+}
+#endif
+
 // Get write pointer for line N within current frame
 static inline uint16_t *line_ring_write_ptr(uint16_t line)
 {
     uint32_t idx = g_line_ring.frame_base_idx + line;
-    return g_line_ring.lines[idx % LINE_RING_SIZE];
+    return g_line_ring.lines[LINE_RING_SLOT(idx)];
 }
 
 // Signal that lines 0..(total_lines-1) of current frame are written
 static inline void line_ring_commit(uint16_t total_lines)
 {
+#if NEOPICO_DIAG_LINE_LATENCY
+    g_line_ring.commit_us[LINE_RING_SLOT((g_line_ring.frame_base_idx + total_lines - 1U))] = timer_hw->timerawl;
+#endif
     __dmb(); // Ensure line data visible before updating index
     g_line_ring.write_idx = g_line_ring.frame_base_idx + total_lines;
 }
 
+// Finish a frame the input abandoned after `line` lines (signal lost
+// mid-frame) from the previous frame, so Core 1 keeps a whole picture until
+// capture relocks. A ring that holds a whole frame still has the previous
+// frame's lines from `line` on: each is copied one frame forward before the
+// copy of an earlier line can reach its slot. With nothing committed the
+// frame is left empty and line_ring_output_vsync() already falls back to the
+// previous one; a shallower ring keeps the partial frame. The copies land
+// on slots of an earlier frame (line y on base + y - depth), which Core 1
+// still scans when its output VSYNC came before this frame's line 0; the
+// frame is then left as it is. Core 1 only ever moves on to this frame, so
+// the caller can try again after its next output VSYNC. Returns whether the
+// frame was completed.
+static inline bool line_ring_complete_from_previous(uint16_t line, uint16_t total_lines)
+{
+    const uint32_t base = g_line_ring.frame_base_idx;
+    if (line == 0U || LINE_RING_DEPTH < total_lines || base < total_lines) {
+        return false;
+    }
+    const uint32_t reader = g_line_ring.read_frame_start;
+    if (reader != base && base + line < reader + total_lines + LINE_RING_DEPTH &&
+        base + total_lines > reader + LINE_RING_DEPTH) {
+        return false; // a destination slot holds a line Core 1 may scan
+    }
+    for (uint32_t y = line; y < total_lines; y++) {
+        const uint32_t from = LINE_RING_SLOT(base - total_lines + y);
+        const uint32_t to = LINE_RING_SLOT(base + y);
+        if (from == to) {
+            continue; // a ring of exactly one frame
+        }
+        memcpy(g_line_ring.lines[to], g_line_ring.lines[from], sizeof g_line_ring.lines[0]);
+#if NEOPICO_EXP_RGB888_SCANOUT
+        g_line_ring.line_shadow[to] = g_line_ring.line_shadow[from];
+#endif
+    }
+    line_ring_commit(total_lines);
+    return true;
+}
+
 // ============================================================================
 // Core 1 API (Consumer) - HDMI output side
 // ============================================================================
@@ -100,6 +300,43 @@ static inline bool line_ring_should_resync(void)
     return false;
 }
 
+#if NEOPICO_DIAG_COUNTERS
+// Output VSYNC accounting: classifies the frame starting at `frame_start`
+// against the previous output frame's. Frame bases step by LINES_PER_FRAME;
+// a capture resync can leave a partial step, which rounds to the nearest.
+static inline void line_ring_diag_output_frame(uint32_t frame_start)
+{
+    line_ring_diag_t *diag = &g_line_ring_diag;
+    if (diag->out_frames != 0U) {
+        const uint32_t frames = (frame_start - diag->last_shown + (LINES_PER_FRAME / 2U)) / LINES_PER_FRAME;
+        if (frames == 1U) {
+            diag->new_frames++;
+            diag->run_frames++;
+        } else {
+            if (frames == 0U) {
+                diag->repeated_frames++;
+            } else {
+                diag->new_frames++;
+                diag->skipped_frames += frames - 1U;
+            }
+            line_ring_pace_event_t *event = &diag->pace_log[diag->pace_events % LINE_RING_PACE_LOG];
+            event->out_frame = diag->out_frames;
+            event->skipped = frames == 0U ? 0U : frames - 1U;
+            if (diag->pace_events != 0U) {
+                diag->beat_frames = diag->out_frames - diag->last_event_frame;
+            }
+            diag->last_event_frame = diag->out_frames;
+            diag->last_run_frames = diag->run_frames;
+            diag->run_frames = 0;
+            __dmb(); // event visible before its count
+            diag->pace_events++;
+        }
+    }
+    diag->last_shown = frame_start;
+    diag->out_frames++;
+}
+#endif
+
 // Called at output VSYNC (when not resyncing)
 static inline void line_ring_output_vsync(void)
 {
@@ -116,10 +353,100 @@ static inline void line_ring_output_vsync(void)
     g_line_ring.read_frame_start = frame_start;
     __dmb();
 #if NEOPICO_DIAG_COUNTERS
-    g_line_ring_diag.out_frames++;
+    line_ring_diag_output_frame(frame_start);
 #endif
 }
 
+#if NEOPICO_EXP_BEAM_RACE
+// Low-latency read policy. line_ring_output_vsync() shows the newest frame
+// base, which is the previous, complete frame whenever the output VSYNC lands
+// in the input's vertical blanking or before its line 0 is committed: a whole
+// input frame (~16.9 ms) older than the one about to arrive. Racing the beam
+// shows the frame being written instead -- the current base even with no
+// line committed yet, while line 0 is still due, or during blanking the next
+// base (write_idx, predicted one frame period after the current one) -- when
+// the line rates guarantee that every line will be committed before scanout
+// reaches it. That holds when the
+// frame starts no later than `race_slack_us` after this output VSYNC; the
+// slack accounts for both ends of the frame (line_ring_race_slack_us()).
+// Otherwise, or when the input rate is implausible (no signal, first frame),
+// this frame falls back to line_ring_output_vsync().
+
+// Frame periods the next-frame prediction trusts: 50 to 70 Hz.
+#define LINE_RING_RACE_PERIOD_MIN_US 14000U
+#define LINE_RING_RACE_PERIOD_MAX_US 21000U
+
+// Scanout jitter the guarantee leaves room for: the vsync callback's entry
+// latency and the capture loop's per-line conversion time.
+#define LINE_RING_RACE_MARGIN_US 100
+
+// How long a frame base may stay empty before its line 0 is overdue. Past
+// that the input stalled or its frame was aborted before line 0, and racing
+// would show an empty frame for the whole outage.
+#define LINE_RING_RACE_FIRST_COMMIT_US                                                                                 \
+    ((int32_t)((CAPTURE_FIRST_COMMIT_LINES * CAPTURE_LINE_NS) / 1000U) + LINE_RING_RACE_MARGIN_US)
+
+// `out_lead_us`: from the output VSYNC callback to scanout's fetch of ring
+// line 0; `out_line_ns`: scanout time per ring line. Negative when the output
+// would overtake the input inside a frame that starts at its VSYNC.
+static inline int32_t line_ring_race_slack_us(uint32_t out_lead_us, uint32_t out_line_ns)
+{
+    int32_t slack = (int32_t)out_lead_us - (int32_t)((CAPTURE_FIRST_COMMIT_LINES * CAPTURE_LINE_NS) / 1000U) -
+                    LINE_RING_RACE_MARGIN_US;
+    // Scanout consuming lines faster than they arrive loses ground towards
+    // the last line.
+    if (out_line_ns < CAPTURE_LINE_NS) {
+        slack -= (int32_t)(((LINES_PER_FRAME - 1U) * (CAPTURE_LINE_NS - out_line_ns)) / 1000U);
+    }
+    return slack;
+}
+
+// Boot-time, with the output mode set and before Core 1 launch.
+static inline void line_ring_race_init(int32_t slack_us)
+{
+    g_line_ring.race_slack_us = slack_us;
+}
+
+// Called at output VSYNC instead of line_ring_output_vsync(); `now_us` is
+// timer_hw->timerawl. Returns whether this frame races the input, i.e. shows
+// a newer frame than line_ring_output_vsync() would have.
+static inline bool line_ring_output_vsync_race(uint32_t now_us)
+{
+    const uint32_t frame_start = g_line_ring.frame_base_idx;
+    __dmb();
+    const uint32_t base_us = g_line_ring.frame_base_us;
+    const uint32_t period_us = g_line_ring.frame_period_us;
+    const uint32_t write_pos = g_line_ring.write_idx;
+
+    const uint32_t committed = write_pos - frame_start;
+    int32_t start_in_us = (int32_t)(base_us - now_us);
+    uint32_t race_start = frame_start;
+    // Mid-frame the default already shows the frame being written; an empty
+    // one only while its line 0 is still due.
+    bool plausible = committed == 0U && start_in_us >= -LINE_RING_RACE_FIRST_COMMIT_US;
+    if (committed >= LINES_PER_FRAME) {
+        // Blanking: the next frame starts at write_idx. Its VSYNC must still
+        // be ahead -- an overdue one means the input stalled.
+        race_start = write_pos;
+        start_in_us += (int32_t)period_us;
+        plausible = period_us >= LINE_RING_RACE_PERIOD_MIN_US && period_us <= LINE_RING_RACE_PERIOD_MAX_US &&
+                    start_in_us >= 0;
+    }
+    if (!plausible || start_in_us > g_line_ring.race_slack_us) {
+        line_ring_output_vsync();
+        return false;
+    }
+
+    g_line_ring.read_frame_start = race_start;
+    __dmb();
+#if NEOPICO_DIAG_COUNTERS
+    line_ring_diag_output_frame(race_start);
+    g_line_ring_diag.raced++;
+#endif
+    return true;
+}
+#endif
+
 // Check if line is ready and still in buffer
 static inline bool line_ring_ready(uint16_t line)
 {
@@ -135,7 +462,7 @@ static inline bool line_ring_ready(uint16_t line)
     }
 
     // Line must still be in buffer (not overwritten)
-    if (write_pos - target_idx > LINE_RING_SIZE) {
+    if (write_pos - target_idx > LINE_RING_DEPTH) {
 #if NEOPICO_DIAG_COUNTERS
         g_line_ring_diag.overrun++;
 #endif
@@ -145,25 +472,72 @@ static inline bool line_ring_ready(uint16_t line)
     return true;
 }
 
+#if NEOPICO_DIAG_LINE_LATENCY
+static inline void line_ring_stamp_read(uint32_t target_idx)
+{
+    const uint32_t slot = LINE_RING_SLOT(target_idx);
+    if (g_line_ring.read_idx[slot] == target_idx) {
+        return;
+    }
+    const uint32_t now = timer_hw->timerawl;
+    const uint32_t latency_us = now - g_line_ring.commit_us[slot];
+    uint32_t bucket = latency_us == 0U ? 0U : 32U - (uint32_t)__builtin_clz(latency_us);
+    if (bucket >= LINE_RING_LATENCY_BUCKETS) {
+        bucket = LINE_RING_LATENCY_BUCKETS - 1U;
+    }
+    g_line_ring.read_idx[slot] = target_idx;
+    g_line_ring.read_us[slot] = now;
+    g_line_ring.latency_hist[bucket]++;
+}
+
+// Upper bound, in us, of the histogram bucket holding the `permille`-th
+// fetch (500: median); 0 with no fetches, UINT32_MAX in the open-ended
+// bucket. For the OSD and the USB dump.
+static inline uint32_t line_ring_latency_percentile_us(uint32_t permille)
+{
+    uint32_t hist[LINE_RING_LATENCY_BUCKETS];
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < LINE_RING_LATENCY_BUCKETS; i++) {
+        hist[i] = g_line_ring.latency_hist[i];
+        total += hist[i];
+    }
+    if (total == 0U) {
+        return 0;
+    }
+    const uint64_t rank = ((total * permille) + 999U) / 1000U;
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i + 1U < LINE_RING_LATENCY_BUCKETS; i++) {
+        seen += hist[i];
+        if (seen >= rank && seen != 0U) {
+            return 1U << i;
+        }
+    }
+    return UINT32_MAX;
+}
+#endif
+
 // Get read pointer for line N in current display frame
 static inline const uint16_t *line_ring_read_ptr(uint16_t line)
 {
     __dmb(); // Ensure we see latest committed data
     uint32_t target_idx = g_line_ring.read_frame_start + line;
-    return g_line_ring.lines[target_idx % LINE_RING_SIZE];
+#if NEOPICO_DIAG_LINE_LATENCY
+    line_ring_stamp_read(target_idx);
+#endif
+    return g_line_ring.lines[LINE_RING_SLOT(target_idx)];
 }
 
 #if NEOPICO_EXP_RGB888_SCANOUT
 static inline void line_ring_write_shadow(uint16_t line, uint32_t shadow)
 {
     uint32_t target_idx = g_line_ring.frame_base_idx + line;
-    g_line_ring.line_shadow[target_idx % LINE_RING_SIZE] = (uint8_t)(shadow & 1U);
+    g_line_ring.line_shadow[LINE_RING_SLOT(target_idx)] = (uint8_t)(shadow & 1U);
 }
 
 static inline uint32_t line_ring_read_shadow(uint16_t line)
 {
     uint32_t target_idx = g_line_ring.read_frame_start + line;
-    return g_line_ring.line_shadow[target_idx % LINE_RING_SIZE];
+    return g_line_ring.line_shadow[LINE_RING_SLOT(target_idx)];
 }
 #endif
 
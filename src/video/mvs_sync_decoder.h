@@ -0,0 +1,148 @@
+#ifndef NEOPICO_HD_MVS_SYNC_DECODER_H
+#define NEOPICO_HD_MVS_SYNC_DECODER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+// MVS vertical sync from the sync SM's pulse lengths. mvs_sync_4a pushes,
+// for every CSYNC period, the PCLK count while CSYNC was high: about 355 for
+// a normal line, far less for the equalization and serration half-lines of
+// the vertical interval. A frame starts at the second of two consecutive line
+// pulses after a run of at least MVS_SYNC_MIN_SHORTS half-line pulses.
+//
+// A single bad pulse must not move that point or lose it:
+// - Pulses outside both plausibility windows (noise spikes, the band between
+//   half-line and line, two lines run together) change no state.
+// - A line pulse only counts once the next pulse is a line too. A lone one
+//   inside the interval (two half-lines run together) is absorbed, and the
+//   short run carries on.
+// - A vsync fewer than MVS_SYNC_MIN_FRAME_LINES line pulses after the last
+//   one is rejected; the first after a restart is always taken.
+// Each vsync also records how many lines the frame it ends lasted, which
+// tells a 50 Hz raster from a 60 Hz one (video_standard.h).
+// Only the sync IRQ touches a decoder, so it is not reentrant and takes no
+// lock. The capture loop asks for a restart through a flag that the IRQ acts
+// on before its next push, rather than calling mvs_sync_decoder_restart().
+
+// Plausibility windows in PCLKs. Between SHORT_MAX and LINE_MIN is
+// hysteresis: a pulse there is neither. A normal line reports 356; two
+// equalization half-lines run together report 371 and must fall above
+// LINE_MAX.
+#define MVS_SYNC_SHORT_MIN 4U
+#define MVS_SYNC_SHORT_MAX 288U
+#define MVS_SYNC_LINE_MIN 336U
+#define MVS_SYNC_LINE_MAX 368U
+
+#define MVS_SYNC_MIN_SHORTS 8U
+#define MVS_SYNC_MIN_FRAME_LINES 200U
+
+// Pulse-length histogram: 16-PCLK buckets, the last one open-ended.
+#define MVS_SYNC_HIST_BUCKET_PCLKS 16U
+#define MVS_SYNC_HIST_BUCKETS ((MVS_SYNC_LINE_MAX / MVS_SYNC_HIST_BUCKET_PCLKS) + 1U)
+
+typedef enum {
+    MVS_SYNC_PULSE_SHORT,
+    MVS_SYNC_PULSE_LINE,
+    MVS_SYNC_PULSE_GLITCH,
+} mvs_sync_pulse_t;
+
+typedef struct {
+    // Decoder state, cleared by mvs_sync_decoder_restart().
+    uint32_t short_run;   // half-line pulses since the last confirmed line
+    uint32_t lines;       // confirmed line pulses since the last vsync
+    bool line_pending;    // the last pulse was a line after a short run
+    bool locked;          // a vsync was taken since the restart
+    uint32_t frame_lines; // lines between the last two vsyncs; 0 until there are two
+
+    // Statistics, kept across restarts.
+    uint32_t vsyncs;
+    uint32_t glitches; // pulses outside both windows
+    uint32_t absorbed; // lone line pulses inside a short run
+    uint32_t early;    // vsyncs rejected as too soon after the last
+    uint32_t hist[MVS_SYNC_HIST_BUCKETS];
+} mvs_sync_decoder_t;
+
+static inline void mvs_sync_decoder_init(mvs_sync_decoder_t *dec)
+{
+    memset(dec, 0, sizeof *dec);
+}
+
+// Forget the raster phase, e.g. after capture was paused or the signal lost.
+static inline void mvs_sync_decoder_restart(mvs_sync_decoder_t *dec)
+{
+    dec->short_run = 0;
+    dec->lines = 0;
+    dec->line_pending = false;
+    dec->locked = false;
+    dec->frame_lines = 0;
+}
+
+static inline mvs_sync_pulse_t mvs_sync_classify(uint32_t h_ctr)
+{
+    if (h_ctr >= MVS_SYNC_SHORT_MIN && h_ctr <= MVS_SYNC_SHORT_MAX) {
+        return MVS_SYNC_PULSE_SHORT;
+    }
+    if (h_ctr >= MVS_SYNC_LINE_MIN && h_ctr <= MVS_SYNC_LINE_MAX) {
+        return MVS_SYNC_PULSE_LINE;
+    }
+    return MVS_SYNC_PULSE_GLITCH;
+}
+
+// Feed one pulse length. Returns true at the pulse that starts a frame.
+static inline bool mvs_sync_decoder_push(mvs_sync_decoder_t *dec, uint32_t h_ctr)
+{
+    const uint32_t bucket = h_ctr / MVS_SYNC_HIST_BUCKET_PCLKS;
+    dec->hist[bucket < MVS_SYNC_HIST_BUCKETS ? bucket : MVS_SYNC_HIST_BUCKETS - 1U]++;
+
+    switch (mvs_sync_classify(h_ctr)) {
+        case MVS_SYNC_PULSE_SHORT:
+            if (dec->line_pending) {
+                dec->absorbed++;
+                dec->line_pending = false;
+            }
+            dec->short_run++;
+            return false;
+
+        case MVS_SYNC_PULSE_LINE:
+            if (dec->short_run == 0U) {
+                dec->lines++;
+                return false;
+            }
+            if (!dec->line_pending) {
+                dec->line_pending = true;
+                return false;
+            }
+            break;
+
+        default:
+            dec->glitches++;
+            return false;
+    }
+
+    // Second line pulse in a row after a short run: the raster is back in
+    // normal lines.
+    const bool interval = dec->short_run >= MVS_SYNC_MIN_SHORTS;
+    const bool plausible = !dec->locked || dec->lines >= MVS_SYNC_MIN_FRAME_LINES;
+    const uint32_t short_run = dec->short_run;
+    dec->short_run = 0;
+    dec->line_pending = false;
+    if (!interval) {
+        dec->lines += 2U;
+        return false;
+    }
+    if (!plausible) {
+        dec->early++;
+        dec->lines += 2U;
+        return false;
+    }
+    // The normal lines, the interval's half-lines in pairs, and the two that
+    // confirm this vsync.
+    dec->frame_lines = dec->locked ? dec->lines + (short_run / 2U) + 2U : 0U;
+    dec->lines = 0;
+    dec->locked = true;
+    dec->vsyncs++;
+    return true;
+}
+
+#endif // NEOPICO_HD_MVS_SYNC_DECODER_H
@@ -6,6 +6,10 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "capture_profile.h"
+#include "content_bounds.h"
+#include "video_standard.h"
+
 #ifndef NEOPICO_MVS_COLOR_MODEL_MENU
 #define NEOPICO_MVS_COLOR_MODEL_MENU 0
 #endif
@@ -33,6 +37,126 @@ void video_capture_run(void);
  */
 uint32_t video_capture_get_frame_count(void);
 
+/**
+ * Content bounds of the captured picture in frame pixels: first and last
+ * non-black column and row, published with hysteresis (content_bounds.h).
+ * The full frame until content has been seen, and always without
+ * NEOPICO_EXP_CONTENT_BOUNDS.
+ *
+ * @return Changes published so far, so a scaler can tell when to re-fit.
+ */
+uint32_t video_capture_get_content_bounds(content_bounds_t *bounds);
+
+/**
+ * Content hash of the last complete frame's converted pixels, folded line by
+ * line (capture_line.h), so duplicate frames can be told apart from new ones
+ * by content rather than timing. Output-side code can hash what it shows with
+ * capture_hash_line() and match it.
+ *
+ * @param frame Set to the frame count the hash belongs to; 0 before the first,
+ *              and always 0 without NEOPICO_EXP_FRAME_HASH.
+ */
+uint32_t video_capture_get_frame_hash(uint32_t *frame);
+
+/**
+ * Input frame rate (video_standard.h), from the lines each frame lasts: the
+ * MVS counts its sync pulses, the SNES divides its VBLANK period by the line
+ * time. 60 Hz until a 50 Hz input has held for a few frames. The capture
+ * window stays CAPTURE_ACTIVE_HEIGHT lines either way.
+ *
+ * @param frame_lines Set to the last plausible frame's line count, 0 before
+ *                    the first; may be NULL.
+ */
+video_standard_t video_capture_get_standard(uint16_t *frame_lines);
+
+#if NEOPICO_CAPTURE_TARGET == NEOPICO_CAPTURE_TARGET_MVS
+/**
+ * Trim the horizontal capture window by `offset` dots (positive moves the
+ * picture left). Clamped to the dots the line can spare; Core 0 hands the
+ * new window to the pixel SM at the next input VSYNC.
+ */
+void video_capture_set_h_offset(int offset);
+int video_capture_get_h_offset(void);
+
+/**
+ * Core 0's idle time in the capture loop: how long it waited for each active
+ * line before converting it, and what the slack scheduler ran meanwhile.
+ * All zero unless the firmware is built with NEOPICO_EXP_CAPTURE_SLACK_TASKS.
+ */
+typedef struct {
+    uint32_t frames;            // complete frames accounted
+    uint32_t frame_slack_us;    // last frame: wait summed over its active lines
+    uint32_t min_line_slack_us; // last frame: shortest wait; 0 when a line was ready early
+    uint32_t task_runs;         // cumulative slack task runs
+    uint32_t task_us;           // cumulative time in slack tasks
+    uint32_t late_tasks;        // cumulative runs that ended past their line's deadline
+} video_capture_slack_stats_t;
+
+void video_capture_get_slack_stats(video_capture_slack_stats_t *stats);
+
+/**
+ * Signal-loss recovery: how often the input was lost, and how each loss
+ * ended. All cumulative except last_relock_us.
+ */
+typedef struct {
+    uint32_t losses;          // vsync timeouts or stalled frames that started a loss
+    uint32_t aborted_frames;  // frames whose lines stopped arriving
+    uint32_t fast_relocks;    // losses that ended without a capture hardware reset
+    uint32_t hardware_resets; // capture PIO resets after repeated timeouts
+    uint32_t audio_rearms;    // relocks that re-armed audio: the I2S clock had stopped
+    uint32_t last_relock_us;  // last loss: from its detection to the first vsync
+} video_capture_relock_stats_t;
+
+void video_capture_get_relock_stats(video_capture_relock_stats_t *stats);
+
+/**
+ * Per-line signal integrity from the CSYNC and PCLK bits every 19-bit capture
+ * word carries (packed capture is not checked). A line is flagged when one of
+ * its pixels was sampled with PCLK already low, or with CSYNC low inside the
+ * active window. All zero unless built with NEOPICO_EXP_LINE_INTEGRITY.
+ */
+#define VIDEO_CAPTURE_LINE_PCLK_LOW 0x01U
+#define VIDEO_CAPTURE_LINE_CSYNC_LOW 0x02U
+
+typedef struct {
+    uint32_t frame_lines;   // active lines checked per frame
+    uint32_t frames;        // complete frames checked
+    uint32_t pclk_lines;    // cumulative lines with a pixel sampled while PCLK was low
+    uint32_t csync_lines;   // cumulative lines with CSYNC low in the active window
+    uint32_t frame_flagged; // last complete frame: lines flagged
+} video_capture_line_stats_t;
+
+void video_capture_get_line_stats(video_capture_line_stats_t *stats);
+
+/**
+ * Active line `line`'s VIDEO_CAPTURE_LINE_* flags in the last frame; stores
+ * how many frames have flagged it in `errors`.
+ */
+uint8_t video_capture_get_line_flags(uint16_t line, uint32_t *errors);
+#endif
+
+#if NEOPICO_CAPTURE_TARGET == NEOPICO_CAPTURE_TARGET_SNES
+/**
+ * SNES video modes as the capture sees them. Hires lines (512 dots, pseudo-
+ * hires included) are only told apart with NEOPICO_EXP_SNES_HIRES_CAPTURE,
+ * which samples both halves of every dot and stores each pair 2:1 averaged;
+ * otherwise hires_lines stays 0. Interlace is detected from the VBLANK
+ * period, whose fields then alternate one line long and short. Detection
+ * only: each field is still captured and shown as a frame of its own, with
+ * no weave or half-line offset for the odd field.
+ */
+typedef struct {
+    uint32_t frames;       // complete frames checked
+    uint32_t hires_frames; // cumulative frames with at least one hires line
+    uint16_t hires_lines;  // last complete frame: lines with detail between a dot's halves
+    bool interlaced;       // the last few fields alternated long and short
+    uint8_t field;         // interlaced: 1 when the last field was the long one
+    uint32_t field_us;     // last VBLANK-to-VBLANK period
+} video_capture_snes_mode_t;
+
+void video_capture_get_snes_mode(video_capture_snes_mode_t *mode);
+#endif
+
 #if NEOPICO_EXP_GENLOCK_DYNAMIC
 /**
  * Timestamp (timer_hw->timerawl) of the most recent input VSYNC, written by Core 0.
@@ -12,22 +12,33 @@
 #include "hardware/dma.h"
 #include "hardware/irq.h"
 #include "hardware/pio.h"
-#if NEOPICO_EXP_GENLOCK_DYNAMIC
 #include "hardware/timer.h"
-#endif
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "audio_subsystem.h"
 #include "hardware_config.h"
 #include "line_ring.h"
 #include "mvs_pins.h"
+#include "mvs_sync_decoder.h"
 #include "pico.h"
 #include "tusb.h"
 #include "video_capture.h"
 #include "video_capture_mvs.pio.h"
 
+// Background tasks in Core 0's per-line slack (see Slack Scheduler below).
+#ifndef NEOPICO_EXP_CAPTURE_SLACK_TASKS
+#define NEOPICO_EXP_CAPTURE_SLACK_TASKS 0
+#endif
+
+// Vertical sync decoder, fed by sync_irq_handler() one pulse per IRQ.
+static mvs_sync_decoder_t g_sync_decoder;
+
+// 50/60 Hz from the decoder's line count per frame, fed at each vsync.
+static video_standard_detector_t g_standard;
+
 #if NEOPICO_EXP_SCANLINE_TRACE
 // Raw-binary dump of the Core 1 scanline timing ring, on host request.
 // Deliberately unformatted: no snprintf, no float, and chunked against the
@@ -84,9 +95,150 @@ static void scanline_trace_dump_tick(void)
 #include <stdio.h>
 line_ring_diag_t g_line_ring_diag;
 
+// Frame-pacing line after the counters: cumulative new/repeated/skipped
+// output frames, the cadence run and beat (in output frames), then the
+// pace_log events since the last line as "D<out_frame>" (repeat) or
+// "S<out_frame>x<skipped>". Events that fell out of the log before the CDC
+// could take them are counted as lost rather than stalling capture.
+static void video_capture_pace_tick(uint32_t now)
+{
+    static uint32_t cursor = 0;
+    const uint32_t events = g_line_ring_diag.pace_events;
+    __dmb(); // log entries no older than the count
+    uint32_t next = cursor;
+    uint32_t lost = 0;
+    if (events - next > LINE_RING_PACE_LOG) {
+        lost = events - next - LINE_RING_PACE_LOG;
+        next = events - LINE_RING_PACE_LOG;
+    }
+    char buf[200];
+    int n = snprintf(buf, sizeof buf, "[%lu] PACE new=%lu dup=%lu skip=%lu run=%lu beat=%lu lost=%lu",
+                     (unsigned long)now, (unsigned long)g_line_ring_diag.new_frames,
+                     (unsigned long)g_line_ring_diag.repeated_frames, (unsigned long)g_line_ring_diag.skipped_frames,
+                     (unsigned long)g_line_ring_diag.last_run_frames, (unsigned long)g_line_ring_diag.beat_frames,
+                     (unsigned long)lost);
+    // Room for one more event and the line end.
+    while (next != events && n > 0 && n < (int)sizeof buf - 28) {
+        const line_ring_pace_event_t *event = &g_line_ring_diag.pace_log[next % LINE_RING_PACE_LOG];
+        if (event->skipped == 0U) {
+            n += snprintf(buf + n, sizeof buf - (size_t)n, " D%lu", (unsigned long)event->out_frame);
+        } else {
+            n += snprintf(buf + n, sizeof buf - (size_t)n, " S%lux%lu", (unsigned long)event->out_frame,
+                          (unsigned long)event->skipped);
+        }
+        next++;
+    }
+    n += snprintf(buf + n, sizeof buf - (size_t)n, "\r\n");
+    if ((int)tud_cdc_write_available() >= n) {
+        tud_cdc_write(buf, (uint32_t)n);
+        tud_cdc_write_flush();
+        cursor = next; // unsent events go out with the next line
+    }
+}
+
+#if NEOPICO_EXP_CAPTURE_SLACK_TASKS
+// Core 0 slack line: the last frame's summed and shortest per-line wait, then
+// cumulative slack task runs, their time and the runs that ended late.
+static void video_capture_slack_tick(uint32_t now)
+{
+    video_capture_slack_stats_t slack;
+    video_capture_get_slack_stats(&slack);
+    char buf[120];
+    int n = snprintf(buf, sizeof buf, "[%lu] SLACK frame=%luus min=%luus runs=%lu task=%luus late=%lu\r\n",
+                     (unsigned long)now, (unsigned long)slack.frame_slack_us,
+                     (unsigned long)slack.min_line_slack_us, (unsigned long)slack.task_runs,
+                     (unsigned long)slack.task_us, (unsigned long)slack.late_tasks);
+    if (n > 0 && (int)tud_cdc_write_available() >= n) {
+        tud_cdc_write(buf, (uint32_t)n);
+        tud_cdc_write_flush();
+    }
+}
+#endif
+
+// Relock line: cumulative signal losses, the frames they cut short, losses
+// that ended without a hardware reset, hardware resets and audio re-arms,
+// then how long the last loss lasted.
+static void video_capture_relock_tick(uint32_t now)
+{
+    video_capture_relock_stats_t relock;
+    video_capture_get_relock_stats(&relock);
+    char buf[120];
+    int n = snprintf(buf, sizeof buf, "[%lu] RELOCK loss=%lu abort=%lu fast=%lu reset=%lu rearm=%lu last=%luus\r\n",
+                     (unsigned long)now, (unsigned long)relock.losses, (unsigned long)relock.aborted_frames,
+                     (unsigned long)relock.fast_relocks, (unsigned long)relock.hardware_resets,
+                     (unsigned long)relock.audio_rearms, (unsigned long)relock.last_relock_us);
+    if (n > 0 && (int)tud_cdc_write_available() >= n) {
+        tud_cdc_write(buf, (uint32_t)n);
+        tud_cdc_write_flush();
+    }
+}
+
+#if NEOPICO_EXP_LINE_INTEGRITY
+// Line integrity line: complete frames checked, cumulative lines sampled with
+// PCLK low or CSYNC low, lines flagged in the last frame, then the flagged
+// line count per eighth of the picture (top first) and the worst line.
+static void video_capture_lines_tick(uint32_t now)
+{
+    video_capture_line_stats_t lines;
+    video_capture_get_line_stats(&lines);
+    char buf[200];
+    int n = snprintf(buf, sizeof buf, "[%lu] LINES frames=%lu pclk=%lu csync=%lu last=%lu bands", (unsigned long)now,
+                     (unsigned long)lines.frames, (unsigned long)lines.pclk_lines, (unsigned long)lines.csync_lines,
+                     (unsigned long)lines.frame_flagged);
+    uint32_t bands[8] = {0};
+    uint16_t worst = 0;
+    uint32_t worst_errors = 0;
+    for (uint16_t line = 0; line < lines.frame_lines; line++) {
+        uint32_t errors;
+        (void)video_capture_get_line_flags(line, &errors);
+        bands[(line * 8U) / lines.frame_lines] += errors;
+        if (errors > worst_errors) {
+            worst = line;
+            worst_errors = errors;
+        }
+    }
+    for (uint32_t i = 0; i < 8U && n > 0 && n < (int)sizeof buf; i++) {
+        n += snprintf(buf + n, sizeof buf - (size_t)n, " %lu", (unsigned long)bands[i]);
+    }
+    if (n > 0 && n < (int)sizeof buf) {
+        n += snprintf(buf + n, sizeof buf - (size_t)n, " worst=%u:%lu\r\n", (unsigned)worst,
+                      (unsigned long)worst_errors);
+    }
+    if (n > 0 && n < (int)sizeof buf && (int)tud_cdc_write_available() >= n) {
+        tud_cdc_write(buf, (uint32_t)n);
+        tud_cdc_write_flush();
+    }
+}
+#endif
+
+// Sync decoder line: cumulative vsyncs, pulses outside both windows, lone
+// line pulses absorbed inside an interval, vsyncs rejected as too early, the
+// last frame's lines and the rate they make, then the pulse-length histogram
+// in 16-PCLK buckets.
+static void video_capture_sync_tick(uint32_t now)
+{
+    char buf[320];
+    const bool rate_50hz = g_standard.standard == VIDEO_STANDARD_50HZ;
+    int n = snprintf(buf, sizeof buf, "[%lu] SYNC vs=%lu glitch=%lu absorbed=%lu early=%lu lines=%lu %sHz hist",
+                     (unsigned long)now, (unsigned long)g_sync_decoder.vsyncs, (unsigned long)g_sync_decoder.glitches,
+                     (unsigned long)g_sync_decoder.absorbed, (unsigned long)g_sync_decoder.early,
+                     (unsigned long)g_sync_decoder.frame_lines, rate_50hz ? "50" : "60");
+    for (uint32_t i = 0; i < MVS_SYNC_HIST_BUCKETS && n > 0 && n < (int)sizeof buf; i++) {
+        n += snprintf(buf + n, sizeof buf - (size_t)n, " %lu", (unsigned long)g_sync_decoder.hist[i]);
+    }
+    if (n > 0 && n < (int)sizeof buf - 2) {
+        n += snprintf(buf + n, sizeof buf - (size_t)n, "\r\n");
+    }
+    if (n > 0 && n < (int)sizeof buf && (int)tud_cdc_write_available() >= n) {
+        tud_cdc_write(buf, (uint32_t)n);
+        tud_cdc_write_flush();
+    }
+}
+
 // Non-blocking 1 Hz dump of capture-health counters over USB-CDC. Called from
-// the inter-frame gap on Core 0. Skips entirely if no host is reading (or the
-// CDC TX buffer is full) so it can never stall capture timing.
+// the inter-frame gap, or from the slack scheduler between lines. Skips
+// entirely if no host is reading (or the CDC TX buffer is full) so it can
+// never stall capture timing.
 static void video_capture_diag_tick(uint32_t input_frames)
 {
     static uint32_t last_ms = 0;
@@ -100,11 +252,12 @@ static void video_capture_diag_tick(uint32_t input_frames)
     // NOTWR/OVR/SYNCRST are printed CUMULATIVE (absolute) so any single line read
     // gives the running totals — robust to dropped/stalled CDC lines. Baseline = 0,
     // so any non-zero means events have occurred since boot.
-    char buf[120];
-    int n = snprintf(buf, sizeof buf, "[%lu] in=%lu(+%lu) out=%lu(+%lu) NOTWR=%lu OVR=%lu SYNCRST=%lu\r\n",
+    char buf[140];
+    int n = snprintf(buf, sizeof buf, "[%lu] in=%lu(+%lu) out=%lu(+%lu) NOTWR=%lu OVR=%lu SYNCRST=%lu LAPPED=%lu\r\n",
                      (unsigned long)now, (unsigned long)input_frames, (unsigned long)(input_frames - l_in),
                      (unsigned long)out, (unsigned long)(out - l_out), (unsigned long)g_line_ring_diag.not_written,
-                     (unsigned long)g_line_ring_diag.overrun, (unsigned long)g_line_ring_diag.sync_resets);
+                     (unsigned long)g_line_ring_diag.overrun, (unsigned long)g_line_ring_diag.sync_resets,
+                     (unsigned long)g_line_ring_diag.line_dma_lapped);
     // Gate ONLY on TX buffer room (non-blocking) — NOT on tud_cdc_connected(), whose
     // DTR state is unreliable with macOS cu.* devices and stalls the stream.
     if (n > 0 && (int)tud_cdc_write_available() >= n) {
@@ -113,6 +266,47 @@ static void video_capture_diag_tick(uint32_t input_frames)
     }
     l_in = input_frames;
     l_out = out;
+    video_capture_pace_tick(now);
+#if NEOPICO_EXP_CAPTURE_SLACK_TASKS
+    video_capture_slack_tick(now);
+#endif
+    video_capture_sync_tick(now);
+    video_capture_relock_tick(now);
+#if NEOPICO_EXP_LINE_INTEGRITY
+    video_capture_lines_tick(now);
+#endif
+}
+#endif
+
+#if NEOPICO_DIAG_LINE_LATENCY
+#include <stdio.h>
+
+// Non-blocking 1 Hz dump of the line ring's capture-to-scanout latency
+// histogram (line_ring.h) over USB-CDC, like video_capture_diag_tick():
+// cumulative bucket counts, so any single line carries the full picture.
+// Bucket k holds latencies in [2^(k-1), 2^k) us.
+static void video_capture_latency_tick(void)
+{
+    static uint32_t last_ms = 0;
+    uint32_t now = to_ms_since_boot(get_absolute_time());
+    if ((now - last_ms) < 1000U) {
+        return;
+    }
+    last_ms = now;
+    char buf[320];
+    int n = snprintf(buf, sizeof buf, "[%lu] LAT p50<=%luus p99<=%luus hist", (unsigned long)now,
+                     (unsigned long)line_ring_latency_percentile_us(500U),
+                     (unsigned long)line_ring_latency_percentile_us(990U));
+    for (uint32_t i = 0; i < LINE_RING_LATENCY_BUCKETS && n > 0 && n < (int)sizeof buf; i++) {
+        n += snprintf(buf + n, sizeof buf - (size_t)n, " %lu", (unsigned long)g_line_ring.latency_hist[i]);
+    }
+    if (n > 0 && n < (int)sizeof buf - 2) {
+        n += snprintf(buf + n, sizeof buf - (size_t)n, "\r\n");
+    }
+    if (n > 0 && n < (int)sizeof buf && (int)tud_cdc_write_available() >= n) {
+        tud_cdc_write(buf, (uint32_t)n);
+        tud_cdc_write_flush();
+    }
 }
 #endif
 
@@ -127,11 +321,17 @@ static void video_capture_diag_tick(uint32_t input_frames)
 #define ENABLE_DARK_SHADOW 0
 #endif
 
+// Two pixels per capture word (mvs_pixel_capture_packed16): RGB555 + DARK
+// only, with SHADOW read from its pin once per line. Halves the pixel DMA's
+// bus traffic and the line buffers.
+#ifndef NEOPICO_EXP_MVS_PACKED_CAPTURE
+#define NEOPICO_EXP_MVS_PACKED_CAPTURE 0
+#endif
+
 // =============================================================================
 // MVS Timing Constants
 // =============================================================================
 
-#define H_THRESHOLD 288
 #define NEO_H_TOTAL 384
 #define NEO_H_ACTIVE 320
 #define H_SKIP_START 28
@@ -140,6 +340,27 @@ static void video_capture_diag_tick(uint32_t input_frames)
 #define NEO_V_ACTIVE 224
 #define MVS_CAPTURE_PIO_TARGET_HZ 126000000U
 
+#if NEOPICO_EXP_MVS_PACKED_CAPTURE
+#define MVS_CAPTURE_PIXELS_PER_WORD 2
+#else
+#define MVS_CAPTURE_PIXELS_PER_WORD 1
+#endif
+#define MVS_CAPTURE_LINE_WORDS (NEO_H_ACTIVE / MVS_CAPTURE_PIXELS_PER_WORD)
+_Static_assert(NEO_H_ACTIVE % 2 == 0, "packed capture needs whole pixel pairs per line");
+
+// Left-border dots the pixel SM may skip. The window must end at least two
+// dots before the line does, which leaves the packed program time to finish
+// its last sample before the next line's CSYNC rises.
+#define MVS_H_SKIP_MIN 1
+#define MVS_H_SKIP_MAX (NEO_H_TOTAL - 2 - NEO_H_ACTIVE)
+_Static_assert(H_SKIP_START >= MVS_H_SKIP_MIN && H_SKIP_START <= MVS_H_SKIP_MAX, "default window out of range");
+
+// Line buffers the pixel DMA fills in turn. A control channel walks a table
+// with one write address per line of the frame, so Core 0 may convert lines
+// in batches and fall up to MVS_CAPTURE_LINE_BUFFERS - 1 lines behind the
+// line being captured without losing pixels.
+#define MVS_CAPTURE_LINE_BUFFERS 4
+
 // PIO IRQ index: sync SM raises this on every line push for event-driven vsync (no polling)
 #define MVS_SYNC_IRQ_INDEX 0
 // No-signal timeout: only used to detect cable unplug / loss of signal; normal path is IRQ-driven
@@ -157,8 +378,14 @@ static uint g_offset_sync = 0;
 static uint g_sm_pixel = 0;
 static uint g_offset_pixel = 0;
 
-static int g_dma_chan = -1;
-static uint32_t g_line_buffers[2][NEO_H_TOTAL]; // Ping-pong buffers for line capture
+static int g_dma_chan = -1;      // pixel DMA, one line per trigger
+static int g_dma_ctrl_chan = -1; // reloads the pixel DMA from g_line_dma_descriptors
+static dma_channel_config g_dma_config;
+static uint32_t g_line_buffers[MVS_CAPTURE_LINE_BUFFERS][MVS_CAPTURE_LINE_WORDS];
+
+// Pixel DMA control blocks: the write address of every line it captures in a
+// frame (V border, then active), then a null trigger that ends the chain.
+static uint32_t g_line_dma_descriptors[V_SKIP_LINES + NEO_V_ACTIVE + 1];
 
 static volatile uint32_t g_frame_count = 0;
 
@@ -166,7 +393,6 @@ static volatile uint32_t g_frame_count = 0;
 volatile uint32_t g_mvs_vsync_timestamp = 0;
 #endif
 
-static int g_skip_start_words = 0;
 static int g_active_words = 0;
 static int g_line_words = 0;
 static float g_capture_pio_clkdiv = 1.0F;
@@ -174,13 +400,36 @@ static float g_capture_pio_clkdiv = 1.0F;
 // Semaphore released by sync IRQ handler when vsync is detected (one release per frame)
 static semaphore_t g_vsync_sem;
 
+// Horizontal trim in dots relative to H_SKIP_START, already clamped. Core 0
+// reads it once per frame and hands the pixel SM the resulting window when it
+// restarts it for the frame.
+static int32_t g_requested_h_offset = 0;
+
+// Pixel SM window word for the requested trim: ((active - 1) << 16) |
+// (skip - 1), split by the program's two `out x, 16`.
+static uint32_t requested_h_window(void)
+{
+    const int32_t h_offset = __atomic_load_n(&g_requested_h_offset, __ATOMIC_ACQUIRE);
+    const uint32_t skip = (uint32_t)(H_SKIP_START + h_offset);
+    return ((uint32_t)(NEO_H_ACTIVE - 1) << 16) | (skip - 1U);
+}
+
 // =============================================================================
 // Pixel Conversion
 // =============================================================================
 
+#include "capture_interp.h"
+#include "capture_line.h"
+#include "content_bounds.h"
 #include "mvs_color.h"
 #include "settings.h"
 
+// The interpolator lanes only shift, mask and add: the LUT must be indexed by
+// the captured RGB555 field as it is.
+#if NEOPICO_EXP_INTERP_LUT && (MVS_RAW_COLOR_MASK != 0 || MVS_REVERSE_15BIT)
+#error "NEOPICO_EXP_INTERP_LUT requires MVS_RAW_COLOR_MASK=0 and MVS_REVERSE_15BIT=0"
+#endif
+
 #if NEOPICO_MVS_COLOR_MODEL_MENU
 #include "mvs_color_model.h"
 
@@ -208,7 +457,7 @@ mvs_color_model_t video_capture_get_color_model(void)
 // flash write; consumed by sync_irq_handler() to reset its sync-decoder state
 // cleanly instead of resuming mid-vsync-detection. Unconditional: both the
 // Colors selector and the always-available Scanlines level use this same
-// resync path.
+// resync path. The no-signal timeout sets it too.
 static volatile bool g_sync_decoder_reset_requested;
 
 #if ENABLE_DARK_SHADOW
@@ -243,11 +492,50 @@ static void generate_capture_lut(void)
     mvs_effect_lut_generate(&g_capture_effect_lut);
 }
 
+#if NEOPICO_EXP_INTERP_LUT
+// interp1 lane 0 addresses the RG table with raw bits 18:7 (effect state,
+// red, green). interp0's full result addresses the B table: lane 0 takes the
+// effect state from bits 18:17, lane 1 blue from bits 6:2 of the same
+// accumulator (CROSS_INPUT), and BASE2 is the table.
+static void capture_interp_effect_init(void)
+{
+    interp_config rg = interp_default_config();
+    interp_config_set_shift(&rg, 6);
+    interp_config_set_mask(&rg, 1, MVS_EFFECT_RG_COLOR_BITS + 2U);
+    interp_claim_lane(interp1, 0);
+    interp_set_config(interp1, 0, &rg);
+    interp_set_base(interp1, 0, (uint32_t)(uintptr_t)g_capture_effect_lut.rg);
+
+    interp_config state = interp_default_config();
+    interp_config_set_shift(&state, 11);
+    interp_config_set_mask(&state, MVS_EFFECT_B_COLOR_BITS + 1U, MVS_EFFECT_B_COLOR_BITS + 2U);
+    interp_config blue = interp_default_config();
+    interp_config_set_cross_input(&blue, true);
+    interp_config_set_shift(&blue, 1);
+    interp_config_set_mask(&blue, 1, MVS_EFFECT_B_COLOR_BITS);
+    interp_claim_lane(interp0, 0);
+    interp_claim_lane(interp0, 1);
+    interp_set_config(interp0, 0, &state);
+    interp_set_config(interp0, 1, &blue);
+    interp_set_base(interp0, 0, 0);
+    interp_set_base(interp0, 1, 0);
+    interp_set_base(interp0, 2, (uint32_t)(uintptr_t)g_capture_effect_lut.b);
+}
+
+static inline uint16_t mvs_capture_effect_convert(uint32_t raw)
+{
+    interp_set_accumulator(interp0, 0, raw);
+    interp_set_accumulator(interp1, 0, raw);
+    return (uint16_t)(capture_interp_load16(interp_peek_lane_result(interp1, 0)) |
+                      capture_interp_load16(interp_peek_full_result(interp0)));
+}
+#else
 static inline uint16_t mvs_capture_effect_convert(uint32_t raw)
 {
     return mvs_effect_lut_lookup_raw(&g_capture_effect_lut, raw);
 }
 #endif
+#endif
 #else
 // 32K LUT: corrected RGB555 -> RGB565 (DARK/SHADOW disabled build).
 #if NEOPICO_MVS_COLOR_MODEL_MENU
@@ -286,6 +574,36 @@ static void generate_color_correct_lut(void)
 }
 #endif
 
+// A packed capture halfword ([DARK][RGB555], mvs_pixel_capture_packed16) back
+// in its one-pixel capture word's bit positions, with the line's SHADOW level.
+// CSYNC and PCLK read as 0; no conversion looks at them.
+static inline uint32_t mvs_packed_raw(uint32_t half, uint32_t line_shadow)
+{
+    return ((half & 0x7FFFU) << 2U) | ((line_shadow & 1U) << 17U) | (((half >> 15U) & 1U) << 18U);
+}
+
+// A packed line's reductions in one-pixel word positions, from the OR of its
+// words. Packed words carry no CSYNC/PCLK, so `all` reports nothing missing.
+static inline capture_line_bits_t mvs_packed_line_bits(uint32_t any_pair, uint32_t hash)
+{
+    const capture_line_bits_t bits = {
+        .all = ~0U,
+        .any = mvs_packed_raw(any_pair & 0xFFFFU, 0U) | mvs_packed_raw(any_pair >> 16U, 0U),
+        .hash = hash,
+    };
+    return bits;
+}
+
+#if NEOPICO_EXP_MVS_PACKED_CAPTURE
+// SHADOW is screen-wide, so packed capture reads its pin once per line, when
+// Core 0 converts the line, instead of sampling it with every pixel. With the
+// line DMA chain that can be a few lines after the pixels were captured.
+static inline uint32_t capture_line_shadow(void)
+{
+    return gpio_get(PIN_MVS_SHADOW) ? 1U : 0U;
+}
+#endif
+
 #if ENABLE_DARK_SHADOW
 static inline uint16_t convert_pixel(uint32_t raw)
 {
@@ -296,36 +614,43 @@ static inline uint16_t convert_pixel(uint32_t raw)
 static uint32_t g_capture_line_shadow;
 #endif
 
-static inline void convert_active_pixels(uint16_t *dst, const uint32_t *src, int count)
+static inline capture_line_bits_t convert_active_pixels(uint16_t *dst, const uint32_t *src, int count)
 {
+    capture_line_bits_t bits = {~0U, 0U, CAPTURE_HASH_SEED};
 #if NEOPICO_EXP_RGB888_SCANOUT
     // RGB888 scanout: the ring carries raw entropy (DARK + raw RGB555) and the
     // colour model is applied on Core 1 at scale time, where 8-bit channels can
     // hold the DARK half-step that RGB565 red/blue cannot. SHADOW is recorded
-    // once per line. Reuses the OR that the effect fast path already needs, so
-    // tracking it costs one extra shift per line.
-    uint32_t shadow_accum = 0;
+    // once per line from the line's OR, so tracking it costs one extra shift
+    // per line.
+    uint32_t line_or = 0;
     int remaining = count;
     while (remaining >= 4) {
         const uint32_t raw0 = src[0];
         const uint32_t raw1 = src[1];
         const uint32_t raw2 = src[2];
         const uint32_t raw3 = src[3];
-        shadow_accum |= raw0 | raw1 | raw2 | raw3;
-        dst[0] = mvs_entropy_pack_raw(raw0);
-        dst[1] = mvs_entropy_pack_raw(raw1);
-        dst[2] = mvs_entropy_pack_raw(raw2);
-        dst[3] = mvs_entropy_pack_raw(raw3);
+        capture_line_fold_all(&bits, raw0 & raw1 & raw2 & raw3);
+        line_or |= raw0 | raw1 | raw2 | raw3;
+        const uint32_t pair01 = (uint32_t)mvs_entropy_pack_raw(raw0) | ((uint32_t)mvs_entropy_pack_raw(raw1) << 16U);
+        const uint32_t pair23 = (uint32_t)mvs_entropy_pack_raw(raw2) | ((uint32_t)mvs_entropy_pack_raw(raw3) << 16U);
+        __builtin_memcpy(dst, &pair01, sizeof pair01);
+        __builtin_memcpy(dst + 2, &pair23, sizeof pair23);
+        bits.hash = capture_line_hash_step(capture_line_hash_step(bits.hash, pair01), pair23);
         dst += 4;
         src += 4;
         remaining -= 4;
     }
+    const int tail = remaining;
     while (remaining-- > 0) {
         const uint32_t raw = *src++;
-        shadow_accum |= raw;
+        capture_line_fold_all(&bits, raw);
+        line_or |= raw;
         *dst++ = mvs_entropy_pack_raw(raw);
     }
-    g_capture_line_shadow = (shadow_accum >> 17U) & 1U;
+    bits.hash = capture_line_hash_pixels(bits.hash, dst - tail, tail);
+    capture_line_fold_any(&bits, line_or);
+    g_capture_line_shadow = (line_or >> 17U) & 1U;
 #elif NEOPICO_MVS_DIGITAL_EFFECT_PROCESSING
     int remaining = count;
     while (remaining >= 4) {
@@ -337,8 +662,11 @@ static inline void convert_active_pixels(uint16_t *dst, const uint32_t *src, int
         uint16_t pixel1;
         uint16_t pixel2;
         uint16_t pixel3;
+        const uint32_t any4 = raw0 | raw1 | raw2 | raw3;
+        capture_line_fold_all(&bits, raw0 & raw1 & raw2 & raw3);
+        capture_line_fold_any(&bits, any4);
 
-        if (((raw0 | raw1 | raw2 | raw3) & MVS_DIGITAL_EFFECT_RAW_MASK) == 0U) {
+        if ((any4 & MVS_DIGITAL_EFFECT_RAW_MASK) == 0U) {
             pixel0 = mvs_digital_effect_normal_rgb565_raw(raw0);
             pixel1 = mvs_digital_effect_normal_rgb565_raw(raw1);
             pixel2 = mvs_digital_effect_normal_rgb565_raw(raw2);
@@ -354,28 +682,73 @@ static inline void convert_active_pixels(uint16_t *dst, const uint32_t *src, int
         const uint32_t pair23 = (uint32_t)pixel2 | ((uint32_t)pixel3 << 16U);
         __builtin_memcpy(dst, &pair01, sizeof pair01);
         __builtin_memcpy(dst + 2, &pair23, sizeof pair23);
+        bits.hash = capture_line_hash_step(capture_line_hash_step(bits.hash, pair01), pair23);
         dst += 4;
         src += 4;
         remaining -= 4;
     }
+    const int tail = remaining;
     while (remaining-- > 0) {
-        *dst++ = mvs_digital_effect_rgb565_raw(*src++);
+        const uint32_t raw = *src++;
+        capture_line_fold_all(&bits, raw);
+        capture_line_fold_any(&bits, raw);
+        *dst++ = mvs_digital_effect_rgb565_raw(raw);
     }
+    bits.hash = capture_line_hash_pixels(bits.hash, dst - tail, tail);
 #else
     int remaining = count;
     while (remaining >= 4) {
+        capture_line_fold_all(&bits, src[0] & src[1] & src[2] & src[3]);
+        capture_line_fold_any(&bits, src[0] | src[1] | src[2] | src[3]);
         dst[0] = mvs_capture_effect_convert(src[0]);
         dst[1] = mvs_capture_effect_convert(src[1]);
         dst[2] = mvs_capture_effect_convert(src[2]);
         dst[3] = mvs_capture_effect_convert(src[3]);
+        bits.hash = capture_line_hash_pixels(bits.hash, dst, 4);
         dst += 4;
         src += 4;
         remaining -= 4;
     }
+    const int tail = remaining;
     while (remaining-- > 0) {
-        *dst++ = mvs_capture_effect_convert(*src++);
+        const uint32_t raw = *src++;
+        capture_line_fold_all(&bits, raw);
+        capture_line_fold_any(&bits, raw);
+        *dst++ = mvs_capture_effect_convert(raw);
     }
+    bits.hash = capture_line_hash_pixels(bits.hash, dst - tail, tail);
 #endif
+    return bits;
+}
+
+// Packed capture words, two pixels each; `pairs` words.
+static inline capture_line_bits_t convert_active_pixels_packed(uint16_t *dst, const uint32_t *src, int pairs,
+                                                               uint32_t line_shadow)
+{
+    uint32_t any_pair = 0;
+    uint32_t hash = CAPTURE_HASH_SEED;
+#if NEOPICO_EXP_RGB888_SCANOUT
+    // The packed halfword already is the ring's entropy format.
+    for (int i = 0; i < pairs; i++) {
+        const uint32_t pair = src[i];
+        any_pair = capture_line_or(any_pair, pair);
+        __builtin_memcpy(dst + (2 * i), &pair, sizeof pair);
+        hash = capture_line_hash_step(hash, pair);
+    }
+    g_capture_line_shadow = line_shadow & 1U;
+#else
+    for (int i = 0; i < pairs; i++) {
+        const uint32_t pair = src[i];
+        any_pair = capture_line_or(any_pair, pair);
+        const uint16_t pixel0 = mvs_capture_effect_convert(mvs_packed_raw(pair & 0xFFFFU, line_shadow));
+        const uint16_t pixel1 = mvs_capture_effect_convert(mvs_packed_raw(pair >> 16U, line_shadow));
+        dst[0] = pixel0;
+        dst[1] = pixel1;
+        hash = capture_line_hash_step(hash, (uint32_t)pixel0 | ((uint32_t)pixel1 << 16U));
+        dst += 2;
+    }
+#endif
+    return mvs_packed_line_bits(any_pair, hash);
 }
 #elif NEOPICO_MVS_COLOR_MODEL_MENU
 static inline uint16_t convert_pixel(const uint16_t *color_lut, uint32_t raw)
@@ -387,11 +760,53 @@ static inline uint16_t convert_pixel(const uint16_t *color_lut, uint32_t raw)
     return color_lut[color15];
 }
 
-static inline void convert_active_pixels(uint16_t *dst, const uint32_t *src, int count, const uint16_t *color_lut)
+static inline capture_line_bits_t convert_active_pixels(uint16_t *dst, const uint32_t *src, int count,
+                                             const uint16_t *color_lut)
 {
-    for (int i = 0; i < count; i++) {
+#if NEOPICO_EXP_INTERP_LUT
+    capture_interp_lut15_set_table(color_lut);
+    return capture_interp_lut15_convert(dst, src, count);
+#else
+    capture_line_bits_t bits = {~0U, 0U, CAPTURE_HASH_SEED};
+    int i = 0;
+    for (; i + 1 < count; i += 2) {
+        const uint32_t raw0 = src[i];
+        const uint32_t raw1 = src[i + 1];
+        capture_line_fold_all(&bits, raw0 & raw1);
+        capture_line_fold_any(&bits, raw0 | raw1);
+        const uint16_t pixel0 = convert_pixel(color_lut, raw0);
+        const uint16_t pixel1 = convert_pixel(color_lut, raw1);
+        dst[i] = pixel0;
+        dst[i + 1] = pixel1;
+        bits.hash = capture_line_hash_step(bits.hash, (uint32_t)pixel0 | ((uint32_t)pixel1 << 16U));
+    }
+    if (i < count) {
+        capture_line_fold_all(&bits, src[i]);
+        capture_line_fold_any(&bits, src[i]);
         dst[i] = convert_pixel(color_lut, src[i]);
+        bits.hash = capture_line_hash_step(bits.hash, dst[i]);
     }
+    return bits;
+#endif
+}
+
+// Packed capture words, two pixels each; `pairs` words.
+static inline capture_line_bits_t convert_active_pixels_packed(uint16_t *dst, const uint32_t *src, int pairs,
+                                                               const uint16_t *color_lut)
+{
+    uint32_t any_pair = 0;
+    uint32_t hash = CAPTURE_HASH_SEED;
+    for (int i = 0; i < pairs; i++) {
+        const uint32_t pair = src[i];
+        any_pair = capture_line_or(any_pair, pair);
+        const uint16_t pixel0 = convert_pixel(color_lut, mvs_packed_raw(pair & 0xFFFFU, 0U));
+        const uint16_t pixel1 = convert_pixel(color_lut, mvs_packed_raw(pair >> 16U, 0U));
+        dst[0] = pixel0;
+        dst[1] = pixel1;
+        hash = capture_line_hash_step(hash, (uint32_t)pixel0 | ((uint32_t)pixel1 << 16U));
+        dst += 2;
+    }
+    return mvs_packed_line_bits(any_pair, hash);
 }
 #else
 static inline uint16_t convert_pixel(uint32_t raw)
@@ -403,11 +818,68 @@ static inline uint16_t convert_pixel(uint32_t raw)
     return g_color_correct_lut[color15];
 }
 
-static inline void convert_active_pixels(uint16_t *dst, const uint32_t *src, int count)
+static inline capture_line_bits_t convert_active_pixels(uint16_t *dst, const uint32_t *src, int count)
 {
-    for (int i = 0; i < count; i++) {
+#if NEOPICO_EXP_INTERP_LUT
+    return capture_interp_lut15_convert(dst, src, count);
+#else
+    capture_line_bits_t bits = {~0U, 0U, CAPTURE_HASH_SEED};
+    int i = 0;
+    for (; i + 1 < count; i += 2) {
+        const uint32_t raw0 = src[i];
+        const uint32_t raw1 = src[i + 1];
+        capture_line_fold_all(&bits, raw0 & raw1);
+        capture_line_fold_any(&bits, raw0 | raw1);
+        const uint16_t pixel0 = convert_pixel(raw0);
+        const uint16_t pixel1 = convert_pixel(raw1);
+        dst[i] = pixel0;
+        dst[i + 1] = pixel1;
+        bits.hash = capture_line_hash_step(bits.hash, (uint32_t)pixel0 | ((uint32_t)pixel1 << 16U));
+    }
+    if (i < count) {
+        capture_line_fold_all(&bits, src[i]);
+        capture_line_fold_any(&bits, src[i]);
         dst[i] = convert_pixel(src[i]);
+        bits.hash = capture_line_hash_step(bits.hash, dst[i]);
+    }
+    return bits;
+#endif
+}
+
+// Packed capture words, two pixels each; `pairs` words.
+static inline capture_line_bits_t convert_active_pixels_packed(uint16_t *dst, const uint32_t *src, int pairs,
+                                                               uint32_t line_shadow)
+{
+    uint32_t any_pair = 0;
+    uint32_t hash = CAPTURE_HASH_SEED;
+    for (int i = 0; i < pairs; i++) {
+        const uint32_t pair = src[i];
+        any_pair = capture_line_or(any_pair, pair);
+        const uint16_t pixel0 = convert_pixel(mvs_packed_raw(pair & 0xFFFFU, line_shadow));
+        const uint16_t pixel1 = convert_pixel(mvs_packed_raw(pair >> 16U, line_shadow));
+        dst[0] = pixel0;
+        dst[1] = pixel1;
+        hash = capture_line_hash_step(hash, (uint32_t)pixel0 | ((uint32_t)pixel1 << 16U));
+        dst += 2;
     }
+    return mvs_packed_line_bits(any_pair, hash);
+}
+#endif
+
+#if NEOPICO_EXP_INTERP_LUT
+// Point Core 0's interpolators at this build's capture LUT. The RGB888 entropy
+// pack and the register-only effect path use no LUT. Packed capture words
+// index the 32K tables in software: their low pixel would need a left shift.
+static void capture_interp_prepare(void)
+{
+#if !ENABLE_DARK_SHADOW
+    capture_interp_lut15_init();
+#if !NEOPICO_MVS_COLOR_MODEL_MENU
+    capture_interp_lut15_set_table(g_color_correct_lut);
+#endif
+#elif !NEOPICO_MVS_DIGITAL_EFFECT_PROCESSING && !NEOPICO_EXP_RGB888_SCANOUT
+    capture_interp_effect_init();
+#endif
 }
 #endif
 
@@ -422,7 +894,8 @@ static inline void drain_sync_fifo(PIO pio, uint sm)
     }
 }
 
-// Runs in IRQ context: one word per line from sync PIO; detect vsync (long pulse after 8 short) and release semaphore
+// Runs in IRQ context: one word per line from sync PIO; the decoder finds the
+// frame start and the handler releases the semaphore for it
 static void sync_irq_handler(void)
 {
     pio_interrupt_clear(g_pio_mvs, MVS_SYNC_IRQ_INDEX);
@@ -430,35 +903,332 @@ static void sync_irq_handler(void)
         return;
 
     uint32_t h_ctr = pio_sm_get(g_pio_mvs, g_sm_sync);
-    bool is_short_pulse = (h_ctr <= H_THRESHOLD);
-
-    static uint32_t equ_count = 0;
-    static bool in_vsync = false;
 
     if (g_sync_decoder_reset_requested) {
-        equ_count = 0;
-        in_vsync = false;
+        mvs_sync_decoder_restart(&g_sync_decoder);
         g_sync_decoder_reset_requested = false;
     }
 
-    if (!in_vsync) {
-        if (is_short_pulse) {
-            equ_count++;
-        } else {
-            if (equ_count >= 8)
-                in_vsync = true;
-            equ_count = 0;
+    if (mvs_sync_decoder_push(&g_sync_decoder, h_ctr)) {
+        (void)video_standard_push(&g_standard, g_sync_decoder.frame_lines);
+        sem_release(&g_vsync_sem);
+    }
+}
+
+// =============================================================================
+// Line DMA Chain
+// =============================================================================
+
+// Lines of the frame the pixel DMA has finished. Each finished line chains the
+// control channel through one more descriptor, so its read address sits one
+// descriptor past the last finished line.
+static uint32_t capture_lines_done(void)
+{
+    const uint32_t read_addr = dma_channel_hw_addr(g_dma_ctrl_chan)->read_addr;
+    const uint32_t loaded = (read_addr - (uint32_t)(uintptr_t)g_line_dma_descriptors) / sizeof(uint32_t);
+    return loaded != 0U ? loaded - 1U : 0U;
+}
+
+// Stop the chain wherever it is. The pixel DMA is unchained while it is
+// aborted, since an abort can fire its CHAIN_TO trigger and load the next
+// descriptor.
+static void capture_dma_stop(void)
+{
+    dma_channel_config unchained = g_dma_config;
+    channel_config_set_chain_to(&unchained, g_dma_chan);
+    dma_channel_set_config(g_dma_chan, &unchained, false);
+    dma_channel_abort(g_dma_ctrl_chan);
+    dma_channel_abort(g_dma_chan);
+    dma_channel_set_config(g_dma_chan, &g_dma_config, false);
+}
+
+// Start the chain at the frame's first line: the control channel writes its
+// address into the pixel DMA's WRITE_ADDR trigger alias.
+static void capture_dma_start(void)
+{
+    dma_channel_set_read_addr(g_dma_ctrl_chan, g_line_dma_descriptors, true);
+}
+
+// =============================================================================
+// Slack Scheduler
+// =============================================================================
+
+// Core 0 converts a line in a fraction of the line period and spins on the
+// chain for the rest. NEOPICO_EXP_CAPTURE_SLACK_TASKS (default OFF, budgets
+// not measured on hardware) sleeps in WFE instead, woken by the pixel
+// channel's completion IRQ, and spends the gap on bounded background tasks.
+// A task starts only if its worst-case budget ends before the awaited line
+// finishes, so conversion never starts later than it would have after a spin.
+
+// One MVS line: NEO_H_TOTAL dots at 6 MHz.
+#define MVS_LINE_PERIOD_US 64U
+// No line completed for this long: the signal was lost mid-frame.
+#define MVS_LINE_STALL_US (8U * MVS_LINE_PERIOD_US)
+
+// Completion time (timer_hw->timerawl) of the pixel DMA's latest line, and
+// the frame's capture trigger before its first line completes.
+static volatile uint32_t g_line_done_us;
+
+// Zero unless the slack scheduler is built in.
+static video_capture_slack_stats_t g_slack_stats;
+
+#if NEOPICO_EXP_CAPTURE_SLACK_TASKS
+// A frame is 264 lines.
+#define MVS_V_TOTAL 264U
+// Kept free before every line deadline; covers the IRQ exit and loop overhead.
+#define MVS_SLACK_GUARD_US 4U
+// DMA_IRQ_0/1 are left to the HDMI output and the diagnostic firmwares.
+#define MVS_LINE_DMA_IRQ_INDEX 2U
+#define MVS_LINE_DMA_IRQ DMA_IRQ_2
+
+typedef struct {
+    void (*run)(void);
+    uint32_t budget_us;   // worst case; the task starts only if this fits
+    uint32_t interval_us; // minimum time between starts
+    uint32_t last_us;
+} capture_slack_task_t;
+
+#if NEOPICO_DIAG_COUNTERS || NEOPICO_DIAG_LINE_LATENCY || NEOPICO_EXP_SCANLINE_TRACE
+// Each tick rate-limits itself (1 Hz dumps, CDC-sized trace chunks).
+static void capture_slack_telemetry(void)
+{
+#if NEOPICO_DIAG_COUNTERS
+    video_capture_diag_tick(g_frame_count);
+#endif
+#if NEOPICO_DIAG_LINE_LATENCY
+    video_capture_latency_tick();
+#endif
+#if NEOPICO_EXP_SCANLINE_TRACE
+    scanline_trace_dump_tick();
+#endif
+}
+#endif
+
+// In priority order. Budgets are conservative estimates at the 252 MHz
+// 480p clock; a run that ends past its line's deadline counts as late.
+// Settings saves stay in the frame gap: a flash erase outlasts any line.
+// This build turns off stdio_usb's IRQ worker (src/CMakeLists.txt), so
+// tud_task() never nests with it: Core 0 is the only caller.
+static capture_slack_task_t g_slack_tasks[] = {
+    {tud_task, 20U, 500U, 0U},
+#if NEOPICO_DIAG_COUNTERS || NEOPICO_DIAG_LINE_LATENCY || NEOPICO_EXP_SCANLINE_TRACE
+    {capture_slack_telemetry, 40U, 1000U, 0U},
+#endif
+};
+#define MVS_SLACK_TASK_COUNT (sizeof(g_slack_tasks) / sizeof(g_slack_tasks[0]))
+
+static uint32_t g_frame_slack_us;
+static uint32_t g_frame_min_slack_us;
+
+static void __not_in_flash_func(line_dma_irq_handler)(void)
+{
+    dma_irqn_acknowledge_channel(MVS_LINE_DMA_IRQ_INDEX, (uint)g_dma_chan);
+    g_line_done_us = timer_hw->timerawl;
+}
+
+// Run the first due task whose budget ends `MVS_SLACK_GUARD_US` before
+// `deadline`. Returns whether one ran.
+static bool capture_slack_run_one(uint32_t now, uint32_t deadline)
+{
+    const int32_t slack = (int32_t)(deadline - now) - (int32_t)MVS_SLACK_GUARD_US;
+    for (uint32_t i = 0; i < MVS_SLACK_TASK_COUNT; i++) {
+        capture_slack_task_t *task = &g_slack_tasks[i];
+        if ((now - task->last_us) < task->interval_us || slack < (int32_t)task->budget_us) {
+            continue;
         }
-    } else {
-        if (is_short_pulse) {
-            equ_count++;
-        } else {
-            equ_count = 0;
-            in_vsync = false;
-            sem_release(&g_vsync_sem);
+        task->last_us = now;
+        task->run();
+        const uint32_t end = timer_hw->timerawl;
+        g_slack_stats.task_runs++;
+        g_slack_stats.task_us += end - now;
+        if ((int32_t)(end - deadline) > 0) {
+            g_slack_stats.late_tasks++;
+        }
+        return true;
+    }
+    return false;
+}
+
+// Wait until the pixel DMA has finished `capture_line`, running slack tasks
+// meanwhile. `*lines_done` is the last completed-line count seen and is
+// updated. The time from the call until the line is ready is the line's
+// slack. Returns false if no line completed for MVS_LINE_STALL_US: the
+// signal is gone and the line will not come.
+static bool capture_wait_line(uint32_t capture_line, uint32_t *lines_done)
+{
+    const uint32_t wait_start = timer_hw->timerawl;
+    uint32_t now = wait_start;
+    while (*lines_done <= capture_line) {
+        // The chain runs one line per period; a line not started yet ends
+        // one period later per line ahead of it.
+        const uint32_t deadline = g_line_done_us + (capture_line + 1U - *lines_done) * MVS_LINE_PERIOD_US;
+        // An IRQ between the poll and the WFE sets the event register, so
+        // the WFE cannot sleep through the line it is waiting for. A line
+        // past its deadline is polled for instead: with the signal gone no
+        // interrupt may come to end the WFE.
+        if (!capture_slack_run_one(now, deadline) && (int32_t)(deadline - now) > 0) {
+            __wfe();
+        }
+        *lines_done = capture_lines_done();
+        now = timer_hw->timerawl;
+        if (*lines_done <= capture_line && (int32_t)(now - g_line_done_us) > (int32_t)MVS_LINE_STALL_US) {
+            return false;
+        }
+    }
+
+    const uint32_t slack = now - wait_start;
+    g_frame_slack_us += slack;
+    if (slack < g_frame_min_slack_us) {
+        g_frame_min_slack_us = slack;
+    }
+    return true;
+}
+
+static void capture_slack_frame_start(void)
+{
+    g_line_done_us = timer_hw->timerawl;
+    g_frame_slack_us = 0;
+    g_frame_min_slack_us = UINT32_MAX;
+}
+
+// The lines after the last active one are slack too: anything still due runs
+// before the next VSYNC, so telemetry keeps its rate even when line gaps are
+// too short for it.
+static void capture_slack_frame_end(void)
+{
+    const uint32_t gap_lines = MVS_V_TOTAL - V_SKIP_LINES - g_mvs_height;
+    const uint32_t deadline = timer_hw->timerawl + gap_lines * MVS_LINE_PERIOD_US;
+    while (capture_slack_run_one(timer_hw->timerawl, deadline)) {
+    }
+
+    g_slack_stats.frames++;
+    g_slack_stats.frame_slack_us = g_frame_slack_us;
+    g_slack_stats.min_line_slack_us = g_frame_min_slack_us;
+}
+
+static void capture_slack_init(void)
+{
+    dma_irqn_set_channel_enabled(MVS_LINE_DMA_IRQ_INDEX, (uint)g_dma_chan, true);
+    irq_set_exclusive_handler(MVS_LINE_DMA_IRQ, line_dma_irq_handler);
+    irq_set_enabled(MVS_LINE_DMA_IRQ, true);
+}
+#else
+// Spin on the chain's completed-line count. Returns false if it has not moved
+// for MVS_LINE_STALL_US: the signal is gone and the line will not come.
+static bool capture_wait_line(uint32_t capture_line, uint32_t *lines_done)
+{
+    while (*lines_done <= capture_line) {
+        const uint32_t done = capture_lines_done();
+        const uint32_t now = timer_hw->timerawl;
+        if (done != *lines_done) {
+            *lines_done = done;
+            g_line_done_us = now;
+        } else if ((int32_t)(now - g_line_done_us) > (int32_t)MVS_LINE_STALL_US) {
+            return false;
         }
     }
+    return true;
+}
+
+static void capture_slack_frame_start(void)
+{
+    g_line_done_us = timer_hw->timerawl;
+}
+
+// Telemetry runs once per frame in the vertical gap, as in the SNES capture
+// loop. USB is stdio_usb's: its low-priority IRQ worker services it.
+static void capture_slack_frame_end(void)
+{
+#if NEOPICO_DIAG_COUNTERS
+    video_capture_diag_tick(g_frame_count);
+#endif
+#if NEOPICO_DIAG_LINE_LATENCY
+    video_capture_latency_tick();
+#endif
+#if NEOPICO_EXP_SCANLINE_TRACE
+    scanline_trace_dump_tick();
+#endif
+}
+
+static void capture_slack_init(void)
+{
+}
+#endif
+
+// =============================================================================
+// Line Integrity
+// =============================================================================
+// Every 19-bit capture word holds CSYNC and PCLK as the pixel SM sampled them
+// with the pixel. PCLK must still be high at the sample point, two SM cycles
+// after the rising edge the SM waited for, and CSYNC must stay high across the
+// active window. The conversion ANDs each line's words together, so a single
+// word missing either bit flags the line. Packed capture drops both bits, so
+// its lines are not checked. Built in with NEOPICO_EXP_LINE_INTEGRITY: the
+// AND costs the conversion loop an instruction per pixel pair.
+
+#define MVS_LINE_CSYNC_BIT (1U << 0)
+#define MVS_LINE_PCLK_BIT (1U << 1)
+
+static uint8_t g_line_flags[NEO_V_ACTIVE];   // last frame, VIDEO_CAPTURE_LINE_*
+static uint32_t g_line_errors[NEO_V_ACTIVE]; // frames that flagged each line
+static video_capture_line_stats_t g_line_stats;
+
+#if NEOPICO_EXP_LINE_INTEGRITY
+static uint32_t g_frame_flagged_lines;
+
+static inline void capture_line_check(uint16_t line, uint32_t line_bits)
+{
+    uint8_t flags = 0;
+    if ((line_bits & MVS_LINE_PCLK_BIT) == 0U) {
+        flags |= VIDEO_CAPTURE_LINE_PCLK_LOW;
+        g_line_stats.pclk_lines++;
+    }
+    if ((line_bits & MVS_LINE_CSYNC_BIT) == 0U) {
+        flags |= VIDEO_CAPTURE_LINE_CSYNC_LOW;
+        g_line_stats.csync_lines++;
+    }
+    g_line_flags[line] = flags;
+    if (flags != 0U) {
+        g_line_errors[line]++;
+        g_frame_flagged_lines++;
+    }
+}
+
+static void capture_line_frame_start(void)
+{
+    g_frame_flagged_lines = 0;
+}
+
+static void capture_line_frame_end(void)
+{
+    g_line_stats.frames++;
+    g_line_stats.frame_flagged = g_frame_flagged_lines;
 }
+#endif
+
+// =============================================================================
+// Content Bounds
+// =============================================================================
+// Lines whose raw OR shows colour are scanned for the picture's edges
+// (content_bounds.h); the scan reads the converted ring line. Built in with
+// NEOPICO_EXP_CONTENT_BOUNDS; otherwise the full frame stays published.
+
+#if NEOPICO_EXP_RGB888_SCANOUT
+#define MVS_RING_COLOR_MASK 0x7FFFU // entropy halfword: DARK on black is black
+#else
+#define MVS_RING_COLOR_MASK 0xFFFFU
+#endif
+
+static content_bounds_tracker_t g_content_bounds;
+
+// =============================================================================
+// Frame Hash
+// =============================================================================
+// The conversion hashes each ring line as it stores it (capture_line.h); a
+// complete frame folds its line hashes and is published with its frame number.
+// Built in with NEOPICO_EXP_FRAME_HASH.
+
+static capture_frame_hash_t g_frame_hash;
 
 // =============================================================================
 // Hardware Reset
@@ -489,8 +1259,8 @@ static void video_capture_reset_hardware(void)
     pio_sm_set_enabled(g_pio_mvs, g_sm_sync, true);
     pio_sm_set_enabled(g_pio_mvs, g_sm_pixel, true);
 
-    // 4. Re-feed the pixel count to the Pixel SM
-    pio_sm_put_blocking(g_pio_mvs, g_sm_pixel, NEO_H_TOTAL - 1);
+    // 4. Re-feed the active window to the Pixel SM
+    pio_sm_put_blocking(g_pio_mvs, g_sm_pixel, requested_h_window());
 
     // 5. Clear any pending trigger IRQ and sync data-ready IRQ
     pio_interrupt_clear(g_pio_mvs, 4);
@@ -509,24 +1279,151 @@ static void video_capture_resync_after_settings_save(void)
     irq_set_enabled(PIO1_IRQ_0, true);
 }
 
+// =============================================================================
+// Relock
+// =============================================================================
+
+// Signal loss is noticed by a vsync wait that times out or a frame whose
+// lines stop arriving. Recovery is tiered:
+// 1. Fast relock: the sync decoder is restarted so the first interval the
+//    source sends is taken, the PIO keeps running, and the ring keeps the
+//    last complete frame. Each wait lasts a little over one frame period.
+// 2. After MVS_RELOCK_FAST_TRIES such waits the capture hardware is reset,
+//    and again every MVS_NO_SIGNAL_TIMEOUT_MS while the signal stays away.
+// Audio is re-armed at the relock only if the I2S DMA stood still between
+// two checks during the loss. A source that kept its audio clock running
+// needs no re-arm, and skipping it avoids the muted re-warm.
+
+// Longer than a 50 Hz frame, so a locked source never trips it.
+#define MVS_RELOCK_TIMEOUT_MS 25
+#define MVS_RELOCK_FAST_TRIES 4
+
+typedef struct {
+    bool lost;
+    uint32_t misses;      // vsync waits timed out in this loss
+    uint32_t lost_us;     // when the loss was noticed
+    uint32_t audio_mark;  // I2S DMA position at the last check
+    bool audio_stopped;   // it stood still between two checks
+    uint16_t cut_line;    // lines of a cut frame still to complete, 0 if none
+} capture_relock_t;
+
+static capture_relock_t g_relock;
+static video_capture_relock_stats_t g_relock_stats;
+
+static void capture_relock_check_audio(void)
+{
+    const uint32_t position = audio_subsystem_capture_position();
+    if (position == g_relock.audio_mark) {
+        g_relock.audio_stopped = true;
+    }
+    g_relock.audio_mark = position;
+}
+
+static void capture_relock_begin(void)
+{
+    if (g_relock.lost) {
+        return;
+    }
+    g_relock.lost = true;
+    g_relock.misses = 0;
+    g_relock.lost_us = timer_hw->timerawl;
+    g_relock.audio_mark = audio_subsystem_capture_position();
+    g_relock.audio_stopped = false;
+    // The raster may come back at any line: take its first vsync without
+    // the frame-length check.
+    g_sync_decoder_reset_requested = true;
+    g_relock_stats.losses++;
+}
+
+// Finish the cut frame once Core 1 has left the frame the copies land on;
+// it moves on at its next output VSYNC.
+static void capture_relock_complete_cut_frame(void)
+{
+    if (g_relock.cut_line != 0U && line_ring_complete_from_previous(g_relock.cut_line, (uint16_t)g_mvs_height)) {
+        g_relock.cut_line = 0;
+    }
+}
+
+// The frame's lines stopped arriving. Stop the capture where it is and let
+// the ring finish the frame from the previous one.
+static void capture_relock_abort_frame(uint16_t line)
+{
+    capture_dma_stop();
+    pio_sm_set_enabled(g_pio_mvs, g_sm_pixel, false);
+    g_relock_stats.aborted_frames++;
+    capture_relock_begin();
+    g_relock.cut_line = line;
+    capture_relock_complete_cut_frame();
+}
+
+// A vsync wait timed out.
+static void capture_relock_miss(void)
+{
+    if (g_relock.lost) {
+        capture_relock_check_audio();
+    }
+    capture_relock_begin();
+    capture_relock_complete_cut_frame();
+    g_relock.misses++;
+    if (settings_service_pending_save()) {
+        video_capture_resync_after_settings_save();
+    } else if (g_relock.misses >= MVS_RELOCK_FAST_TRIES) {
+        video_capture_reset_hardware();
+        g_relock_stats.hardware_resets++;
+#if NEOPICO_DIAG_COUNTERS
+        g_line_ring_diag.sync_resets++;
+#endif
+    }
+}
+
+// A vsync arrived; ends the loss if there was one.
+static void capture_relock_end(void)
+{
+    if (!g_relock.lost) {
+        return;
+    }
+    capture_relock_check_audio();
+    // Last chance before the next frame replaces it.
+    capture_relock_complete_cut_frame();
+    g_relock.cut_line = 0;
+    g_relock.lost = false;
+    g_relock_stats.last_relock_us = timer_hw->timerawl - g_relock.lost_us;
+    if (g_relock.misses < MVS_RELOCK_FAST_TRIES) {
+        g_relock_stats.fast_relocks++;
+    }
+    if (g_relock.audio_stopped) {
+        audio_subsystem_request_rearm();
+        g_relock_stats.audio_rearms++;
+    }
+}
+
+static uint32_t capture_vsync_timeout_ms(void)
+{
+    return g_relock.misses >= MVS_RELOCK_FAST_TRIES ? MVS_NO_SIGNAL_TIMEOUT_MS : MVS_RELOCK_TIMEOUT_MS;
+}
+
 // =============================================================================
 // Public API
 // =============================================================================
 
 void video_capture_init(uint mvs_height)
 {
-    g_mvs_height = mvs_height;
+    // The line DMA descriptor table covers at most NEO_V_ACTIVE lines
+    g_mvs_height = mvs_height <= NEO_V_ACTIVE ? mvs_height : NEO_V_ACTIVE;
 
 #if ENABLE_DARK_SHADOW
     generate_capture_lut();
 #else
     generate_color_correct_lut();
 #endif
+#if NEOPICO_EXP_INTERP_LUT
+    capture_interp_prepare();
+#endif
 
-    // 19-bit capture: 1 pixel per word
-    g_skip_start_words = H_SKIP_START;
-    g_active_words = NEO_H_ACTIVE;
-    g_line_words = NEO_H_TOTAL;
+    // The pixel SM pushes only the active window. 19-bit capture: 1 pixel
+    // per word; packed capture: 2
+    g_active_words = NEO_H_ACTIVE / MVS_CAPTURE_PIXELS_PER_WORD;
+    g_line_words = MVS_CAPTURE_LINE_WORDS;
     g_capture_pio_clkdiv = (float)clock_get_hz(clk_sys) / (float)MVS_CAPTURE_PIO_TARGET_HZ;
     if (g_capture_pio_clkdiv < 1.0F) {
         g_capture_pio_clkdiv = 1.0F;
@@ -546,7 +1443,11 @@ void video_capture_init(uint mvs_height)
     // 2. Add programs
     pio_clear_instruction_memory(g_pio_mvs);
     g_offset_sync = pio_add_program(g_pio_mvs, &mvs_sync_4a_program);
+#if NEOPICO_EXP_MVS_PACKED_CAPTURE
+    g_offset_pixel = pio_add_program(g_pio_mvs, &mvs_pixel_capture_packed16_program);
+#else
     g_offset_pixel = pio_add_program(g_pio_mvs, &mvs_pixel_capture_dark19_program);
+#endif
 
     // 3. Claim SMs
     g_sm_sync = (uint)pio_claim_unused_sm(g_pio_mvs, true);
@@ -572,9 +1473,19 @@ void video_capture_init(uint mvs_height)
     g_pio_mvs->sm[g_sm_sync].execctrl = (g_pio_mvs->sm[g_sm_sync].execctrl & ~0x1f000000) | (pin_idx_sync << 24);
 
     // 6. Configure Pixel SM: IN_BASE = GP27 (pin index 11), capture GP27-45
+#if NEOPICO_EXP_MVS_PACKED_CAPTURE
+    // Both shift right: OSR hands the sample over low bits first, and the
+    // earlier pixel of each autopushed pair ends up in the low halfword.
+    pio_sm_config pc = mvs_pixel_capture_packed16_program_get_default_config(g_offset_pixel);
+    sm_config_set_clkdiv(&pc, g_capture_pio_clkdiv);
+    sm_config_set_out_shift(&pc, true, false, 32);
+    sm_config_set_in_shift(&pc, true, true, 32);
+#else
     pio_sm_config pc = mvs_pixel_capture_dark19_program_get_default_config(g_offset_pixel);
     sm_config_set_clkdiv(&pc, g_capture_pio_clkdiv);
+    sm_config_set_out_shift(&pc, true, false, 32); // window: skip in the low halfword
     sm_config_set_in_shift(&pc, false, true, MVS_CAPTURE_BITS);
+#endif
     pio_sm_init(g_pio_mvs, g_sm_pixel, g_offset_pixel, &pc);
 
     uint pin_idx_pixel = PIN_MVS_BASE - 16; // 11: first pin of capture window
@@ -586,18 +1497,52 @@ void video_capture_init(uint mvs_height)
     pio_sm_set_enabled(g_pio_mvs, g_sm_sync, true);
     pio_sm_set_enabled(g_pio_mvs, g_sm_pixel, true);
 
-    // 7a. Initialize Pixel SM with pixel count
-    pio_sm_put_blocking(g_pio_mvs, g_sm_pixel, NEO_H_TOTAL - 1);
+    // 7a. Initialize Pixel SM with the active window
+    pio_sm_put_blocking(g_pio_mvs, g_sm_pixel, requested_h_window());
 
-    // 8. Configure DMA for Async Pixel Capture
+    // 8. Configure DMA for Async Pixel Capture: the pixel channel moves one
+    // line per trigger and chains to the control channel, which copies the
+    // next line's address from g_line_dma_descriptors into the pixel
+    // channel's WRITE_ADDR trigger alias.
     g_dma_chan = dma_claim_unused_channel(true);
-    dma_channel_config dc = dma_channel_get_default_config(g_dma_chan);
-    channel_config_set_read_increment(&dc, false);
-    channel_config_set_write_increment(&dc, true);
-    channel_config_set_dreq(&dc, pio_get_dreq(g_pio_mvs, g_sm_pixel, false));
-    dma_channel_configure(g_dma_chan, &dc, g_line_buffers[0], &g_pio_mvs->rxf[g_sm_pixel], 0, false);
+    g_dma_ctrl_chan = dma_claim_unused_channel(true);
+    g_dma_config = dma_channel_get_default_config(g_dma_chan);
+    channel_config_set_read_increment(&g_dma_config, false);
+    channel_config_set_write_increment(&g_dma_config, true);
+    channel_config_set_dreq(&g_dma_config, pio_get_dreq(g_pio_mvs, g_sm_pixel, false));
+    channel_config_set_chain_to(&g_dma_config, g_dma_ctrl_chan);
+    dma_channel_configure(g_dma_chan, &g_dma_config, g_line_buffers[0], &g_pio_mvs->rxf[g_sm_pixel], g_line_words,
+                          false);
+
+    const uint32_t frame_lines = V_SKIP_LINES + g_mvs_height;
+    for (uint32_t i = 0; i < frame_lines; i++) {
+        g_line_dma_descriptors[i] = (uint32_t)(uintptr_t)g_line_buffers[i % MVS_CAPTURE_LINE_BUFFERS];
+    }
+    g_line_dma_descriptors[frame_lines] = 0U;
+
+    dma_channel_config cc = dma_channel_get_default_config(g_dma_ctrl_chan);
+    channel_config_set_read_increment(&cc, true);
+    channel_config_set_write_increment(&cc, false);
+    dma_channel_configure(g_dma_ctrl_chan, &cc, &dma_hw->ch[g_dma_chan].al2_write_addr_trig, g_line_dma_descriptors,
+                          1, false);
+
+    // 8a. Line IRQ: wakes the slack scheduler's WFE as each line finishes (when built in)
+    capture_slack_init();
 
     // 9. Sync IRQ: event-driven vsync (no polling). Sync SM raises IRQ 0 on every line push.
+    mvs_sync_decoder_init(&g_sync_decoder);
+    g_sync_decoder_reset_requested = false;
+    video_standard_init(&g_standard);
+    memset(&g_relock, 0, sizeof g_relock);
+    memset(&g_relock_stats, 0, sizeof g_relock_stats);
+    memset(g_line_flags, 0, sizeof g_line_flags);
+    memset(g_line_errors, 0, sizeof g_line_errors);
+    memset(&g_line_stats, 0, sizeof g_line_stats);
+#if NEOPICO_EXP_LINE_INTEGRITY
+    g_line_stats.frame_lines = g_mvs_height;
+#endif
+    content_bounds_init(&g_content_bounds, NEO_H_ACTIVE, (uint16_t)g_mvs_height);
+    memset(&g_frame_hash, 0, sizeof g_frame_hash);
     sem_init(&g_vsync_sem, 0, 2);
     pio_interrupt_clear(g_pio_mvs, MVS_SYNC_IRQ_INDEX);
     g_pio_mvs->inte0 |= (1U << MVS_SYNC_IRQ_INDEX);
@@ -611,7 +1556,6 @@ void video_capture_init(uint mvs_height)
 
 void video_capture_run(void)
 {
-    bool audio_rearm_on_next_signal = false;
 #if NEOPICO_MVS_COLOR_MODEL_MENU
     const uint16_t *frame_color_lut = g_color_correct_lut[MVS_COLOR_MODEL_DIGITAL];
 #endif
@@ -624,24 +1568,14 @@ void video_capture_run(void)
     while (1) {
         g_frame_count++;
 
-        if (!sem_acquire_timeout_ms(&g_vsync_sem, MVS_NO_SIGNAL_TIMEOUT_MS)) {
-#if NEOPICO_DIAG_COUNTERS
-            g_line_ring_diag.sync_resets++;
+        if (!sem_acquire_timeout_ms(&g_vsync_sem, capture_vsync_timeout_ms())) {
+            capture_relock_miss();
+#if NEOPICO_EXP_CAPTURE_SLACK_TASKS
+            tud_task(); // no line slack to run it in
 #endif
-            audio_rearm_on_next_signal = true;
-            if (settings_service_pending_save()) {
-                video_capture_resync_after_settings_save();
-            } else {
-                video_capture_reset_hardware();
-            }
-            tud_task();
             continue;
         }
-
-        if (audio_rearm_on_next_signal) {
-            audio_subsystem_request_rearm();
-            audio_rearm_on_next_signal = false;
-        }
+        capture_relock_end();
 
 #if NEOPICO_MVS_COLOR_MODEL_MENU
         // Read the cross-core request exactly once per frame. All active lines
@@ -658,85 +1592,105 @@ void video_capture_run(void)
 #endif
 
         // Signal VSYNC to Core 1
+#if NEOPICO_EXP_BEAM_RACE
+        line_ring_vsync_at(timer_hw->timerawl);
+#else
         line_ring_vsync();
+#endif
 
         drain_sync_fifo(g_pio_mvs, g_sm_sync);
 
-        // Reset Pixel Capture SM for frame alignment
+        // Reset Pixel Capture SM for frame alignment. It restarts at its PULL
+        // and takes this frame's active window from the TX FIFO.
         pio_sm_set_enabled(g_pio_mvs, g_sm_pixel, false);
         pio_sm_clear_fifos(g_pio_mvs, g_sm_pixel);
-        pio_sm_exec(g_pio_mvs, g_sm_pixel, pio_encode_jmp(g_offset_pixel + 2));
+        pio_sm_exec(g_pio_mvs, g_sm_pixel, pio_encode_jmp(g_offset_pixel));
         pio_sm_set_enabled(g_pio_mvs, g_sm_pixel, true);
+        pio_sm_put(g_pio_mvs, g_sm_pixel, requested_h_window());
 
-        // Prepare first DMA
-        dma_channel_set_trans_count(g_dma_chan, g_line_words, false);
-        dma_channel_set_write_addr(g_dma_chan, g_line_buffers[0], true);
+        // Re-arm the line chain at the frame's first line
+        capture_dma_stop();
+        capture_dma_start();
 
         // Trigger capture
         pio_interrupt_clear(g_pio_mvs, 4);
         pio_sm_exec(g_pio_mvs, g_sm_sync, pio_encode_irq_set(false, 4));
+        capture_slack_frame_start();
+#if NEOPICO_EXP_LINE_INTEGRITY
+        capture_line_frame_start();
+#endif
+#if NEOPICO_EXP_CONTENT_BOUNDS
+        content_bounds_frame_start(&g_content_bounds);
+#endif
 
-        // Skip V border lines
-        for (int skip = 0; skip < V_SKIP_LINES; skip++) {
-            dma_channel_wait_for_finish_blocking(g_dma_chan);
-            dma_channel_set_trans_count(g_dma_chan, g_line_words, false);
-            dma_channel_set_write_addr(g_dma_chan, g_line_buffers[0], true);
-        }
-
-        // Capture active lines into ring buffer
-        uint8_t buf_idx = 0;
-        for (uint16_t line = 0; line + 1 < g_mvs_height; line++) {
+        // Convert active lines into the ring buffer as the chain finishes
+        // them (running slack tasks while waiting, when built in). The V
+        // border lines land in the same buffers and are never read; lines
+        // that finished together are converted back to back.
+        uint32_t lines_done = 0;
+#if NEOPICO_EXP_FRAME_HASH
+        uint32_t frame_hash = CAPTURE_HASH_SEED;
+#endif
+        bool frame_complete = true;
+        for (uint16_t line = 0; line < g_mvs_height; line++) {
             uint16_t *dst = line_ring_write_ptr(line);
-
-            dma_channel_wait_for_finish_blocking(g_dma_chan);
-
-            // Start next DMA (ping-pong)
-            uint32_t *buf = g_line_buffers[buf_idx];
-            buf_idx ^= 1U;
-            dma_channel_set_trans_count(g_dma_chan, g_line_words, false);
-            dma_channel_set_write_addr(g_dma_chan, g_line_buffers[buf_idx], true);
+            const uint32_t capture_line = V_SKIP_LINES + line;
+            if (!capture_wait_line(capture_line, &lines_done)) {
+                capture_relock_abort_frame(line);
+                frame_complete = false;
+                break;
+            }
 
             // Convert pixels directly to ring buffer
-            uint32_t *src = buf + g_skip_start_words;
-#if NEOPICO_MVS_COLOR_MODEL_MENU
-            convert_active_pixels(dst, src, g_active_words, frame_color_lut);
+            uint32_t *src = g_line_buffers[capture_line % MVS_CAPTURE_LINE_BUFFERS];
+#if NEOPICO_EXP_MVS_PACKED_CAPTURE && NEOPICO_MVS_COLOR_MODEL_MENU
+            const capture_line_bits_t bits = convert_active_pixels_packed(dst, src, g_active_words, frame_color_lut);
+#elif NEOPICO_EXP_MVS_PACKED_CAPTURE
+            const capture_line_bits_t bits =
+                convert_active_pixels_packed(dst, src, g_active_words, capture_line_shadow());
+#elif NEOPICO_MVS_COLOR_MODEL_MENU
+            const capture_line_bits_t bits = convert_active_pixels(dst, src, g_active_words, frame_color_lut);
 #else
-            convert_active_pixels(dst, src, g_active_words);
+            const capture_line_bits_t bits = convert_active_pixels(dst, src, g_active_words);
+#endif
+            (void)bits; // each field is read only when its reduction is built in
+#if NEOPICO_EXP_LINE_INTEGRITY && !NEOPICO_EXP_MVS_PACKED_CAPTURE
+            capture_line_check(line, bits.all);
+#endif
+#if NEOPICO_EXP_CONTENT_BOUNDS
+            if ((bits.any & CAPTURE_RAW_COLOR_BITS) != 0U) {
+                content_bounds_line(&g_content_bounds, line, dst, MVS_RING_COLOR_MASK);
+            }
+#endif
+#if NEOPICO_EXP_FRAME_HASH
+            frame_hash = capture_hash_step(frame_hash, bits.hash);
 #endif
 #if NEOPICO_EXP_RGB888_SCANOUT
             line_ring_write_shadow(line, g_capture_line_shadow);
 #endif
+#if NEOPICO_DIAG_COUNTERS
+            if (capture_lines_done() >= capture_line + MVS_CAPTURE_LINE_BUFFERS) {
+                g_line_ring_diag.line_dma_lapped++;
+            }
+#endif
 
             // Signal line ready
             line_ring_commit(line + 1);
         }
-
-        // Last active line (no next DMA to schedule)
-        if (g_mvs_height > 0) {
-            uint16_t last_line = (uint16_t)(g_mvs_height - 1);
-            uint16_t *dst = line_ring_write_ptr(last_line);
-
-            dma_channel_wait_for_finish_blocking(g_dma_chan);
-
-            uint32_t *src = g_line_buffers[buf_idx] + g_skip_start_words;
-#if NEOPICO_MVS_COLOR_MODEL_MENU
-            convert_active_pixels(dst, src, g_active_words, frame_color_lut);
-#else
-            convert_active_pixels(dst, src, g_active_words);
-#endif
-#if NEOPICO_EXP_RGB888_SCANOUT
-            line_ring_write_shadow(last_line, g_capture_line_shadow);
-#endif
-
-            line_ring_commit(g_mvs_height);
+        if (!frame_complete) {
+            continue;
         }
-
-#if NEOPICO_DIAG_COUNTERS
-        video_capture_diag_tick(g_frame_count);
+        capture_slack_frame_end();
+#if NEOPICO_EXP_LINE_INTEGRITY
+        capture_line_frame_end();
 #endif
-#if NEOPICO_EXP_SCANLINE_TRACE
-        scanline_trace_dump_tick();
+#if NEOPICO_EXP_CONTENT_BOUNDS
+        (void)content_bounds_frame_end(&g_content_bounds);
+#endif
+#if NEOPICO_EXP_FRAME_HASH
+        capture_frame_hash_publish(&g_frame_hash, g_frame_count, frame_hash);
 #endif
+
         // Persist only after a complete input frame. This pauses capture for a
         // rare flash operation while Core 1 continues outputting the last frame.
         if (settings_service_pending_save()) {
@@ -749,3 +1703,61 @@ uint32_t video_capture_get_frame_count(void)
 {
     return g_frame_count;
 }
+
+void video_capture_get_slack_stats(video_capture_slack_stats_t *stats)
+{
+    *stats = g_slack_stats;
+}
+
+void video_capture_get_relock_stats(video_capture_relock_stats_t *stats)
+{
+    *stats = g_relock_stats;
+}
+
+void video_capture_get_line_stats(video_capture_line_stats_t *stats)
+{
+    *stats = g_line_stats;
+}
+
+uint32_t video_capture_get_content_bounds(content_bounds_t *bounds)
+{
+    return content_bounds_read(&g_content_bounds, bounds);
+}
+
+uint32_t video_capture_get_frame_hash(uint32_t *frame)
+{
+    return capture_frame_hash_read(&g_frame_hash, frame);
+}
+
+video_standard_t video_capture_get_standard(uint16_t *frame_lines)
+{
+    if (frame_lines != NULL) {
+        *frame_lines = g_standard.frame_lines;
+    }
+    return g_standard.standard;
+}
+
+uint8_t video_capture_get_line_flags(uint16_t line, uint32_t *errors)
+{
+    if (line >= NEO_V_ACTIVE) {
+        *errors = 0;
+        return 0;
+    }
+    *errors = g_line_errors[line];
+    return g_line_flags[line];
+}
+
+void video_capture_set_h_offset(int offset)
+{
+    if (offset < MVS_H_SKIP_MIN - H_SKIP_START) {
+        offset = MVS_H_SKIP_MIN - H_SKIP_START;
+    } else if (offset > MVS_H_SKIP_MAX - H_SKIP_START) {
+        offset = MVS_H_SKIP_MAX - H_SKIP_START;
+    }
+    __atomic_store_n(&g_requested_h_offset, (int32_t)offset, __ATOMIC_RELEASE);
+}
+
+int video_capture_get_h_offset(void)
+{
+    return (int)__atomic_load_n(&g_requested_h_offset, __ATOMIC_ACQUIRE);
+}
@@ -6,18 +6,21 @@
  */
 
 #include "pico/stdlib.h"
+#include "pico/sync.h"
 
 #include "hardware/clocks.h"
 #include "hardware/dma.h"
+#include "hardware/irq.h"
 #include "hardware/pio.h"
-#if NEOPICO_EXP_GENLOCK_DYNAMIC
 #include "hardware/timer.h"
-#endif
 
 #include <stdint.h>
 #include <string.h>
 
+#include "capture_interp.h"
+#include "capture_line.h"
 #include "capture_profile.h"
+#include "content_bounds.h"
 #include "line_ring.h"
 #include "pico.h"
 #include "settings.h"
@@ -30,10 +33,44 @@
 #define NEOPICO_SNES_CAPTURE_WARMUP_FRAMES 60
 #endif
 
+// Convert through the 64 KiB RGB565 table instead of in registers. Only the
+// benchmark builds it on its own (tests/CMakeLists.txt); the interpolator path
+// always needs the table.
+#ifndef NEOPICO_SNES_PIXEL_LUT
+#define NEOPICO_SNES_PIXEL_LUT 0
+#endif
+#define SNES_PIXEL_LUT (NEOPICO_SNES_PIXEL_LUT || NEOPICO_EXP_INTERP_LUT)
+
+// Sample each dot on both PCLK edges (snes_hard_sync_hires), so 512-dot hires
+// and pseudo-hires lines are seen; they are stored 2:1 averaged into the
+// 256-pixel active window.
+#ifndef NEOPICO_EXP_SNES_HIRES_CAPTURE
+#define NEOPICO_EXP_SNES_HIRES_CAPTURE 0
+#endif
+#if NEOPICO_EXP_SNES_HIRES_CAPTURE
+#define SNES_SAMPLES_PER_DOT 2
+#else
+#define SNES_SAMPLES_PER_DOT 1
+#endif
+#define SNES_LINE_SAMPLES (CAPTURE_ACTIVE_WIDTH * SNES_SAMPLES_PER_DOT)
+
 // SNES source timing.
 #define SNES_H_TOTAL 341
 #define SNES_CAPTURE_PIO_TARGET_HZ 126000000U
 
+// PIO IRQ index: the VBLANK SM raises this at each VBLANK falling edge.
+#define SNES_VBLANK_IRQ_INDEX 0
+// An edge taken later than this can no longer arm the pixel SM before line
+// 0's HBLANK rises (300 dots, ~56 us, after the edge); the frame is skipped.
+#define SNES_VBLANK_STALE_US 40U
+// No-signal timeout: Core 0 still services USB while no VBLANK arrives.
+#define SNES_NO_SIGNAL_TIMEOUT_MS 50U
+// Interlaced fields alternate one line longer and shorter; a step of half a
+// line (~32 us) between VBLANK periods tells them from clock jitter.
+#define SNES_FIELD_STEP_US 32
+// Alternating steps in a row before the source counts as interlaced.
+#define SNES_INTERLACE_FIELDS 4U
+
 // =============================================================================
 // State
 // =============================================================================
@@ -46,28 +83,59 @@ static uint g_offset_pixel = 0;
 static pio_sm_config g_pio_config;
 static float g_capture_pio_clkdiv = 1.0F;
 
+static uint g_sm_vblank = 0;
+static uint g_offset_vblank = 0;
+
+// Released by vblank_irq_handler() once per frame; holds at most one edge, so
+// a frame Core 0 was late for is left to the stale check.
+static semaphore_t g_vblank_sem;
+static volatile uint32_t g_vblank_edge_us = 0;
+static volatile uint32_t g_vblank_period_us = 0;
+
 static int g_dma_chan = -1;
-static uint32_t g_line_buffers[2][CAPTURE_ACTIVE_WIDTH];
+static uint32_t g_line_buffers[2][SNES_LINE_SAMPLES];
 static volatile uint32_t g_frame_count = 0;
 
+// Ring lines are RGB565; the borders either side of the 256 active pixels are
+// filled black, so the bounds come out in frame columns. Built in with
+// NEOPICO_EXP_CONTENT_BOUNDS; otherwise the full frame stays published.
+static content_bounds_tracker_t g_content_bounds;
+
+// Hash of the 256 converted pixels of each line, folded per frame
+// (capture_line.h); the black borders are left out. Built in with
+// NEOPICO_EXP_FRAME_HASH.
+static capture_frame_hash_t g_frame_hash;
+
+// Video mode seen by the capture (video_capture_get_snes_mode()), and the
+// field-length history interlace is detected from.
+static video_capture_snes_mode_t g_mode;
+static int32_t g_field_step_us = 0;
+static uint32_t g_field_alternations = 0;
+
+// 50/60 Hz from the VBLANK period in lines. A PAL line (1364 master clocks
+// at 21.281 MHz) is 1% longer than CAPTURE_LINE_NS, so a 312-line field
+// counts as about 315.
+static video_standard_detector_t g_standard;
+
 #if NEOPICO_EXP_GENLOCK_DYNAMIC
 volatile uint32_t g_mvs_vsync_timestamp = 0;
 #endif
 
 // =============================================================================
-// Pixel Conversion - RGB555 to RGB565 LUT
+// Pixel Conversion - RGB555 to RGB565
 // =============================================================================
 // SuperPico wiring maps MSB (R4/G4/B4) to the lower GPIO of each 5-bit group,
 // so each color channel is bit-reversed in the captured word.
 
-static inline uint32_t snes_reverse_5bit(uint32_t x)
+static inline uint16_t snes_pack_rgb565(uint32_t r5, uint32_t g5, uint32_t b5)
 {
-    return ((x & 1U) << 4) | ((x & 2U) << 2) | (x & 4U) | ((x & 8U) >> 2) | ((x & 16U) >> 4);
+    return (uint16_t)((r5 << 11) | (g5 << 6) | (g5 >> 4) | b5);
 }
 
-static inline uint16_t snes_pack_rgb565(uint32_t r5, uint32_t g5, uint32_t b5)
+#if SNES_PIXEL_LUT
+static inline uint32_t snes_reverse_5bit(uint32_t x)
 {
-    return (uint16_t)((r5 << 11) | (g5 << 6) | (g5 >> 4) | b5);
+    return ((x & 1U) << 4) | ((x & 2U) << 2) | (x & 4U) | ((x & 8U) >> 2) | ((x & 16U) >> 4);
 }
 
 static uint16_t g_pixel_lut[32768] __attribute__((aligned(4)));
@@ -82,29 +150,150 @@ static void generate_pixel_lut(void)
     }
 }
 
-static inline void fill_rgb565(uint16_t *dst, uint32_t count, uint16_t color)
+static inline uint16_t convert_pixel(uint32_t raw)
+{
+    return g_pixel_lut[(raw >> 2) & 0x7FFF];
+}
+#else
+static inline uint32_t snes_reverse32(uint32_t value)
+{
+#if defined(__arm__) || defined(__thumb__)
+    uint32_t reversed;
+    __asm__("rbit %0, %1" : "=r"(reversed) : "r"(value));
+    return reversed;
+#else
+    value = ((value >> 1U) & UINT32_C(0x55555555)) | ((value & UINT32_C(0x55555555)) << 1U);
+    value = ((value >> 2U) & UINT32_C(0x33333333)) | ((value & UINT32_C(0x33333333)) << 2U);
+    value = ((value >> 4U) & UINT32_C(0x0F0F0F0F)) | ((value & UINT32_C(0x0F0F0F0F)) << 4U);
+    value = ((value >> 8U) & UINT32_C(0x00FF00FF)) | ((value & UINT32_C(0x00FF00FF)) << 8U);
+    return (value >> 16U) | (value << 16U);
+#endif
+}
+
+// One RBIT puts all three channels back in bit order: raw bits 16:2 land at
+// 15:29 as R, G, B, each a field for a shift and mask. No table, so no 64 KiB
+// of SRAM and no per-pixel load competing with Core 1's scanout.
+static inline uint16_t convert_pixel(uint32_t raw)
+{
+    const uint32_t reversed = snes_reverse32(raw);
+    const uint32_t r5 = (reversed >> 15U) & 0x1FU;
+    const uint32_t g5 = (reversed >> 20U) & 0x1FU;
+    const uint32_t b5 = (reversed >> 25U) & 0x1FU;
+    return snes_pack_rgb565(r5, g5, b5);
+}
+#endif
+
+#if NEOPICO_EXP_SNES_HIRES_CAPTURE
+static inline uint16_t rgb565_average(uint16_t a, uint16_t b)
 {
-    for (uint32_t i = 0; i < count; i++) {
-        dst[i] = color;
+    return (uint16_t)((a & b) + (((a ^ b) & 0xF7DEU) >> 1));
+}
+
+// `count` dots of two samples each, as snes_hard_sync_hires pushes them. A
+// 256-dot line repeats each pixel and costs one conversion per dot; only dots
+// whose halves differ convert both and average them 2:1, so the store and
+// hash are the same either way. `hires` collects the colour bits that
+// differed: nonzero for a hires line.
+static inline capture_line_bits_t convert_hires_pixels(uint16_t *dst, const uint32_t *src, int count,
+                                                       uint32_t *hires)
+{
+    capture_line_bits_t bits = {~0U, 0U, CAPTURE_HASH_SEED};
+    uint32_t differ = 0;
+    int remaining = count;
+    while (remaining >= 2) {
+        capture_line_fold_any(&bits, src[0] | src[1] | src[2] | src[3]);
+        const uint32_t differ01 = (src[0] ^ src[1]) & CAPTURE_RAW_COLOR_BITS;
+        const uint32_t differ23 = (src[2] ^ src[3]) & CAPTURE_RAW_COLOR_BITS;
+        uint16_t pixel0 = convert_pixel(src[0]);
+        uint16_t pixel1 = convert_pixel(src[2]);
+        if ((differ01 | differ23) != 0U) {
+            differ |= differ01 | differ23;
+            pixel0 = rgb565_average(pixel0, convert_pixel(src[1]));
+            pixel1 = rgb565_average(pixel1, convert_pixel(src[3]));
+        }
+        const uint32_t pair = (uint32_t)pixel0 | ((uint32_t)pixel1 << 16);
+        __builtin_memcpy(dst, &pair, sizeof pair);
+        bits.hash = capture_line_hash_step(bits.hash, pair);
+        dst += 2;
+        src += 4;
+        remaining -= 2;
+    }
+    if (remaining > 0) {
+        capture_line_fold_any(&bits, src[0] | src[1]);
+        differ |= (src[0] ^ src[1]) & CAPTURE_RAW_COLOR_BITS;
+        *dst = rgb565_average(convert_pixel(src[0]), convert_pixel(src[1]));
+        bits.hash = capture_line_hash_pixels(bits.hash, dst, 1);
     }
+    *hires = differ;
+    return bits;
 }
+#endif
 
-static inline void convert_active_pixels(uint16_t *dst, const uint32_t *src, int count)
+// The OR of the raw words (a line without colour bits is black, when content
+// bounds are built in) and the hash of the converted pixels; `all` is not
+// tracked, SNES words carry no sync.
+static inline capture_line_bits_t convert_active_pixels(uint16_t *dst, const uint32_t *src, int count)
 {
-    const uint16_t *lut = g_pixel_lut;
+#if NEOPICO_EXP_INTERP_LUT
+    return capture_interp_lut15_convert(dst, src, count);
+#else
+    capture_line_bits_t bits = {~0U, 0U, CAPTURE_HASH_SEED};
     int remaining = count;
     while (remaining >= 4) {
-        dst[0] = lut[(src[0] >> 2) & 0x7FFF];
-        dst[1] = lut[(src[1] >> 2) & 0x7FFF];
-        dst[2] = lut[(src[2] >> 2) & 0x7FFF];
-        dst[3] = lut[(src[3] >> 2) & 0x7FFF];
+        capture_line_fold_any(&bits, src[0] | src[1] | src[2] | src[3]);
+        const uint32_t pair01 = (uint32_t)convert_pixel(src[0]) | ((uint32_t)convert_pixel(src[1]) << 16);
+        const uint32_t pair23 = (uint32_t)convert_pixel(src[2]) | ((uint32_t)convert_pixel(src[3]) << 16);
+        __builtin_memcpy(dst, &pair01, sizeof pair01);
+        __builtin_memcpy(dst + 2, &pair23, sizeof pair23);
+        bits.hash = capture_line_hash_step(capture_line_hash_step(bits.hash, pair01), pair23);
         dst += 4;
         src += 4;
         remaining -= 4;
     }
+    const int tail = remaining;
     while (remaining-- > 0) {
-        *dst++ = lut[(*src++ >> 2) & 0x7FFF];
+        capture_line_fold_any(&bits, *src);
+        *dst++ = convert_pixel(*src++);
     }
+    bits.hash = capture_line_hash_pixels(bits.hash, dst - tail, tail);
+    return bits;
+#endif
+}
+
+// =============================================================================
+// VBLANK Edge
+// =============================================================================
+
+// Runs in IRQ context: the timestamp is the edge's, not whenever Core 0 gets
+// round to the frame.
+static void vblank_irq_handler(void)
+{
+    const uint32_t now = timer_hw->timerawl;
+    g_vblank_period_us = now - g_vblank_edge_us;
+    g_vblank_edge_us = now;
+    pio_interrupt_clear(g_pio_snes, SNES_VBLANK_IRQ_INDEX);
+    sem_release(&g_vblank_sem);
+}
+
+// Interlace: fields that alternate long and short, one line apart. `period`
+// is the field that just ended, VBLANK edge to VBLANK edge. Only reported;
+// the capture and output treat every field as a progressive frame.
+static void update_field(uint32_t period_us)
+{
+    const int32_t step = (int32_t)(period_us - g_mode.field_us);
+    const bool alternates = (step >= SNES_FIELD_STEP_US && g_field_step_us <= -SNES_FIELD_STEP_US) ||
+                            (step <= -SNES_FIELD_STEP_US && g_field_step_us >= SNES_FIELD_STEP_US);
+    g_field_alternations = alternates ? g_field_alternations + 1U : 0U;
+    g_field_step_us = step;
+    g_mode.field_us = period_us;
+    g_mode.interlaced = g_field_alternations >= SNES_INTERLACE_FIELDS;
+    g_mode.field = (g_mode.interlaced && step > 0) ? 1U : 0U;
+}
+
+// Lines in a VBLANK period, to the nearest.
+static uint32_t period_lines(uint32_t period_us)
+{
+    return (uint32_t)((((uint64_t)period_us * 1000U) + (CAPTURE_LINE_NS / 2U)) / CAPTURE_LINE_NS);
 }
 
 // =============================================================================
@@ -125,6 +314,14 @@ static void video_capture_reset_hardware(void)
     pio_sm_put_blocking(g_pio_snes, g_sm_pixel, CAPTURE_ACTIVE_WIDTH - 1);
 }
 
+#if NEOPICO_EXP_SNES_HIRES_CAPTURE
+#define SNES_PIXEL_PROGRAM snes_hard_sync_hires_program
+#define snes_pixel_program_get_default_config snes_hard_sync_hires_program_get_default_config
+#else
+#define SNES_PIXEL_PROGRAM snes_hard_sync_program
+#define snes_pixel_program_get_default_config snes_hard_sync_program_get_default_config
+#endif
+
 // =============================================================================
 // Public API
 // =============================================================================
@@ -132,7 +329,19 @@ static void video_capture_reset_hardware(void)
 void video_capture_init(uint height)
 {
     g_snes_height = height;
+    content_bounds_init(&g_content_bounds, LINE_WIDTH, (uint16_t)height);
+    memset(&g_frame_hash, 0, sizeof g_frame_hash);
+    memset(&g_mode, 0, sizeof g_mode);
+    g_field_step_us = 0;
+    g_field_alternations = 0;
+    video_standard_init(&g_standard);
+#if SNES_PIXEL_LUT
     generate_pixel_lut();
+#endif
+#if NEOPICO_EXP_INTERP_LUT
+    capture_interp_lut15_init();
+    capture_interp_lut15_set_table(g_pixel_lut);
+#endif
     g_capture_pio_clkdiv = (float)clock_get_hz(clk_sys) / (float)SNES_CAPTURE_PIO_TARGET_HZ;
     if (g_capture_pio_clkdiv < 1.0F) {
         g_capture_pio_clkdiv = 1.0F;
@@ -144,7 +353,7 @@ void video_capture_init(uint height)
     pio_set_gpio_base(pio1, 0);
     *(volatile uint32_t *)((uintptr_t)g_pio_snes + 0x168) = 16;
 
-    g_offset_pixel = pio_add_program(g_pio_snes, &snes_hard_sync_program);
+    g_offset_pixel = pio_add_program(g_pio_snes, &SNES_PIXEL_PROGRAM);
     g_sm_pixel = (uint)pio_claim_unused_sm(g_pio_snes, true);
 
     for (uint pin = PIN_SNES_BASE; pin <= SNES_CAPTURE_PIN_LAST; pin++) {
@@ -154,7 +363,7 @@ void video_capture_init(uint height)
         gpio_set_input_hysteresis_enabled(pin, true);
     }
 
-    g_pio_config = snes_hard_sync_program_get_default_config(g_offset_pixel);
+    g_pio_config = snes_pixel_program_get_default_config(g_offset_pixel);
     sm_config_set_clkdiv(&g_pio_config, g_capture_pio_clkdiv);
     sm_config_set_in_shift(&g_pio_config, false, true, SNES_CAPTURE_BITS);
 
@@ -165,19 +374,46 @@ void video_capture_init(uint height)
     channel_config_set_read_increment(&dc, false);
     channel_config_set_write_increment(&dc, true);
     channel_config_set_dreq(&dc, pio_get_dreq(g_pio_snes, g_sm_pixel, false));
-    dma_channel_configure(g_dma_chan, &dc, g_line_buffers[0], &g_pio_snes->rxf[g_sm_pixel], CAPTURE_ACTIVE_WIDTH,
+    dma_channel_configure(g_dma_chan, &dc, g_line_buffers[0], &g_pio_snes->rxf[g_sm_pixel], SNES_LINE_SAMPLES,
                           false);
+
+    // VBLANK edge SM: free-running, raises SNES_VBLANK_IRQ_INDEX per frame.
+    g_offset_vblank = pio_add_program(g_pio_snes, &snes_vblank_program);
+    g_sm_vblank = (uint)pio_claim_unused_sm(g_pio_snes, true);
+    pio_sm_config vc = snes_vblank_program_get_default_config(g_offset_vblank);
+    sm_config_set_clkdiv(&vc, g_capture_pio_clkdiv);
+    pio_sm_init(g_pio_snes, g_sm_vblank, g_offset_vblank, &vc);
+    uint pin_idx = PIN_SNES_VBLANK - 16;
+    g_pio_snes->sm[g_sm_vblank].pinctrl = (g_pio_snes->sm[g_sm_vblank].pinctrl & ~0x000f8000U) | (pin_idx << 15);
+
+    g_vblank_edge_us = 0;
+    g_vblank_period_us = 0;
+    sem_init(&g_vblank_sem, 0, 1);
+    pio_interrupt_clear(g_pio_snes, SNES_VBLANK_IRQ_INDEX);
+    // INTE bits 11:8 are the SM IRQ flags (3:0 would be RX-not-empty).
+    g_pio_snes->inte0 |= (1U << (8U + SNES_VBLANK_IRQ_INDEX));
+    irq_set_exclusive_handler(PIO1_IRQ_0, vblank_irq_handler);
+    irq_set_enabled(PIO1_IRQ_0, true);
+    pio_sm_set_enabled(g_pio_snes, g_sm_vblank, true);
 }
 
 void video_capture_run(void)
 {
     while (1) {
-        // Detect VBLANK falling edge, which marks active frame start.
-        while (!gpio_get(PIN_SNES_VBLANK)) {
-            tight_loop_contents();
+        // VBLANK falling edge, which marks active frame start. Core 0 sleeps
+        // through the vertical blank until the VBLANK SM's IRQ instead of
+        // polling the pin.
+        if (!sem_acquire_timeout_ms(&g_vblank_sem, SNES_NO_SIGNAL_TIMEOUT_MS)) {
+            continue;
         }
-        while (gpio_get(PIN_SNES_VBLANK)) {
-            tight_loop_contents();
+        const uint32_t vblank_us = g_vblank_edge_us;
+        const uint32_t period_us = g_vblank_period_us;
+        update_field(period_us);
+        (void)video_standard_push(&g_standard, period_lines(period_us));
+        if ((uint32_t)(timer_hw->timerawl - vblank_us) > SNES_VBLANK_STALE_US) {
+            // Too late to catch line 0 (a settings save ran over the edge):
+            // wait for the next one.
+            continue;
         }
 
         g_frame_count++;
@@ -190,7 +426,7 @@ void video_capture_run(void)
 #endif
 
 #if NEOPICO_EXP_GENLOCK_DYNAMIC
-        g_mvs_vsync_timestamp = timer_hw->timerawl;
+        g_mvs_vsync_timestamp = vblank_us;
 #endif
 
         // Reset pixel capture SM for frame alignment.
@@ -199,15 +435,28 @@ void video_capture_run(void)
         pio_sm_exec(g_pio_snes, g_sm_pixel, pio_encode_jmp(g_offset_pixel + 2));
         pio_sm_set_enabled(g_pio_snes, g_sm_pixel, true);
 
-        dma_channel_set_trans_count(g_dma_chan, CAPTURE_ACTIVE_WIDTH, false);
+        dma_channel_set_trans_count(g_dma_chan, SNES_LINE_SAMPLES, false);
         dma_channel_set_write_addr(g_dma_chan, g_line_buffers[0], true);
 
+#if NEOPICO_EXP_BEAM_RACE
+        // The publish time, not the edge: the race slack counts the capture's
+        // lead to line 0 from here, as on MVS.
+        line_ring_vsync_at(timer_hw->timerawl);
+#else
         line_ring_vsync();
+#endif
 
         pio_interrupt_clear(g_pio_snes, 4);
         pio_sm_exec(g_pio_snes, g_sm_pixel, pio_encode_irq_set(false, 4));
 
+#if NEOPICO_EXP_CONTENT_BOUNDS
+        content_bounds_frame_start(&g_content_bounds);
+#endif
         uint8_t buf_idx = 0;
+#if NEOPICO_EXP_FRAME_HASH
+        uint32_t frame_hash = CAPTURE_HASH_SEED;
+#endif
+        uint16_t hires_lines = 0;
         for (uint16_t line = 0; line < g_snes_height; line++) {
             uint16_t *dst = line_ring_write_ptr(line);
 
@@ -217,31 +466,51 @@ void video_capture_run(void)
             buf_idx ^= 1U;
 
             if (line + 1 < g_snes_height) {
-                dma_channel_set_trans_count(g_dma_chan, CAPTURE_ACTIVE_WIDTH, false);
+                dma_channel_set_trans_count(g_dma_chan, SNES_LINE_SAMPLES, false);
                 dma_channel_set_write_addr(g_dma_chan, g_line_buffers[buf_idx], true);
             }
 
-            fill_rgb565(dst, CAPTURE_ACTIVE_X_OFFSET, 0x0000);
-            convert_active_pixels(dst + CAPTURE_ACTIVE_X_OFFSET, buf, CAPTURE_ACTIVE_WIDTH);
-            fill_rgb565(dst + CAPTURE_ACTIVE_X_OFFSET + CAPTURE_ACTIVE_WIDTH,
-                        LINE_WIDTH - CAPTURE_ACTIVE_X_OFFSET - CAPTURE_ACTIVE_WIDTH, 0x0000);
+            // Only the active window: line_ring_init() painted the border.
+#if NEOPICO_EXP_SNES_HIRES_CAPTURE
+            uint32_t hires;
+            const capture_line_bits_t bits = convert_hires_pixels(dst + LINE_ACTIVE_X, buf, LINE_ACTIVE_WIDTH, &hires);
+            hires_lines += hires != 0U ? 1U : 0U;
+#else
+            const capture_line_bits_t bits = convert_active_pixels(dst + LINE_ACTIVE_X, buf, LINE_ACTIVE_WIDTH);
+#endif
+            (void)bits; // each field is read only when its reduction is built in
+#if NEOPICO_EXP_CONTENT_BOUNDS
+            if ((bits.any & CAPTURE_RAW_COLOR_BITS) != 0U) {
+                content_bounds_line(&g_content_bounds, line, dst, 0xFFFFU);
+            }
+#endif
+#if NEOPICO_EXP_FRAME_HASH
+            frame_hash = capture_hash_step(frame_hash, bits.hash);
+#endif
 
             line_ring_commit(line + 1);
         }
+#if NEOPICO_EXP_CONTENT_BOUNDS
+        (void)content_bounds_frame_end(&g_content_bounds);
+#endif
+#if NEOPICO_EXP_FRAME_HASH
+        capture_frame_hash_publish(&g_frame_hash, g_frame_count, frame_hash);
+#endif
+        g_mode.frames++;
+        g_mode.hires_lines = hires_lines;
+        g_mode.hires_frames += hires_lines != 0U ? 1U : 0U;
 
         // Persist only after a complete input frame, mirroring the MVS
         // capture loop's drain site (video_capture_mvs.c): this pauses
         // capture for a rare flash operation while Core 1 continues
         // outputting the last frame. Unlike MVS, no separate post-save
-        // resync call is needed here: MVS's resync clears a free-running
-        // PIO sync-decoder's stale state and a backlogged vsync semaphore,
-        // neither of which exist on this path -- VBLANK is detected by
-        // directly polling a GPIO in this same loop (above), not by a
-        // background IRQ. By the time this line runs, the last DMA transfer
-        // has already completed (dma_channel_wait_for_finish_blocking()
-        // above), and the unconditional per-frame pixel SM reset at the top
-        // of this loop already realigns capture hardware for the next frame
-        // regardless of whether a save happened here.
+        // resync call is needed here: the VBLANK SM keeps no decoder state,
+        // the semaphore holds at most the one edge that fell during the
+        // save, and the stale check above drops it. By the time this line
+        // runs, the last DMA transfer has already completed
+        // (dma_channel_wait_for_finish_blocking() above), and the
+        // unconditional per-frame pixel SM reset at the top of this loop
+        // already realigns capture hardware for the next frame.
         settings_service_pending_save();
     }
 }
@@ -250,3 +519,26 @@ uint32_t video_capture_get_frame_count(void)
 {
     return g_frame_count;
 }
+
+uint32_t video_capture_get_content_bounds(content_bounds_t *bounds)
+{
+    return content_bounds_read(&g_content_bounds, bounds);
+}
+
+uint32_t video_capture_get_frame_hash(uint32_t *frame)
+{
+    return capture_frame_hash_read(&g_frame_hash, frame);
+}
+
+video_standard_t video_capture_get_standard(uint16_t *frame_lines)
+{
+    if (frame_lines != NULL) {
+        *frame_lines = g_standard.frame_lines;
+    }
+    return g_standard.standard;
+}
+
+void video_capture_get_snes_mode(video_capture_snes_mode_t *mode)
+{
+    *mode = g_mode;
+}
@@ -20,6 +20,7 @@
 #if NEOPICO_EXP_GENLOCK_DYNAMIC
 #include "video_capture.h"
 #endif
+#include "video_standard.h"
 
 #ifndef NEOPICO_VIDEO_TEST_PATTERN
 #define NEOPICO_VIDEO_TEST_PATTERN 0
@@ -122,6 +123,9 @@ typedef void (*pixel_scale_fn_t)(uint32_t *dst, const uint16_t *src, int count);
 typedef void (*pixel_scale_osd_fn_t)(uint32_t *dst, const uint16_t *game, const uint16_t *osd, int count);
 // Overscan/background outside active 224-line image area (RGB565): black.
 #define OVERSCAN_COLOR_RGB565 0x0000
+// The plain scanout path folds the line's border (line_ring.h) into the
+// overscan fill rather than scaling it out of the ring.
+_Static_assert(LINE_BORDER_COLOR == OVERSCAN_COLOR_RGB565, "line border must match the overscan colour");
 // Missing/not-ready capture-line fallback: International Orange
 // (aerospace), #FF4F00, converted to RGB565.
 #define NO_SIGNAL_COLOR_RGB565 0xFA60
@@ -158,6 +162,7 @@ static inline uint32_t reboot_mode_boot_check(uint32_t mode)
     return REBOOT_MODE_BOOT_MAGIC ^ mode ^ REBOOT_MODE_BOOT_CHECK_XOR;
 }
 
+#if !NEOPICO_EXP_RGB888_SCANOUT
 static void __scratch_y("") video_pipeline_fill_rgb565(uint32_t *dst, uint32_t words, uint16_t color)
     __attribute__((noinline, noclone));
 
@@ -168,6 +173,7 @@ static void __scratch_y("") video_pipeline_fill_rgb565(uint32_t *dst, uint32_t w
         dst[i] = packed;
     }
 }
+#endif
 
 #if NEOPICO_EXP_RGB888_SCANOUT
 #include "mvs_effect_lut.h"
@@ -635,6 +641,22 @@ static void video_pipeline_init_test_pattern_line(void)
  * Initialize the video pipeline.
  * Sets up HDMI output and registers scanline/vsync callbacks.
  */
+#if NEOPICO_EXP_BEAM_RACE
+// Scanout side of the beam-racing guarantee (line_ring_race_slack_us()). The
+// scanline callback fetches ring line 0 one row ahead of the row that shows
+// it, after the vertical blanking and the V_OFFSET border rows; one more row
+// covers a genlock pull-back to vtotal-1. The mode's own v_total is the
+// shortest blanking any output (genlocked included) runs with.
+static void video_pipeline_race_init(void)
+{
+    const video_mode_t *mode = video_output_active_mode;
+    const uint32_t v_scale = mode->v_active_lines / FRAME_HEIGHT;
+    const uint32_t row_ns = (uint32_t)(((uint64_t)mode->h_total_pixels * 1000000000ULL) / mode->pixel_clock_hz);
+    const uint32_t lead_rows = (mode->v_total_lines - mode->v_active_lines) + (V_OFFSET * v_scale) - 2U;
+    line_ring_race_init(line_ring_race_slack_us((lead_rows * row_ns) / 1000U, v_scale * row_ns));
+}
+#endif
+
 void video_pipeline_init(uint32_t frame_width, uint32_t frame_height)
 {
 #if NEOPICO_EXP_RGB888_SCANOUT
@@ -650,6 +672,9 @@ void video_pipeline_init(uint32_t frame_width, uint32_t frame_height)
         reboot_requested_mode = VIDEO_PIPELINE_REBOOT_MODE_480P;
     }
     video_output_set_scanline_callback(video_pipeline_scanline_callback_reboot_modes);
+#if NEOPICO_EXP_BEAM_RACE
+    video_pipeline_race_init();
+#endif
 
     osd_visible_latched = osd_visible;
 }
@@ -1019,6 +1044,52 @@ uint8_t video_pipeline_get_scanline_level(void)
     return g_scanline_level;
 }
 
+// Output frame rate. Core 1's background task only requests a change; the
+// vsync callback applies it at the frame boundary, ahead of the genlock
+// servo, so rt_v_total_lines never moves mid-frame and the servo sees one
+// standard for the whole frame it computes.
+static volatile video_standard_t g_requested_standard = VIDEO_STANDARD_60HZ;
+static volatile video_standard_t g_output_standard = VIDEO_STANDARD_60HZ;
+
+// V total that runs `mode` at `standard`'s rate on its own pixel clock and
+// line: the mode's for 60 Hz, and for 50 Hz its vertical blanking stretched
+// to the nearest line -- 480p 630 (50.00 Hz), 240p 315 (50.00 Hz) or 312 on
+// the 1613-wide genlock raster (50.07 Hz), 720p 889 (49.99 Hz).
+static uint16_t video_pipeline_standard_vtotal(const video_mode_t *mode, video_standard_t standard)
+{
+    if (standard != VIDEO_STANDARD_50HZ) {
+        return mode->v_total_lines;
+    }
+    const uint32_t line_hz = (uint32_t)mode->h_total_pixels * 50U;
+    return (uint16_t)((mode->pixel_clock_hz + (line_hz / 2U)) / line_hz);
+}
+
+void video_pipeline_set_standard(video_standard_t standard)
+{
+    g_requested_standard = standard;
+}
+
+// Once per frame from the vsync callback, before the servo.
+static void video_pipeline_apply_standard(void)
+{
+    const video_standard_t standard = g_requested_standard;
+    if (standard == g_output_standard) {
+        return;
+    }
+    g_output_standard = standard;
+#if NEOPICO_EXP_GENLOCK_DYNAMIC
+    if (g_genlock_enabled) {
+        return; // the servo moves to the new nominal right after this
+    }
+#endif
+    rt_v_total_lines = video_pipeline_standard_vtotal(video_output_active_mode, standard);
+}
+
+video_standard_t video_pipeline_get_standard(void)
+{
+    return g_output_standard;
+}
+
 #if NEOPICO_EXP_GENLOCK_DYNAMIC
 // Nominals that approximate MVS ~59.18 Hz at each mode's pixel clock:
 //   480p: 25.2M / (800 * 532) = 59.21 Hz    (±1 → 59.10–59.32 Hz)
@@ -1034,6 +1105,12 @@ uint8_t video_pipeline_get_scanline_level(void)
 //   pulls back. (The pre-sunset nominal 762 belonged to the deleted 372 MHz
 //   1650-h_total timing and must not be reused here.)
 #define GENLOCK_NOMINAL_VTOTAL_720 751
+// 50 Hz nominals are worked out from a 312-line raster of 64 us lines
+// (19968 us, 50.08 Hz); a PAL SNES field (19997 us) is within the servo's
+// +-1 line of it:
+//   480p: 25.2M * 19968 us / 800 = 629.0    240p: 25.2M * 19968 us / 1613 = 312.0
+//   720p: 64M * 19968 us / 1440 = 887.5 -> 887
+#define GENLOCK_50HZ_FRAME_US 19968U
 #define GENLOCK_PHASE_THRESHOLD_US 200
 #define GENLOCK_PHASE_MAX_US 5000
 // Output vsyncs landing shortly after the MVS vsync sample a frame base no
@@ -1043,9 +1120,41 @@ uint8_t video_pipeline_get_scanline_level(void)
 // (top-of-image wobble). Instead: WIDE HYSTERESIS — let the phase ramp the
 // healthy zone on a constant vtotal, pull it back on a constant vtotal-1.
 // Two one-line timing changes per ~42 s instead of ~18 per second.
+#ifndef NEOPICO_EXP_GENLOCK_EARLY_PHASE
+#define NEOPICO_EXP_GENLOCK_EARLY_PHASE 0
+#endif
+#if NEOPICO_EXP_GENLOCK_EARLY_PHASE
+// Early zone: the output trails the capture by ~5 ms instead of ~11 ms, so a
+// locked output reads each line ~100 lines sooner after its commit. The ring
+// stays full depth: it must cover the free-running output before lock. The
+// resume bound keeps the first read clear of the first commit (~1.1 ms after
+// the MVS vsync sample, plus the output's own blanking lead).
+#define GENLOCK_PHASE_PULLBACK_AT_US 7000
+#define GENLOCK_PHASE_RESUME_AT_US 3000
+#define GENLOCK_PHASE_SETPOINT_US 5000
+#else
 #define GENLOCK_PHASE_PULLBACK_AT_US 14000
 #define GENLOCK_PHASE_RESUME_AT_US 4000
 #define GENLOCK_PHASE_SETPOINT_US 11000
+#endif
+
+static uint16_t genlock_nominal_vtotal_at(const video_mode_t *mode, video_standard_t standard)
+{
+    if (standard == VIDEO_STANDARD_50HZ) {
+        const uint64_t line_us_x1m = (uint64_t)mode->h_total_pixels * 1000000U;
+        return (uint16_t)((((uint64_t)mode->pixel_clock_hz * GENLOCK_50HZ_FRAME_US) + (line_us_x1m / 2U)) /
+                          line_us_x1m);
+    }
+    const uint16_t mode_total = mode->v_total_lines;
+    return (mode_total <= 266)   ? GENLOCK_NOMINAL_VTOTAL_240
+           : (mode_total >= 700) ? GENLOCK_NOMINAL_VTOTAL_720
+                                 : GENLOCK_NOMINAL_VTOTAL_480;
+}
+
+static uint16_t genlock_nominal_vtotal(const video_mode_t *mode)
+{
+    return genlock_nominal_vtotal_at(mode, g_output_standard);
+}
 
 // Once per frame from the vsync callback; does not need scratch residency
 // (and scratch_x is at its hard boundary).
@@ -1059,10 +1168,7 @@ static void genlock_dynamic_update(void)
     uint32_t phase = hdmi_ts - mvs_ts; // us since last MVS vsync, [0, ~16.9ms)
     g_genlock_phase_us = phase;
 
-    const uint16_t mode_total = video_output_active_mode->v_total_lines;
-    uint16_t nominal = (mode_total <= 266)   ? GENLOCK_NOMINAL_VTOTAL_240
-                       : (mode_total >= 700) ? GENLOCK_NOMINAL_VTOTAL_720
-                                             : GENLOCK_NOMINAL_VTOTAL_480;
+    uint16_t nominal = genlock_nominal_vtotal(video_output_active_mode);
 
     // Steady state: vtotal stays at nominal FOREVER and a proportional servo
     // on the blanking h-trim nulls the residual drift (sub-line steps are
@@ -1150,14 +1256,18 @@ static void genlock_dynamic_update(void)
  *
  * Placement (VIDEO_PIPELINE_VSYNC_RAM, see the header): scratch_x content
  * plus the 2 KiB core-1 stack fill the 4 KiB bank EXACTLY (the link fails on
- * a single added instruction), so the extra genlock call cannot live there.
- * With genlock ON the callback moves to scratch_y, which has over 1 KiB of
- * headroom; the servo body itself runs from normal RAM (once per frame in
- * blanking, no scratch residency needed).
+ * a single added instruction), so the callback lives in scratch_y, which has
+ * headroom. The standard change and the servo bodies run from normal RAM
+ * (once per frame in blanking, no scratch residency needed).
  */
 void VIDEO_PIPELINE_VSYNC_RAM video_pipeline_vsync_callback(void)
 {
+#if NEOPICO_EXP_BEAM_RACE
+    (void)line_ring_output_vsync_race(timer_hw->timerawl);
+#else
     line_ring_output_vsync();
+#endif
+    video_pipeline_apply_standard();
 #if NEOPICO_EXP_GENLOCK_DYNAMIC && !defined(NEOPICO_DIAG_GENLOCK_SERVO_OFF)
     // Default OFF (opt-in via OSD): g_genlock_enabled is latched once at
     // boot (see video_pipeline_set_genlock_enabled()), so this is one load.
@@ -1236,6 +1346,19 @@ static void __scratch_x("000_video_pipeline_modes")
         (LINE_WIDTH * h_scale) / 2U;
 #endif
     const uint32_t x_margin_words = (h_words > image_words) ? ((h_words - image_words) / 2U) : 0U;
+    // The line's active window; both zero-width borders on the MVS target.
+    const uint32_t window_x_words = x_margin_words +
+#if NEOPICO_EXP_RGB888_SCANOUT
+                                    (LINE_ACTIVE_X * h_scale);
+#else
+                                    ((LINE_ACTIVE_X * h_scale) / 2U);
+#endif
+    const uint32_t window_words =
+#if NEOPICO_EXP_RGB888_SCANOUT
+        LINE_ACTIVE_WIDTH * h_scale;
+#else
+        (LINE_ACTIVE_WIDTH * h_scale) / 2U;
+#endif
     const pixel_scale_fn_t scale_pixels = mode_is_3x     ? video_pipeline_triple_pixels_fast
                                           : mode_is_240p ? video_pipeline_quadruple_pixels_fast
                                                          : video_pipeline_double_pixels_fast;
@@ -1306,9 +1429,9 @@ static void __scratch_x("000_video_pipeline_modes")
             VIDEO_PIPELINE_FILL(dst, h_words, NO_SIGNAL_COLOR_RGB565);
             return;
         }
-        VIDEO_PIPELINE_FILL(dst, x_margin_words, OVERSCAN_COLOR_RGB565);
-        VIDEO_PIPELINE_SCALE_SELECTED(dst + x_margin_words, src, LINE_WIDTH);
-        VIDEO_PIPELINE_FILL(dst + x_margin_words + image_words, h_words - x_margin_words - image_words,
+        VIDEO_PIPELINE_FILL(dst, window_x_words, OVERSCAN_COLOR_RGB565);
+        VIDEO_PIPELINE_SCALE_SELECTED(dst + window_x_words, src + LINE_ACTIVE_X, LINE_ACTIVE_WIDTH);
+        VIDEO_PIPELINE_FILL(dst + window_x_words + window_words, h_words - window_x_words - window_words,
                             OVERSCAN_COLOR_RGB565);
         return;
     }
@@ -5,6 +5,7 @@
 #include <stdint.h>
 
 #include "pico.h"
+#include "video_standard.h"
 
 // Video effect toggles
 extern bool fx_scanlines_enabled;
@@ -67,12 +68,15 @@ bool video_pipeline_take_reboot_240p_boot_request(bool *enabled);
  * VSYNC callback - called once per frame to sync input/output buffers.
  *
  * Placement: scratch_x content plus the 2 KiB core-1 stack fill the 4 KiB
- * bank exactly, so the genlock build's extra call cannot live there; with
- * genlock ON the callback moves to scratch_y (over 1 KiB of headroom).
+ * bank exactly, and the callback grows with the standard change, genlock and
+ * the beam-racing read policy (line_ring.h), so it lives in scratch_y.
  */
 #ifndef NEOPICO_EXP_GENLOCK_DYNAMIC
 #define NEOPICO_EXP_GENLOCK_DYNAMIC 0
 #endif
+#ifndef NEOPICO_EXP_BEAM_RACE
+#define NEOPICO_EXP_BEAM_RACE 0
+#endif
 
 #if NEOPICO_EXP_GENLOCK_DYNAMIC
 // Genlock on/off: a flash-persisted setting (default off), applied at boot
@@ -90,6 +94,16 @@ void video_pipeline_request_reboot_genlock_pending(bool new_enabled, bool previo
 bool video_pipeline_take_genlock_pending_confirmation(bool *previous_enabled);
 #endif
 
+// Output frame rate, to follow the input's (video_capture_get_standard()):
+// 50 Hz keeps the mode's pixel clock, lines and active raster and stretches
+// its vertical blanking (480p 630 lines, 240p 315, 720p 889), so a 50 Hz
+// input is shown once per output frame instead of repeating one frame in
+// five. Core 1 background context: the request is applied by the vsync
+// callback at the next output VSYNC, never mid-frame; with genlock on the
+// servo takes its 50 Hz nominal there. get returns the applied standard.
+void video_pipeline_set_standard(video_standard_t standard);
+video_standard_t video_pipeline_get_standard(void);
+
 // Scanline STRENGTH, shared BY NUMBER with pico_hdmi's
 // video_output_set_scanline_level() (720p path, lib/pico_hdmi): a caller
 // passes the same uint8_t 0..4 to both, and both apply the same per-channel
@@ -127,11 +141,7 @@ void video_pipeline_set_scanline_level(uint8_t level);
 // default, otherwise the menu shows a stale value after a reboot.
 uint8_t video_pipeline_get_scanline_level(void);
 
-#if NEOPICO_EXP_GENLOCK_DYNAMIC
-#define VIDEO_PIPELINE_VSYNC_RAM __scratch_y("genlock_vsync")
-#else
-#define VIDEO_PIPELINE_VSYNC_RAM __scratch_x("")
-#endif
+#define VIDEO_PIPELINE_VSYNC_RAM __scratch_y("video_pipeline_vsync")
 void VIDEO_PIPELINE_VSYNC_RAM video_pipeline_vsync_callback(void);
 
 #endif // VIDEO_PIPELINE_H
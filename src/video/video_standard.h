@@ -0,0 +1,78 @@
+#ifndef NEOPICO_HD_VIDEO_STANDARD_H
+#define NEOPICO_HD_VIDEO_STANDARD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+// Input frame rate from the lines each frame lasts. Both consoles run a
+// 262-264 line raster at about 60 Hz and a 312-313 line one at about 50 Hz,
+// on nearly the same line period, so the count alone tells them apart with
+// a wide margin either side of VIDEO_STANDARD_50HZ_MIN_LINES. The MVS counts
+// its sync pulses (mvs_sync_decoder.h); the SNES divides its VBLANK period
+// by the line time.
+//
+// A change is published only after VIDEO_STANDARD_CONFIRM_FRAMES frames in a
+// row of the other rate, so a miscounted frame (pulses lost to noise, a
+// relock) cannot retime the output. Counts outside both ranges -- the partial
+// frame after a restart, a signal that comes and goes -- change nothing and
+// break a streak.
+// Each target pushes from one context only: the MVS from its sync IRQ, the
+// SNES from Core 0's capture loop. `standard` and `frame_lines` are single
+// volatile fields, so any context may read them without a lock.
+
+#define VIDEO_STANDARD_60HZ_MIN_LINES 240U
+#define VIDEO_STANDARD_50HZ_MIN_LINES 288U
+#define VIDEO_STANDARD_50HZ_MAX_LINES 340U
+#define VIDEO_STANDARD_CONFIRM_FRAMES 8U
+
+typedef enum {
+    VIDEO_STANDARD_60HZ = 0,
+    VIDEO_STANDARD_50HZ = 1,
+} video_standard_t;
+
+typedef struct {
+    volatile video_standard_t standard; // published: 60 Hz until 50 Hz is confirmed
+    volatile uint16_t frame_lines;      // last plausible frame's count
+    uint8_t streak;                     // frames in a row of the other rate
+    uint32_t changes;
+} video_standard_detector_t;
+
+static inline void video_standard_init(video_standard_detector_t *det)
+{
+    memset(det, 0, sizeof *det);
+}
+
+// Rate class of a `lines`-line frame; false for an implausible count.
+static inline bool video_standard_classify(uint32_t lines, video_standard_t *standard)
+{
+    if (lines < VIDEO_STANDARD_60HZ_MIN_LINES || lines > VIDEO_STANDARD_50HZ_MAX_LINES) {
+        return false;
+    }
+    *standard = lines >= VIDEO_STANDARD_50HZ_MIN_LINES ? VIDEO_STANDARD_50HZ : VIDEO_STANDARD_60HZ;
+    return true;
+}
+
+// Feed one frame's line count. Returns true when the published rate changes.
+static inline bool video_standard_push(video_standard_detector_t *det, uint32_t frame_lines)
+{
+    video_standard_t seen;
+    if (!video_standard_classify(frame_lines, &seen)) {
+        det->streak = 0;
+        return false;
+    }
+    det->frame_lines = (uint16_t)frame_lines;
+    if (seen == det->standard) {
+        det->streak = 0;
+        return false;
+    }
+    if (++det->streak < VIDEO_STANDARD_CONFIRM_FRAMES) {
+        return false;
+    }
+    det->streak = 0;
+    det->standard = seen;
+    det->changes++;
+    return true;
+}
+
+#endif // NEOPICO_HD_VIDEO_STANDARD_H
@@ -0,0 +1,39 @@
+// Entry points the benchmark (and host_capture_packed) needs into firmware
+// kernels that are static in their translation units. kernels_capture_mvs.c,
+// kernels_capture_snes.c and kernels_video_pipeline.c each #include the
+// firmware source they expose and are compiled in its place
+// (neopico_host_firmware(... KERNEL_ACCESS) in tests/CMakeLists.txt), with the
+// same flags, so what is timed is the code the firmware inlines.
+#ifndef NEOPICO_BENCH_KERNELS_H
+#define NEOPICO_BENCH_KERNELS_H
+
+#include <stdint.h>
+
+// Builds the conversion LUTs video_capture_init() would, without touching
+// PIO or DMA.
+void bench_capture_prepare(void);
+
+// The capture loop's per-line conversion for this build, with the colour
+// table it would use for the Digital model where the build selects one.
+// Returns the AND of the raw words, whose CSYNC/PCLK bits the line check reads
+// (all ones unless NEOPICO_EXP_LINE_INTEGRITY).
+uint32_t bench_convert_active_pixels(uint16_t *dst, const uint32_t *src, int count);
+
+// The same conversion from packed capture words (two [DARK][RGB555] pixels
+// per word, NEOPICO_EXP_MVS_PACKED_CAPTURE) with the line's SHADOW level.
+// MVS only, like bench_capture_line_shadow().
+void bench_convert_active_pixels_packed(uint16_t *dst, const uint32_t *src, int pairs, uint32_t line_shadow);
+
+// SHADOW latch the last conversion left for the ring line (RGB888 scanout
+// builds; 0 otherwise).
+uint32_t bench_capture_line_shadow(void);
+
+// Line hash the last conversion returned, one-pixel or packed
+// (CAPTURE_HASH_SEED unless NEOPICO_EXP_FRAME_HASH).
+uint32_t bench_capture_line_hash(void);
+
+void bench_double_pixels_osd_fake_blend(uint32_t *dst, const uint16_t *game, const uint16_t *osd, int count);
+void bench_triple_pixels_osd_fake_blend(uint32_t *dst, const uint16_t *game, const uint16_t *osd, int count);
+void bench_quadruple_pixels_osd_fake_blend(uint32_t *dst, const uint16_t *game, const uint16_t *osd, int count);
+
+#endif // NEOPICO_BENCH_KERNELS_H
@@ -0,0 +1,57 @@
+// Benchmark access to video_capture_mvs.c's static conversion kernels; see
+// bench_kernels.h.
+
+#include "video_capture_mvs.c"
+
+#include "bench_kernels.h"
+
+static uint32_t g_bench_line_hash;
+
+void bench_capture_prepare(void)
+{
+#if ENABLE_DARK_SHADOW
+    generate_capture_lut();
+#else
+    generate_color_correct_lut();
+#endif
+#if NEOPICO_EXP_INTERP_LUT
+    capture_interp_prepare();
+#endif
+}
+
+uint32_t bench_convert_active_pixels(uint16_t *dst, const uint32_t *src, int count)
+{
+#if NEOPICO_MVS_COLOR_MODEL_MENU
+    const capture_line_bits_t bits =
+        convert_active_pixels(dst, src, count, g_color_correct_lut[MVS_COLOR_MODEL_DIGITAL]);
+#else
+    const capture_line_bits_t bits = convert_active_pixels(dst, src, count);
+#endif
+    g_bench_line_hash = bits.hash;
+    return bits.all;
+}
+
+void bench_convert_active_pixels_packed(uint16_t *dst, const uint32_t *src, int pairs, uint32_t line_shadow)
+{
+#if NEOPICO_MVS_COLOR_MODEL_MENU
+    (void)line_shadow;
+    g_bench_line_hash =
+        convert_active_pixels_packed(dst, src, pairs, g_color_correct_lut[MVS_COLOR_MODEL_DIGITAL]).hash;
+#else
+    g_bench_line_hash = convert_active_pixels_packed(dst, src, pairs, line_shadow).hash;
+#endif
+}
+
+uint32_t bench_capture_line_shadow(void)
+{
+#if ENABLE_DARK_SHADOW && NEOPICO_EXP_RGB888_SCANOUT
+    return g_capture_line_shadow;
+#else
+    return 0U;
+#endif
+}
+
+uint32_t bench_capture_line_hash(void)
+{
+    return g_bench_line_hash;
+}
@@ -0,0 +1,39 @@
+// Benchmark access to video_capture_snes.c's static conversion kernel; see
+// bench_kernels.h. SNES has no packed capture and no SHADOW, so only the
+// one-pixel conversion is exported (the two-sample one in the hires build).
+
+#include "video_capture_snes.c"
+
+#include "bench_kernels.h"
+
+static uint32_t g_bench_line_hash;
+
+void bench_capture_prepare(void)
+{
+#if SNES_PIXEL_LUT
+    generate_pixel_lut();
+#endif
+#if NEOPICO_EXP_INTERP_LUT
+    capture_interp_lut15_init();
+    capture_interp_lut15_set_table(g_pixel_lut);
+#endif
+}
+
+// The hires build converts the `count` words as count / 2 two-sample dots,
+// so its time is per capture word as well.
+uint32_t bench_convert_active_pixels(uint16_t *dst, const uint32_t *src, int count)
+{
+#if NEOPICO_EXP_SNES_HIRES_CAPTURE
+    uint32_t hires;
+    const capture_line_bits_t bits = convert_hires_pixels(dst, src, count / 2, &hires);
+#else
+    const capture_line_bits_t bits = convert_active_pixels(dst, src, count);
+#endif
+    g_bench_line_hash = bits.hash;
+    return bits.all;
+}
+
+uint32_t bench_capture_line_hash(void)
+{
+    return g_bench_line_hash;
+}
@@ -0,0 +1,21 @@
+// Benchmark access to video_pipeline.c's static OSD blend kernels; see
+// bench_kernels.h.
+
+#include "video_pipeline.c"
+
+#include "bench_kernels.h"
+
+void bench_double_pixels_osd_fake_blend(uint32_t *dst, const uint16_t *game, const uint16_t *osd, int count)
+{
+    video_pipeline_double_pixels_osd_fake_blend(dst, game, osd, count);
+}
+
+void bench_triple_pixels_osd_fake_blend(uint32_t *dst, const uint16_t *game, const uint16_t *osd, int count)
+{
+    video_pipeline_triple_pixels_osd_fake_blend(dst, game, osd, count);
+}
+
+void bench_quadruple_pixels_osd_fake_blend(uint32_t *dst, const uint16_t *game, const uint16_t *osd, int count)
+{
+    video_pipeline_quadruple_pixels_osd_fake_blend(dst, game, osd, count);
+}
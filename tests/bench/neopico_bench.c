@@ -0,0 +1,522 @@
+// Host microbenchmarks for the per-pixel and per-sample hot kernels, built
+// once per capture conversion variant (tests/CMakeLists.txt, neopico_bench()):
+//
+//   capture  convert_active_pixels, one 320-pixel line
+//   scanout  video_pipeline_{double,triple,quadruple}_pixels_fast, the three
+//            *_osd_fake_blend kernels over the OSD box width, and (RGB888
+//            builds) mvs_effect_lut888_lookup_entropy over a line
+//   audio    src_process (DROP and LINEAR), lowpass_process_buffer and
+//            dc_filter_process_buffer, 512-sample blocks (default variant)
+//
+// Each kernel reports ns per call, ns per pixel or sample, the bytes a call
+// moves (source read plus destination written; LUT traffic is not counted)
+// and a machine-independent cost: ns per unit divided by ns per step of a
+// fixed dependent multiply-add chain, which tracks the host core clock. The
+// baseline file stores that relative cost, and any kernel that comes out
+// more than --tolerance percent above it fails the run.
+//
+//   neopico_bench_mvs [--baseline FILE] [--write-baseline FILE]
+//                     [--tolerance PCT] [--quick]
+//
+// --quick runs every kernel once, skips timing checks and only requires the
+// baseline to list every kernel (the ctest smoke test).
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "bench_kernels.h"
+#include "dc_filter.h"
+#include "fast_osd.h"
+#include "line_ring.h"
+#include "lowpass.h"
+#include "pico_hdmi/video_output_rt.h"
+#include "pico_host.h"
+#include "src.h"
+#include "video_pipeline.h"
+
+#if NEOPICO_EXP_RGB888_SCANOUT
+#include "mvs_effect_lut.h"
+#endif
+
+#ifndef NEOPICO_BENCH_VARIANT
+#error "NEOPICO_BENCH_VARIANT names the build variant in the baseline file"
+#endif
+
+#define BENCH_LINE_PIXELS LINE_WIDTH
+#define BENCH_AUDIO_BLOCK 512U
+#define BENCH_MIN_RUN_NS 200000U
+#define BENCH_REPEATS 60U
+#define BENCH_CALIBRATION_STEPS 1024U
+#define BENCH_DEFAULT_TOLERANCE_PCT 25.0
+#define BENCH_CONFIRM_RUNS 3U
+#define BENCH_MAX_KERNELS 16U
+#define BENCH_MAX_BASELINE_LINES 256U
+
+// Output words per source pixel at scale 1: one RGB888 pixel per word, or
+// half a word of packed RGB565.
+#if NEOPICO_EXP_RGB888_SCANOUT
+#define BENCH_OUT_BYTES_PER_PIXEL 4U
+#else
+#define BENCH_OUT_BYTES_PER_PIXEL 2U
+#endif
+
+typedef struct {
+    const char *name;
+    const char *unit;
+    uint32_t units; // pixels or samples per call
+    uint32_t bytes; // moved per call
+    void (*run)(void);
+} bench_kernel_t;
+
+typedef struct {
+    const bench_kernel_t *kernel;
+    double ns_per_call;
+    double rel; // ns per unit / ns per calibration step
+} bench_result_t;
+
+// =============================================================================
+// Inputs
+// =============================================================================
+
+static uint32_t g_raw_line[BENCH_LINE_PIXELS];
+static uint16_t g_ring_line[BENCH_LINE_PIXELS];
+static uint16_t g_osd_line[OSD_BOX_W];
+static uint32_t g_out_line[BENCH_LINE_PIXELS * 4U];
+#if NEOPICO_BENCH_AUDIO
+static audio_sample_t g_audio_in[BENCH_AUDIO_BLOCK];
+static audio_sample_t g_audio_out[BENCH_AUDIO_BLOCK * 2U];
+static audio_sample_t g_audio_work[BENCH_AUDIO_BLOCK];
+static src_t g_src_drop;
+static src_t g_src_linear;
+static lowpass_t g_lowpass;
+static dc_filter_t g_dc_filter;
+#endif
+#if NEOPICO_EXP_RGB888_SCANOUT
+static mvs_effect_lut888_t g_lut888;
+#endif
+static uint16_t g_calibration_src[BENCH_CALIBRATION_STEPS];
+static uint32_t g_calibration_dst[BENCH_CALIBRATION_STEPS];
+static uint32_t g_calibration_table[256];
+
+static uint32_t hash32(uint32_t x)
+{
+    x ^= x >> 16;
+    x *= 0x7FEB352DU;
+    x ^= x >> 15;
+    x *= 0x846CA68BU;
+    x ^= x >> 16;
+    return x;
+}
+
+// A line of raw capture words: random colour, sync and PCLK bits as the
+// pixel SM sees them mid-line, and DARK or SHADOW on about one pixel in 32
+// so the effect paths are exercised at a game-like rate.
+static void prepare_inputs(void)
+{
+    for (uint32_t x = 0; x < BENCH_LINE_PIXELS; x++) {
+        const uint32_t h = hash32(x + 1U);
+        uint32_t raw = ((h & 0x7FFFU) << 2) | 3U;
+        if ((h >> 27) == 0U) {
+            raw |= ((h >> 15) & 3U) << 17;
+        }
+        g_raw_line[x] = raw;
+    }
+    for (uint32_t i = 0; i < BENCH_CALIBRATION_STEPS; i++) {
+        g_calibration_src[i] = (uint16_t)hash32(i + 4099U);
+    }
+    for (uint32_t i = 0; i < 256U; i++) {
+        g_calibration_table[i] = hash32(i + 8191U);
+    }
+    bench_capture_prepare();
+    bench_convert_active_pixels(g_ring_line, g_raw_line, BENCH_LINE_PIXELS);
+
+    // Menu text density: about half the box is background.
+    for (uint32_t x = 0; x < OSD_BOX_W; x++) {
+        g_osd_line[x] = (hash32(x + 977U) & 1U) != 0U ? (uint16_t)OSD_COLOR_BG : (uint16_t)0xFFFFU;
+    }
+
+#if NEOPICO_BENCH_AUDIO
+    for (uint32_t i = 0; i < BENCH_AUDIO_BLOCK; i++) {
+        const int32_t h = (int32_t)(hash32(i + 31U) & 0x3FFFU) - 0x2000;
+        g_audio_in[i].left = (int16_t)((int32_t)(i * 97U % 20000U) - 10000 + h);
+        g_audio_in[i].right = (int16_t)(-g_audio_in[i].left / 2);
+    }
+    src_init(&g_src_drop, CAPTURE_AUDIO_INPUT_RATE, SRC_OUTPUT_RATE_DEFAULT);
+    src_set_mode(&g_src_drop, SRC_MODE_DROP);
+    src_init(&g_src_linear, CAPTURE_AUDIO_INPUT_RATE, SRC_OUTPUT_RATE_DEFAULT);
+    src_set_mode(&g_src_linear, SRC_MODE_LINEAR);
+    lowpass_init(&g_lowpass);
+    lowpass_set_enabled(&g_lowpass, true);
+    dc_filter_init(&g_dc_filter);
+    dc_filter_set_enabled(&g_dc_filter, true);
+#endif
+#if NEOPICO_EXP_RGB888_SCANOUT
+    mvs_effect_lut888_generate(&g_lut888);
+#endif
+}
+
+// =============================================================================
+// Kernels
+// =============================================================================
+
+static void run_convert(void)
+{
+    bench_convert_active_pixels(g_ring_line, g_raw_line, BENCH_LINE_PIXELS);
+}
+
+static void run_double(void)
+{
+    video_pipeline_double_pixels_fast(g_out_line, g_ring_line, BENCH_LINE_PIXELS);
+}
+
+static void run_triple(void)
+{
+    video_pipeline_triple_pixels_fast(g_out_line, g_ring_line, BENCH_LINE_PIXELS);
+}
+
+static void run_quadruple(void)
+{
+    video_pipeline_quadruple_pixels_fast(g_out_line, g_ring_line, BENCH_LINE_PIXELS);
+}
+
+static void run_double_osd(void)
+{
+    bench_double_pixels_osd_fake_blend(g_out_line, g_ring_line, g_osd_line, OSD_BOX_W);
+}
+
+static void run_triple_osd(void)
+{
+    bench_triple_pixels_osd_fake_blend(g_out_line, g_ring_line, g_osd_line, OSD_BOX_W);
+}
+
+static void run_quadruple_osd(void)
+{
+    bench_quadruple_pixels_osd_fake_blend(g_out_line, g_ring_line, g_osd_line, OSD_BOX_W);
+}
+
+#if NEOPICO_EXP_RGB888_SCANOUT
+static void run_lut888_lookup(void)
+{
+    for (uint32_t x = 0; x < BENCH_LINE_PIXELS; x++) {
+        g_out_line[x] = mvs_effect_lut888_lookup_entropy(&g_lut888, g_ring_line[x], x & 1U);
+    }
+}
+#endif
+
+#if NEOPICO_BENCH_AUDIO
+static void run_src(src_t *s)
+{
+    uint32_t consumed = 0;
+    (void)src_process(s, g_audio_in, BENCH_AUDIO_BLOCK, g_audio_out, BENCH_AUDIO_BLOCK * 2U, &consumed);
+}
+
+static void run_src_drop(void)
+{
+    run_src(&g_src_drop);
+}
+
+static void run_src_linear(void)
+{
+    run_src(&g_src_linear);
+}
+
+// The filters work in place; restart from the same block every call so the
+// IIR state sees the same signal however long the run. The 2 KiB copy is
+// timed with the filter, a few percent of either.
+static void run_lowpass(void)
+{
+    memcpy(g_audio_work, g_audio_in, sizeof g_audio_work);
+    lowpass_process_buffer(&g_lowpass, g_audio_work, BENCH_AUDIO_BLOCK);
+}
+
+static void run_dc_filter(void)
+{
+    memcpy(g_audio_work, g_audio_in, sizeof g_audio_work);
+    dc_filter_process_buffer(&g_dc_filter, g_audio_work, BENCH_AUDIO_BLOCK);
+}
+#endif
+
+#define LINE_IN (BENCH_LINE_PIXELS * 4U)
+#define RING_IN (BENCH_LINE_PIXELS * 2U)
+#define SCALED_OUT(n, scale) ((n) * (scale) * BENCH_OUT_BYTES_PER_PIXEL)
+#define SAMPLE_BYTES ((uint32_t)sizeof(audio_sample_t))
+
+static const bench_kernel_t g_kernels[] = {
+    {"convert_active_pixels", "px", BENCH_LINE_PIXELS, LINE_IN + RING_IN, run_convert},
+    {"double_pixels_fast", "px", BENCH_LINE_PIXELS, RING_IN + SCALED_OUT(BENCH_LINE_PIXELS, 2U), run_double},
+    {"triple_pixels_fast", "px", BENCH_LINE_PIXELS, RING_IN + SCALED_OUT(BENCH_LINE_PIXELS, 3U), run_triple},
+    {"quadruple_pixels_fast", "px", BENCH_LINE_PIXELS, RING_IN + SCALED_OUT(BENCH_LINE_PIXELS, 4U), run_quadruple},
+    {"double_pixels_osd_fake_blend", "px", OSD_BOX_W, (OSD_BOX_W * 4U) + SCALED_OUT(OSD_BOX_W, 2U), run_double_osd},
+    {"triple_pixels_osd_fake_blend", "px", OSD_BOX_W, (OSD_BOX_W * 4U) + SCALED_OUT(OSD_BOX_W, 3U), run_triple_osd},
+    {"quadruple_pixels_osd_fake_blend", "px", OSD_BOX_W, (OSD_BOX_W * 4U) + SCALED_OUT(OSD_BOX_W, 4U),
+     run_quadruple_osd},
+#if NEOPICO_EXP_RGB888_SCANOUT
+    {"lut888_lookup_entropy", "px", BENCH_LINE_PIXELS, RING_IN + (BENCH_LINE_PIXELS * 4U), run_lut888_lookup},
+#endif
+#if NEOPICO_BENCH_AUDIO
+    // DROP keeps 48000/55556 of its input, LINEAR about the same.
+    {"src_process_drop", "sample", BENCH_AUDIO_BLOCK, BENCH_AUDIO_BLOCK * SAMPLE_BYTES * 2U, run_src_drop},
+    {"src_process_linear", "sample", BENCH_AUDIO_BLOCK, BENCH_AUDIO_BLOCK * SAMPLE_BYTES * 2U, run_src_linear},
+    {"lowpass_process_buffer", "sample", BENCH_AUDIO_BLOCK, BENCH_AUDIO_BLOCK * SAMPLE_BYTES * 2U, run_lowpass},
+    {"dc_filter_process_buffer", "sample", BENCH_AUDIO_BLOCK, BENCH_AUDIO_BLOCK * SAMPLE_BYTES * 2U, run_dc_filter},
+#endif
+};
+
+#define KERNEL_COUNT (sizeof g_kernels / sizeof g_kernels[0])
+_Static_assert(KERNEL_COUNT <= BENCH_MAX_KERNELS, "raise BENCH_MAX_KERNELS");
+
+// =============================================================================
+// Timing
+// =============================================================================
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+
+// Reference kernel: a line of 16-bit pixels through a 256-entry word table
+// into 32-bit words -- the load/lookup/store shape of the real kernels, so it
+// feels the same clock and the same contention from a busy sibling core.
+static void run_calibration(void)
+{
+    for (uint32_t i = 0; i < BENCH_CALIBRATION_STEPS; i++) {
+        const uint32_t p = g_calibration_src[i];
+        g_calibration_dst[i] = g_calibration_table[p & 0xFFU] ^ (p >> 8);
+    }
+    // Nothing reads the result; keep the stores.
+    __asm__ volatile("" : : "r"(g_calibration_dst) : "memory");
+}
+
+static double time_block(void (*run)(void), uint64_t calls)
+{
+    const uint64_t t0 = now_ns();
+    for (uint64_t i = 0; i < calls; i++) {
+        run();
+    }
+    return (double)(now_ns() - t0) / (double)calls;
+}
+
+// Calls of `run` that take at least BENCH_MIN_RUN_NS.
+static uint64_t calls_for_run(void (*run)(void))
+{
+    uint64_t calls = 1;
+    while (time_block(run, calls) * (double)calls < BENCH_MIN_RUN_NS) {
+        calls *= 2U;
+    }
+    return calls;
+}
+
+// Best ns per call of `run` and of the calibration loop, timed in alternating
+// blocks so both see the same clock and the same neighbours; the minimum of
+// each over BENCH_REPEATS blocks rejects preemption.
+static void time_kernel(void (*run)(void), bool quick, double *ns_per_call, double *ns_per_step)
+{
+    const uint64_t calls = quick ? 1U : calls_for_run(run);
+    const uint64_t calib_calls = quick ? 1U : calls_for_run(run_calibration);
+    double best = 0.0;
+    double best_calib = 0.0;
+    for (uint32_t r = 0; r < (quick ? 1U : BENCH_REPEATS); r++) {
+        const double calib = time_block(run_calibration, calib_calls);
+        const double ns = time_block(run, calls);
+        best_calib = (r == 0U || calib < best_calib) ? calib : best_calib;
+        best = (r == 0U || ns < best) ? ns : best;
+    }
+    *ns_per_call = best;
+    *ns_per_step = best_calib / BENCH_CALIBRATION_STEPS;
+}
+
+// =============================================================================
+// Baseline file: "<variant> <kernel> <relative cost>" per line, '#' comments.
+// =============================================================================
+
+typedef struct {
+    char variant[64];
+    char kernel[64];
+    double rel;
+} baseline_entry_t;
+
+static uint32_t load_baseline(const char *path, baseline_entry_t *entries, uint32_t max)
+{
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        return 0;
+    }
+    uint32_t n = 0;
+    char line[256];
+    while (n < max && fgets(line, sizeof line, f) != NULL) {
+        if (line[0] == '#' || line[0] == '\n') {
+            continue;
+        }
+        if (sscanf(line, "%63s %63s %lf", entries[n].variant, entries[n].kernel, &entries[n].rel) == 3) {
+            n++;
+        }
+    }
+    fclose(f);
+    return n;
+}
+
+static const baseline_entry_t *find_baseline(const baseline_entry_t *entries, uint32_t count, const char *kernel)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        if (strcmp(entries[i].variant, NEOPICO_BENCH_VARIANT) == 0 && strcmp(entries[i].kernel, kernel) == 0) {
+            return &entries[i];
+        }
+    }
+    return NULL;
+}
+
+// Rewrites `path` with this variant's entries replaced and every other
+// variant's kept, so the per-variant executables can update it in turn.
+static bool write_baseline(const char *path, const bench_result_t *results, uint32_t result_count)
+{
+    static baseline_entry_t entries[BENCH_MAX_BASELINE_LINES];
+    const uint32_t count = load_baseline(path, entries, BENCH_MAX_BASELINE_LINES);
+    FILE *f = fopen(path, "w");
+    if (f == NULL) {
+        fprintf(stderr, "%s: cannot create\n", path);
+        return false;
+    }
+    fprintf(f, "# Kernel cost relative to the neopico_bench calibration step (ns per pixel or\n"
+               "# sample / ns per step), per build variant. Regenerate on an idle machine with\n"
+               "#   cmake --build build-host --target bench-baseline\n"
+               "# and commit it together with the change that moved the numbers.\n");
+    for (uint32_t i = 0; i < count; i++) {
+        if (strcmp(entries[i].variant, NEOPICO_BENCH_VARIANT) != 0) {
+            fprintf(f, "%s %s %.4f\n", entries[i].variant, entries[i].kernel, entries[i].rel);
+        }
+    }
+    for (uint32_t i = 0; i < result_count; i++) {
+        fprintf(f, "%s %s %.4f\n", NEOPICO_BENCH_VARIANT, results[i].kernel->name, results[i].rel);
+    }
+    return fclose(f) == 0;
+}
+
+// =============================================================================
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr,
+            "usage: %s [--baseline FILE] [--write-baseline FILE] [--tolerance PCT] [--quick]\n"
+            "  --baseline FILE        fail if any kernel is over its baseline cost\n"
+            "  --write-baseline FILE  record this variant's costs into FILE\n"
+            "  --tolerance PCT        allowed slowdown over the baseline (default %.0f)\n"
+            "  --quick                one call per kernel; only check the baseline lists it\n",
+            argv0, BENCH_DEFAULT_TOLERANCE_PCT);
+}
+
+int main(int argc, char **argv)
+{
+    const char *baseline_path = NULL;
+    const char *write_path = NULL;
+    double tolerance = BENCH_DEFAULT_TOLERANCE_PCT;
+    bool quick = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *val = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(arg, "--baseline") == 0 && val) {
+            baseline_path = val;
+            i++;
+        } else if (strcmp(arg, "--write-baseline") == 0 && val) {
+            write_path = val;
+            i++;
+        } else if (strcmp(arg, "--tolerance") == 0 && val) {
+            tolerance = strtod(val, NULL);
+            i++;
+        } else if (strcmp(arg, "--quick") == 0) {
+            quick = true;
+        } else {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // The scale kernels read the LUTs video_pipeline_init() builds.
+    pico_host_reset();
+    video_output_set_mode(&video_mode_480_p);
+    video_pipeline_init(640, 480);
+    video_pipeline_set_scanline_level(VIDEO_PIPELINE_SCANLINE_OFF);
+    prepare_inputs();
+
+    static baseline_entry_t baseline[BENCH_MAX_BASELINE_LINES];
+    const uint32_t baseline_count =
+        baseline_path != NULL ? load_baseline(baseline_path, baseline, BENCH_MAX_BASELINE_LINES) : 0U;
+    if (baseline_path != NULL && baseline_count == 0U) {
+        fprintf(stderr, "%s: no baseline entries\n", baseline_path);
+        return EXIT_FAILURE;
+    }
+
+    printf("%s%s\n", NEOPICO_BENCH_VARIANT, quick ? " (quick, untimed)" : "");
+    printf("%-32s %10s %8s %-6s %8s %8s %7s %9s %8s\n", "kernel", "ns/call", "ns/unit", "unit", "rel", "bytes",
+           "GB/s", "baseline", "delta");
+
+    const double limit = 1.0 + (tolerance / 100.0);
+    static bench_result_t results[BENCH_MAX_KERNELS];
+    unsigned regressions = 0;
+    unsigned missing = 0;
+    for (uint32_t k = 0; k < KERNEL_COUNT; k++) {
+        const bench_kernel_t *kernel = &g_kernels[k];
+        bench_result_t *r = &results[k];
+        r->kernel = kernel;
+        double step_ns = 0.0;
+        time_kernel(kernel->run, quick, &r->ns_per_call, &step_ns);
+        r->rel = (r->ns_per_call / kernel->units) / step_ns;
+
+        // A slow reading is re-measured before it counts, and a new baseline
+        // is the best of several: host timing has outliers that the per-run
+        // minimum does not always reject.
+        const baseline_entry_t *base = find_baseline(baseline, baseline_count, kernel->name);
+        for (uint32_t retry = 0; !quick && retry < BENCH_CONFIRM_RUNS; retry++) {
+            if (write_path == NULL && (base == NULL || r->rel <= base->rel * limit)) {
+                break;
+            }
+            double ns_per_call = 0.0;
+            time_kernel(kernel->run, false, &ns_per_call, &step_ns);
+            const double rel = (ns_per_call / kernel->units) / step_ns;
+            if (rel < r->rel) {
+                r->ns_per_call = ns_per_call;
+                r->rel = rel;
+            }
+        }
+
+        printf("%-32s %10.1f %8.3f %-6s %8.3f %8" PRIu32 " %7.2f", kernel->name, r->ns_per_call,
+               r->ns_per_call / kernel->units, kernel->unit, r->rel, kernel->bytes,
+               (double)kernel->bytes / r->ns_per_call);
+        if (baseline_path == NULL) {
+            printf("\n");
+        } else if (base == NULL) {
+            printf(" %9s\n", "MISSING");
+            missing++;
+        } else {
+            const double delta = ((r->rel / base->rel) - 1.0) * 100.0;
+            const bool regressed = !quick && delta > tolerance;
+            printf(" %9.3f %+7.1f%%%s\n", base->rel, delta, regressed ? "  REGRESSION" : "");
+            regressions += regressed ? 1U : 0U;
+        }
+    }
+
+    if (write_path != NULL && !quick) {
+        if (!write_baseline(write_path, results, KERNEL_COUNT)) {
+            return EXIT_FAILURE;
+        }
+        printf("%s: wrote %zu %s entries\n", write_path, KERNEL_COUNT, NEOPICO_BENCH_VARIANT);
+    }
+    if (missing != 0U) {
+        fprintf(stderr, "FAIL: %u kernels have no %s entry in %s\n", missing, NEOPICO_BENCH_VARIANT, baseline_path);
+        return EXIT_FAILURE;
+    }
+    if (regressions != 0U) {
+        fprintf(stderr, "FAIL: %u kernels more than %.0f%% over the %s baseline\n", regressions, tolerance,
+                NEOPICO_BENCH_VARIANT);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,233 @@
+#!/usr/bin/env python3
+"""Check the host build's copies of the pioasm output against the .pio sources.
+
+The host build has no pioasm, so tests/host/include carries hand-copied
+headers for the PIO programs the emulator runs. This assembles each .pio
+source for the instruction subset the firmware uses and fails if a copy's
+opcodes, wrap, public label offsets, length or c-sdk block no longer match:
+a retuned `nop`, threshold or `in` width must reach the copy, or the host
+tests would keep checking the old program.
+
+Usage: check_pio_headers.py [REPO_ROOT]
+"""
+
+import re
+import sys
+from pathlib import Path
+
+
+REPO = Path(sys.argv[1]).resolve() if len(sys.argv) > 1 else Path(__file__).resolve().parents[1]
+
+# .pio source -> host copy of its pioasm output.
+PAIRS = [
+    ("src/video/video_capture_mvs.pio", "tests/host/include/video_capture_mvs.pio.h"),
+    ("src/video/video_capture_snes.pio", "tests/host/include/video_capture_snes.pio.h"),
+    ("src/audio/i2s_capture.pio", "tests/host/include/i2s_capture.pio.h"),
+]
+
+JMP_CONDITIONS = {"": 0, "!x": 1, "x--": 2, "!y": 3, "y--": 4, "x!=y": 5, "pin": 6, "!osre": 7}
+WAIT_SOURCES = {"gpio": 0, "pin": 1, "irq": 2}
+IN_SOURCES = {"pins": 0, "x": 1, "y": 2, "null": 3, "isr": 6, "osr": 7}
+OUT_DESTINATIONS = {"pins": 0, "x": 1, "y": 2, "null": 3, "pindirs": 4, "pc": 5, "isr": 6, "exec": 7}
+MOV_DESTINATIONS = {"pins": 0, "x": 1, "y": 2, "exec": 4, "pc": 5, "isr": 6, "osr": 7}
+MOV_SOURCES = {"pins": 0, "x": 1, "y": 2, "null": 3, "status": 5, "isr": 6, "osr": 7}
+SET_DESTINATIONS = {"pins": 0, "x": 1, "y": 2, "pindirs": 4}
+
+
+class PioError(Exception):
+    pass
+
+
+def number(token: str) -> int:
+    try:
+        return int(token, 0)
+    except ValueError:
+        raise PioError(f"not a number: {token!r}") from None
+
+
+def lookup(table: dict, token: str, what: str) -> int:
+    if token not in table:
+        raise PioError(f"unknown {what} {token!r}")
+    return table[token]
+
+
+def bit_count(token: str) -> int:
+    count = number(token)
+    if not 1 <= count <= 32:
+        raise PioError(f"bit count {count} out of range")
+    return count & 0x1F
+
+
+def encode(text: str, labels: dict) -> int:
+    """One instruction, delay included; no side-set (none of the sources use it)."""
+    delay = 0
+    match = re.fullmatch(r"(.*?)\s*\[\s*(\w+)\s*\]", text)
+    if match:
+        text, delay = match.group(1), number(match.group(2))
+        if delay > 31:
+            raise PioError(f"delay {delay} out of range")
+    words = text.replace(",", " ").split()
+    op, args = words[0], words[1:]
+
+    if op == "nop" and not args:
+        word = 0xA042  # mov y, y
+    elif op == "jmp":
+        condition = args[0] if len(args) == 2 else ""
+        target = args[-1]
+        address = labels[target] if target in labels else number(target)
+        word = 0x0000 | (lookup(JMP_CONDITIONS, condition, "jmp condition") << 5) | address
+    elif op == "wait":
+        polarity, source, index = args[0], args[1], args[2]
+        index_bits = number(index)
+        if len(args) == 4 and args[3] == "rel":
+            index_bits |= 0x10
+        elif len(args) != 3:
+            raise PioError(f"unsupported wait {text!r}")
+        word = 0x2000 | (number(polarity) << 7) | (lookup(WAIT_SOURCES, source, "wait source") << 5) | index_bits
+    elif op == "in":
+        word = 0x4000 | (lookup(IN_SOURCES, args[0], "in source") << 5) | bit_count(args[1])
+    elif op == "out":
+        word = 0x6000 | (lookup(OUT_DESTINATIONS, args[0], "out destination") << 5) | bit_count(args[1])
+    elif op in ("push", "pull"):
+        flags = set(args)
+        if not flags <= {"iffull", "ifempty", "block", "noblock"}:
+            raise PioError(f"unsupported {op} {text!r}")
+        word = 0x8000 | (0x80 if op == "pull" else 0)
+        word |= 0x40 if flags & {"iffull", "ifempty"} else 0
+        word |= 0 if "noblock" in flags else 0x20
+    elif op == "mov":
+        destination, source = args[0], "".join(args[1:])
+        operation = 0
+        if source.startswith(("!", "~")):
+            operation, source = 1, source[1:]
+        elif source.startswith("::"):
+            operation, source = 2, source[2:]
+        word = 0xA000 | (lookup(MOV_DESTINATIONS, destination, "mov destination") << 5) | (operation << 3)
+        word |= lookup(MOV_SOURCES, source, "mov source")
+    elif op == "irq":
+        mode = args[0] if len(args) == 2 else "set"
+        index = number(args[-1])
+        modes = {"set": 0, "nowait": 0, "wait": 0x20, "clear": 0x40}
+        word = 0xC000 | lookup(modes, mode, "irq mode") | index
+    elif op == "set":
+        word = 0xE000 | (lookup(SET_DESTINATIONS, args[0], "set destination") << 5) | number(args[1])
+    else:
+        raise PioError(f"unsupported instruction {text!r}")
+    return word | (delay << 8)
+
+
+def assemble(source: str) -> dict:
+    """Programs in a .pio file: name -> instructions, wrap, public offsets, c-sdk lines."""
+    programs = {}
+    program = None
+    in_block = False
+    for raw in source.splitlines():
+        line = raw.split(";", 1)[0].split("//", 1)[0].strip()
+        if in_block:
+            if raw.strip() == "%}":
+                in_block = False
+            elif program is not None and raw.strip():
+                program["c_sdk"].append(raw.strip())
+            continue
+        if not line:
+            continue
+        if line.startswith("%"):
+            if not re.fullmatch(r"%\s*c-sdk\s*\{", line):
+                raise PioError(f"unsupported block {line!r}")
+            in_block = True
+            continue
+        if line.startswith(".program"):
+            name = line.split()[1]
+            program = {"lines": [], "labels": {}, "public": {}, "wrap_target": None, "wrap": None, "c_sdk": []}
+            programs[name] = program
+            continue
+        if program is None:
+            raise PioError(f"{line!r} outside a program")
+        if line == ".wrap_target":
+            program["wrap_target"] = len(program["lines"])
+        elif line == ".wrap":
+            program["wrap"] = len(program["lines"]) - 1
+        elif line.startswith("."):
+            raise PioError(f"unsupported directive {line!r}")
+        elif line.endswith(":"):
+            label = line[:-1].split()
+            program["labels"][label[-1]] = len(program["lines"])
+            if label[0] == "public":
+                program["public"][label[-1]] = len(program["lines"])
+        else:
+            program["lines"].append(line)
+
+    for program in programs.values():
+        program["instructions"] = [encode(line, program["labels"]) for line in program["lines"]]
+        if program["wrap_target"] is None:
+            program["wrap_target"] = 0
+        if program["wrap"] is None:
+            program["wrap"] = len(program["instructions"]) - 1
+    return programs
+
+
+def check_copy(name: str, program: dict, header: str, context: str) -> list:
+    failures = []
+    table = re.search(rf"{name}_program_instructions\[\]\s*=\s*\{{(.*?)\}};", header, re.S)
+    if table is None:
+        return [f"{context}: no {name}_program_instructions"]
+    copied = [int(word, 16) for word in re.findall(r"0x([0-9a-fA-F]{4}),", table.group(1))]
+    for i, (want, have) in enumerate(zip(program["instructions"], copied)):
+        if want != have:
+            line = program["lines"][i]
+            failures.append(f"{context}: {name}[{i}] `{line}` is 0x{want:04x}, the copy has 0x{have:04x}")
+    if len(copied) != len(program["instructions"]):
+        failures.append(f"{context}: {name} has {len(program['instructions'])} instructions, the copy {len(copied)}")
+
+    def define(suffix: str):
+        match = re.search(rf"#define {name}_{suffix} (\d+)u?\b", header)
+        return int(match.group(1)) if match else None
+
+    for suffix in ("wrap_target", "wrap"):
+        if define(suffix) != program[suffix]:
+            failures.append(f"{context}: {name}_{suffix} is {program[suffix]}, the copy has {define(suffix)}")
+    for label, offset in program["public"].items():
+        if define(f"offset_{label}") != offset:
+            failures.append(f"{context}: {name}_offset_{label} is {offset}, the copy has {define(f'offset_{label}')}")
+    length = re.search(rf"{name}_program\s*=\s*\{{.*?\.length = (\d+)", header, re.S)
+    if length is None or int(length.group(1)) != len(program["instructions"]):
+        failures.append(f"{context}: {name}_program.length does not match")
+
+    # pioasm copies the c-sdk block verbatim after the program.
+    position = 0
+    lines = [line.strip() for line in header.splitlines()]
+    for wanted in program["c_sdk"]:
+        try:
+            position = lines.index(wanted, position) + 1
+        except ValueError:
+            failures.append(f"{context}: {name} c-sdk line missing or out of order: {wanted!r}")
+            break
+    return failures
+
+
+def main() -> None:
+    failures = []
+    checked = 0
+    for source_path, header_path in PAIRS:
+        source = (REPO / source_path).read_text()
+        header = (REPO / header_path).read_text()
+        try:
+            programs = assemble(source)
+        except PioError as error:
+            raise SystemExit(f"FAIL: {source_path}: {error}; extend tests/check_pio_headers.py") from None
+        for name, program in programs.items():
+            failures += check_copy(name, program, header, header_path)
+            checked += 1
+        for name in re.findall(r"(\w+)_program_instructions\[\]", header):
+            if name not in programs:
+                failures.append(f"{header_path}: {name} is not in {source_path}")
+
+    if failures:
+        for failure in failures:
+            print(f"FAIL: {failure}", file=sys.stderr)
+        raise SystemExit(f"FAIL: {len(failures)} differences; regenerate the copies with pioasm")
+    print(f"PASS: {checked} PIO programs match their host copies.")
+
+
+if __name__ == "__main__":
+    main()
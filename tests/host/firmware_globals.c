@@ -0,0 +1,10 @@
+// Definitions main.c owns on the target.
+
+#include "line_ring.h"
+
+// main.c picks the depth at boot; the host harnesses run the full ring.
+line_ring_t g_line_ring;
+
+#if NEOPICO_DIAG_COUNTERS
+line_ring_diag_t g_line_ring_diag;
+#endif
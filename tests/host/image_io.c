@@ -0,0 +1,410 @@
+// PPM and PNG reading and writing for the host tools. See image_io.h.
+
+#include "image_io.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if NEOPICO_HOST_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+bool host_image_alloc(host_image_t *image, uint32_t width, uint32_t height)
+{
+    image->width = width;
+    image->height = height;
+    image->rgb = calloc((size_t)width * height, 3U);
+    if (image->rgb == NULL && width != 0U && height != 0U) {
+        fprintf(stderr, "image: out of memory for %ux%u\n", (unsigned)width, (unsigned)height);
+        return false;
+    }
+    return true;
+}
+
+void host_image_free(host_image_t *image)
+{
+    free(image->rgb);
+    image->rgb = NULL;
+    image->width = 0;
+    image->height = 0;
+}
+
+static uint8_t *read_file(const char *path, size_t *size)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return NULL;
+    }
+    uint8_t *data = NULL;
+    size_t len = 0;
+    size_t cap = 0;
+    for (;;) {
+        if (len == cap) {
+            cap = cap ? cap * 2U : 65536U;
+            uint8_t *grown = realloc(data, cap);
+            if (grown == NULL) {
+                free(data);
+                fclose(f);
+                fprintf(stderr, "%s: out of memory\n", path);
+                return NULL;
+            }
+            data = grown;
+        }
+        const size_t n = fread(data + len, 1, cap - len, f);
+        len += n;
+        if (n == 0U) {
+            break;
+        }
+    }
+    fclose(f);
+    *size = len;
+    return data;
+}
+
+// =============================================================================
+// PPM
+// =============================================================================
+
+static bool ppm_field(const uint8_t *data, size_t size, size_t *pos, uint32_t *value)
+{
+    // Whitespace and '#' comments separate header fields.
+    while (*pos < size) {
+        if (data[*pos] == '#') {
+            while (*pos < size && data[*pos] != '\n') {
+                (*pos)++;
+            }
+        } else if (data[*pos] == ' ' || data[*pos] == '\t' || data[*pos] == '\r' || data[*pos] == '\n') {
+            (*pos)++;
+        } else {
+            break;
+        }
+    }
+    uint32_t v = 0;
+    size_t digits = 0;
+    while (*pos < size && data[*pos] >= '0' && data[*pos] <= '9' && digits < 9U) {
+        v = (v * 10U) + (uint32_t)(data[*pos] - '0');
+        (*pos)++;
+        digits++;
+    }
+    *value = v;
+    return digits > 0U;
+}
+
+static bool ppm_decode(const char *path, const uint8_t *data, size_t size, host_image_t *image)
+{
+    size_t pos = 2;
+    uint32_t width;
+    uint32_t height;
+    uint32_t maxval;
+    if (!ppm_field(data, size, &pos, &width) || !ppm_field(data, size, &pos, &height) ||
+        !ppm_field(data, size, &pos, &maxval) || pos >= size) {
+        fprintf(stderr, "%s: malformed PPM header\n", path);
+        return false;
+    }
+    pos++; // single whitespace before the raster
+    if (maxval != 255U) {
+        fprintf(stderr, "%s: only 8-bit PPM is supported (maxval %u)\n", path, (unsigned)maxval);
+        return false;
+    }
+    const size_t bytes = (size_t)width * height * 3U;
+    if (size - pos < bytes) {
+        fprintf(stderr, "%s: PPM raster truncated\n", path);
+        return false;
+    }
+    if (!host_image_alloc(image, width, height)) {
+        return false;
+    }
+    memcpy(image->rgb, data + pos, bytes);
+    return true;
+}
+
+bool host_image_save_ppm(const char *path, const host_image_t *image)
+{
+    FILE *f = fopen(path, "wb");
+    if (f == NULL) {
+        fprintf(stderr, "%s: cannot create\n", path);
+        return false;
+    }
+    fprintf(f, "P6\n%u %u\n255\n", (unsigned)image->width, (unsigned)image->height);
+    const size_t bytes = (size_t)image->width * image->height * 3U;
+    const bool ok = fwrite(image->rgb, 1, bytes, f) == bytes;
+    if (fclose(f) != 0 || !ok) {
+        fprintf(stderr, "%s: write failed\n", path);
+        return false;
+    }
+    return true;
+}
+
+// =============================================================================
+// PNG
+// =============================================================================
+
+static const uint8_t k_png_signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+#if NEOPICO_HOST_HAVE_ZLIB
+
+static uint32_t be32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static void put_be32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static uint8_t paeth(uint8_t a, uint8_t b, uint8_t c)
+{
+    const int p = (int)a + (int)b - (int)c;
+    const int pa = abs(p - (int)a);
+    const int pb = abs(p - (int)b);
+    const int pc = abs(p - (int)c);
+    if (pa <= pb && pa <= pc) {
+        return a;
+    }
+    return pb <= pc ? b : c;
+}
+
+// Undo the per-row filters in place. `raw` holds height rows of a filter
+// byte followed by `stride` bytes; `bpp` is bytes per pixel (at least 1).
+static bool png_unfilter(uint8_t *raw, uint32_t height, size_t stride, size_t bpp)
+{
+    const uint8_t *prev = NULL;
+    for (uint32_t y = 0; y < height; y++) {
+        uint8_t *row = raw + (y * (stride + 1U));
+        const uint8_t filter = row[0];
+        uint8_t *cur = row + 1;
+        for (size_t i = 0; i < stride; i++) {
+            const uint8_t a = i >= bpp ? cur[i - bpp] : 0U;
+            const uint8_t b = prev ? prev[i] : 0U;
+            const uint8_t c = (prev && i >= bpp) ? prev[i - bpp] : 0U;
+            switch (filter) {
+                case 0: break;
+                case 1: cur[i] = (uint8_t)(cur[i] + a); break;
+                case 2: cur[i] = (uint8_t)(cur[i] + b); break;
+                case 3: cur[i] = (uint8_t)(cur[i] + ((a + b) >> 1)); break;
+                case 4: cur[i] = (uint8_t)(cur[i] + paeth(a, b, c)); break;
+                default: return false;
+            }
+        }
+        prev = cur;
+    }
+    return true;
+}
+
+static bool png_decode(const char *path, const uint8_t *data, size_t size, host_image_t *image)
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint8_t depth = 0;
+    uint8_t color_type = 0;
+    uint8_t palette[256 * 3];
+    uint32_t palette_entries = 0;
+    uint8_t *idat = NULL;
+    size_t idat_len = 0;
+    bool ok = false;
+
+    size_t pos = sizeof k_png_signature;
+    while (pos + 12U <= size) {
+        const uint32_t len = be32(data + pos);
+        const uint8_t *type = data + pos + 4U;
+        const uint8_t *body = data + pos + 8U;
+        if (len > size - pos - 12U) {
+            fprintf(stderr, "%s: PNG chunk overruns the file\n", path);
+            goto done;
+        }
+        if (memcmp(type, "IHDR", 4) == 0 && len >= 13U) {
+            width = be32(body);
+            height = be32(body + 4);
+            depth = body[8];
+            color_type = body[9];
+            if (body[12] != 0U) {
+                fprintf(stderr, "%s: interlaced PNG is not supported\n", path);
+                goto done;
+            }
+        } else if (memcmp(type, "PLTE", 4) == 0) {
+            palette_entries = len / 3U > 256U ? 256U : len / 3U;
+            memcpy(palette, body, palette_entries * 3U);
+        } else if (memcmp(type, "IDAT", 4) == 0) {
+            uint8_t *grown = realloc(idat, idat_len + len);
+            if (grown == NULL) {
+                fprintf(stderr, "%s: out of memory\n", path);
+                goto done;
+            }
+            idat = grown;
+            memcpy(idat + idat_len, body, len);
+            idat_len += len;
+        } else if (memcmp(type, "IEND", 4) == 0) {
+            break;
+        }
+        pos += 12U + len;
+    }
+
+    static const uint8_t k_channels[7] = {1, 0, 3, 1, 2, 0, 4};
+    const uint32_t channels = color_type < 7U ? k_channels[color_type] : 0U;
+    const bool depth_ok = color_type == 3U ? depth == 8U : (depth == 8U || depth == 16U);
+    if (width == 0U || height == 0U || channels == 0U || !depth_ok) {
+        fprintf(stderr, "%s: unsupported PNG (colour type %u, depth %u)\n", path, color_type, depth);
+        goto done;
+    }
+
+    const size_t bpp = (size_t)channels * (depth / 8U);
+    const size_t stride = (size_t)width * bpp;
+    uLongf raw_len = (uLongf)((stride + 1U) * height);
+    uint8_t *raw = malloc(raw_len);
+    if (raw == NULL || uncompress(raw, &raw_len, idat, (uLong)idat_len) != Z_OK ||
+        raw_len != (stride + 1U) * height || !png_unfilter(raw, height, stride, bpp)) {
+        fprintf(stderr, "%s: corrupt PNG image data\n", path);
+        free(raw);
+        goto done;
+    }
+    if (!host_image_alloc(image, width, height)) {
+        free(raw);
+        goto done;
+    }
+
+    // 16-bit samples keep their most significant byte.
+    const size_t step = depth / 8U;
+    for (uint32_t y = 0; y < height; y++) {
+        const uint8_t *row = raw + (y * (stride + 1U)) + 1U;
+        for (uint32_t x = 0; x < width; x++) {
+            const uint8_t *px = row + (x * bpp);
+            uint8_t *out = &image->rgb[(((size_t)y * width) + x) * 3U];
+            if (color_type == 3U) {
+                const uint32_t idx = px[0] < palette_entries ? px[0] : 0U;
+                memcpy(out, &palette[idx * 3U], 3);
+            } else if (channels <= 2U) {
+                out[0] = out[1] = out[2] = px[0];
+            } else {
+                out[0] = px[0];
+                out[1] = px[step];
+                out[2] = px[2U * step];
+            }
+        }
+    }
+    free(raw);
+    ok = true;
+
+done:
+    free(idat);
+    return ok;
+}
+
+static bool png_chunk(FILE *f, const char *type, const uint8_t *body, uint32_t len)
+{
+    uint8_t header[8];
+    put_be32(header, len);
+    memcpy(header + 4, type, 4);
+    uLong crc = crc32(0L, header + 4, 4);
+    crc = crc32(crc, body, len);
+    uint8_t trailer[4];
+    put_be32(trailer, (uint32_t)crc);
+    return fwrite(header, 1, 8, f) == 8U && (len == 0U || fwrite(body, 1, len, f) == len) &&
+           fwrite(trailer, 1, 4, f) == 4U;
+}
+
+bool host_image_save_png(const char *path, const host_image_t *image)
+{
+    const size_t stride = (size_t)image->width * 3U;
+    const size_t raw_len = (stride + 1U) * image->height;
+    uint8_t *raw = malloc(raw_len);
+    uLongf packed_len = compressBound((uLong)raw_len);
+    uint8_t *packed = malloc(packed_len);
+    if (raw == NULL || packed == NULL) {
+        free(raw);
+        free(packed);
+        fprintf(stderr, "%s: out of memory\n", path);
+        return false;
+    }
+    for (uint32_t y = 0; y < image->height; y++) {
+        raw[y * (stride + 1U)] = 0; // filter: none
+        memcpy(raw + (y * (stride + 1U)) + 1U, image->rgb + (y * stride), stride);
+    }
+    const bool packed_ok = compress2(packed, &packed_len, raw, (uLong)raw_len, 6) == Z_OK;
+    free(raw);
+
+    uint8_t ihdr[13];
+    put_be32(ihdr, image->width);
+    put_be32(ihdr + 4, image->height);
+    ihdr[8] = 8;  // bit depth
+    ihdr[9] = 2;  // truecolour
+    ihdr[10] = 0; // deflate
+    ihdr[11] = 0; // adaptive filtering
+    ihdr[12] = 0; // not interlaced
+
+    FILE *f = packed_ok ? fopen(path, "wb") : NULL;
+    if (f == NULL) {
+        free(packed);
+        fprintf(stderr, "%s: cannot create\n", path);
+        return false;
+    }
+    bool ok = fwrite(k_png_signature, 1, sizeof k_png_signature, f) == sizeof k_png_signature &&
+              png_chunk(f, "IHDR", ihdr, sizeof ihdr) && png_chunk(f, "IDAT", packed, (uint32_t)packed_len) &&
+              png_chunk(f, "IEND", NULL, 0);
+    free(packed);
+    if (fclose(f) != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        fprintf(stderr, "%s: write failed\n", path);
+    }
+    return ok;
+}
+
+#else
+
+static bool png_decode(const char *path, const uint8_t *data, size_t size, host_image_t *image)
+{
+    (void)data;
+    (void)size;
+    (void)image;
+    fprintf(stderr, "%s: PNG support needs zlib; convert to PPM or rebuild with zlib\n", path);
+    return false;
+}
+
+bool host_image_save_png(const char *path, const host_image_t *image)
+{
+    (void)image;
+    fprintf(stderr, "%s: PNG support needs zlib; save as .ppm instead\n", path);
+    return false;
+}
+
+#endif
+
+// =============================================================================
+// Dispatch
+// =============================================================================
+
+bool host_image_load(const char *path, host_image_t *image)
+{
+    size_t size = 0;
+    uint8_t *data = read_file(path, &size);
+    if (data == NULL) {
+        return false;
+    }
+    bool ok;
+    if (size >= sizeof k_png_signature && memcmp(data, k_png_signature, sizeof k_png_signature) == 0) {
+        ok = png_decode(path, data, size, image);
+    } else if (size >= 2U && data[0] == 'P' && data[1] == '6') {
+        ok = ppm_decode(path, data, size, image);
+    } else {
+        fprintf(stderr, "%s: not a PNG or binary PPM file\n", path);
+        ok = false;
+    }
+    free(data);
+    return ok;
+}
+
+bool host_image_save(const char *path, const host_image_t *image)
+{
+    const size_t len = strlen(path);
+    if (len >= 4U && strcmp(path + len - 4U, ".png") == 0) {
+        return host_image_save_png(path, image);
+    }
+    return host_image_save_ppm(path, image);
+}
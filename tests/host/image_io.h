@@ -0,0 +1,30 @@
+// Minimal RGB888 image files for the host tools: binary PPM (P6) always, PNG
+// when the host build found zlib (NEOPICO_HOST_HAVE_ZLIB). Errors are
+// reported on stderr and returned as false.
+#ifndef NEOPICO_HOST_IMAGE_IO_H
+#define NEOPICO_HOST_IMAGE_IO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct {
+    uint32_t width;
+    uint32_t height;
+    uint8_t *rgb; // width * height * 3, row-major
+} host_image_t;
+
+// Allocates a black image.
+bool host_image_alloc(host_image_t *image, uint32_t width, uint32_t height);
+void host_image_free(host_image_t *image);
+
+// Reads a PPM or PNG, chosen by the file's magic bytes. PNG input may be
+// 8- or 16-bit grey, RGB, palette or with alpha (dropped); not interlaced.
+bool host_image_load(const char *path, host_image_t *image);
+
+bool host_image_save_ppm(const char *path, const host_image_t *image);
+bool host_image_save_png(const char *path, const host_image_t *image);
+
+// Saves as PNG when `path` ends in ".png", PPM otherwise.
+bool host_image_save(const char *path, const host_image_t *image);
+
+#endif // NEOPICO_HOST_IMAGE_IO_H
@@ -0,0 +1,20 @@
+#ifndef NEOPICO_HOST_HARDWARE_CLOCKS_H
+#define NEOPICO_HOST_HARDWARE_CLOCKS_H
+
+#include "pico/types.h"
+
+enum clock_index {
+    clk_gpout0 = 0,
+    clk_ref = 4,
+    clk_sys = 5,
+    clk_peri = 6,
+    clk_hstx = 7,
+    clk_usb = 8,
+    clk_adc = 9,
+};
+
+// Returns the system clock set with pico_host_set_sys_clock_hz() (126 MHz,
+// the 240p/60 Hz capture clock, by default).
+uint32_t clock_get_hz(enum clock_index clk_index);
+
+#endif // NEOPICO_HOST_HARDWARE_CLOCKS_H
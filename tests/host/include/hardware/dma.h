@@ -0,0 +1,175 @@
+// Host shim for hardware/dma.h. Control words use the RP2350 CTRL_TRIG bit
+// layout. Paced transfers never move on their own: the host model feeds words
+// into a channel with pico_host_dma_write(), which honours write increment,
+// write ring wrapping, transfer counts and CHAIN_TO exactly as the engine
+// would. DREQ_FORCE channels run to completion when triggered, and their
+// writes into channel registers reprogram (and trigger) that channel.
+#ifndef NEOPICO_HOST_HARDWARE_DMA_H
+#define NEOPICO_HOST_HARDWARE_DMA_H
+
+#include "pico.h"
+#include "pico/types.h"
+
+#define NUM_DMA_CHANNELS 16U
+
+#define DMA_CH0_CTRL_TRIG_EN_LSB 0U
+#define DMA_CH0_CTRL_TRIG_HIGH_PRIORITY_LSB 1U
+#define DMA_CH0_CTRL_TRIG_DATA_SIZE_LSB 2U
+#define DMA_CH0_CTRL_TRIG_DATA_SIZE_BITS 0x0000000cU
+#define DMA_CH0_CTRL_TRIG_INCR_READ_LSB 4U
+#define DMA_CH0_CTRL_TRIG_INCR_WRITE_LSB 6U
+#define DMA_CH0_CTRL_TRIG_RING_SIZE_LSB 8U
+#define DMA_CH0_CTRL_TRIG_RING_SIZE_BITS 0x00000f00U
+#define DMA_CH0_CTRL_TRIG_RING_SEL_LSB 12U
+#define DMA_CH0_CTRL_TRIG_CHAIN_TO_LSB 13U
+#define DMA_CH0_CTRL_TRIG_CHAIN_TO_BITS 0x0001e000U
+#define DMA_CH0_CTRL_TRIG_TREQ_SEL_LSB 17U
+#define DMA_CH0_CTRL_TRIG_TREQ_SEL_BITS 0x007e0000U
+#define DMA_CH0_CTRL_TRIG_IRQ_QUIET_LSB 23U
+#define DMA_CH0_CTRL_TRIG_BSWAP_LSB 24U
+#define DMA_CH0_CTRL_TRIG_BUSY_LSB 26U
+
+#define DREQ_FORCE 0x3fU
+
+enum dma_channel_transfer_size {
+    DMA_SIZE_8 = 0,
+    DMA_SIZE_16 = 1,
+    DMA_SIZE_32 = 2,
+};
+
+typedef struct {
+    volatile uint32_t read_addr;
+    volatile uint32_t write_addr;
+    volatile uint32_t transfer_count;
+    volatile uint32_t ctrl_trig;
+    volatile uint32_t al1_ctrl;
+    volatile uint32_t al1_read_addr;
+    volatile uint32_t al1_write_addr;
+    volatile uint32_t al1_transfer_count_trig;
+    volatile uint32_t al2_ctrl;
+    volatile uint32_t al2_transfer_count;
+    volatile uint32_t al2_read_addr;
+    volatile uint32_t al2_write_addr_trig;
+    volatile uint32_t al3_ctrl;
+    volatile uint32_t al3_write_addr;
+    volatile uint32_t al3_transfer_count;
+    volatile uint32_t al3_read_addr_trig;
+} dma_channel_hw_t;
+
+// Address registers hold the low 32 bits of the host pointer. That keeps
+// firmware arithmetic such as i2s_capture_poll()'s (write_addr - buffer)
+// exact, because both operands are truncated the same way.
+// One block per DMA_IRQ_n line; INTR is the shared raw status in every one.
+typedef struct {
+    volatile uint32_t intr;
+    volatile uint32_t inte;
+    volatile uint32_t intf;
+    volatile uint32_t ints;
+} dma_irq_ctrl_hw_t;
+
+#define NUM_DMA_IRQS 4U
+
+typedef struct {
+    dma_channel_hw_t ch[NUM_DMA_CHANNELS];
+    dma_irq_ctrl_hw_t irq_ctrl[NUM_DMA_IRQS];
+} dma_hw_t;
+
+extern dma_hw_t pico_host_dma_hw;
+#define dma_hw (&pico_host_dma_hw)
+
+typedef struct {
+    uint32_t ctrl;
+} dma_channel_config;
+
+static inline void channel_config_set_read_increment(dma_channel_config *c, bool incr)
+{
+    c->ctrl = incr ? (c->ctrl | (1U << DMA_CH0_CTRL_TRIG_INCR_READ_LSB))
+                   : (c->ctrl & ~(1U << DMA_CH0_CTRL_TRIG_INCR_READ_LSB));
+}
+
+static inline void channel_config_set_write_increment(dma_channel_config *c, bool incr)
+{
+    c->ctrl = incr ? (c->ctrl | (1U << DMA_CH0_CTRL_TRIG_INCR_WRITE_LSB))
+                   : (c->ctrl & ~(1U << DMA_CH0_CTRL_TRIG_INCR_WRITE_LSB));
+}
+
+static inline void channel_config_set_dreq(dma_channel_config *c, uint dreq)
+{
+    c->ctrl = (c->ctrl & ~DMA_CH0_CTRL_TRIG_TREQ_SEL_BITS) | ((dreq & 0x3fU) << DMA_CH0_CTRL_TRIG_TREQ_SEL_LSB);
+}
+
+static inline void channel_config_set_chain_to(dma_channel_config *c, uint chain_to)
+{
+    c->ctrl = (c->ctrl & ~DMA_CH0_CTRL_TRIG_CHAIN_TO_BITS) | ((chain_to & 0xfU) << DMA_CH0_CTRL_TRIG_CHAIN_TO_LSB);
+}
+
+static inline void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size)
+{
+    c->ctrl = (c->ctrl & ~DMA_CH0_CTRL_TRIG_DATA_SIZE_BITS) | ((uint32_t)size << DMA_CH0_CTRL_TRIG_DATA_SIZE_LSB);
+}
+
+static inline void channel_config_set_ring(dma_channel_config *c, bool write, uint size_bits)
+{
+    c->ctrl = (c->ctrl & ~(DMA_CH0_CTRL_TRIG_RING_SIZE_BITS | (1U << DMA_CH0_CTRL_TRIG_RING_SEL_LSB))) |
+              ((size_bits & 0xfU) << DMA_CH0_CTRL_TRIG_RING_SIZE_LSB) |
+              ((write ? 1U : 0U) << DMA_CH0_CTRL_TRIG_RING_SEL_LSB);
+}
+
+static inline void channel_config_set_irq_quiet(dma_channel_config *c, bool irq_quiet)
+{
+    c->ctrl = irq_quiet ? (c->ctrl | (1U << DMA_CH0_CTRL_TRIG_IRQ_QUIET_LSB))
+                        : (c->ctrl & ~(1U << DMA_CH0_CTRL_TRIG_IRQ_QUIET_LSB));
+}
+
+static inline void channel_config_set_enable(dma_channel_config *c, bool enable)
+{
+    c->ctrl = enable ? (c->ctrl | (1U << DMA_CH0_CTRL_TRIG_EN_LSB)) : (c->ctrl & ~(1U << DMA_CH0_CTRL_TRIG_EN_LSB));
+}
+
+static inline dma_channel_config dma_channel_get_default_config(uint channel)
+{
+    dma_channel_config c = {0U};
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, DREQ_FORCE);
+    channel_config_set_chain_to(&c, channel);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_ring(&c, false, 0U);
+    channel_config_set_irq_quiet(&c, false);
+    channel_config_set_enable(&c, true);
+    return c;
+}
+
+// --- Implemented in pico_host.c ---------------------------------------------
+
+// Like gpio_get(), going through this to poll a channel's registers lets the
+// host model make progress (PICO_HOST_WAIT_DMA) before the read.
+dma_channel_hw_t *dma_channel_hw_addr(uint channel);
+
+int dma_claim_unused_channel(bool required);
+void dma_channel_claim(uint channel);
+void dma_channel_unclaim(uint channel);
+void dma_channel_set_config(uint channel, const dma_channel_config *config, bool trigger);
+void dma_channel_set_read_addr(uint channel, const volatile void *read_addr, bool trigger);
+void dma_channel_set_write_addr(uint channel, volatile void *write_addr, bool trigger);
+void dma_channel_set_trans_count(uint channel, uint32_t trans_count, bool trigger);
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint32_t transfer_count, bool trigger);
+void dma_channel_start(uint channel);
+void dma_channel_abort(uint channel);
+bool dma_channel_is_busy(uint channel);
+void dma_channel_wait_for_finish_blocking(uint channel);
+void dma_irqn_set_channel_enabled(uint irq_index, uint channel, bool enabled);
+void dma_irqn_acknowledge_channel(uint irq_index, uint channel);
+
+static inline void dma_channel_set_irq0_enabled(uint channel, bool enabled)
+{
+    dma_irqn_set_channel_enabled(0U, channel, enabled);
+}
+
+static inline void dma_channel_acknowledge_irq0(uint channel)
+{
+    dma_irqn_acknowledge_channel(0U, channel);
+}
+
+#endif // NEOPICO_HOST_HARDWARE_DMA_H
@@ -0,0 +1,12 @@
+#ifndef NEOPICO_HOST_HARDWARE_FLASH_H
+#define NEOPICO_HOST_HARDWARE_FLASH_H
+
+#include "pico.h"
+
+#define FLASH_PAGE_SIZE (1U << 8)
+#define FLASH_SECTOR_SIZE (1U << 12)
+
+void flash_range_erase(uint32_t flash_offs, size_t count);
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count);
+
+#endif // NEOPICO_HOST_HARDWARE_FLASH_H
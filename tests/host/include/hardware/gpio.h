@@ -0,0 +1,46 @@
+// GPIO configuration calls are accepted and ignored; gpio_get() reads the
+// host pin vector that tests and the signal models drive.
+#ifndef NEOPICO_HOST_HARDWARE_GPIO_H
+#define NEOPICO_HOST_HARDWARE_GPIO_H
+
+#include "pico/types.h"
+
+#define GPIO_IN false
+#define GPIO_OUT true
+
+bool gpio_get(uint gpio);
+
+static inline void gpio_init(uint gpio)
+{
+    (void)gpio;
+}
+
+static inline void gpio_set_dir(uint gpio, bool out)
+{
+    (void)gpio;
+    (void)out;
+}
+
+static inline void gpio_disable_pulls(uint gpio)
+{
+    (void)gpio;
+}
+
+static inline void gpio_pull_up(uint gpio)
+{
+    (void)gpio;
+}
+
+static inline void gpio_set_input_enabled(uint gpio, bool enabled)
+{
+    (void)gpio;
+    (void)enabled;
+}
+
+static inline void gpio_set_input_hysteresis_enabled(uint gpio, bool enabled)
+{
+    (void)gpio;
+    (void)enabled;
+}
+
+#endif // NEOPICO_HOST_HARDWARE_GPIO_H
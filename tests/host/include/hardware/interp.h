@@ -0,0 +1,153 @@
+// Host shim for hardware/interp.h: a bit-exact model of one core's two SIO
+// interpolators. Control words use the RP2350 SIO_INTERPx_CTRL_LANEy bit
+// layout. Each lane shifts its accumulator (or the other lane's, CROSS_INPUT)
+// right, masks it, optionally sign-extends from MASK_MSB and adds its base
+// (or the unshifted input, ADD_RAW); the full result is BASE2 plus both
+// lanes' masked values; FORCE_MSB ORs into the lane results the bus sees;
+// POP writes both lane results back to the accumulators (swapped per lane
+// with CROSS_RESULT). BLEND and CLAMP are not modelled and panic.
+//
+// There is no register block to poke: the firmware goes through the SDK's
+// accessors, which is also all it may do on the hardware for PEEK/POP.
+// Results are 32 bits like the hardware's. The PEEK/POP accessors return
+// them widened with the upper half of the firmware image's addresses, so a
+// lane whose base is a table's (truncated) address yields a pointer into that
+// table on the host, and a result stored into a uint32_t is the exact
+// hardware value. The interpolators are per core; the model is Core 0's.
+#ifndef NEOPICO_HOST_HARDWARE_INTERP_H
+#define NEOPICO_HOST_HARDWARE_INTERP_H
+
+#include "pico.h"
+#include "pico/types.h"
+
+#define SIO_INTERP0_CTRL_LANE0_SHIFT_LSB 0U
+#define SIO_INTERP0_CTRL_LANE0_SHIFT_BITS 0x0000001fU
+#define SIO_INTERP0_CTRL_LANE0_MASK_LSB_LSB 5U
+#define SIO_INTERP0_CTRL_LANE0_MASK_LSB_BITS 0x000003e0U
+#define SIO_INTERP0_CTRL_LANE0_MASK_MSB_LSB 10U
+#define SIO_INTERP0_CTRL_LANE0_MASK_MSB_BITS 0x00007c00U
+#define SIO_INTERP0_CTRL_LANE0_SIGNED_BITS 0x00008000U
+#define SIO_INTERP0_CTRL_LANE0_CROSS_INPUT_BITS 0x00010000U
+#define SIO_INTERP0_CTRL_LANE0_CROSS_RESULT_BITS 0x00020000U
+#define SIO_INTERP0_CTRL_LANE0_ADD_RAW_BITS 0x00040000U
+#define SIO_INTERP0_CTRL_LANE0_FORCE_MSB_LSB 19U
+#define SIO_INTERP0_CTRL_LANE0_FORCE_MSB_BITS 0x00180000U
+#define SIO_INTERP0_CTRL_LANE0_BLEND_BITS 0x00200000U
+#define SIO_INTERP1_CTRL_LANE0_CLAMP_BITS 0x00400000U
+
+typedef struct {
+    uint32_t accum[2];
+    uint32_t base[3];
+    uint32_t ctrl[2];
+} interp_hw_t;
+
+extern interp_hw_t pico_host_interp_hw[2];
+#define interp0 (&pico_host_interp_hw[0])
+#define interp1 (&pico_host_interp_hw[1])
+
+typedef struct {
+    uint32_t ctrl;
+} interp_config;
+
+static inline void interp_config_set_shift(interp_config *c, uint shift)
+{
+    c->ctrl = (c->ctrl & ~SIO_INTERP0_CTRL_LANE0_SHIFT_BITS) |
+              ((shift << SIO_INTERP0_CTRL_LANE0_SHIFT_LSB) & SIO_INTERP0_CTRL_LANE0_SHIFT_BITS);
+}
+
+static inline void interp_config_set_mask(interp_config *c, uint mask_lsb, uint mask_msb)
+{
+    c->ctrl = (c->ctrl & ~(SIO_INTERP0_CTRL_LANE0_MASK_LSB_BITS | SIO_INTERP0_CTRL_LANE0_MASK_MSB_BITS)) |
+              ((mask_lsb << SIO_INTERP0_CTRL_LANE0_MASK_LSB_LSB) & SIO_INTERP0_CTRL_LANE0_MASK_LSB_BITS) |
+              ((mask_msb << SIO_INTERP0_CTRL_LANE0_MASK_MSB_LSB) & SIO_INTERP0_CTRL_LANE0_MASK_MSB_BITS);
+}
+
+static inline void interp_config_set_flag(interp_config *c, uint32_t bits, bool set)
+{
+    c->ctrl = set ? (c->ctrl | bits) : (c->ctrl & ~bits);
+}
+
+static inline void interp_config_set_cross_input(interp_config *c, bool cross_input)
+{
+    interp_config_set_flag(c, SIO_INTERP0_CTRL_LANE0_CROSS_INPUT_BITS, cross_input);
+}
+
+static inline void interp_config_set_cross_result(interp_config *c, bool cross_result)
+{
+    interp_config_set_flag(c, SIO_INTERP0_CTRL_LANE0_CROSS_RESULT_BITS, cross_result);
+}
+
+static inline void interp_config_set_signed(interp_config *c, bool _signed)
+{
+    interp_config_set_flag(c, SIO_INTERP0_CTRL_LANE0_SIGNED_BITS, _signed);
+}
+
+static inline void interp_config_set_add_raw(interp_config *c, bool add_raw)
+{
+    interp_config_set_flag(c, SIO_INTERP0_CTRL_LANE0_ADD_RAW_BITS, add_raw);
+}
+
+static inline void interp_config_set_blend(interp_config *c, bool blend)
+{
+    interp_config_set_flag(c, SIO_INTERP0_CTRL_LANE0_BLEND_BITS, blend);
+}
+
+static inline void interp_config_set_clamp(interp_config *c, bool clamp)
+{
+    interp_config_set_flag(c, SIO_INTERP1_CTRL_LANE0_CLAMP_BITS, clamp);
+}
+
+static inline void interp_config_set_force_bits(interp_config *c, uint bits)
+{
+    c->ctrl = (c->ctrl & ~SIO_INTERP0_CTRL_LANE0_FORCE_MSB_BITS) |
+              ((bits << SIO_INTERP0_CTRL_LANE0_FORCE_MSB_LSB) & SIO_INTERP0_CTRL_LANE0_FORCE_MSB_BITS);
+}
+
+static inline interp_config interp_default_config(void)
+{
+    interp_config c = {0U};
+    interp_config_set_mask(&c, 0U, 31U);
+    return c;
+}
+
+static inline void interp_set_base(interp_hw_t *interp, uint lane, uint32_t val)
+{
+    interp->base[lane] = val;
+}
+
+static inline uint32_t interp_get_base(interp_hw_t *interp, uint lane)
+{
+    return interp->base[lane];
+}
+
+static inline void interp_set_accumulator(interp_hw_t *interp, uint lane, uint32_t val)
+{
+    interp->accum[lane] = val;
+}
+
+static inline uint32_t interp_get_accumulator(interp_hw_t *interp, uint lane)
+{
+    return interp->accum[lane];
+}
+
+static inline void interp_add_accumulater(interp_hw_t *interp, uint lane, uint32_t val)
+{
+    interp->accum[lane] += val;
+}
+
+// --- Implemented in pico_host.c ---------------------------------------------
+
+void interp_claim_lane(interp_hw_t *interp, uint lane);
+void interp_unclaim_lane(interp_hw_t *interp, uint lane);
+bool interp_lane_is_claimed(interp_hw_t *interp, uint lane);
+void interp_set_config(interp_hw_t *interp, uint lane, interp_config *config);
+
+// Lane `lane`'s shifted, masked, sign-extended value before its base is
+// added (the ACCUMx_ADD read).
+uint32_t interp_get_raw(interp_hw_t *interp, uint lane);
+uintptr_t interp_peek_lane_result(interp_hw_t *interp, uint lane);
+uintptr_t interp_pop_lane_result(interp_hw_t *interp, uint lane);
+uintptr_t interp_peek_full_result(interp_hw_t *interp);
+uintptr_t interp_pop_full_result(interp_hw_t *interp);
+
+#endif // NEOPICO_HOST_HARDWARE_INTERP_H
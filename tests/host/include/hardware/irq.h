@@ -0,0 +1,36 @@
+// Handlers are recorded, not wired to anything: the host model raises them
+// with pico_host_irq_fire() at the point the hardware would have.
+#ifndef NEOPICO_HOST_HARDWARE_IRQ_H
+#define NEOPICO_HOST_HARDWARE_IRQ_H
+
+#include "pico/types.h"
+
+typedef void (*irq_handler_t)(void);
+
+enum irq_num_rp2350 {
+    TIMER0_IRQ_0 = 0,
+    DMA_IRQ_0 = 10,
+    DMA_IRQ_1 = 11,
+    DMA_IRQ_2 = 12,
+    DMA_IRQ_3 = 13,
+    PIO0_IRQ_0 = 15,
+    PIO0_IRQ_1 = 16,
+    PIO1_IRQ_0 = 17,
+    PIO1_IRQ_1 = 18,
+    PIO2_IRQ_0 = 19,
+    PIO2_IRQ_1 = 20,
+    IO_IRQ_BANK0 = 21,
+    PICO_HOST_IRQ_COUNT = 52,
+};
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler);
+void irq_set_enabled(uint num, bool enabled);
+bool irq_is_enabled(uint num);
+
+static inline void irq_set_priority(uint num, uint8_t priority)
+{
+    (void)num;
+    (void)priority;
+}
+
+#endif // NEOPICO_HOST_HARDWARE_IRQ_H
@@ -0,0 +1,320 @@
+// Host shim for hardware/pio.h. Register layout, config-word encodings and
+// program relocation follow the RP2350 SDK bit for bit, so whatever the
+// firmware writes (including its direct pinctrl/execctrl and GPIOBASE pokes)
+// lands where a host PIO model can read it back. FIFOs and IRQ flags live in
+// pico_host.c; nothing here executes PIO instructions.
+#ifndef NEOPICO_HOST_HARDWARE_PIO_H
+#define NEOPICO_HOST_HARDWARE_PIO_H
+
+#include <stddef.h>
+
+#include "pico.h"
+#include "pico/types.h"
+
+#define NUM_PIOS 3U
+#define NUM_PIO_STATE_MACHINES 4U
+#define PIO_INSTRUCTION_COUNT 32U
+
+typedef struct {
+    volatile uint32_t clkdiv;
+    volatile uint32_t execctrl;
+    volatile uint32_t shiftctrl;
+    volatile uint32_t addr;
+    volatile uint32_t instr;
+    volatile uint32_t pinctrl;
+} pio_sm_hw_t;
+
+typedef struct {
+    volatile uint32_t ctrl;
+    volatile uint32_t fstat;
+    volatile uint32_t fdebug;
+    volatile uint32_t flevel;
+    volatile uint32_t txf[NUM_PIO_STATE_MACHINES];
+    volatile uint32_t rxf[NUM_PIO_STATE_MACHINES];
+    volatile uint32_t irq;
+    volatile uint32_t irq_force;
+    volatile uint32_t input_sync_bypass;
+    volatile uint32_t dbg_padout;
+    volatile uint32_t dbg_padoe;
+    volatile uint32_t dbg_cfginfo;
+    volatile uint32_t instr_mem[PIO_INSTRUCTION_COUNT];
+    pio_sm_hw_t sm[NUM_PIO_STATE_MACHINES];
+    volatile uint32_t rxf_putget[NUM_PIO_STATE_MACHINES][4];
+    volatile uint32_t gpiobase;
+    volatile uint32_t intr;
+    volatile uint32_t inte0;
+    volatile uint32_t intf0;
+    volatile uint32_t ints0;
+    volatile uint32_t inte1;
+    volatile uint32_t intf1;
+    volatile uint32_t ints1;
+} pio_hw_t;
+
+_Static_assert(offsetof(pio_hw_t, sm) == 0x0c8, "PIO SM register block offset must match RP2350");
+_Static_assert(offsetof(pio_hw_t, gpiobase) == 0x168, "PIO GPIOBASE offset must match RP2350");
+_Static_assert(offsetof(pio_hw_t, inte0) == 0x170, "PIO IRQ0_INTE offset must match RP2350");
+
+typedef pio_hw_t *PIO;
+
+extern pio_hw_t pico_host_pio_hw[NUM_PIOS];
+#define pio0 (&pico_host_pio_hw[0])
+#define pio1 (&pico_host_pio_hw[1])
+#define pio2 (&pico_host_pio_hw[2])
+
+// Field positions (RP2350 PIO register map).
+#define PIO_SM0_CLKDIV_INT_LSB 16U
+#define PIO_SM0_CLKDIV_FRAC_LSB 8U
+#define PIO_SM0_EXECCTRL_SIDE_EN_LSB 30U
+#define PIO_SM0_EXECCTRL_SIDE_PINDIR_LSB 29U
+#define PIO_SM0_EXECCTRL_JMP_PIN_LSB 24U
+#define PIO_SM0_EXECCTRL_JMP_PIN_BITS 0x1f000000U
+#define PIO_SM0_EXECCTRL_OUT_STICKY_LSB 17U
+#define PIO_SM0_EXECCTRL_WRAP_TOP_LSB 12U
+#define PIO_SM0_EXECCTRL_WRAP_TOP_BITS 0x0001f000U
+#define PIO_SM0_EXECCTRL_WRAP_BOTTOM_LSB 7U
+#define PIO_SM0_EXECCTRL_WRAP_BOTTOM_BITS 0x00000f80U
+#define PIO_SM0_SHIFTCTRL_FJOIN_RX_LSB 31U
+#define PIO_SM0_SHIFTCTRL_FJOIN_TX_LSB 30U
+#define PIO_SM0_SHIFTCTRL_PULL_THRESH_LSB 25U
+#define PIO_SM0_SHIFTCTRL_PULL_THRESH_BITS 0x3e000000U
+#define PIO_SM0_SHIFTCTRL_PUSH_THRESH_LSB 20U
+#define PIO_SM0_SHIFTCTRL_PUSH_THRESH_BITS 0x01f00000U
+#define PIO_SM0_SHIFTCTRL_OUT_SHIFTDIR_LSB 19U
+#define PIO_SM0_SHIFTCTRL_IN_SHIFTDIR_LSB 18U
+#define PIO_SM0_SHIFTCTRL_AUTOPULL_LSB 17U
+#define PIO_SM0_SHIFTCTRL_AUTOPUSH_LSB 16U
+#define PIO_SM0_PINCTRL_SIDESET_COUNT_LSB 29U
+#define PIO_SM0_PINCTRL_SET_COUNT_LSB 26U
+#define PIO_SM0_PINCTRL_OUT_COUNT_LSB 20U
+#define PIO_SM0_PINCTRL_IN_BASE_LSB 15U
+#define PIO_SM0_PINCTRL_IN_BASE_BITS 0x000f8000U
+#define PIO_SM0_PINCTRL_SIDESET_BASE_LSB 10U
+#define PIO_SM0_PINCTRL_SET_BASE_LSB 5U
+#define PIO_SM0_PINCTRL_OUT_BASE_LSB 0U
+
+typedef struct {
+    uint32_t clkdiv;
+    uint32_t execctrl;
+    uint32_t shiftctrl;
+    uint32_t pinctrl;
+} pio_sm_config;
+
+typedef struct pio_program {
+    const uint16_t *instructions;
+    uint8_t length;
+    int8_t origin; // required instruction memory origin or -1
+    uint8_t pio_version;
+} pio_program_t;
+
+enum pio_fifo_join {
+    PIO_FIFO_JOIN_NONE = 0,
+    PIO_FIFO_JOIN_TX = 1,
+    PIO_FIFO_JOIN_RX = 2,
+};
+
+enum pio_src_dest {
+    pio_pins = 0U,
+    pio_x = 1U,
+    pio_y = 2U,
+    pio_null = 3U,
+    pio_pindirs = 4U,
+    pio_exec_mov = 4U,
+    pio_status = 5U,
+    pio_pc = 5U,
+    pio_isr = 6U,
+    pio_osr = 7U,
+    pio_exec_out = 7U,
+};
+
+static inline uint pio_get_index(PIO pio)
+{
+    return (uint)(pio - pico_host_pio_hw);
+}
+
+static inline uint pio_get_dreq(PIO pio, uint sm, bool is_tx)
+{
+    return (pio_get_index(pio) * 8U) + (is_tx ? 0U : 4U) + sm;
+}
+
+// --- Instruction encoders (identical to the SDK's pio_instructions.h) -------
+
+static inline uint pio_encode_jmp(uint addr)
+{
+    return 0x0000U | (addr & 0x1fU);
+}
+
+static inline uint pio_encode_set(enum pio_src_dest dest, uint value)
+{
+    return 0xe000U | ((uint)dest << 5) | (value & 0x1fU);
+}
+
+static inline uint pio_encode_mov(enum pio_src_dest dest, enum pio_src_dest src)
+{
+    return 0xa000U | ((uint)dest << 5) | (uint)src;
+}
+
+static inline uint pio_encode_nop(void)
+{
+    return pio_encode_mov(pio_y, pio_y);
+}
+
+static inline uint pio_encode_irq_set(bool relative, uint irq)
+{
+    return 0xc000U | (relative ? 0x10U : 0U) | (irq & 7U);
+}
+
+static inline uint pio_encode_irq_clear(bool relative, uint irq)
+{
+    return 0xc040U | (relative ? 0x10U : 0U) | (irq & 7U);
+}
+
+static inline uint pio_encode_pull(bool if_empty, bool block)
+{
+    return 0x8080U | (if_empty ? 0x40U : 0U) | (block ? 0x20U : 0U);
+}
+
+static inline uint pio_encode_push(bool if_full, bool block)
+{
+    return 0x8000U | (if_full ? 0x40U : 0U) | (block ? 0x20U : 0U);
+}
+
+// --- State machine configuration -------------------------------------------
+
+static inline void sm_config_set_clkdiv_int_frac(pio_sm_config *c, uint16_t div_int, uint8_t div_frac)
+{
+    c->clkdiv = ((uint32_t)div_frac << PIO_SM0_CLKDIV_FRAC_LSB) | ((uint32_t)div_int << PIO_SM0_CLKDIV_INT_LSB);
+}
+
+static inline void sm_config_set_clkdiv(pio_sm_config *c, float div)
+{
+    const uint16_t div_int = (uint16_t)div;
+    const uint8_t div_frac = (div_int == 0U) ? 0U : (uint8_t)((div - (float)div_int) * 256.0F);
+    sm_config_set_clkdiv_int_frac(c, div_int, div_frac);
+}
+
+static inline void sm_config_set_wrap(pio_sm_config *c, uint wrap_target, uint wrap)
+{
+    c->execctrl = (c->execctrl & ~(PIO_SM0_EXECCTRL_WRAP_TOP_BITS | PIO_SM0_EXECCTRL_WRAP_BOTTOM_BITS)) |
+                  (wrap_target << PIO_SM0_EXECCTRL_WRAP_BOTTOM_LSB) | (wrap << PIO_SM0_EXECCTRL_WRAP_TOP_LSB);
+}
+
+static inline void sm_config_set_jmp_pin(pio_sm_config *c, uint pin)
+{
+    c->execctrl = (c->execctrl & ~PIO_SM0_EXECCTRL_JMP_PIN_BITS) | ((pin & 31U) << PIO_SM0_EXECCTRL_JMP_PIN_LSB);
+}
+
+static inline void sm_config_set_in_pins(pio_sm_config *c, uint in_base)
+{
+    c->pinctrl = (c->pinctrl & ~PIO_SM0_PINCTRL_IN_BASE_BITS) | ((in_base & 31U) << PIO_SM0_PINCTRL_IN_BASE_LSB);
+}
+
+static inline void sm_config_set_out_pins(pio_sm_config *c, uint out_base, uint out_count)
+{
+    c->pinctrl = (c->pinctrl & ~((0x3fU << PIO_SM0_PINCTRL_OUT_COUNT_LSB) | 0x1fU)) |
+                 ((out_base & 31U) << PIO_SM0_PINCTRL_OUT_BASE_LSB) | (out_count << PIO_SM0_PINCTRL_OUT_COUNT_LSB);
+}
+
+static inline void sm_config_set_set_pins(pio_sm_config *c, uint set_base, uint set_count)
+{
+    c->pinctrl = (c->pinctrl & ~((7U << PIO_SM0_PINCTRL_SET_COUNT_LSB) | (0x1fU << PIO_SM0_PINCTRL_SET_BASE_LSB))) |
+                 ((set_base & 31U) << PIO_SM0_PINCTRL_SET_BASE_LSB) | (set_count << PIO_SM0_PINCTRL_SET_COUNT_LSB);
+}
+
+static inline void sm_config_set_in_shift(pio_sm_config *c, bool shift_right, bool autopush, uint push_threshold)
+{
+    c->shiftctrl = (c->shiftctrl & ~((1U << PIO_SM0_SHIFTCTRL_IN_SHIFTDIR_LSB) |
+                                     (1U << PIO_SM0_SHIFTCTRL_AUTOPUSH_LSB) | PIO_SM0_SHIFTCTRL_PUSH_THRESH_BITS)) |
+                   ((shift_right ? 1U : 0U) << PIO_SM0_SHIFTCTRL_IN_SHIFTDIR_LSB) |
+                   ((autopush ? 1U : 0U) << PIO_SM0_SHIFTCTRL_AUTOPUSH_LSB) |
+                   ((push_threshold & 31U) << PIO_SM0_SHIFTCTRL_PUSH_THRESH_LSB);
+}
+
+static inline void sm_config_set_out_shift(pio_sm_config *c, bool shift_right, bool autopull, uint pull_threshold)
+{
+    c->shiftctrl = (c->shiftctrl & ~((1U << PIO_SM0_SHIFTCTRL_OUT_SHIFTDIR_LSB) |
+                                     (1U << PIO_SM0_SHIFTCTRL_AUTOPULL_LSB) | PIO_SM0_SHIFTCTRL_PULL_THRESH_BITS)) |
+                   ((shift_right ? 1U : 0U) << PIO_SM0_SHIFTCTRL_OUT_SHIFTDIR_LSB) |
+                   ((autopull ? 1U : 0U) << PIO_SM0_SHIFTCTRL_AUTOPULL_LSB) |
+                   ((pull_threshold & 31U) << PIO_SM0_SHIFTCTRL_PULL_THRESH_LSB);
+}
+
+static inline void sm_config_set_fifo_join(pio_sm_config *c, enum pio_fifo_join join)
+{
+    c->shiftctrl = (c->shiftctrl & ~((1U << PIO_SM0_SHIFTCTRL_FJOIN_TX_LSB) | (1U << PIO_SM0_SHIFTCTRL_FJOIN_RX_LSB))) |
+                   (((uint32_t)join & 1U) << PIO_SM0_SHIFTCTRL_FJOIN_TX_LSB) |
+                   ((((uint32_t)join >> 1) & 1U) << PIO_SM0_SHIFTCTRL_FJOIN_RX_LSB);
+}
+
+static inline pio_sm_config pio_get_default_sm_config(void)
+{
+    pio_sm_config c = {0U, 0U, 0U, 0U};
+    sm_config_set_clkdiv_int_frac(&c, 1U, 0U);
+    sm_config_set_wrap(&c, 0U, 31U);
+    sm_config_set_in_shift(&c, true, false, 32U);
+    sm_config_set_out_shift(&c, true, false, 32U);
+    return c;
+}
+
+// --- Implemented in pico_host.c ---------------------------------------------
+
+int pio_set_gpio_base(PIO pio, uint gpio_base);
+void pio_clear_instruction_memory(PIO pio);
+bool pio_can_add_program(PIO pio, const pio_program_t *program);
+uint pio_add_program(PIO pio, const pio_program_t *program);
+void pio_remove_program(PIO pio, const pio_program_t *program, uint loaded_offset);
+int pio_claim_unused_sm(PIO pio, bool required);
+void pio_sm_claim(PIO pio, uint sm);
+void pio_sm_unclaim(PIO pio, uint sm);
+void pio_sm_init(PIO pio, uint sm, uint initial_pc, const pio_sm_config *config);
+void pio_sm_set_config(PIO pio, uint sm, const pio_sm_config *config);
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled);
+void pio_sm_restart(PIO pio, uint sm);
+void pio_sm_clear_fifos(PIO pio, uint sm);
+void pio_sm_exec(PIO pio, uint sm, uint instr);
+void pio_sm_put(PIO pio, uint sm, uint32_t data);
+void pio_sm_put_blocking(PIO pio, uint sm, uint32_t data);
+uint32_t pio_sm_get(PIO pio, uint sm);
+uint32_t pio_sm_get_blocking(PIO pio, uint sm);
+bool pio_sm_is_rx_fifo_empty(PIO pio, uint sm);
+bool pio_sm_is_rx_fifo_full(PIO pio, uint sm);
+uint pio_sm_get_rx_fifo_level(PIO pio, uint sm);
+bool pio_sm_is_tx_fifo_empty(PIO pio, uint sm);
+bool pio_sm_is_tx_fifo_full(PIO pio, uint sm);
+uint pio_sm_get_tx_fifo_level(PIO pio, uint sm);
+uint8_t pio_sm_get_pc(PIO pio, uint sm);
+bool pio_interrupt_get(PIO pio, uint pio_interrupt_num);
+void pio_interrupt_clear(PIO pio, uint pio_interrupt_num);
+
+static inline void pio_sm_set_clkdiv(PIO pio, uint sm, float div)
+{
+    pio_sm_config c = {0U, 0U, 0U, 0U};
+    sm_config_set_clkdiv(&c, div);
+    pio->sm[sm].clkdiv = c.clkdiv;
+}
+
+static inline void pio_gpio_init(PIO pio, uint pin)
+{
+    (void)pio;
+    (void)pin;
+}
+
+static inline int pio_sm_set_pindirs_with_mask64(PIO pio, uint sm, uint64_t pin_dirs, uint64_t pin_mask)
+{
+    (void)pio;
+    (void)sm;
+    (void)pin_dirs;
+    (void)pin_mask;
+    return 0;
+}
+
+static inline int pio_sm_set_consecutive_pindirs(PIO pio, uint sm, uint pins_base, uint pin_count, bool is_out)
+{
+    (void)pio;
+    (void)sm;
+    (void)pins_base;
+    (void)pin_count;
+    (void)is_out;
+    return 0;
+}
+
+#endif // NEOPICO_HOST_HARDWARE_PIO_H
@@ -0,0 +1,17 @@
+#ifndef NEOPICO_HOST_HARDWARE_STRUCTS_WATCHDOG_H
+#define NEOPICO_HOST_HARDWARE_STRUCTS_WATCHDOG_H
+
+#include "pico/types.h"
+
+typedef struct {
+    volatile uint32_t ctrl;
+    volatile uint32_t load;
+    volatile uint32_t reason;
+    volatile uint32_t scratch[8];
+    volatile uint32_t tick;
+} watchdog_hw_t;
+
+extern watchdog_hw_t pico_host_watchdog_hw;
+#define watchdog_hw (&pico_host_watchdog_hw)
+
+#endif // NEOPICO_HOST_HARDWARE_STRUCTS_WATCHDOG_H
@@ -0,0 +1,51 @@
+// Barriers map to full host fences so the line ring's producer/consumer
+// ordering is exercised for real when Core 0 and Core 1 are host threads.
+#ifndef NEOPICO_HOST_HARDWARE_SYNC_H
+#define NEOPICO_HOST_HARDWARE_SYNC_H
+
+#include "pico/types.h"
+
+static inline void __dmb(void)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+static inline void __dsb(void)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+static inline void __isb(void)
+{
+    __atomic_signal_fence(__ATOMIC_SEQ_CST);
+}
+
+// WFE parks the core until an event; on the host that means "let the
+// scheduler hook deliver whatever the hardware would do next".
+void pico_host_wait_for_event(void);
+
+static inline void __wfe(void)
+{
+    pico_host_wait_for_event();
+}
+
+static inline void __wfi(void)
+{
+    pico_host_wait_for_event();
+}
+
+static inline void __sev(void)
+{
+}
+
+static inline uint32_t save_and_disable_interrupts(void)
+{
+    return 0U;
+}
+
+static inline void restore_interrupts(uint32_t status)
+{
+    (void)status;
+}
+
+#endif // NEOPICO_HOST_HARDWARE_SYNC_H
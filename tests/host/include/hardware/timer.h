@@ -0,0 +1,19 @@
+#ifndef NEOPICO_HOST_HARDWARE_TIMER_H
+#define NEOPICO_HOST_HARDWARE_TIMER_H
+
+#include "pico/time.h"
+#include "pico/types.h"
+
+// Only the raw low word is read by the firmware (genlock timestamps). The
+// shim keeps it equal to the low 32 bits of the virtual clock.
+typedef struct {
+    volatile uint32_t timehr;
+    volatile uint32_t timelr;
+    volatile uint32_t timerawh;
+    volatile uint32_t timerawl;
+} timer_hw_t;
+
+extern timer_hw_t pico_host_timer_hw;
+#define timer_hw (&pico_host_timer_hw)
+
+#endif // NEOPICO_HOST_HARDWARE_TIMER_H
@@ -0,0 +1,11 @@
+#ifndef NEOPICO_HOST_HARDWARE_WATCHDOG_H
+#define NEOPICO_HOST_HARDWARE_WATCHDOG_H
+
+#include "hardware/structs/watchdog.h"
+
+// Counts the request and hands control to the host reboot handler (see
+// pico_host_set_reboot_handler()), so the caller's spin-until-reset loop is
+// never reached.
+void watchdog_reboot(uint32_t pc, uint32_t sp, uint32_t delay_ms);
+
+#endif // NEOPICO_HOST_HARDWARE_WATCHDOG_H
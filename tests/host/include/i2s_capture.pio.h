@@ -0,0 +1,164 @@
+// Host copy of the pioasm output for src/audio/i2s_capture.pio (the SDK build generates it;
+// the host build has no pioasm). Keep in step with the .pio source; the pio_headers test
+// (tests/check_pio_headers.py) fails when it is not.
+
+#pragma once
+
+#if !PICO_NO_HARDWARE
+#include "hardware/pio.h"
+#endif
+
+// ------------------------ //
+// i2s_capture_frame_resync //
+// ------------------------ //
+
+#define i2s_capture_frame_resync_wrap_target 2
+#define i2s_capture_frame_resync_wrap 18
+#define i2s_capture_frame_resync_pio_version 0
+
+static const uint16_t i2s_capture_frame_resync_program_instructions[] = {
+    0x2022, //  0: wait 0 pin, 2
+    0x20a2, //  1: wait 1 pin, 2
+            //     .wrap_target
+    0x20a1, //  2: wait 1 pin, 1
+    0x2021, //  3: wait 0 pin, 1
+    0xe037, //  4: set x, 23
+    0x2022, //  5: wait 0 pin, 2
+    0x20a2, //  6: wait 1 pin, 2
+    0xa042, //  7: nop
+    0x4001, //  8: in pins, 1
+    0x0045, //  9: jmp x--, 5
+    0x8000, // 10: push noblock
+    0x20a1, // 11: wait 1 pin, 1
+    0xe037, // 12: set x, 23
+    0x2022, // 13: wait 0 pin, 2
+    0x20a2, // 14: wait 1 pin, 2
+    0xa042, // 15: nop
+    0x4001, // 16: in pins, 1
+    0x004d, // 17: jmp x--, 13
+    0x8000, // 18: push noblock
+            //     .wrap
+};
+
+#if !PICO_NO_HARDWARE
+static const struct pio_program i2s_capture_frame_resync_program = {
+    .instructions = i2s_capture_frame_resync_program_instructions,
+    .length = 19,
+    .origin = -1,
+    .pio_version = i2s_capture_frame_resync_pio_version,
+};
+
+static inline pio_sm_config i2s_capture_frame_resync_program_get_default_config(uint offset)
+{
+    pio_sm_config c = pio_get_default_sm_config();
+    sm_config_set_wrap(&c, offset + i2s_capture_frame_resync_wrap_target, offset + i2s_capture_frame_resync_wrap);
+    return c;
+}
+#endif
+
+// ------------------- //
+// i2s_capture_pcm1802 //
+// ------------------- //
+
+#define i2s_capture_pcm1802_wrap_target 4
+#define i2s_capture_pcm1802_wrap 23
+#define i2s_capture_pcm1802_pio_version 0
+
+static const uint16_t i2s_capture_pcm1802_program_instructions[] = {
+    0x2022, //  0: wait 0 pin, 2
+    0x20a2, //  1: wait 1 pin, 2
+    0x20a1, //  2: wait 1 pin, 1
+    0x2021, //  3: wait 0 pin, 1
+            //     .wrap_target
+    0x2022, //  4: wait 0 pin, 2
+    0x20a2, //  5: wait 1 pin, 2
+    0xe037, //  6: set x, 23
+    0x2022, //  7: wait 0 pin, 2
+    0x20a2, //  8: wait 1 pin, 2
+    0xa042, //  9: nop
+    0x4001, // 10: in pins, 1
+    0x0047, // 11: jmp x--, 7
+    0x8000, // 12: push noblock
+    0x20a1, // 13: wait 1 pin, 1
+    0x2022, // 14: wait 0 pin, 2
+    0x20a2, // 15: wait 1 pin, 2
+    0xe037, // 16: set x, 23
+    0x2022, // 17: wait 0 pin, 2
+    0x20a2, // 18: wait 1 pin, 2
+    0xa042, // 19: nop
+    0x4001, // 20: in pins, 1
+    0x0051, // 21: jmp x--, 17
+    0x8000, // 22: push noblock
+    0x2021, // 23: wait 0 pin, 1
+            //     .wrap
+};
+
+#if !PICO_NO_HARDWARE
+static const struct pio_program i2s_capture_pcm1802_program = {
+    .instructions = i2s_capture_pcm1802_program_instructions,
+    .length = 24,
+    .origin = -1,
+    .pio_version = i2s_capture_pcm1802_pio_version,
+};
+
+static inline pio_sm_config i2s_capture_pcm1802_program_get_default_config(uint offset)
+{
+    pio_sm_config c = pio_get_default_sm_config();
+    sm_config_set_wrap(&c, offset + i2s_capture_pcm1802_wrap_target, offset + i2s_capture_pcm1802_wrap);
+    return c;
+}
+#endif
+
+#if !PICO_NO_HARDWARE
+#include "hardware/gpio.h"
+
+// Pin definitions: DAT, WS, BCK. OUT_BASE = DAT so wait pin 0=DAT, 1=WS, 2=BCK.
+
+static inline void i2s_capture_frame_resync_program_init(PIO pio, uint sm, uint offset, uint pin_dat, uint pin_ws, uint pin_bck) {
+    pio_sm_config c = i2s_capture_frame_resync_program_get_default_config(offset);
+
+    // Same pin mapping as i2s_capture: IN base = DAT, OUT base = DAT (for wait pin N)
+    sm_config_set_in_pins(&c, pin_dat);
+    sm_config_set_out_pins(&c, pin_dat, 3);
+
+    // Shift LEFT (MSB first), no autopush
+    sm_config_set_in_shift(&c, false, false, 32);
+
+    // Join FIFOs for 8-word RX depth
+    sm_config_set_fifo_join(&c, PIO_FIFO_JOIN_RX);
+
+    pio_gpio_init(pio, pin_dat);
+    pio_gpio_init(pio, pin_bck);
+    pio_gpio_init(pio, pin_ws);
+
+    pio_sm_set_pindirs_with_mask64(pio, sm, 0,
+        (1ull << pin_dat) | (1ull << pin_bck) | (1ull << pin_ws));
+
+    sm_config_set_clkdiv(&c, 1.0f);
+    pio_sm_init(pio, sm, offset, &c);
+}
+
+static inline void i2s_capture_pcm1802_program_init(PIO pio, uint sm, uint offset, uint pin_dat, uint pin_ws, uint pin_bck) {
+    pio_sm_config c = i2s_capture_pcm1802_program_get_default_config(offset);
+
+    // Same pin mapping as i2s_capture: IN base = DAT, OUT base = DAT (for wait pin N)
+    sm_config_set_in_pins(&c, pin_dat);
+    sm_config_set_out_pins(&c, pin_dat, 3);
+
+    // Shift LEFT (MSB first), no autopush
+    sm_config_set_in_shift(&c, false, false, 32);
+
+    // Join FIFOs for 8-word RX depth
+    sm_config_set_fifo_join(&c, PIO_FIFO_JOIN_RX);
+
+    pio_gpio_init(pio, pin_dat);
+    pio_gpio_init(pio, pin_bck);
+    pio_gpio_init(pio, pin_ws);
+
+    pio_sm_set_pindirs_with_mask64(pio, sm, 0,
+        (1ull << pin_dat) | (1ull << pin_bck) | (1ull << pin_ws));
+
+    sm_config_set_clkdiv(&c, 1.0f);
+    pio_sm_init(pio, sm, offset, &c);
+}
+#endif
@@ -0,0 +1,35 @@
+// Host shim for the Pico SDK's pico.h: just enough of the SDK surface for the
+// firmware's portable hot paths to compile unchanged on a Linux host. Section
+// placement attributes become plain functions; nothing here models timing.
+#ifndef NEOPICO_HOST_PICO_H
+#define NEOPICO_HOST_PICO_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "pico/types.h"
+
+// Scratch/RAM placement only matters to the RP2350 linker script. On the host
+// every function already runs from RAM, so the section names are dropped.
+#define __scratch_x(group)
+#define __scratch_y(group)
+#define __not_in_flash(group)
+#define __not_in_flash_func(func_name) func_name
+#define __no_inline_not_in_flash_func(func_name) __attribute__((noinline)) func_name
+#define __time_critical_func(func_name) func_name
+
+#ifndef PICO_FLASH_SIZE_BYTES
+#define PICO_FLASH_SIZE_BYTES (16U * 1024U * 1024U)
+#endif
+
+// Flash is a host array (see pico_host.c); XIP_BASE points at it so
+// settings.c's memory-mapped reads resolve to the same bytes it programs.
+extern uint8_t pico_host_flash_image[PICO_FLASH_SIZE_BYTES];
+#define XIP_BASE ((uintptr_t)pico_host_flash_image)
+
+static inline void tight_loop_contents(void)
+{
+}
+
+#endif // NEOPICO_HOST_PICO_H
@@ -0,0 +1,11 @@
+#ifndef NEOPICO_HOST_PICO_MULTICORE_H
+#define NEOPICO_HOST_PICO_MULTICORE_H
+
+#include "pico/types.h"
+
+static inline uint get_core_num(void)
+{
+    return 0U;
+}
+
+#endif // NEOPICO_HOST_PICO_MULTICORE_H
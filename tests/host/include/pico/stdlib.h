@@ -0,0 +1,10 @@
+#ifndef NEOPICO_HOST_PICO_STDLIB_H
+#define NEOPICO_HOST_PICO_STDLIB_H
+
+#include <stdio.h>
+
+#include "hardware/gpio.h"
+#include "pico.h"
+#include "pico/time.h"
+
+#endif // NEOPICO_HOST_PICO_STDLIB_H
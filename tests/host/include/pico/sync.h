@@ -0,0 +1,23 @@
+// Counting semaphore. A blocked acquire hands control to the host scheduler
+// hook (pico_host.h), which plays the role of every interrupt and DMA engine
+// that would have released it on hardware.
+#ifndef NEOPICO_HOST_PICO_SYNC_H
+#define NEOPICO_HOST_PICO_SYNC_H
+
+#include "hardware/sync.h"
+#include "pico/types.h"
+
+typedef struct {
+    volatile int16_t permits;
+    int16_t max_permits;
+} semaphore_t;
+
+void sem_init(semaphore_t *sem, int16_t initial_permits, int16_t max_permits);
+bool sem_release(semaphore_t *sem);
+void sem_reset(semaphore_t *sem, int16_t permits);
+int sem_available(semaphore_t *sem);
+bool sem_acquire_timeout_ms(semaphore_t *sem, uint32_t timeout_ms);
+bool sem_acquire_timeout_us(semaphore_t *sem, uint32_t timeout_us);
+void sem_acquire_blocking(semaphore_t *sem);
+
+#endif // NEOPICO_HOST_PICO_SYNC_H
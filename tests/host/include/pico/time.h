@@ -0,0 +1,33 @@
+// Virtual time. The host clock only moves when pico_host_advance_us() is
+// called or when the firmware blocks in a shim wait with a deadline, so every
+// run is deterministic regardless of how fast the host executes.
+#ifndef NEOPICO_HOST_PICO_TIME_H
+#define NEOPICO_HOST_PICO_TIME_H
+
+#include "pico/types.h"
+
+uint64_t time_us_64(void);
+void sleep_us(uint64_t us);
+void sleep_ms(uint32_t ms);
+
+static inline uint32_t time_us_32(void)
+{
+    return (uint32_t)time_us_64();
+}
+
+static inline absolute_time_t get_absolute_time(void)
+{
+    return time_us_64();
+}
+
+static inline uint32_t to_ms_since_boot(absolute_time_t t)
+{
+    return (uint32_t)(t / 1000U);
+}
+
+static inline void busy_wait_us(uint64_t us)
+{
+    sleep_us(us);
+}
+
+#endif // NEOPICO_HOST_PICO_TIME_H
@@ -0,0 +1,10 @@
+#ifndef NEOPICO_HOST_PICO_TYPES_H
+#define NEOPICO_HOST_PICO_TYPES_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef unsigned int uint;
+typedef uint64_t absolute_time_t;
+
+#endif // NEOPICO_HOST_PICO_TYPES_H
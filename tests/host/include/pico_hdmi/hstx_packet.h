@@ -0,0 +1,32 @@
+// Host stand-in for pico_hdmi's packet layer. Real packets carry BCH-coded
+// TMDS payloads; the host keeps the decoded audio so tests can inspect what
+// would have been sent.
+#ifndef NEOPICO_HOST_PICO_HDMI_HSTX_PACKET_H
+#define NEOPICO_HOST_PICO_HDMI_HSTX_PACKET_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct {
+    int16_t left;
+    int16_t right;
+} audio_sample_t;
+
+typedef struct {
+    audio_sample_t samples[4];
+    uint8_t sample_count;
+    int frame_counter;
+} hstx_packet_t;
+
+typedef struct {
+    hstx_packet_t packet;
+    bool vsync_active;
+    bool hsync_active;
+} hstx_data_island_t;
+
+int hstx_packet_set_audio_samples(hstx_packet_t *packet, const audio_sample_t *samples, int num_samples,
+                                  int frame_counter);
+void hstx_encode_data_island(hstx_data_island_t *island, const hstx_packet_t *packet, bool vsync_active,
+                             bool hsync_active);
+
+#endif // NEOPICO_HOST_PICO_HDMI_HSTX_PACKET_H
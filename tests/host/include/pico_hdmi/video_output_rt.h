@@ -0,0 +1,37 @@
+// Host stand-in for pico_hdmi's runtime video output. There is no HSTX: the
+// registered callbacks are handed back to the host scanout model through
+// pico_host_video_scanline_callback()/pico_host_video_vsync_callback().
+#ifndef NEOPICO_HOST_PICO_HDMI_VIDEO_OUTPUT_RT_H
+#define NEOPICO_HOST_PICO_HDMI_VIDEO_OUTPUT_RT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct {
+    uint16_t h_active_pixels;
+    uint16_t v_active_lines;
+    uint16_t h_total_pixels;
+    uint16_t v_total_lines;
+    uint32_t pixel_clock_hz;
+} video_mode_t;
+
+typedef void (*video_output_scanline_cb_t)(uint32_t v_scanline, uint32_t active_line, uint32_t *dst);
+typedef void (*video_output_vsync_cb_t)(void);
+
+extern const video_mode_t video_mode_480_p;
+extern const video_mode_t video_mode_240_p;
+extern const video_mode_t video_mode_240_p_genlock;
+extern const video_mode_t video_mode_720_p;
+
+extern const video_mode_t *video_output_active_mode;
+extern volatile uint16_t rt_v_total_lines;
+extern volatile uint32_t video_frame_count;
+
+void video_output_set_mode(const video_mode_t *mode);
+void video_output_init(uint32_t frame_width, uint32_t frame_height);
+void video_output_set_scanline_callback(video_output_scanline_cb_t cb);
+void video_output_set_vsync_callback(video_output_vsync_cb_t cb);
+void video_output_set_scanline_level(uint8_t level);
+void video_output_set_vblank_htrim_px(int px);
+
+#endif // NEOPICO_HOST_PICO_HDMI_VIDEO_OUTPUT_RT_H
@@ -0,0 +1,16 @@
+// TinyUSB CDC surface used by the diagnostics dumps. Writes land in a host
+// buffer (pico_host_cdc_take()); reads come from pico_host_cdc_inject().
+#ifndef NEOPICO_HOST_TUSB_H
+#define NEOPICO_HOST_TUSB_H
+
+#include "pico/types.h"
+
+void tud_task(void);
+bool tud_cdc_connected(void);
+uint32_t tud_cdc_available(void);
+int32_t tud_cdc_read_char(void);
+uint32_t tud_cdc_write_available(void);
+uint32_t tud_cdc_write(const void *buffer, uint32_t bufsize);
+uint32_t tud_cdc_write_flush(void);
+
+#endif // NEOPICO_HOST_TUSB_H
@@ -0,0 +1,146 @@
+// Host copy of the pioasm output for src/video/video_capture_mvs.pio (the SDK build generates it;
+// the host build has no pioasm). Keep in step with the .pio source; the pio_headers test
+// (tests/check_pio_headers.py) fails when it is not.
+
+#pragma once
+
+#if !PICO_NO_HARDWARE
+#include "hardware/pio.h"
+#endif
+
+// ----------- //
+// mvs_sync_4a //
+// ----------- //
+
+#define mvs_sync_4a_wrap_target 0
+#define mvs_sync_4a_wrap 9
+#define mvs_sync_4a_pio_version 0
+
+#define mvs_sync_4a_offset_entry_point 0u
+
+static const uint16_t mvs_sync_4a_program_instructions[] = {
+            //     .wrap_target
+    0x20a0, //  0: wait 1 pin, 0
+    0xa02b, //  1: mov x, !null
+    0x2021, //  2: wait 0 pin, 1
+    0x20a1, //  3: wait 1 pin, 1
+    0x0045, //  4: jmp x--, 5
+    0x00c2, //  5: jmp pin, 2
+    0xa0c9, //  6: mov isr, !x
+    0x8000, //  7: push noblock
+    0xc000, //  8: irq nowait 0
+    0x0000, //  9: jmp 0
+            //     .wrap
+};
+
+#if !PICO_NO_HARDWARE
+static const struct pio_program mvs_sync_4a_program = {
+    .instructions = mvs_sync_4a_program_instructions,
+    .length = 10,
+    .origin = -1,
+    .pio_version = mvs_sync_4a_pio_version,
+};
+
+static inline pio_sm_config mvs_sync_4a_program_get_default_config(uint offset)
+{
+    pio_sm_config c = pio_get_default_sm_config();
+    sm_config_set_wrap(&c, offset + mvs_sync_4a_wrap_target, offset + mvs_sync_4a_wrap);
+    return c;
+}
+#endif
+
+// ------------------------ //
+// mvs_pixel_capture_dark19 //
+// ------------------------ //
+
+#define mvs_pixel_capture_dark19_wrap_target 3
+#define mvs_pixel_capture_dark19_wrap 16
+#define mvs_pixel_capture_dark19_pio_version 0
+
+static const uint16_t mvs_pixel_capture_dark19_program_instructions[] = {
+    0x80a0, //  0: pull block
+    0xa047, //  1: mov y, osr
+    0x20c4, //  2: wait 1 irq, 4
+            //     .wrap_target
+    0x2020, //  3: wait 0 pin, 0
+    0x20a0, //  4: wait 1 pin, 0
+    0x6030, //  5: out x, 16
+    0x2021, //  6: wait 0 pin, 1
+    0x20a1, //  7: wait 1 pin, 1
+    0x0046, //  8: jmp x--, 6
+    0x6030, //  9: out x, 16
+    0x2021, // 10: wait 0 pin, 1
+    0x20a1, // 11: wait 1 pin, 1
+    0xa042, // 12: nop
+    0xa042, // 13: nop
+    0x4013, // 14: in pins, 19
+    0x004a, // 15: jmp x--, 10
+    0xa0e2, // 16: mov osr, y
+            //     .wrap
+};
+
+#if !PICO_NO_HARDWARE
+static const struct pio_program mvs_pixel_capture_dark19_program = {
+    .instructions = mvs_pixel_capture_dark19_program_instructions,
+    .length = 17,
+    .origin = -1,
+    .pio_version = mvs_pixel_capture_dark19_pio_version,
+};
+
+static inline pio_sm_config mvs_pixel_capture_dark19_program_get_default_config(uint offset)
+{
+    pio_sm_config c = pio_get_default_sm_config();
+    sm_config_set_wrap(&c, offset + mvs_pixel_capture_dark19_wrap_target, offset + mvs_pixel_capture_dark19_wrap);
+    return c;
+}
+#endif
+
+// -------------------------- //
+// mvs_pixel_capture_packed16 //
+// -------------------------- //
+
+#define mvs_pixel_capture_packed16_wrap_target 3
+#define mvs_pixel_capture_packed16_wrap 20
+#define mvs_pixel_capture_packed16_pio_version 0
+
+static const uint16_t mvs_pixel_capture_packed16_program_instructions[] = {
+    0x80a0, //  0: pull block
+    0xa047, //  1: mov y, osr
+    0x20c4, //  2: wait 1 irq, 4
+            //     .wrap_target
+    0x2020, //  3: wait 0 pin, 0
+    0x20a0, //  4: wait 1 pin, 0
+    0x6030, //  5: out x, 16
+    0x2021, //  6: wait 0 pin, 1
+    0x20a1, //  7: wait 1 pin, 1
+    0x0046, //  8: jmp x--, 6
+    0x6030, //  9: out x, 16
+    0x2021, // 10: wait 0 pin, 1
+    0x20a1, // 11: wait 1 pin, 1
+    0xa042, // 12: nop
+    0xa042, // 13: nop
+    0xa0e0, // 14: mov osr, pins
+    0x6062, // 15: out null, 2
+    0x40ef, // 16: in osr, 15
+    0x6070, // 17: out null, 16
+    0x40e1, // 18: in osr, 1
+    0x004a, // 19: jmp x--, 10
+    0xa0e2, // 20: mov osr, y
+            //     .wrap
+};
+
+#if !PICO_NO_HARDWARE
+static const struct pio_program mvs_pixel_capture_packed16_program = {
+    .instructions = mvs_pixel_capture_packed16_program_instructions,
+    .length = 21,
+    .origin = -1,
+    .pio_version = mvs_pixel_capture_packed16_pio_version,
+};
+
+static inline pio_sm_config mvs_pixel_capture_packed16_program_get_default_config(uint offset)
+{
+    pio_sm_config c = pio_get_default_sm_config();
+    sm_config_set_wrap(&c, offset + mvs_pixel_capture_packed16_wrap_target, offset + mvs_pixel_capture_packed16_wrap);
+    return c;
+}
+#endif
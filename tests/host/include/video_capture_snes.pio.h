@@ -0,0 +1,134 @@
+// Host copy of the pioasm output for src/video/video_capture_snes.pio (the SDK build generates it;
+// the host build has no pioasm). Keep in step with the .pio source; the pio_headers test
+// (tests/check_pio_headers.py) fails when it is not.
+
+#pragma once
+
+#if !PICO_NO_HARDWARE
+#include "hardware/pio.h"
+#endif
+
+// -------------- //
+// snes_hard_sync //
+// -------------- //
+
+#define snes_hard_sync_wrap_target 2
+#define snes_hard_sync_wrap 16
+#define snes_hard_sync_pio_version 0
+
+static const uint16_t snes_hard_sync_program_instructions[] = {
+    0x80a0, //  0: pull block
+    0xa047, //  1: mov y, osr
+            //     .wrap_target
+    0x20c4, //  2: wait 1 irq, 4
+    0x20b1, //  3: wait 1 pin, 17
+    0x2031, //  4: wait 0 pin, 17
+    0xe033, //  5: set x, 19
+    0x2021, //  6: wait 0 pin, 1
+    0x20a1, //  7: wait 1 pin, 1
+    0x0046, //  8: jmp x--, 6
+    0xa022, //  9: mov x, y
+    0x2021, // 10: wait 0 pin, 1
+    0x20a1, // 11: wait 1 pin, 1
+    0xa042, // 12: nop
+    0xa042, // 13: nop
+    0x4012, // 14: in pins, 18
+    0x004a, // 15: jmp x--, 10
+    0x0003, // 16: jmp 3
+            //     .wrap
+};
+
+#if !PICO_NO_HARDWARE
+static const struct pio_program snes_hard_sync_program = {
+    .instructions = snes_hard_sync_program_instructions,
+    .length = 17,
+    .origin = -1,
+    .pio_version = snes_hard_sync_pio_version,
+};
+
+static inline pio_sm_config snes_hard_sync_program_get_default_config(uint offset)
+{
+    pio_sm_config c = pio_get_default_sm_config();
+    sm_config_set_wrap(&c, offset + snes_hard_sync_wrap_target, offset + snes_hard_sync_wrap);
+    return c;
+}
+#endif
+
+// -------------------- //
+// snes_hard_sync_hires //
+// -------------------- //
+
+#define snes_hard_sync_hires_wrap_target 2
+#define snes_hard_sync_hires_wrap 17
+#define snes_hard_sync_hires_pio_version 0
+
+static const uint16_t snes_hard_sync_hires_program_instructions[] = {
+    0x80a0, //  0: pull block
+    0xa047, //  1: mov y, osr
+            //     .wrap_target
+    0x20c4, //  2: wait 1 irq, 4
+    0x20b1, //  3: wait 1 pin, 17
+    0x2031, //  4: wait 0 pin, 17
+    0xe033, //  5: set x, 19
+    0x2021, //  6: wait 0 pin, 1
+    0x20a1, //  7: wait 1 pin, 1
+    0x0046, //  8: jmp x--, 6
+    0xa022, //  9: mov x, y
+    0x2521, // 10: wait 0 pin, 1     [5]
+    0x4012, // 11: in pins, 18
+    0x20a1, // 12: wait 1 pin, 1
+    0xa042, // 13: nop
+    0xa042, // 14: nop
+    0x4012, // 15: in pins, 18
+    0x004a, // 16: jmp x--, 10
+    0x0003, // 17: jmp 3
+            //     .wrap
+};
+
+#if !PICO_NO_HARDWARE
+static const struct pio_program snes_hard_sync_hires_program = {
+    .instructions = snes_hard_sync_hires_program_instructions,
+    .length = 18,
+    .origin = -1,
+    .pio_version = snes_hard_sync_hires_pio_version,
+};
+
+static inline pio_sm_config snes_hard_sync_hires_program_get_default_config(uint offset)
+{
+    pio_sm_config c = pio_get_default_sm_config();
+    sm_config_set_wrap(&c, offset + snes_hard_sync_hires_wrap_target, offset + snes_hard_sync_hires_wrap);
+    return c;
+}
+#endif
+
+// ----------- //
+// snes_vblank //
+// ----------- //
+
+#define snes_vblank_wrap_target 0
+#define snes_vblank_wrap 2
+#define snes_vblank_pio_version 0
+
+static const uint16_t snes_vblank_program_instructions[] = {
+            //     .wrap_target
+    0x20a0, //  0: wait 1 pin, 0
+    0x2020, //  1: wait 0 pin, 0
+    0xc000, //  2: irq nowait 0
+            //     .wrap
+};
+
+#if !PICO_NO_HARDWARE
+static const struct pio_program snes_vblank_program = {
+    .instructions = snes_vblank_program_instructions,
+    .length = 3,
+    .origin = -1,
+    .pio_version = snes_vblank_pio_version,
+};
+
+static inline pio_sm_config snes_vblank_program_get_default_config(uint offset)
+{
+    pio_sm_config c = pio_get_default_sm_config();
+    sm_config_set_wrap(&c, offset + snes_vblank_wrap_target, offset + snes_vblank_wrap);
+    return c;
+}
+#endif
@@ -0,0 +1,163 @@
+// pico_hdmi stand-in: mode tables, registered callbacks and a data-island
+// queue that keeps decoded audio so tests can check what would be sent.
+
+#include "pico_hdmi/hstx_data_island_queue.h"
+#include "pico_hdmi/hstx_packet.h"
+#include "pico_hdmi/video_output_rt.h"
+
+#include <string.h>
+
+#include "pico_host.h"
+
+// IEC 60958 channel-status blocks are 192 frames long.
+#define HDMI_AUDIO_FRAMES_PER_BLOCK 192
+
+const video_mode_t video_mode_480_p = {640, 480, 800, 525, 25200000U};
+const video_mode_t video_mode_240_p = {1280, 240, 1600, 262, 25200000U};
+const video_mode_t video_mode_240_p_genlock = {1280, 240, 1613, 264, 25200000U};
+const video_mode_t video_mode_720_p = {1280, 720, 1440, 741, 64000000U};
+
+const video_mode_t *video_output_active_mode = &video_mode_480_p;
+volatile uint16_t rt_v_total_lines = 525;
+volatile uint32_t video_frame_count = 0;
+volatile uint32_t hstx_di_queue_silence_count = 0;
+
+static video_output_scanline_cb_t g_scanline_cb;
+static video_output_vsync_cb_t g_vsync_cb;
+static uint8_t g_scanline_level;
+static int g_vblank_htrim_px;
+
+static hstx_data_island_t g_di_queue[HSTX_DI_QUEUE_SIZE];
+static uint32_t g_di_head;
+static uint32_t g_di_count;
+static bool g_di_hsync_active;
+
+void video_output_set_mode(const video_mode_t *mode)
+{
+    video_output_active_mode = mode;
+    rt_v_total_lines = mode->v_total_lines;
+}
+
+void video_output_init(uint32_t frame_width, uint32_t frame_height)
+{
+    (void)frame_width;
+    (void)frame_height;
+    rt_v_total_lines = video_output_active_mode->v_total_lines;
+    video_frame_count = 0;
+    g_scanline_cb = NULL;
+    g_vsync_cb = NULL;
+    g_scanline_level = 0;
+    g_vblank_htrim_px = 0;
+}
+
+void video_output_set_scanline_callback(video_output_scanline_cb_t cb)
+{
+    g_scanline_cb = cb;
+}
+
+void video_output_set_vsync_callback(video_output_vsync_cb_t cb)
+{
+    g_vsync_cb = cb;
+}
+
+void video_output_set_scanline_level(uint8_t level)
+{
+    g_scanline_level = level;
+}
+
+void video_output_set_vblank_htrim_px(int px)
+{
+    g_vblank_htrim_px = px;
+}
+
+video_output_scanline_cb_t pico_host_video_scanline_callback(void)
+{
+    return g_scanline_cb;
+}
+
+video_output_vsync_cb_t pico_host_video_vsync_callback(void)
+{
+    return g_vsync_cb;
+}
+
+uint8_t pico_host_video_scanline_level(void)
+{
+    return g_scanline_level;
+}
+
+int pico_host_video_vblank_htrim_px(void)
+{
+    return g_vblank_htrim_px;
+}
+
+int hstx_packet_set_audio_samples(hstx_packet_t *packet, const audio_sample_t *samples, int num_samples,
+                                  int frame_counter)
+{
+    memset(packet, 0, sizeof *packet);
+    if (num_samples > 4) {
+        num_samples = 4;
+    }
+    memcpy(packet->samples, samples, (size_t)num_samples * sizeof(audio_sample_t));
+    packet->sample_count = (uint8_t)num_samples;
+    packet->frame_counter = frame_counter;
+    return (frame_counter + num_samples) % HDMI_AUDIO_FRAMES_PER_BLOCK;
+}
+
+void hstx_encode_data_island(hstx_data_island_t *island, const hstx_packet_t *packet, bool vsync_active,
+                             bool hsync_active)
+{
+    island->packet = *packet;
+    island->vsync_active = vsync_active;
+    island->hsync_active = hsync_active;
+}
+
+void hstx_di_queue_init(void)
+{
+    g_di_head = 0;
+    g_di_count = 0;
+    hstx_di_queue_silence_count = 0;
+}
+
+bool hstx_di_queue_push(const hstx_data_island_t *island)
+{
+    if (g_di_count >= HSTX_DI_QUEUE_SIZE) {
+        return false;
+    }
+    g_di_queue[(g_di_head + g_di_count) % HSTX_DI_QUEUE_SIZE] = *island;
+    g_di_count++;
+    return true;
+}
+
+uint32_t hstx_di_queue_get_level(void)
+{
+    return g_di_count;
+}
+
+bool hstx_di_queue_get_hsync_active(void)
+{
+    return g_di_hsync_active;
+}
+
+void pico_host_hdmi_reset(void)
+{
+    video_output_set_mode(&video_mode_480_p);
+    video_output_init(0, 0);
+    hstx_di_queue_init();
+    g_di_hsync_active = false;
+}
+
+void pico_host_di_queue_set_hsync_active(bool active)
+{
+    g_di_hsync_active = active;
+}
+
+bool pico_host_di_queue_pop(hstx_data_island_t *island)
+{
+    if (g_di_count == 0U) {
+        return false;
+    }
+    *island = g_di_queue[g_di_head];
+    g_di_head = (g_di_head + 1U) % HSTX_DI_QUEUE_SIZE;
+    g_di_count--;
+    return true;
+}
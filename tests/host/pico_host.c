@@ -0,0 +1,1320 @@
+// Host HAL model: the state behind the shim headers in tests/host/include.
+// See pico_host.h for the execution model.
+
+#include "pico_host.h"
+
+#include "pio_emu.h"
+
+#include "pico.h"
+#include "pico/sync.h"
+#include "pico/time.h"
+
+#include "hardware/clocks.h"
+#include "hardware/flash.h"
+#include "hardware/gpio.h"
+#include "hardware/interp.h"
+#include "hardware/irq.h"
+#include "hardware/structs/watchdog.h"
+#include "hardware/timer.h"
+#include "hardware/watchdog.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tusb.h"
+
+#define PIO_FIFO_DEPTH 4U
+#define PIO_FIFO_JOINED_DEPTH 8U
+#define CDC_BUFFER_SIZE 65536U
+
+// =============================================================================
+// Register files visible to the firmware
+// =============================================================================
+
+pio_hw_t pico_host_pio_hw[NUM_PIOS];
+dma_hw_t pico_host_dma_hw;
+timer_hw_t pico_host_timer_hw;
+watchdog_hw_t pico_host_watchdog_hw;
+uint8_t pico_host_flash_image[PICO_FLASH_SIZE_BYTES];
+interp_hw_t pico_host_interp_hw[2];
+
+// =============================================================================
+// Model state
+// =============================================================================
+
+typedef struct {
+    uint32_t words[PIO_FIFO_JOINED_DEPTH];
+    uint32_t head;
+    uint32_t count;
+} host_fifo_t;
+
+typedef struct {
+    host_fifo_t rx[NUM_PIO_STATE_MACHINES];
+    host_fifo_t tx[NUM_PIO_STATE_MACHINES];
+    uint32_t used_instructions;
+    uint32_t claimed_sms;
+} host_pio_t;
+
+typedef struct {
+    uintptr_t read_ptr;
+    uintptr_t write_ptr;
+    uint32_t reload_count;
+    uint32_t remaining;
+    bool claimed;
+} host_dma_t;
+
+static host_pio_t g_pio[NUM_PIOS];
+static host_dma_t g_dma[NUM_DMA_CHANNELS];
+static bool g_interp_claimed[2][2];
+
+static irq_handler_t g_irq_handlers[PICO_HOST_IRQ_COUNT];
+static bool g_irq_enabled[PICO_HOST_IRQ_COUNT];
+static bool g_irq_active[PICO_HOST_IRQ_COUNT];
+
+static uint64_t g_time_us;
+static uint64_t g_sys_cycles;
+static uint64_t g_cycle_remainder; // sub-microsecond part of g_sys_cycles, in Hz*cycles
+static uint32_t g_sys_clock_hz = PICO_HOST_DEFAULT_SYS_CLOCK_HZ;
+static uint64_t g_gpio_values;
+static pico_host_pin_source_t g_pin_source;
+static void *g_pin_source_ctx;
+
+static pico_host_wait_hook_t g_wait_hook;
+static void *g_wait_ctx;
+
+static void (*g_reboot_handler)(void);
+static uint32_t g_reboot_count;
+
+static void (*g_usb_task_hook)(void *ctx);
+static void *g_usb_task_ctx;
+
+static uint8_t g_cdc_out[CDC_BUFFER_SIZE];
+static size_t g_cdc_out_len;
+static uint8_t g_cdc_in[CDC_BUFFER_SIZE];
+static size_t g_cdc_in_head;
+static size_t g_cdc_in_len;
+
+static void pio_update_irq(PIO pio);
+
+// DMA address registers and interpolator bases hold the low 32 bits of a host
+// pointer (see dma.h, interp.h). The firmware statics they point at live in
+// the same image as the register files, so the upper half comes from there.
+static uintptr_t host_image_address(uint32_t low)
+{
+    return ((uintptr_t)&pico_host_dma_hw & ~(uintptr_t)UINT32_MAX) | low;
+}
+
+// =============================================================================
+// Core
+// =============================================================================
+
+void pico_host_panic(const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    fputs("pico_host: ", stderr);
+    vfprintf(stderr, fmt, args);
+    fputc('\n', stderr);
+    va_end(args);
+    abort();
+}
+
+static void sync_timer_registers(void)
+{
+    pico_host_timer_hw.timerawl = (uint32_t)g_time_us;
+    pico_host_timer_hw.timerawh = (uint32_t)(g_time_us >> 32);
+    pico_host_timer_hw.timelr = (uint32_t)g_time_us;
+    pico_host_timer_hw.timehr = (uint32_t)(g_time_us >> 32);
+}
+
+static bool host_wait(pico_host_wait_reason_t reason, uint64_t deadline_us)
+{
+    if (!g_wait_hook) {
+        return false;
+    }
+    return g_wait_hook(reason, deadline_us, g_wait_ctx);
+}
+
+void pico_host_reset(void)
+{
+    memset(pico_host_pio_hw, 0, sizeof pico_host_pio_hw);
+    memset(&pico_host_dma_hw, 0, sizeof pico_host_dma_hw);
+    memset(&pico_host_timer_hw, 0, sizeof pico_host_timer_hw);
+    memset(&pico_host_watchdog_hw, 0, sizeof pico_host_watchdog_hw);
+    memset(pico_host_flash_image, 0xFF, sizeof pico_host_flash_image);
+    memset(g_pio, 0, sizeof g_pio);
+    memset(g_dma, 0, sizeof g_dma);
+    memset(pico_host_interp_hw, 0, sizeof pico_host_interp_hw);
+    memset(g_interp_claimed, 0, sizeof g_interp_claimed);
+    memset(g_irq_handlers, 0, sizeof g_irq_handlers);
+    memset(g_irq_enabled, 0, sizeof g_irq_enabled);
+    memset(g_irq_active, 0, sizeof g_irq_active);
+    g_time_us = 0;
+    g_sys_cycles = 0;
+    g_cycle_remainder = 0;
+    g_sys_clock_hz = PICO_HOST_DEFAULT_SYS_CLOCK_HZ;
+    g_gpio_values = 0;
+    g_pin_source = NULL;
+    g_pin_source_ctx = NULL;
+    g_wait_hook = NULL;
+    g_wait_ctx = NULL;
+    g_reboot_handler = NULL;
+    g_reboot_count = 0;
+    g_usb_task_hook = NULL;
+    g_usb_task_ctx = NULL;
+    g_cdc_out_len = 0;
+    g_cdc_in_head = 0;
+    g_cdc_in_len = 0;
+    for (uint32_t ch = 0; ch < NUM_DMA_CHANNELS; ch++) {
+        dma_channel_config c = dma_channel_get_default_config(ch);
+        pico_host_dma_hw.ch[ch].ctrl_trig = c.ctrl & ~(1U << DMA_CH0_CTRL_TRIG_EN_LSB);
+    }
+    pio_emu_reset();
+    pico_host_hdmi_reset();
+}
+
+void pico_host_set_wait_hook(pico_host_wait_hook_t hook, void *ctx)
+{
+    g_wait_hook = hook;
+    g_wait_ctx = ctx;
+}
+
+// =============================================================================
+// Time and clocks
+// =============================================================================
+
+void pico_host_advance_us(uint64_t us)
+{
+    g_time_us += us;
+    g_sys_cycles += (us * g_sys_clock_hz) / 1000000U;
+    sync_timer_registers();
+}
+
+void pico_host_set_time_us(uint64_t us)
+{
+    if (us > g_time_us) {
+        g_sys_cycles += ((us - g_time_us) * g_sys_clock_hz) / 1000000U;
+    }
+    g_time_us = us;
+    sync_timer_registers();
+}
+
+void pico_host_advance_cycles(uint64_t cycles)
+{
+    g_sys_cycles += cycles;
+    g_cycle_remainder += cycles * 1000000U;
+    if (g_cycle_remainder >= g_sys_clock_hz) {
+        g_time_us += g_cycle_remainder / g_sys_clock_hz;
+        g_cycle_remainder %= g_sys_clock_hz;
+        sync_timer_registers();
+    }
+}
+
+uint64_t pico_host_sys_cycles(void)
+{
+    return g_sys_cycles;
+}
+
+void pico_host_set_sys_clock_hz(uint32_t hz)
+{
+    g_sys_clock_hz = hz;
+}
+
+uint64_t time_us_64(void)
+{
+    return g_time_us;
+}
+
+void sleep_us(uint64_t us)
+{
+    const uint64_t deadline = g_time_us + us;
+    while (g_time_us < deadline) {
+        if (!host_wait(PICO_HOST_WAIT_SLEEP, deadline)) {
+            pico_host_set_time_us(deadline);
+        }
+    }
+}
+
+void sleep_ms(uint32_t ms)
+{
+    sleep_us((uint64_t)ms * 1000U);
+}
+
+uint32_t clock_get_hz(enum clock_index clk_index)
+{
+    switch (clk_index) {
+    case clk_sys:
+    case clk_peri:
+        return g_sys_clock_hz;
+    case clk_usb:
+    case clk_adc:
+        return 48000000U;
+    default:
+        return 12000000U;
+    }
+}
+
+void pico_host_wait_for_event(void)
+{
+    (void)host_wait(PICO_HOST_WAIT_EVENT, PICO_HOST_NO_DEADLINE);
+}
+
+// =============================================================================
+// Semaphores
+// =============================================================================
+
+void sem_init(semaphore_t *sem, int16_t initial_permits, int16_t max_permits)
+{
+    sem->permits = initial_permits;
+    sem->max_permits = max_permits;
+}
+
+bool sem_release(semaphore_t *sem)
+{
+    if (sem->permits >= sem->max_permits) {
+        return false;
+    }
+    sem->permits++;
+    return true;
+}
+
+void sem_reset(semaphore_t *sem, int16_t permits)
+{
+    sem->permits = permits;
+}
+
+int sem_available(semaphore_t *sem)
+{
+    return sem->permits;
+}
+
+static bool sem_acquire_until(semaphore_t *sem, uint64_t deadline_us)
+{
+    while (sem->permits <= 0) {
+        if (g_time_us >= deadline_us) {
+            return false;
+        }
+        if (!host_wait(PICO_HOST_WAIT_SEM, deadline_us)) {
+            if (deadline_us == PICO_HOST_NO_DEADLINE) {
+                pico_host_panic("sem_acquire_blocking: no permit will ever arrive");
+            }
+            pico_host_set_time_us(deadline_us);
+            return false;
+        }
+    }
+    sem->permits--;
+    return true;
+}
+
+bool sem_acquire_timeout_ms(semaphore_t *sem, uint32_t timeout_ms)
+{
+    return sem_acquire_until(sem, g_time_us + ((uint64_t)timeout_ms * 1000U));
+}
+
+bool sem_acquire_timeout_us(semaphore_t *sem, uint32_t timeout_us)
+{
+    return sem_acquire_until(sem, g_time_us + timeout_us);
+}
+
+void sem_acquire_blocking(semaphore_t *sem)
+{
+    (void)sem_acquire_until(sem, PICO_HOST_NO_DEADLINE);
+}
+
+// =============================================================================
+// Interrupts
+// =============================================================================
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler)
+{
+    if (num >= PICO_HOST_IRQ_COUNT) {
+        pico_host_panic("irq_set_exclusive_handler: bad IRQ %u", num);
+    }
+    if (g_irq_handlers[num] && g_irq_handlers[num] != handler) {
+        pico_host_panic("irq_set_exclusive_handler: IRQ %u already has a handler", num);
+    }
+    g_irq_handlers[num] = handler;
+}
+
+void irq_set_enabled(uint num, bool enabled)
+{
+    if (num >= PICO_HOST_IRQ_COUNT) {
+        pico_host_panic("irq_set_enabled: bad IRQ %u", num);
+    }
+    g_irq_enabled[num] = enabled;
+    // A level-triggered PIO source that stayed asserted while masked fires as
+    // soon as it is unmasked.
+    if (enabled && num >= PIO0_IRQ_0 && num <= PIO2_IRQ_1) {
+        pio_update_irq(&pico_host_pio_hw[(num - PIO0_IRQ_0) / 2U]);
+    }
+}
+
+bool irq_is_enabled(uint num)
+{
+    return num < PICO_HOST_IRQ_COUNT && g_irq_enabled[num];
+}
+
+bool pico_host_irq_fire(uint32_t num)
+{
+    if (num >= PICO_HOST_IRQ_COUNT || !g_irq_enabled[num] || !g_irq_handlers[num] || g_irq_active[num]) {
+        return false;
+    }
+    g_irq_active[num] = true;
+    g_irq_handlers[num]();
+    g_irq_active[num] = false;
+    return true;
+}
+
+// =============================================================================
+// PIO
+// =============================================================================
+
+static host_pio_t *host_pio(PIO pio)
+{
+    return &g_pio[pio_get_index(pio)];
+}
+
+static uint32_t fifo_depth(PIO pio, uint32_t sm, bool rx)
+{
+    const uint32_t shiftctrl = pio->sm[sm].shiftctrl;
+    const bool joined = rx ? (shiftctrl & (1U << PIO_SM0_SHIFTCTRL_FJOIN_RX_LSB)) != 0U
+                           : (shiftctrl & (1U << PIO_SM0_SHIFTCTRL_FJOIN_TX_LSB)) != 0U;
+    return joined ? PIO_FIFO_JOINED_DEPTH : PIO_FIFO_DEPTH;
+}
+
+static bool fifo_push(host_fifo_t *fifo, uint32_t depth, uint32_t word)
+{
+    if (fifo->count >= depth) {
+        return false;
+    }
+    fifo->words[(fifo->head + fifo->count) % PIO_FIFO_JOINED_DEPTH] = word;
+    fifo->count++;
+    return true;
+}
+
+static bool fifo_pop(host_fifo_t *fifo, uint32_t *word)
+{
+    if (fifo->count == 0U) {
+        return false;
+    }
+    *word = fifo->words[fifo->head];
+    fifo->head = (fifo->head + 1U) % PIO_FIFO_JOINED_DEPTH;
+    fifo->count--;
+    return true;
+}
+
+// INTR as the RP2350 lays it out: RXNEMPTY in bits 3:0, TXNFULL in 7:4 and
+// the eight PIO IRQ flags in 15:8. Both NVIC lines are level-triggered, so a
+// handler keeps running while its source stays asserted.
+static uint32_t pio_raw_intr(PIO pio)
+{
+    host_pio_t *hp = host_pio(pio);
+    uint32_t intr = (pio->irq & 0xFFU) << 8;
+    for (uint32_t sm = 0; sm < NUM_PIO_STATE_MACHINES; sm++) {
+        if (hp->rx[sm].count != 0U) {
+            intr |= 1U << sm;
+        }
+        if (hp->tx[sm].count < fifo_depth(pio, sm, false)) {
+            intr |= 1U << (4U + sm);
+        }
+    }
+    return intr;
+}
+
+static void pio_update_irq(PIO pio)
+{
+    const uint32_t irq_base = PIO0_IRQ_0 + (pio_get_index(pio) * 2U);
+    for (uint32_t line = 0; line < 2U; line++) {
+        const uint32_t num = irq_base + line;
+        // Bounded: a handler that never clears its source would otherwise spin
+        // forever; on hardware that is a hang, here it is a test failure.
+        for (uint32_t guard = 0; guard < 64U; guard++) {
+            const uint32_t intr = pio_raw_intr(pio);
+            pio->intr = intr;
+            pio->ints0 = intr & pio->inte0;
+            pio->ints1 = intr & pio->inte1;
+            const uint32_t ints = line == 0U ? pio->ints0 : pio->ints1;
+            if (ints == 0U || !pico_host_irq_fire(num)) {
+                break;
+            }
+            if (guard == 63U) {
+                pico_host_panic("PIO%u IRQ_%u handler never deasserts its source", pio_get_index(pio), line);
+            }
+        }
+    }
+}
+
+int pio_set_gpio_base(PIO pio, uint gpio_base)
+{
+    if (gpio_base != 0U && gpio_base != 16U) {
+        return -1;
+    }
+    pio->gpiobase = gpio_base;
+    return 0;
+}
+
+void pio_clear_instruction_memory(PIO pio)
+{
+    host_pio(pio)->used_instructions = 0;
+    for (uint32_t i = 0; i < PIO_INSTRUCTION_COUNT; i++) {
+        pio->instr_mem[i] = pio_encode_jmp(i);
+    }
+}
+
+static int find_offset_for_program(PIO pio, const pio_program_t *program)
+{
+    const uint32_t used = host_pio(pio)->used_instructions;
+    const uint32_t mask = (program->length >= 32U) ? 0xFFFFFFFFU : ((1U << program->length) - 1U);
+    if (program->origin >= 0) {
+        if ((uint32_t)program->origin > PIO_INSTRUCTION_COUNT - program->length) {
+            return -1;
+        }
+        return (used & (mask << (uint32_t)program->origin)) ? -1 : program->origin;
+    }
+    // Same search order as the SDK: always work down from the top.
+    for (int i = (int)(PIO_INSTRUCTION_COUNT - program->length); i >= 0; i--) {
+        if (!(used & (mask << (uint32_t)i))) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool pio_can_add_program(PIO pio, const pio_program_t *program)
+{
+    return find_offset_for_program(pio, program) >= 0;
+}
+
+uint pio_add_program(PIO pio, const pio_program_t *program)
+{
+    const int offset = find_offset_for_program(pio, program);
+    if (offset < 0) {
+        pico_host_panic("pio_add_program: no program space on PIO%u", pio_get_index(pio));
+    }
+    for (uint32_t i = 0; i < program->length; i++) {
+        const uint16_t instr = program->instructions[i];
+        // JMP targets are program-relative in pioasm output.
+        pio->instr_mem[(uint32_t)offset + i] = ((instr & 0xE000U) == 0U) ? (uint32_t)(instr + offset) : instr;
+    }
+    const uint32_t mask = (program->length >= 32U) ? 0xFFFFFFFFU : ((1U << program->length) - 1U);
+    host_pio(pio)->used_instructions |= mask << (uint32_t)offset;
+    return (uint)offset;
+}
+
+void pio_remove_program(PIO pio, const pio_program_t *program, uint loaded_offset)
+{
+    const uint32_t mask = (program->length >= 32U) ? 0xFFFFFFFFU : ((1U << program->length) - 1U);
+    host_pio(pio)->used_instructions &= ~(mask << loaded_offset);
+}
+
+int pio_claim_unused_sm(PIO pio, bool required)
+{
+    host_pio_t *hp = host_pio(pio);
+    for (uint32_t sm = 0; sm < NUM_PIO_STATE_MACHINES; sm++) {
+        if (!(hp->claimed_sms & (1U << sm))) {
+            hp->claimed_sms |= 1U << sm;
+            return (int)sm;
+        }
+    }
+    if (required) {
+        pico_host_panic("pio_claim_unused_sm: no free SM on PIO%u", pio_get_index(pio));
+    }
+    return -1;
+}
+
+void pio_sm_claim(PIO pio, uint sm)
+{
+    host_pio_t *hp = host_pio(pio);
+    if (hp->claimed_sms & (1U << sm)) {
+        pico_host_panic("pio_sm_claim: PIO%u SM%u already claimed", pio_get_index(pio), sm);
+    }
+    hp->claimed_sms |= 1U << sm;
+}
+
+void pio_sm_unclaim(PIO pio, uint sm)
+{
+    host_pio(pio)->claimed_sms &= ~(1U << sm);
+}
+
+void pio_sm_set_config(PIO pio, uint sm, const pio_sm_config *config)
+{
+    pio->sm[sm].clkdiv = config->clkdiv;
+    pio->sm[sm].execctrl = config->execctrl;
+    pio->sm[sm].shiftctrl = config->shiftctrl;
+    pio->sm[sm].pinctrl = config->pinctrl;
+}
+
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled)
+{
+    pio->ctrl = enabled ? (pio->ctrl | (1U << sm)) : (pio->ctrl & ~(1U << sm));
+}
+
+void pio_sm_restart(PIO pio, uint sm)
+{
+    pio_emu_sm_restart(pio, sm);
+}
+
+void pio_sm_clear_fifos(PIO pio, uint sm)
+{
+    host_pio_t *hp = host_pio(pio);
+    memset(&hp->rx[sm], 0, sizeof hp->rx[sm]);
+    memset(&hp->tx[sm], 0, sizeof hp->tx[sm]);
+    pio_update_irq(pio);
+}
+
+void pio_sm_exec(PIO pio, uint sm, uint instr)
+{
+    pio->sm[sm].instr = instr;
+    pio_emu_exec(pio, sm, instr);
+}
+
+void pio_sm_init(PIO pio, uint sm, uint initial_pc, const pio_sm_config *config)
+{
+    pio_sm_set_enabled(pio, sm, false);
+    pio_sm_set_config(pio, sm, config);
+    pio_sm_clear_fifos(pio, sm);
+    pio_sm_restart(pio, sm);
+    pio_sm_exec(pio, sm, pio_encode_jmp(initial_pc));
+}
+
+void pio_sm_put(PIO pio, uint sm, uint32_t data)
+{
+    (void)fifo_push(&host_pio(pio)->tx[sm], fifo_depth(pio, sm, false), data);
+    pio_update_irq(pio);
+}
+
+void pio_sm_put_blocking(PIO pio, uint sm, uint32_t data)
+{
+    while (pio_sm_is_tx_fifo_full(pio, sm)) {
+        if (!host_wait(PICO_HOST_WAIT_PIO_TX, PICO_HOST_NO_DEADLINE)) {
+            pico_host_panic("pio_sm_put_blocking: PIO%u SM%u TX FIFO never drains", pio_get_index(pio), sm);
+        }
+    }
+    pio_sm_put(pio, sm, data);
+}
+
+uint32_t pio_sm_get(PIO pio, uint sm)
+{
+    uint32_t word = 0;
+    (void)fifo_pop(&host_pio(pio)->rx[sm], &word);
+    pio_update_irq(pio);
+    return word;
+}
+
+uint32_t pio_sm_get_blocking(PIO pio, uint sm)
+{
+    while (pio_sm_is_rx_fifo_empty(pio, sm)) {
+        if (!host_wait(PICO_HOST_WAIT_PIO_RX, PICO_HOST_NO_DEADLINE)) {
+            pico_host_panic("pio_sm_get_blocking: PIO%u SM%u RX FIFO never fills", pio_get_index(pio), sm);
+        }
+    }
+    return pio_sm_get(pio, sm);
+}
+
+bool pio_sm_is_rx_fifo_empty(PIO pio, uint sm)
+{
+    return host_pio(pio)->rx[sm].count == 0U;
+}
+
+bool pio_sm_is_rx_fifo_full(PIO pio, uint sm)
+{
+    return host_pio(pio)->rx[sm].count >= fifo_depth(pio, sm, true);
+}
+
+uint pio_sm_get_rx_fifo_level(PIO pio, uint sm)
+{
+    return host_pio(pio)->rx[sm].count;
+}
+
+bool pio_sm_is_tx_fifo_empty(PIO pio, uint sm)
+{
+    return host_pio(pio)->tx[sm].count == 0U;
+}
+
+bool pio_sm_is_tx_fifo_full(PIO pio, uint sm)
+{
+    return host_pio(pio)->tx[sm].count >= fifo_depth(pio, sm, false);
+}
+
+uint pio_sm_get_tx_fifo_level(PIO pio, uint sm)
+{
+    return host_pio(pio)->tx[sm].count;
+}
+
+uint8_t pio_sm_get_pc(PIO pio, uint sm)
+{
+    return (uint8_t)(pio->sm[sm].addr & 0x1FU);
+}
+
+bool pio_interrupt_get(PIO pio, uint pio_interrupt_num)
+{
+    return (pio->irq & (1U << pio_interrupt_num)) != 0U;
+}
+
+void pio_interrupt_clear(PIO pio, uint pio_interrupt_num)
+{
+    pio->irq &= ~(1U << pio_interrupt_num);
+    pio_update_irq(pio);
+}
+
+static void dma_service_dreq(uint32_t dreq);
+
+bool pico_host_pio_push_rx(PIO pio, uint32_t sm, uint32_t word)
+{
+    const bool pushed = fifo_push(&host_pio(pio)->rx[sm], fifo_depth(pio, sm, true), word);
+    dma_service_dreq(pio_get_dreq(pio, sm, false));
+    pio_update_irq(pio);
+    return pushed;
+}
+
+bool pico_host_pio_pop_tx(PIO pio, uint32_t sm, uint32_t *word)
+{
+    const bool popped = fifo_pop(&host_pio(pio)->tx[sm], word);
+    pio_update_irq(pio);
+    return popped;
+}
+
+void pico_host_pio_irq_set(PIO pio, uint32_t irq_num)
+{
+    pio->irq |= 1U << (irq_num & 7U);
+    pio_update_irq(pio);
+}
+
+bool pico_host_pio_sm_enabled(PIO pio, uint32_t sm)
+{
+    return (pio->ctrl & (1U << sm)) != 0U;
+}
+
+bool pico_host_pio_sm_claimed(PIO pio, uint32_t sm)
+{
+    return (host_pio(pio)->claimed_sms & (1U << sm)) != 0U;
+}
+
+// =============================================================================
+// DMA
+// =============================================================================
+
+static bool dma_busy(uint32_t ch)
+{
+    return (pico_host_dma_hw.ch[ch].ctrl_trig & (1U << DMA_CH0_CTRL_TRIG_BUSY_LSB)) != 0U;
+}
+
+static void dma_sync_registers(uint32_t ch)
+{
+    pico_host_dma_hw.ch[ch].read_addr = (uint32_t)g_dma[ch].read_ptr;
+    pico_host_dma_hw.ch[ch].write_addr = (uint32_t)g_dma[ch].write_ptr;
+    pico_host_dma_hw.ch[ch].transfer_count = dma_busy(ch) ? g_dma[ch].remaining : g_dma[ch].reload_count;
+}
+
+static void dma_run_forced(uint32_t ch);
+
+static void dma_trigger(uint32_t ch)
+{
+    uint32_t ctrl = pico_host_dma_hw.ch[ch].ctrl_trig;
+    if (!(ctrl & (1U << DMA_CH0_CTRL_TRIG_EN_LSB))) {
+        return;
+    }
+    g_dma[ch].remaining = g_dma[ch].reload_count;
+    if (g_dma[ch].remaining == 0U) {
+        return;
+    }
+    pico_host_dma_hw.ch[ch].ctrl_trig = ctrl | (1U << DMA_CH0_CTRL_TRIG_BUSY_LSB);
+    dma_sync_registers(ch);
+    // A FIFO that filled while the channel was idle drains as soon as it
+    // is re-armed, exactly as a held DREQ would.
+    const uint32_t dreq = (ctrl & DMA_CH0_CTRL_TRIG_TREQ_SEL_BITS) >> DMA_CH0_CTRL_TRIG_TREQ_SEL_LSB;
+    if (dreq != DREQ_FORCE) {
+        dma_service_dreq(dreq);
+    } else {
+        dma_run_forced(ch);
+    }
+}
+
+static uint32_t dma_raw_irq(void)
+{
+    return pico_host_dma_hw.irq_ctrl[0].intr;
+}
+
+static void dma_set_raw_irq(uint32_t intr)
+{
+    for (uint32_t line = 0; line < NUM_DMA_IRQS; line++) {
+        dma_irq_ctrl_hw_t *ctrl = &pico_host_dma_hw.irq_ctrl[line];
+        ctrl->intr = intr;
+        ctrl->ints = intr & ctrl->inte;
+    }
+}
+
+static void dma_complete(uint32_t ch)
+{
+    const uint32_t ctrl = pico_host_dma_hw.ch[ch].ctrl_trig & ~(1U << DMA_CH0_CTRL_TRIG_BUSY_LSB);
+    pico_host_dma_hw.ch[ch].ctrl_trig = ctrl;
+    dma_sync_registers(ch);
+    if (!(ctrl & (1U << DMA_CH0_CTRL_TRIG_IRQ_QUIET_LSB))) {
+        dma_set_raw_irq(dma_raw_irq() | (1U << ch));
+        for (uint32_t line = 0; line < NUM_DMA_IRQS; line++) {
+            if (pico_host_dma_hw.irq_ctrl[line].ints & (1U << ch)) {
+                (void)pico_host_irq_fire(DMA_IRQ_0 + line);
+            }
+        }
+    }
+    const uint32_t chain_to = (ctrl & DMA_CH0_CTRL_TRIG_CHAIN_TO_BITS) >> DMA_CH0_CTRL_TRIG_CHAIN_TO_LSB;
+    if (chain_to != ch) {
+        dma_trigger(chain_to);
+    }
+}
+
+static void dma_store_word(uint32_t ch, uint32_t word)
+{
+    host_dma_t *d = &g_dma[ch];
+    const uint32_t ctrl = pico_host_dma_hw.ch[ch].ctrl_trig;
+    const uint32_t size = 1U << ((ctrl & DMA_CH0_CTRL_TRIG_DATA_SIZE_BITS) >> DMA_CH0_CTRL_TRIG_DATA_SIZE_LSB);
+    switch (size) {
+    case 1U:
+        *(volatile uint8_t *)d->write_ptr = (uint8_t)word;
+        break;
+    case 2U:
+        *(volatile uint16_t *)d->write_ptr = (uint16_t)word;
+        break;
+    default:
+        *(volatile uint32_t *)d->write_ptr = word;
+        break;
+    }
+    if (ctrl & (1U << DMA_CH0_CTRL_TRIG_INCR_WRITE_LSB)) {
+        const uint32_t ring_bits = (ctrl & DMA_CH0_CTRL_TRIG_RING_SIZE_BITS) >> DMA_CH0_CTRL_TRIG_RING_SIZE_LSB;
+        const bool ring_on_write = (ctrl & (1U << DMA_CH0_CTRL_TRIG_RING_SEL_LSB)) != 0U;
+        uintptr_t next = d->write_ptr + size;
+        if (ring_bits != 0U && ring_on_write) {
+            const uintptr_t mask = ((uintptr_t)1U << ring_bits) - 1U;
+            next = (d->write_ptr & ~mask) | (next & mask);
+        }
+        d->write_ptr = next;
+    }
+    if (ctrl & (1U << DMA_CH0_CTRL_TRIG_INCR_READ_LSB)) {
+        d->read_ptr += size;
+    }
+    d->remaining--;
+    dma_sync_registers(ch);
+}
+
+// A word a DMA transfer stored into `target`: if that is a channel register,
+// apply it the way the register write would. Each of the four alias groups
+// ends in a trigger register; writing zero there is a null trigger.
+static void dma_register_write(uintptr_t target, uint32_t word)
+{
+    const uintptr_t base = (uintptr_t)&pico_host_dma_hw.ch[0];
+    if (target < base || target >= (uintptr_t)&pico_host_dma_hw.ch[NUM_DMA_CHANNELS]) {
+        return;
+    }
+    const uint32_t ch = (uint32_t)((target - base) / sizeof(dma_channel_hw_t));
+    dma_channel_hw_t *hw = &pico_host_dma_hw.ch[ch];
+    const uintptr_t reg = target - (uintptr_t)hw;
+    const bool trigger = reg == offsetof(dma_channel_hw_t, ctrl_trig) ||
+                         reg == offsetof(dma_channel_hw_t, al1_transfer_count_trig) ||
+                         reg == offsetof(dma_channel_hw_t, al2_write_addr_trig) ||
+                         reg == offsetof(dma_channel_hw_t, al3_read_addr_trig);
+    if (reg == offsetof(dma_channel_hw_t, read_addr) || reg == offsetof(dma_channel_hw_t, al1_read_addr) ||
+        reg == offsetof(dma_channel_hw_t, al2_read_addr) || reg == offsetof(dma_channel_hw_t, al3_read_addr_trig)) {
+        g_dma[ch].read_ptr = host_image_address(word);
+    } else if (reg == offsetof(dma_channel_hw_t, write_addr) || reg == offsetof(dma_channel_hw_t, al1_write_addr) ||
+               reg == offsetof(dma_channel_hw_t, al2_write_addr_trig) ||
+               reg == offsetof(dma_channel_hw_t, al3_write_addr)) {
+        g_dma[ch].write_ptr = host_image_address(word);
+    } else if (reg == offsetof(dma_channel_hw_t, transfer_count) ||
+               reg == offsetof(dma_channel_hw_t, al1_transfer_count_trig) ||
+               reg == offsetof(dma_channel_hw_t, al2_transfer_count) ||
+               reg == offsetof(dma_channel_hw_t, al3_transfer_count)) {
+        g_dma[ch].reload_count = word;
+    } else {
+        const uint32_t busy = hw->ctrl_trig & (1U << DMA_CH0_CTRL_TRIG_BUSY_LSB);
+        hw->ctrl_trig = (word & ~(1U << DMA_CH0_CTRL_TRIG_BUSY_LSB)) | busy;
+    }
+    dma_sync_registers(ch);
+    if (trigger && word != 0U) {
+        dma_trigger(ch);
+    }
+}
+
+// Unpaced transfers: copy memory to memory until the count runs out. The
+// register side effect of each word is applied after the transfer is
+// accounted, so a control block that re-triggers its chain source finds this
+// channel idle again.
+static void dma_run_forced(uint32_t ch)
+{
+    while (dma_busy(ch)) {
+        const uint32_t ctrl = pico_host_dma_hw.ch[ch].ctrl_trig;
+        const uint32_t size = 1U << ((ctrl & DMA_CH0_CTRL_TRIG_DATA_SIZE_BITS) >> DMA_CH0_CTRL_TRIG_DATA_SIZE_LSB);
+        uint32_t word;
+        switch (size) {
+        case 1U:
+            word = *(const volatile uint8_t *)g_dma[ch].read_ptr;
+            break;
+        case 2U:
+            word = *(const volatile uint16_t *)g_dma[ch].read_ptr;
+            break;
+        default:
+            word = *(const volatile uint32_t *)g_dma[ch].read_ptr;
+            break;
+        }
+        const uintptr_t target = g_dma[ch].write_ptr;
+        dma_store_word(ch, word);
+        if (g_dma[ch].remaining == 0U) {
+            dma_complete(ch);
+        }
+        dma_register_write(target, word);
+    }
+}
+
+uint32_t pico_host_dma_write(uint32_t channel, const uint32_t *words, uint32_t count)
+{
+    uint32_t accepted = 0;
+    while (accepted < count && dma_busy(channel)) {
+        dma_store_word(channel, words[accepted++]);
+        if (g_dma[channel].remaining == 0U) {
+            dma_complete(channel);
+        }
+    }
+    return accepted;
+}
+
+// Move words from a PIO RX FIFO into every busy channel paced by its DREQ.
+static void dma_service_dreq(uint32_t dreq)
+{
+    for (uint32_t ch = 0; ch < NUM_DMA_CHANNELS; ch++) {
+        const uint32_t ctrl = pico_host_dma_hw.ch[ch].ctrl_trig;
+        if (!dma_busy(ch) || ((ctrl & DMA_CH0_CTRL_TRIG_TREQ_SEL_BITS) >> DMA_CH0_CTRL_TRIG_TREQ_SEL_LSB) != dreq) {
+            continue;
+        }
+        for (uint32_t pio_idx = 0; pio_idx < NUM_PIOS; pio_idx++) {
+            PIO pio = &pico_host_pio_hw[pio_idx];
+            for (uint32_t sm = 0; sm < NUM_PIO_STATE_MACHINES; sm++) {
+                if (g_dma[ch].read_ptr != (uintptr_t)&pio->rxf[sm] || pio_get_dreq(pio, sm, false) != dreq) {
+                    continue;
+                }
+                uint32_t word;
+                while (dma_busy(ch) && fifo_pop(&g_pio[pio_idx].rx[sm], &word)) {
+                    // RX FIFO reads never increment the read address.
+                    g_dma[ch].read_ptr = (uintptr_t)&pio->rxf[sm];
+                    dma_store_word(ch, word);
+                    g_dma[ch].read_ptr = (uintptr_t)&pio->rxf[sm];
+                    if (g_dma[ch].remaining == 0U) {
+                        dma_complete(ch);
+                    }
+                }
+            }
+        }
+    }
+}
+
+uint32_t pico_host_dma_remaining(uint32_t channel)
+{
+    return dma_busy(channel) ? g_dma[channel].remaining : 0U;
+}
+
+volatile void *pico_host_dma_write_ptr(uint32_t channel)
+{
+    return (volatile void *)g_dma[channel].write_ptr;
+}
+
+int dma_claim_unused_channel(bool required)
+{
+    for (uint32_t ch = 0; ch < NUM_DMA_CHANNELS; ch++) {
+        if (!g_dma[ch].claimed) {
+            g_dma[ch].claimed = true;
+            return (int)ch;
+        }
+    }
+    if (required) {
+        pico_host_panic("dma_claim_unused_channel: no free channel");
+    }
+    return -1;
+}
+
+void dma_channel_claim(uint channel)
+{
+    if (g_dma[channel].claimed) {
+        pico_host_panic("dma_channel_claim: channel %u already claimed", channel);
+    }
+    g_dma[channel].claimed = true;
+}
+
+void dma_channel_unclaim(uint channel)
+{
+    g_dma[channel].claimed = false;
+}
+
+void dma_channel_set_config(uint channel, const dma_channel_config *config, bool trigger)
+{
+    const uint32_t busy = pico_host_dma_hw.ch[channel].ctrl_trig & (1U << DMA_CH0_CTRL_TRIG_BUSY_LSB);
+    pico_host_dma_hw.ch[channel].ctrl_trig = (config->ctrl & ~(1U << DMA_CH0_CTRL_TRIG_BUSY_LSB)) | busy;
+    if (trigger) {
+        dma_trigger(channel);
+    }
+}
+
+void dma_channel_set_read_addr(uint channel, const volatile void *read_addr, bool trigger)
+{
+    g_dma[channel].read_ptr = (uintptr_t)read_addr;
+    dma_sync_registers(channel);
+    if (trigger) {
+        dma_trigger(channel);
+    }
+}
+
+void dma_channel_set_write_addr(uint channel, volatile void *write_addr, bool trigger)
+{
+    g_dma[channel].write_ptr = (uintptr_t)write_addr;
+    dma_sync_registers(channel);
+    if (trigger) {
+        dma_trigger(channel);
+    }
+}
+
+void dma_channel_set_trans_count(uint channel, uint32_t trans_count, bool trigger)
+{
+    g_dma[channel].reload_count = trans_count;
+    dma_sync_registers(channel);
+    if (trigger) {
+        dma_trigger(channel);
+    }
+}
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint32_t transfer_count, bool trigger)
+{
+    dma_channel_set_read_addr(channel, read_addr, false);
+    dma_channel_set_write_addr(channel, write_addr, false);
+    dma_channel_set_trans_count(channel, transfer_count, false);
+    dma_channel_set_config(channel, config, trigger);
+}
+
+void dma_channel_start(uint channel)
+{
+    dma_trigger(channel);
+}
+
+void dma_channel_abort(uint channel)
+{
+    pico_host_dma_hw.ch[channel].ctrl_trig &= ~(1U << DMA_CH0_CTRL_TRIG_BUSY_LSB);
+    g_dma[channel].remaining = 0;
+    dma_sync_registers(channel);
+}
+
+bool dma_channel_is_busy(uint channel)
+{
+    return dma_busy(channel);
+}
+
+dma_channel_hw_t *dma_channel_hw_addr(uint channel)
+{
+    (void)host_wait(PICO_HOST_WAIT_DMA, g_time_us);
+    return &pico_host_dma_hw.ch[channel];
+}
+
+void dma_channel_wait_for_finish_blocking(uint channel)
+{
+    while (dma_busy(channel)) {
+        if (!host_wait(PICO_HOST_WAIT_DMA, PICO_HOST_NO_DEADLINE)) {
+            pico_host_panic("dma_channel_wait_for_finish_blocking: channel %u never completes", channel);
+        }
+    }
+}
+
+void dma_irqn_set_channel_enabled(uint irq_index, uint channel, bool enabled)
+{
+    if (irq_index >= NUM_DMA_IRQS) {
+        pico_host_panic("dma_irqn_set_channel_enabled: bad DMA IRQ %u", irq_index);
+    }
+    dma_irq_ctrl_hw_t *ctrl = &pico_host_dma_hw.irq_ctrl[irq_index];
+    ctrl->inte = enabled ? (ctrl->inte | (1U << channel)) : (ctrl->inte & ~(1U << channel));
+    ctrl->ints = ctrl->intr & ctrl->inte;
+}
+
+void dma_irqn_acknowledge_channel(uint irq_index, uint channel)
+{
+    if (irq_index >= NUM_DMA_IRQS) {
+        pico_host_panic("dma_irqn_acknowledge_channel: bad DMA IRQ %u", irq_index);
+    }
+    // The status is shared: acknowledging on one line clears it on all.
+    dma_set_raw_irq(dma_raw_irq() & ~(1U << channel));
+}
+
+// =============================================================================
+// Interpolators
+// =============================================================================
+
+static uint32_t interp_index(const interp_hw_t *interp)
+{
+    if (interp != interp0 && interp != interp1) {
+        pico_host_panic("interp: not an interpolator");
+    }
+    return interp == interp0 ? 0U : 1U;
+}
+
+static void interp_check_lane(const interp_hw_t *interp, uint lane)
+{
+    (void)interp_index(interp);
+    if (lane > 1U) {
+        pico_host_panic("interp: bad lane %u", lane);
+    }
+}
+
+void interp_claim_lane(interp_hw_t *interp, uint lane)
+{
+    interp_check_lane(interp, lane);
+    bool *claimed = &g_interp_claimed[interp_index(interp)][lane];
+    if (*claimed) {
+        pico_host_panic("interp_claim_lane: interp%u lane %u already claimed", interp_index(interp), lane);
+    }
+    *claimed = true;
+}
+
+void interp_unclaim_lane(interp_hw_t *interp, uint lane)
+{
+    interp_check_lane(interp, lane);
+    g_interp_claimed[interp_index(interp)][lane] = false;
+}
+
+bool interp_lane_is_claimed(interp_hw_t *interp, uint lane)
+{
+    interp_check_lane(interp, lane);
+    return g_interp_claimed[interp_index(interp)][lane];
+}
+
+void interp_set_config(interp_hw_t *interp, uint lane, interp_config *config)
+{
+    interp_check_lane(interp, lane);
+    if ((config->ctrl & (SIO_INTERP0_CTRL_LANE0_BLEND_BITS | SIO_INTERP1_CTRL_LANE0_CLAMP_BITS)) != 0U) {
+        pico_host_panic("interp_set_config: BLEND and CLAMP are not modelled");
+    }
+    interp->ctrl[lane] = config->ctrl;
+}
+
+static uint32_t interp_lane_input(const interp_hw_t *interp, uint lane)
+{
+    const bool cross = (interp->ctrl[lane] & SIO_INTERP0_CTRL_LANE0_CROSS_INPUT_BITS) != 0U;
+    return interp->accum[cross ? lane ^ 1U : lane];
+}
+
+uint32_t interp_get_raw(interp_hw_t *interp, uint lane)
+{
+    interp_check_lane(interp, lane);
+    const uint32_t ctrl = interp->ctrl[lane];
+    const uint32_t shift = (ctrl & SIO_INTERP0_CTRL_LANE0_SHIFT_BITS) >> SIO_INTERP0_CTRL_LANE0_SHIFT_LSB;
+    const uint32_t lsb = (ctrl & SIO_INTERP0_CTRL_LANE0_MASK_LSB_BITS) >> SIO_INTERP0_CTRL_LANE0_MASK_LSB_LSB;
+    const uint32_t msb = (ctrl & SIO_INTERP0_CTRL_LANE0_MASK_MSB_BITS) >> SIO_INTERP0_CTRL_LANE0_MASK_MSB_LSB;
+    // Bits lsb..msb; empty when msb < lsb.
+    const uint32_t below_msb = UINT32_MAX >> (31U - msb);
+    uint32_t value = (interp_lane_input(interp, lane) >> shift) & below_msb & (UINT32_MAX << lsb);
+    if ((ctrl & SIO_INTERP0_CTRL_LANE0_SIGNED_BITS) != 0U && ((value >> msb) & 1U) != 0U) {
+        value |= ~below_msb;
+    }
+    return value;
+}
+
+// A lane's result on the internal datapath, without FORCE_MSB.
+static uint32_t interp_lane_result(interp_hw_t *interp, uint lane)
+{
+    const bool add_raw = (interp->ctrl[lane] & SIO_INTERP0_CTRL_LANE0_ADD_RAW_BITS) != 0U;
+    return interp->base[lane] + (add_raw ? interp_lane_input(interp, lane) : interp_get_raw(interp, lane));
+}
+
+static uint32_t interp_bus_result(interp_hw_t *interp, uint lane)
+{
+    const uint32_t force =
+        (interp->ctrl[lane] & SIO_INTERP0_CTRL_LANE0_FORCE_MSB_BITS) >> SIO_INTERP0_CTRL_LANE0_FORCE_MSB_LSB;
+    return interp_lane_result(interp, lane) | (force << 28U);
+}
+
+static uint32_t interp_full_result(interp_hw_t *interp)
+{
+    return interp->base[2] + interp_get_raw(interp, 0U) + interp_get_raw(interp, 1U);
+}
+
+// Every POP writes both lane results back, whichever register was read.
+static void interp_writeback(interp_hw_t *interp)
+{
+    const uint32_t result[2] = {interp_lane_result(interp, 0U), interp_lane_result(interp, 1U)};
+    for (uint lane = 0; lane < 2U; lane++) {
+        const bool cross = (interp->ctrl[lane] & SIO_INTERP0_CTRL_LANE0_CROSS_RESULT_BITS) != 0U;
+        interp->accum[lane] = result[cross ? lane ^ 1U : lane];
+    }
+}
+
+uintptr_t interp_peek_lane_result(interp_hw_t *interp, uint lane)
+{
+    interp_check_lane(interp, lane);
+    return host_image_address(interp_bus_result(interp, lane));
+}
+
+uintptr_t interp_pop_lane_result(interp_hw_t *interp, uint lane)
+{
+    const uintptr_t result = interp_peek_lane_result(interp, lane);
+    interp_writeback(interp);
+    return result;
+}
+
+uintptr_t interp_peek_full_result(interp_hw_t *interp)
+{
+    (void)interp_index(interp);
+    return host_image_address(interp_full_result(interp));
+}
+
+uintptr_t interp_pop_full_result(interp_hw_t *interp)
+{
+    const uintptr_t result = interp_peek_full_result(interp);
+    interp_writeback(interp);
+    return result;
+}
+
+// =============================================================================
+// GPIO, flash, watchdog
+// =============================================================================
+
+bool gpio_get(uint gpio)
+{
+    (void)host_wait(PICO_HOST_WAIT_GPIO, g_time_us);
+    return ((pico_host_gpio_levels(g_sys_cycles) >> gpio) & 1U) != 0U;
+}
+
+void pico_host_set_pin_source(pico_host_pin_source_t source, void *ctx)
+{
+    g_pin_source = source;
+    g_pin_source_ctx = ctx;
+}
+
+uint64_t pico_host_gpio_levels(uint64_t cycle)
+{
+    return g_pin_source ? g_pin_source(cycle, g_pin_source_ctx) : g_gpio_values;
+}
+
+void pico_host_gpio_put(uint32_t gpio, bool value)
+{
+    g_gpio_values = value ? (g_gpio_values | (1ULL << gpio)) : (g_gpio_values & ~(1ULL << gpio));
+}
+
+void pico_host_gpio_put_all(uint64_t values)
+{
+    g_gpio_values = values;
+}
+
+void flash_range_erase(uint32_t flash_offs, size_t count)
+{
+    if ((flash_offs % FLASH_SECTOR_SIZE) != 0U || (count % FLASH_SECTOR_SIZE) != 0U ||
+        flash_offs + count > PICO_FLASH_SIZE_BYTES) {
+        pico_host_panic("flash_range_erase: bad range 0x%x+%zu", flash_offs, count);
+    }
+    memset(&pico_host_flash_image[flash_offs], 0xFF, count);
+}
+
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count)
+{
+    if ((flash_offs % FLASH_PAGE_SIZE) != 0U || (count % FLASH_PAGE_SIZE) != 0U ||
+        flash_offs + count > PICO_FLASH_SIZE_BYTES) {
+        pico_host_panic("flash_range_program: bad range 0x%x+%zu", flash_offs, count);
+    }
+    // NOR programming can only clear bits.
+    for (size_t i = 0; i < count; i++) {
+        pico_host_flash_image[flash_offs + i] &= data[i];
+    }
+}
+
+void watchdog_reboot(uint32_t pc, uint32_t sp, uint32_t delay_ms)
+{
+    (void)pc;
+    (void)sp;
+    (void)delay_ms;
+    g_reboot_count++;
+    if (!g_reboot_handler) {
+        pico_host_panic("watchdog_reboot requested with no reboot handler installed");
+    }
+    g_reboot_handler();
+}
+
+void pico_host_set_reboot_handler(void (*handler)(void))
+{
+    g_reboot_handler = handler;
+}
+
+uint32_t pico_host_reboot_count(void)
+{
+    return g_reboot_count;
+}
+
+// =============================================================================
+// TinyUSB CDC
+// =============================================================================
+
+void pico_host_set_usb_task_hook(void (*hook)(void *ctx), void *ctx)
+{
+    g_usb_task_hook = hook;
+    g_usb_task_ctx = ctx;
+}
+
+void tud_task(void)
+{
+    if (g_usb_task_hook != NULL) {
+        g_usb_task_hook(g_usb_task_ctx);
+    }
+}
+
+bool tud_cdc_connected(void)
+{
+    return true;
+}
+
+uint32_t tud_cdc_available(void)
+{
+    return (uint32_t)(g_cdc_in_len - g_cdc_in_head);
+}
+
+int32_t tud_cdc_read_char(void)
+{
+    if (g_cdc_in_head >= g_cdc_in_len) {
+        return -1;
+    }
+    return g_cdc_in[g_cdc_in_head++];
+}
+
+uint32_t tud_cdc_write_available(void)
+{
+    return (uint32_t)(CDC_BUFFER_SIZE - g_cdc_out_len);
+}
+
+uint32_t tud_cdc_write(const void *buffer, uint32_t bufsize)
+{
+    const uint32_t room = tud_cdc_write_available();
+    const uint32_t n = bufsize < room ? bufsize : room;
+    memcpy(&g_cdc_out[g_cdc_out_len], buffer, n);
+    g_cdc_out_len += n;
+    return n;
+}
+
+uint32_t tud_cdc_write_flush(void)
+{
+    return 0;
+}
+
+size_t pico_host_cdc_take(void *dst, size_t max)
+{
+    const size_t n = g_cdc_out_len < max ? g_cdc_out_len : max;
+    memcpy(dst, g_cdc_out, n);
+    memmove(g_cdc_out, &g_cdc_out[n], g_cdc_out_len - n);
+    g_cdc_out_len -= n;
+    return n;
+}
+
+void pico_host_cdc_inject(const void *src, size_t len)
+{
+    if (g_cdc_in_head == g_cdc_in_len) {
+        g_cdc_in_head = 0;
+        g_cdc_in_len = 0;
+    }
+    if (len > CDC_BUFFER_SIZE - g_cdc_in_len) {
+        len = CDC_BUFFER_SIZE - g_cdc_in_len;
+    }
+    memcpy(&g_cdc_in[g_cdc_in_len], src, len);
+    g_cdc_in_len += len;
+}
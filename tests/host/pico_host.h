@@ -0,0 +1,121 @@
+// Control surface for the host HAL model behind tests/host/include.
+//
+// The firmware runs single-threaded against this model. Anything the hardware
+// would do asynchronously (a PIO pushing a word, a DMA completing, an
+// interrupt firing, time passing) happens only when a test drives it, either
+// directly or from the wait hook that every blocking shim call invokes. That
+// keeps runs deterministic and lets a test decide exactly what the input
+// signal looks like at each point the firmware waits.
+#ifndef NEOPICO_HOST_PICO_HOST_H
+#define NEOPICO_HOST_PICO_HOST_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "hardware/dma.h"
+#include "hardware/pio.h"
+#include "pico_hdmi/hstx_data_island_queue.h"
+#include "pico_hdmi/video_output_rt.h"
+
+#define PICO_HOST_DEFAULT_SYS_CLOCK_HZ 126000000U
+#define PICO_HOST_NO_DEADLINE UINT64_MAX
+
+typedef enum {
+    PICO_HOST_WAIT_DMA,     // dma_channel_wait_for_finish_blocking(), dma_channel_hw_addr() polls
+    PICO_HOST_WAIT_SEM,     // sem_acquire_*() with no permit available
+    PICO_HOST_WAIT_EVENT,   // __wfe()/__wfi()
+    PICO_HOST_WAIT_PIO_TX,  // pio_sm_put_blocking() on a full TX FIFO
+    PICO_HOST_WAIT_PIO_RX,  // pio_sm_get_blocking() on an empty RX FIFO
+    PICO_HOST_WAIT_SLEEP,   // sleep_us()/sleep_ms()
+    PICO_HOST_WAIT_GPIO,    // gpio_get(): lets busy-wait pin polls make progress
+} pico_host_wait_reason_t;
+
+// Called whenever the firmware would block. Return true if the hook changed
+// anything (pushed data, fired an IRQ, advanced time); returning false means
+// "nothing more will happen": timed waits then expire at their deadline and
+// untimed DMA/FIFO waits are reported as a deadlock.
+typedef bool (*pico_host_wait_hook_t)(pico_host_wait_reason_t reason, uint64_t deadline_us, void *ctx);
+
+// Return every peripheral, the clock, flash and the CDC buffers to power-on
+// state. Registered callbacks and the wait hook are cleared too.
+void pico_host_reset(void);
+
+void pico_host_set_wait_hook(pico_host_wait_hook_t hook, void *ctx);
+void pico_host_panic(const char *fmt, ...) __attribute__((noreturn, format(printf, 1, 2)));
+
+// --- Time -------------------------------------------------------------------
+
+// Microsecond time and the system-clock cycle count move together: advancing
+// one advances the other at the current clock_get_hz(clk_sys) rate.
+void pico_host_advance_us(uint64_t us);
+void pico_host_set_time_us(uint64_t us);
+void pico_host_advance_cycles(uint64_t cycles);
+uint64_t pico_host_sys_cycles(void);
+void pico_host_set_sys_clock_hz(uint32_t hz);
+
+// --- Interrupts ---------------------------------------------------------------
+
+// Run the handler for `num` now if it is registered and enabled. Returns
+// whether a handler ran.
+bool pico_host_irq_fire(uint32_t num);
+
+// --- PIO ----------------------------------------------------------------------
+
+// Push one word into an SM's RX FIFO as the SM would (`push noblock`: the word
+// is dropped when the FIFO is full). Any busy DMA channel paced by that
+// FIFO's DREQ drains it immediately, and PIO interrupts are re-evaluated.
+bool pico_host_pio_push_rx(PIO pio, uint32_t sm, uint32_t word);
+bool pico_host_pio_pop_tx(PIO pio, uint32_t sm, uint32_t *word);
+// Raise PIO IRQ flag `irq_num` (0-7), as `irq set` would.
+void pico_host_pio_irq_set(PIO pio, uint32_t irq_num);
+bool pico_host_pio_sm_enabled(PIO pio, uint32_t sm);
+bool pico_host_pio_sm_claimed(PIO pio, uint32_t sm);
+
+// --- DMA ----------------------------------------------------------------------
+
+// Feed up to `count` words into a busy channel. Returns the number accepted
+// (fewer once the transfer count runs out). Completion clears BUSY, raises
+// the channel's interrupt and triggers CHAIN_TO like the engine does.
+// DREQ_FORCE channels need no feeding: they copy memory as soon as they are
+// triggered, and a copy into another channel's registers (a control block)
+// acts as that register write, trigger aliases and null triggers included.
+uint32_t pico_host_dma_write(uint32_t channel, const uint32_t *words, uint32_t count);
+uint32_t pico_host_dma_remaining(uint32_t channel);
+volatile void *pico_host_dma_write_ptr(uint32_t channel);
+
+// --- GPIO, watchdog, USB --------------------------------------------------------
+
+void pico_host_gpio_put(uint32_t gpio, bool value);
+void pico_host_gpio_put_all(uint64_t values);
+
+// Drive the GPIO inputs from a waveform instead of the static levels above:
+// GPIO n is bit n of the return value at system-clock `cycle`. gpio_get() and
+// the PIO emulator (pio_emu.h) both read through it.
+typedef uint64_t (*pico_host_pin_source_t)(uint64_t cycle, void *ctx);
+void pico_host_set_pin_source(pico_host_pin_source_t source, void *ctx);
+uint64_t pico_host_gpio_levels(uint64_t cycle);
+
+// watchdog_reboot() calls this handler (tests typically longjmp out of it).
+// With no handler installed a reboot request is a panic.
+void pico_host_set_reboot_handler(void (*handler)(void));
+uint32_t pico_host_reboot_count(void);
+
+size_t pico_host_cdc_take(void *dst, size_t max);
+void pico_host_cdc_inject(const void *src, size_t len);
+
+// tud_task() calls this (when set) in place of servicing USB, so a test can
+// see when the firmware runs it and charge it time.
+void pico_host_set_usb_task_hook(void (*hook)(void *ctx), void *ctx);
+
+// --- HDMI output (pico_hdmi stand-in) ---------------------------------------------
+
+video_output_scanline_cb_t pico_host_video_scanline_callback(void);
+video_output_vsync_cb_t pico_host_video_vsync_callback(void);
+uint8_t pico_host_video_scanline_level(void);
+int pico_host_video_vblank_htrim_px(void);
+void pico_host_hdmi_reset(void); // also run by pico_host_reset()
+void pico_host_di_queue_set_hsync_active(bool active);
+bool pico_host_di_queue_pop(hstx_data_island_t *island);
+
+#endif // NEOPICO_HOST_PICO_HOST_H
@@ -0,0 +1,750 @@
+// Cycle-level PIO interpreter. See pio_emu.h for the model.
+//
+// Instruction semantics follow the RP2350 datasheet, section 11.4. Every SM
+// clock tick either completes one instruction, burns one delay cycle, or
+// stalls (re-issuing the same instruction on the next tick).
+
+#include "pio_emu.h"
+
+#include "pico_host.h"
+
+#include <string.h>
+
+// RP2350 register fields the SDK headers in the shim do not name.
+#define EMU_EXECCTRL_STATUS_N_BITS 0x0000001FU
+#define EMU_EXECCTRL_STATUS_SEL_LSB 5U
+#define EMU_FDEBUG_RXSTALL_LSB 0U
+#define EMU_FDEBUG_TXSTALL_LSB 24U
+
+typedef enum {
+    STEP_DONE,    // completed; PC advanced (or wrapped)
+    STEP_JUMPED,  // completed; PC already set by the instruction
+    STEP_STALLED, // re-issue on the next tick
+} step_result_t;
+
+typedef struct {
+    pio_emu_sm_t sm[NUM_PIOS][NUM_PIO_STATE_MACHINES];
+    bool irq_wait_armed[NUM_PIOS][NUM_PIO_STATE_MACHINES];
+    bool autopush_pending[NUM_PIOS][NUM_PIO_STATE_MACHINES];
+    uint64_t cycle;
+    uint64_t pins_cycle[NUM_PIOS];
+    uint32_t pins[NUM_PIOS];
+    pio_emu_trace_t trace;
+    void *trace_ctx;
+} pio_emu_state_t;
+
+static pio_emu_state_t g_emu;
+
+// =============================================================================
+// Helpers
+// =============================================================================
+
+static inline uint32_t rotr32(uint32_t v, uint32_t n)
+{
+    n &= 31U;
+    return n == 0U ? v : (v >> n) | (v << (32U - n));
+}
+
+static inline uint32_t bit_count_or_32(uint32_t n)
+{
+    return n == 0U ? 32U : n;
+}
+
+static inline uint32_t low_mask(uint32_t n)
+{
+    return n >= 32U ? 0xFFFFFFFFU : ((1U << n) - 1U);
+}
+
+static uint32_t reverse32(uint32_t v)
+{
+    v = ((v >> 1) & 0x55555555U) | ((v & 0x55555555U) << 1);
+    v = ((v >> 2) & 0x33333333U) | ((v & 0x33333333U) << 2);
+    v = ((v >> 4) & 0x0F0F0F0FU) | ((v & 0x0F0F0F0FU) << 4);
+    v = ((v >> 8) & 0x00FF00FFU) | ((v & 0x00FF00FFU) << 8);
+    return (v >> 16) | (v << 16);
+}
+
+static inline uint32_t field(uint32_t reg, uint32_t lsb, uint32_t width)
+{
+    return (reg >> lsb) & low_mask(width);
+}
+
+static uint32_t push_threshold(PIO pio, uint32_t sm)
+{
+    return bit_count_or_32(field(pio->sm[sm].shiftctrl, PIO_SM0_SHIFTCTRL_PUSH_THRESH_LSB, 5U));
+}
+
+static uint32_t pull_threshold(PIO pio, uint32_t sm)
+{
+    return bit_count_or_32(field(pio->sm[sm].shiftctrl, PIO_SM0_SHIFTCTRL_PULL_THRESH_LSB, 5U));
+}
+
+// The 32 GPIOBASE-relative inputs as the SM sees them on this cycle: through
+// the two-flop synchronizer unless INPUT_SYNC_BYPASS is set for the pin.
+static uint32_t pio_inputs(PIO pio)
+{
+    const uint32_t index = pio_get_index(pio);
+    if (g_emu.pins_cycle[index] == g_emu.cycle + 1U) {
+        return g_emu.pins[index];
+    }
+    const uint32_t base = pio->gpiobase;
+    const uint64_t delayed_cycle =
+        g_emu.cycle >= PIO_EMU_INPUT_SYNC_CYCLES ? g_emu.cycle - PIO_EMU_INPUT_SYNC_CYCLES : 0U;
+    uint32_t pins = (uint32_t)(pico_host_gpio_levels(delayed_cycle) >> base);
+    const uint32_t bypass = pio->input_sync_bypass;
+    if (bypass != 0U) {
+        const uint32_t direct = (uint32_t)(pico_host_gpio_levels(g_emu.cycle) >> base);
+        pins = (pins & ~bypass) | (direct & bypass);
+    }
+    // Stored as cycle + 1 so the zeroed cache never matches cycle 0.
+    g_emu.pins_cycle[index] = g_emu.cycle + 1U;
+    g_emu.pins[index] = pins;
+    return pins;
+}
+
+static uint32_t in_pins(PIO pio, uint32_t sm)
+{
+    return rotr32(pio_inputs(pio), field(pio->sm[sm].pinctrl, PIO_SM0_PINCTRL_IN_BASE_LSB, 5U));
+}
+
+static void write_pads(volatile uint32_t *pads, uint32_t base, uint32_t count, uint32_t value)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        const uint32_t bit = 1U << ((base + i) & 31U);
+        *pads = ((value >> i) & 1U) ? (*pads | bit) : (*pads & ~bit);
+    }
+}
+
+// IRQ index with the RP2350 index modes: 0 this PIO, 1 previous PIO,
+// 2 SM-relative, 3 next PIO.
+static PIO irq_target(PIO pio, uint32_t sm, uint32_t operand, uint32_t *flag)
+{
+    const uint32_t index = operand & 7U;
+    const uint32_t mode = (operand >> 3) & 3U;
+    const uint32_t pio_index = pio_get_index(pio);
+    switch (mode) {
+    case 1U:
+        *flag = index;
+        return &pico_host_pio_hw[(pio_index + NUM_PIOS - 1U) % NUM_PIOS];
+    case 2U:
+        *flag = (index & 4U) | ((index + sm) & 3U);
+        return pio;
+    case 3U:
+        *flag = index;
+        return &pico_host_pio_hw[(pio_index + 1U) % NUM_PIOS];
+    default:
+        *flag = index;
+        return pio;
+    }
+}
+
+// =============================================================================
+// Instruction execution
+// =============================================================================
+
+static void jump_to(PIO pio, uint32_t sm, uint32_t addr)
+{
+    pio->sm[sm].addr = addr & 0x1FU;
+}
+
+static step_result_t exec_jmp(PIO pio, uint32_t sm, uint32_t instr)
+{
+    pio_emu_sm_t *s = &g_emu.sm[pio_get_index(pio)][sm];
+    bool taken;
+    switch ((instr >> 5) & 7U) {
+    case 0U:
+        taken = true;
+        break;
+    case 1U:
+        taken = s->x == 0U;
+        break;
+    case 2U:
+        taken = s->x != 0U;
+        s->x--;
+        break;
+    case 3U:
+        taken = s->y == 0U;
+        break;
+    case 4U:
+        taken = s->y != 0U;
+        s->y--;
+        break;
+    case 5U:
+        taken = s->x != s->y;
+        break;
+    case 6U:
+        taken = ((pio_inputs(pio) >> field(pio->sm[sm].execctrl, PIO_SM0_EXECCTRL_JMP_PIN_LSB, 5U)) & 1U) != 0U;
+        break;
+    default:
+        taken = s->osr_count < pull_threshold(pio, sm);
+        break;
+    }
+    if (!taken) {
+        return STEP_DONE;
+    }
+    jump_to(pio, sm, instr & 0x1FU);
+    return STEP_JUMPED;
+}
+
+static step_result_t exec_wait(PIO pio, uint32_t sm, uint32_t instr)
+{
+    const bool polarity = (instr & 0x80U) != 0U;
+    const uint32_t index = instr & 0x1FU;
+    bool level;
+    switch ((instr >> 5) & 3U) {
+    case 0U: // GPIO (GPIOBASE-relative on RP2350)
+        level = ((pio_inputs(pio) >> index) & 1U) != 0U;
+        break;
+    case 1U: // PIN, relative to IN_BASE
+        level = (in_pins(pio, sm) >> index) & 1U;
+        break;
+    case 2U: { // IRQ flag; a satisfied `wait 1 irq` clears it
+        uint32_t flag;
+        PIO target = irq_target(pio, sm, index, &flag);
+        level = pio_interrupt_get(target, flag);
+        if (polarity && level) {
+            pio_interrupt_clear(target, flag);
+        }
+        break;
+    }
+    default: { // JMPPIN (RP2350): JMP_PIN + index
+        const uint32_t jmp_pin = field(pio->sm[sm].execctrl, PIO_SM0_EXECCTRL_JMP_PIN_LSB, 5U);
+        level = ((pio_inputs(pio) >> ((jmp_pin + (index & 3U)) & 31U)) & 1U) != 0U;
+        break;
+    }
+    }
+    return level == polarity ? STEP_DONE : STEP_STALLED;
+}
+
+static bool try_autopush(PIO pio, uint32_t sm, pio_emu_sm_t *s)
+{
+    if (pio_sm_is_rx_fifo_full(pio, sm)) {
+        pio->fdebug |= 1U << (EMU_FDEBUG_RXSTALL_LSB + sm);
+        s->autopush_stall_cycles++;
+        return false;
+    }
+    const uint32_t word = s->isr;
+    s->isr = 0U;
+    s->isr_count = 0U;
+    s->rx_pushes++;
+    (void)pico_host_pio_push_rx(pio, sm, word);
+    return true;
+}
+
+static step_result_t exec_in(PIO pio, uint32_t sm, uint32_t instr)
+{
+    const uint32_t pio_index = pio_get_index(pio);
+    pio_emu_sm_t *s = &g_emu.sm[pio_index][sm];
+    bool *pending = &g_emu.autopush_pending[pio_index][sm];
+
+    // The shift already happened on the first issue; a stalled autopush only
+    // retries the push.
+    if (!*pending) {
+        const uint32_t count = bit_count_or_32(instr & 0x1FU);
+        uint32_t data;
+        switch ((instr >> 5) & 7U) {
+        case 0U:
+            data = in_pins(pio, sm);
+            break;
+        case 1U:
+            data = s->x;
+            break;
+        case 2U:
+            data = s->y;
+            break;
+        case 6U:
+            data = s->isr;
+            break;
+        case 7U:
+            data = s->osr;
+            break;
+        default:
+            data = 0U;
+            break;
+        }
+        data &= low_mask(count);
+        const bool shift_right = (pio->sm[sm].shiftctrl & (1U << PIO_SM0_SHIFTCTRL_IN_SHIFTDIR_LSB)) != 0U;
+        if (count == 32U) {
+            s->isr = data;
+        } else if (shift_right) {
+            s->isr = (s->isr >> count) | (data << (32U - count));
+        } else {
+            s->isr = (s->isr << count) | data;
+        }
+        s->isr_count = s->isr_count + count > 32U ? 32U : s->isr_count + count;
+    }
+
+    const bool autopush = (pio->sm[sm].shiftctrl & (1U << PIO_SM0_SHIFTCTRL_AUTOPUSH_LSB)) != 0U;
+    if (autopush && s->isr_count >= push_threshold(pio, sm)) {
+        *pending = !try_autopush(pio, sm, s);
+        if (*pending) {
+            return STEP_STALLED;
+        }
+    }
+    return STEP_DONE;
+}
+
+static bool pull_word(PIO pio, uint32_t sm, pio_emu_sm_t *s)
+{
+    uint32_t word;
+    if (!pico_host_pio_pop_tx(pio, sm, &word)) {
+        return false;
+    }
+    s->osr = word;
+    s->osr_count = 0U;
+    return true;
+}
+
+static step_result_t exec_out(PIO pio, uint32_t sm, uint32_t instr)
+{
+    pio_emu_sm_t *s = &g_emu.sm[pio_get_index(pio)][sm];
+    const uint32_t shiftctrl = pio->sm[sm].shiftctrl;
+    const bool autopull = (shiftctrl & (1U << PIO_SM0_SHIFTCTRL_AUTOPULL_LSB)) != 0U;
+    if (autopull && s->osr_count >= pull_threshold(pio, sm) && !pull_word(pio, sm, s)) {
+        pio->fdebug |= 1U << (EMU_FDEBUG_TXSTALL_LSB + sm);
+        return STEP_STALLED;
+    }
+
+    const uint32_t count = bit_count_or_32(instr & 0x1FU);
+    const bool shift_right = (shiftctrl & (1U << PIO_SM0_SHIFTCTRL_OUT_SHIFTDIR_LSB)) != 0U;
+    uint32_t data;
+    if (count == 32U) {
+        data = s->osr;
+        s->osr = 0U;
+    } else if (shift_right) {
+        data = s->osr & low_mask(count);
+        s->osr >>= count;
+    } else {
+        data = s->osr >> (32U - count);
+        s->osr <<= count;
+    }
+    s->osr_count = s->osr_count + count > 32U ? 32U : s->osr_count + count;
+
+    const uint32_t pinctrl = pio->sm[sm].pinctrl;
+    step_result_t result = STEP_DONE;
+    switch ((instr >> 5) & 7U) {
+    case 0U:
+        write_pads(&pio->dbg_padout, field(pinctrl, PIO_SM0_PINCTRL_OUT_BASE_LSB, 5U),
+                   field(pinctrl, PIO_SM0_PINCTRL_OUT_COUNT_LSB, 6U), data);
+        break;
+    case 1U:
+        s->x = data;
+        break;
+    case 2U:
+        s->y = data;
+        break;
+    case 4U:
+        write_pads(&pio->dbg_padoe, field(pinctrl, PIO_SM0_PINCTRL_OUT_BASE_LSB, 5U),
+                   field(pinctrl, PIO_SM0_PINCTRL_OUT_COUNT_LSB, 6U), data);
+        break;
+    case 5U:
+        jump_to(pio, sm, data);
+        result = STEP_JUMPED;
+        break;
+    case 6U:
+        s->isr = data;
+        s->isr_count = count;
+        break;
+    case 7U:
+        s->exec_pending = true;
+        s->exec_instr = data & 0xFFFFU;
+        break;
+    default:
+        break;
+    }
+
+    // Autopull refills a drained OSR behind the OUT without stalling.
+    if (autopull && s->osr_count >= pull_threshold(pio, sm)) {
+        (void)pull_word(pio, sm, s);
+    }
+    return result;
+}
+
+static step_result_t exec_push_pull(PIO pio, uint32_t sm, uint32_t instr)
+{
+    pio_emu_sm_t *s = &g_emu.sm[pio_get_index(pio)][sm];
+    const bool conditional = (instr & 0x40U) != 0U;
+    const bool block = (instr & 0x20U) != 0U;
+
+    if ((instr & 0x80U) == 0U) { // PUSH
+        if (conditional && s->isr_count < push_threshold(pio, sm)) {
+            return STEP_DONE;
+        }
+        if (pio_sm_is_rx_fifo_full(pio, sm)) {
+            if (block) {
+                pio->fdebug |= 1U << (EMU_FDEBUG_RXSTALL_LSB + sm);
+                return STEP_STALLED;
+            }
+            s->rx_dropped++;
+        } else {
+            s->rx_pushes++;
+            const uint32_t word = s->isr;
+            s->isr = 0U;
+            s->isr_count = 0U;
+            (void)pico_host_pio_push_rx(pio, sm, word);
+            return STEP_DONE;
+        }
+        s->isr = 0U;
+        s->isr_count = 0U;
+        return STEP_DONE;
+    }
+
+    // PULL
+    if (conditional && s->osr_count < pull_threshold(pio, sm)) {
+        return STEP_DONE;
+    }
+    if (pull_word(pio, sm, s)) {
+        return STEP_DONE;
+    }
+    if (block) {
+        pio->fdebug |= 1U << (EMU_FDEBUG_TXSTALL_LSB + sm);
+        return STEP_STALLED;
+    }
+    s->osr = s->x;
+    s->osr_count = 0U;
+    return STEP_DONE;
+}
+
+static uint32_t mov_status(PIO pio, uint32_t sm)
+{
+    const uint32_t execctrl = pio->sm[sm].execctrl;
+    const uint32_t n = execctrl & EMU_EXECCTRL_STATUS_N_BITS;
+    bool status;
+    switch (field(execctrl, EMU_EXECCTRL_STATUS_SEL_LSB, 2U)) {
+    case 0U:
+        status = pio_sm_get_tx_fifo_level(pio, sm) < n;
+        break;
+    case 1U:
+        status = pio_sm_get_rx_fifo_level(pio, sm) < n;
+        break;
+    default: {
+        uint32_t flag;
+        PIO target = irq_target(pio, sm, n, &flag);
+        status = pio_interrupt_get(target, flag);
+        break;
+    }
+    }
+    return status ? 0xFFFFFFFFU : 0U;
+}
+
+static step_result_t exec_mov(PIO pio, uint32_t sm, uint32_t instr)
+{
+    pio_emu_sm_t *s = &g_emu.sm[pio_get_index(pio)][sm];
+    uint32_t value;
+    switch (instr & 7U) {
+    case 0U:
+        value = in_pins(pio, sm);
+        break;
+    case 1U:
+        value = s->x;
+        break;
+    case 2U:
+        value = s->y;
+        break;
+    case 5U:
+        value = mov_status(pio, sm);
+        break;
+    case 6U:
+        value = s->isr;
+        break;
+    case 7U:
+        value = s->osr;
+        break;
+    default:
+        value = 0U;
+        break;
+    }
+    switch ((instr >> 3) & 3U) {
+    case 1U:
+        value = ~value;
+        break;
+    case 2U:
+        value = reverse32(value);
+        break;
+    default:
+        break;
+    }
+
+    const uint32_t pinctrl = pio->sm[sm].pinctrl;
+    switch ((instr >> 5) & 7U) {
+    case 0U:
+        write_pads(&pio->dbg_padout, field(pinctrl, PIO_SM0_PINCTRL_OUT_BASE_LSB, 5U),
+                   field(pinctrl, PIO_SM0_PINCTRL_OUT_COUNT_LSB, 6U), value);
+        break;
+    case 1U:
+        s->x = value;
+        break;
+    case 2U:
+        s->y = value;
+        break;
+    case 3U:
+        write_pads(&pio->dbg_padoe, field(pinctrl, PIO_SM0_PINCTRL_OUT_BASE_LSB, 5U),
+                   field(pinctrl, PIO_SM0_PINCTRL_OUT_COUNT_LSB, 6U), value);
+        break;
+    case 4U:
+        s->exec_pending = true;
+        s->exec_instr = value & 0xFFFFU;
+        break;
+    case 5U:
+        jump_to(pio, sm, value);
+        return STEP_JUMPED;
+    case 6U:
+        s->isr = value;
+        s->isr_count = 0U;
+        break;
+    default:
+        s->osr = value;
+        s->osr_count = 0U;
+        break;
+    }
+    return STEP_DONE;
+}
+
+static step_result_t exec_irq(PIO pio, uint32_t sm, uint32_t instr)
+{
+    bool *armed = &g_emu.irq_wait_armed[pio_get_index(pio)][sm];
+    uint32_t flag;
+    PIO target = irq_target(pio, sm, instr & 0x1FU, &flag);
+
+    if (instr & 0x40U) { // clear
+        pio_interrupt_clear(target, flag);
+        return STEP_DONE;
+    }
+    if (!*armed) {
+        pico_host_pio_irq_set(target, flag);
+        if ((instr & 0x20U) == 0U) {
+            return STEP_DONE;
+        }
+        *armed = true;
+    }
+    // `irq wait`: hold until another agent clears the flag.
+    if (pio_interrupt_get(target, flag)) {
+        return STEP_STALLED;
+    }
+    *armed = false;
+    return STEP_DONE;
+}
+
+static step_result_t exec_set(PIO pio, uint32_t sm, uint32_t instr)
+{
+    pio_emu_sm_t *s = &g_emu.sm[pio_get_index(pio)][sm];
+    const uint32_t data = instr & 0x1FU;
+    const uint32_t pinctrl = pio->sm[sm].pinctrl;
+    switch ((instr >> 5) & 7U) {
+    case 0U:
+        write_pads(&pio->dbg_padout, field(pinctrl, PIO_SM0_PINCTRL_SET_BASE_LSB, 5U),
+                   field(pinctrl, PIO_SM0_PINCTRL_SET_COUNT_LSB, 3U), data);
+        break;
+    case 1U:
+        s->x = data;
+        break;
+    case 2U:
+        s->y = data;
+        break;
+    case 4U:
+        write_pads(&pio->dbg_padoe, field(pinctrl, PIO_SM0_PINCTRL_SET_BASE_LSB, 5U),
+                   field(pinctrl, PIO_SM0_PINCTRL_SET_COUNT_LSB, 3U), data);
+        break;
+    default:
+        break;
+    }
+    return STEP_DONE;
+}
+
+// Side-set takes effect when the instruction issues, stalled or not. Returns
+// the delay-cycle count encoded alongside it.
+static uint32_t apply_side_set(PIO pio, uint32_t sm, uint32_t instr)
+{
+    const uint32_t pinctrl = pio->sm[sm].pinctrl;
+    const uint32_t execctrl = pio->sm[sm].execctrl;
+    const uint32_t side_count = field(pinctrl, PIO_SM0_PINCTRL_SIDESET_COUNT_LSB, 3U);
+    const uint32_t delay_bits = 5U - side_count;
+    const uint32_t bits = (instr >> 8) & 0x1FU;
+    const uint32_t delay = bits & low_mask(delay_bits);
+    if (side_count == 0U) {
+        return delay;
+    }
+
+    uint32_t side = bits >> delay_bits;
+    uint32_t side_pins = side_count;
+    if (execctrl & (1U << PIO_SM0_EXECCTRL_SIDE_EN_LSB)) {
+        side_pins--;
+        if ((side & (1U << side_pins)) == 0U) {
+            return delay;
+        }
+        side &= low_mask(side_pins);
+    }
+    volatile uint32_t *pads = (execctrl & (1U << PIO_SM0_EXECCTRL_SIDE_PINDIR_LSB)) ? &pio->dbg_padoe : &pio->dbg_padout;
+    write_pads(pads, field(pinctrl, PIO_SM0_PINCTRL_SIDESET_BASE_LSB, 5U), side_pins, side);
+    return delay;
+}
+
+static step_result_t exec_instruction(PIO pio, uint32_t sm, uint32_t instr)
+{
+    switch (instr >> 13) {
+    case 0U:
+        return exec_jmp(pio, sm, instr);
+    case 1U:
+        return exec_wait(pio, sm, instr);
+    case 2U:
+        return exec_in(pio, sm, instr);
+    case 3U:
+        return exec_out(pio, sm, instr);
+    case 4U:
+        if (instr & 0x10U) {
+            pico_host_panic("pio_emu: PIO%u SM%u: FIFO-indexed mov 0x%04x is not modelled", pio_get_index(pio), sm,
+                            instr);
+        }
+        return exec_push_pull(pio, sm, instr);
+    case 5U:
+        return exec_mov(pio, sm, instr);
+    case 6U:
+        return exec_irq(pio, sm, instr);
+    default:
+        return exec_set(pio, sm, instr);
+    }
+}
+
+static void advance_pc(PIO pio, uint32_t sm)
+{
+    const uint32_t execctrl = pio->sm[sm].execctrl;
+    const uint32_t pc = pio->sm[sm].addr & 0x1FU;
+    const uint32_t wrap_top = field(execctrl, PIO_SM0_EXECCTRL_WRAP_TOP_LSB, 5U);
+    const uint32_t wrap_bottom = field(execctrl, PIO_SM0_EXECCTRL_WRAP_BOTTOM_LSB, 5U);
+    pio->sm[sm].addr = pc == wrap_top ? wrap_bottom : (pc + 1U) & 0x1FU;
+}
+
+// One SM clock tick.
+static void sm_tick(PIO pio, uint32_t sm)
+{
+    pio_emu_sm_t *s = &g_emu.sm[pio_get_index(pio)][sm];
+    if (s->delay != 0U) {
+        s->delay--;
+        return;
+    }
+
+    const bool from_exec = s->exec_pending;
+    const uint32_t pc = pio->sm[sm].addr & 0x1FU;
+    const uint32_t instr = from_exec ? s->exec_instr : pio->instr_mem[pc] & 0xFFFFU;
+    const uint32_t delay = apply_side_set(pio, sm, instr);
+    s->exec_pending = false;
+
+    const step_result_t result = exec_instruction(pio, sm, instr);
+    if (result == STEP_STALLED) {
+        if (from_exec) {
+            s->exec_pending = true;
+            s->exec_instr = instr;
+        }
+        s->stall_cycles++;
+        return;
+    }
+    // EXEC'd instructions do not advance the PC; a fetched one does unless
+    // it jumped. OUT/MOV EXEC leave the next instruction latched instead.
+    if (result == STEP_DONE && !from_exec && !s->exec_pending) {
+        advance_pc(pio, sm);
+    }
+    s->delay = delay;
+    s->instructions++;
+
+    if (g_emu.trace) {
+        const pio_emu_event_t event = {
+            .pio = pio_get_index(pio),
+            .sm = sm,
+            .pc = pc,
+            .instr = instr,
+            .cycle = g_emu.cycle,
+            .pins = pio_inputs(pio),
+        };
+        g_emu.trace(&event, g_emu.trace_ctx);
+    }
+}
+
+// Fractional divider: INT.FRAC in 1/256 units, INT 0 meaning 65536.
+static bool sm_clock_enable(PIO pio, uint32_t sm, pio_emu_sm_t *s)
+{
+    const uint32_t clkdiv = pio->sm[sm].clkdiv;
+    uint32_t div_int = clkdiv >> PIO_SM0_CLKDIV_INT_LSB;
+    if (div_int == 0U) {
+        div_int = 65536U;
+    }
+    const uint32_t div256 = (div_int << 8) | ((clkdiv >> PIO_SM0_CLKDIV_FRAC_LSB) & 0xFFU);
+    s->clkdiv_acc += 256U;
+    if (s->clkdiv_acc < div256) {
+        return false;
+    }
+    s->clkdiv_acc -= div256;
+    return true;
+}
+
+// =============================================================================
+// Public API
+// =============================================================================
+
+void pio_emu_reset(void)
+{
+    memset(&g_emu, 0, sizeof g_emu);
+}
+
+void pio_emu_set_trace(pio_emu_trace_t trace, void *ctx)
+{
+    g_emu.trace = trace;
+    g_emu.trace_ctx = ctx;
+}
+
+void pio_emu_run(uint64_t cycles)
+{
+    for (uint64_t i = 0; i < cycles; i++) {
+        g_emu.cycle = pico_host_sys_cycles();
+        for (uint32_t p = 0; p < NUM_PIOS; p++) {
+            PIO pio = &pico_host_pio_hw[p];
+            const uint32_t enabled = pio->ctrl & 0xFU;
+            if (enabled == 0U) {
+                continue;
+            }
+            for (uint32_t sm = 0; sm < NUM_PIO_STATE_MACHINES; sm++) {
+                if ((enabled & (1U << sm)) && sm_clock_enable(pio, sm, &g_emu.sm[p][sm])) {
+                    sm_tick(pio, sm);
+                }
+            }
+        }
+        pico_host_advance_cycles(1U);
+    }
+}
+
+void pio_emu_exec(PIO pio, uint32_t sm, uint32_t instr)
+{
+    pio_emu_sm_t *s = &g_emu.sm[pio_get_index(pio)][sm];
+    g_emu.cycle = pico_host_sys_cycles();
+    // Forced instructions run immediately, enabled or not, and abandon any
+    // instruction the SM was stalled on. One that stalls itself stays latched
+    // and retries on the SM's next tick.
+    s->exec_pending = false;
+    g_emu.irq_wait_armed[pio_get_index(pio)][sm] = false;
+    g_emu.autopush_pending[pio_get_index(pio)][sm] = false;
+    if (exec_instruction(pio, sm, instr & 0xFFFFU) == STEP_STALLED) {
+        s->exec_pending = true;
+        s->exec_instr = instr & 0xFFFFU;
+    }
+}
+
+void pio_emu_sm_restart(PIO pio, uint32_t sm)
+{
+    const uint32_t p = pio_get_index(pio);
+    pio_emu_sm_t *s = &g_emu.sm[p][sm];
+    // SM_RESTART clears the shift counters, ISR, delay and stall state and
+    // the clock divider phase. X, Y, OSR and the PC survive.
+    const uint32_t x = s->x;
+    const uint32_t y = s->y;
+    const uint32_t osr = s->osr;
+    memset(s, 0, sizeof *s);
+    s->x = x;
+    s->y = y;
+    s->osr = osr;
+    g_emu.irq_wait_armed[p][sm] = false;
+    g_emu.autopush_pending[p][sm] = false;
+}
+
+const pio_emu_sm_t *pio_emu_sm(PIO pio, uint32_t sm)
+{
+    return &g_emu.sm[pio_get_index(pio)][sm];
+}
@@ -0,0 +1,77 @@
+// Cycle-level PIO interpreter for the host HAL.
+//
+// Executes whatever the firmware loaded into pico_host_pio_hw[].instr_mem with
+// the configuration it wrote to the SM registers: clock divider, wrap, pin
+// bases (relative to GPIOBASE), JMP pin, shift directions, autopush/autopull
+// thresholds and FIFO joins. FIFOs and IRQ flags are the ones pico_host.c
+// already models, so an emulated `push` feeds DMA channels and interrupt
+// handlers exactly as pico_host_pio_push_rx() does.
+//
+// Inputs come from pico_host_gpio_levels() through the two-flop input
+// synchronizer (bypassed per pin by INPUT_SYNC_BYPASS), so the sample point of
+// an `in pins` lands where it would on silicon. Outputs (SET/OUT/MOV pins,
+// side-set) are recorded but do not loop back into the inputs.
+//
+// Nothing runs until a test calls pio_emu_run(); tests that push FIFO words
+// by hand are unaffected.
+#ifndef NEOPICO_HOST_PIO_EMU_H
+#define NEOPICO_HOST_PIO_EMU_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "hardware/pio.h"
+
+// System clocks between a pad change and the SM seeing it.
+#define PIO_EMU_INPUT_SYNC_CYCLES 2U
+
+typedef struct {
+    uint32_t x;
+    uint32_t y;
+    uint32_t isr;
+    uint32_t osr;
+    uint32_t isr_count;
+    uint32_t osr_count;
+    uint32_t delay;         // delay cycles still to run for the last instruction
+    bool exec_pending;      // a stalled EXEC'd instruction is latched
+    uint32_t exec_instr;
+    uint32_t clkdiv_acc;    // fractional divider phase, 1/256 cycle units
+
+    // Counters since the last restart.
+    uint64_t instructions;  // instructions completed
+    uint64_t stall_cycles;  // SM clock ticks spent stalled (WAIT, blocking FIFO)
+    uint64_t rx_pushes;     // words delivered to the RX FIFO
+    uint64_t rx_dropped;    // `push noblock` into a full RX FIFO
+    uint64_t autopush_stall_cycles;
+} pio_emu_sm_t;
+
+// One completed instruction. `cycle` is the system clock it finished on and
+// `pins` the 32 synchronized PIO input levels it saw (GPIOBASE-relative).
+typedef struct {
+    uint32_t pio;
+    uint32_t sm;
+    uint32_t pc;
+    uint32_t instr;
+    uint64_t cycle;
+    uint32_t pins;
+} pio_emu_event_t;
+
+typedef void (*pio_emu_trace_t)(const pio_emu_event_t *event, void *ctx);
+
+// Clears every SM's internal state and the trace hook. Run by pico_host_reset().
+void pio_emu_reset(void);
+
+// Advance every enabled SM on all PIO blocks by `cycles` system clocks. Host
+// time advances with them (pico_host_advance_cycles()).
+void pio_emu_run(uint64_t cycles);
+
+// Called for every instruction an SM completes (not for stall ticks).
+void pio_emu_set_trace(pio_emu_trace_t trace, void *ctx);
+
+// Back ends for pio_sm_exec() and pio_sm_restart().
+void pio_emu_exec(PIO pio, uint32_t sm, uint32_t instr);
+void pio_emu_sm_restart(PIO pio, uint32_t sm);
+
+const pio_emu_sm_t *pio_emu_sm(PIO pio, uint32_t sm);
+
+#endif // NEOPICO_HOST_PIO_EMU_H
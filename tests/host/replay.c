@@ -0,0 +1,267 @@
+// Replay engine: see replay.h.
+
+#include "replay.h"
+
+#include <setjmp.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "line_ring.h"
+#include "pico_hdmi/video_output_rt.h"
+#include "pico_host.h"
+#include "pio_emu.h"
+#include "video_capture.h"
+#include "video_config.h"
+#include "video_pipeline.h"
+
+// Emulated system clocks per wait-hook step: the resolution of every cycle
+// counter the engine reports.
+#define REPLAY_EMU_STEP_CYCLES 64U
+
+#if NEOPICO_CAPTURE_TARGET == NEOPICO_CAPTURE_TARGET_SNES
+// Mirror of the default in video_capture_snes.c.
+#define REPLAY_SNES_WARMUP_FRAMES 60U
+#endif
+
+typedef struct {
+    const replay_config_t *config;
+    jmp_buf exit;
+    uint64_t cycle_limit;
+    uint32_t delivered;
+
+    // Input frame in progress, as seen from the hook.
+    bool in_frame;
+    bool emitted;
+    uint32_t committed; // ring lines of it seen so far
+    uint64_t hook_exit_ns;
+
+    replay_frame_t frame;
+    uint32_t *row;
+    uint32_t *words;
+    uint32_t *rgb;
+    uint64_t *scanout_ns;
+    uint64_t capture_cycles[SOURCE_HEIGHT];
+    uint64_t capture_ns[SOURCE_HEIGHT];
+} replay_state_t;
+
+static const video_mode_t *mode_timing(replay_mode_t mode)
+{
+    switch (mode) {
+    case REPLAY_MODE_240P:
+        return &video_mode_240_p;
+    case REPLAY_MODE_720P:
+        return &video_mode_720_p;
+    case REPLAY_MODE_480P:
+    default:
+        return &video_mode_480_p;
+    }
+}
+
+void replay_mode_size(replay_mode_t mode, uint32_t *width, uint32_t *height)
+{
+    const video_mode_t *timing = mode_timing(mode);
+    *width = timing->h_active_pixels;
+    *height = timing->v_active_lines;
+}
+
+uint32_t replay_mode_sys_hz(replay_mode_t mode)
+{
+    // Mirrors of SYS_CLK_720P_RUNTIME_KHZ and SYS_CLK_480P_KHZ in main.c;
+    // 240p shares the 480p overclock.
+    return mode == REPLAY_MODE_720P ? 320000000U : 252000000U;
+}
+
+static uint64_t host_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+#if !NEOPICO_EXP_RGB888_SCANOUT
+static uint32_t rgb565_to_rgb888(uint32_t pixel)
+{
+    const uint32_t r = (pixel >> 11) & 0x1FU;
+    const uint32_t g = (pixel >> 5) & 0x3FU;
+    const uint32_t b = pixel & 0x1FU;
+    return (((r << 3) | (r >> 2)) << 16) | (((g << 2) | (g >> 4)) << 8) | ((b << 3) | (b >> 2));
+}
+#endif
+
+static void widen_row(const uint32_t *words, uint32_t width, uint32_t *rgb)
+{
+    for (uint32_t x = 0; x < width; x++) {
+#if NEOPICO_EXP_RGB888_SCANOUT
+        rgb[x] = words[x] & 0x00FFFFFFU;
+#else
+        rgb[x] = rgb565_to_rgb888((words[x / 2U] >> ((x & 1U) * 16U)) & 0xFFFFU);
+#endif
+    }
+}
+
+// Core 1's side of one output frame: the vsync callback, then every active
+// line into one persistent line buffer, the way pico_hdmi reuses a row it
+// was not asked to refill.
+static void scan_out(replay_state_t *st)
+{
+    const replay_config_t *config = st->config;
+    replay_frame_t *frame = &st->frame;
+    video_output_vsync_cb_t vsync = pico_host_video_vsync_callback();
+    video_output_scanline_cb_t scanline = pico_host_video_scanline_callback();
+
+    vsync();
+    for (uint32_t line = 0; line < frame->height; line++) {
+        const uint64_t t0 = host_ns();
+        scanline(line, line, st->row);
+        st->scanout_ns[line] = host_ns() - t0;
+        uint32_t *words = &st->words[(size_t)line * frame->words_per_line];
+        memcpy(words, st->row, frame->words_per_line * sizeof *words);
+        widen_row(words, frame->width, &st->rgb[(size_t)line * frame->width]);
+    }
+
+    frame->index = st->delivered++;
+    const bool more = config->on_frame == NULL || config->on_frame(frame, config->ctx);
+    if (!more || st->delivered >= config->frames) {
+        longjmp(st->exit, 1);
+    }
+}
+
+static void track_capture(replay_state_t *st, uint64_t cycle, uint64_t now_ns)
+{
+    // Firmware time since the hook last returned: for the stretch that ends
+    // in a commit, that is the line's conversion after its DMA wait. Other
+    // stretches are wait-loop polls.
+    const uint64_t firmware_ns = now_ns - st->hook_exit_ns;
+
+    // line_ring_vsync() raised the resync request: consume it as the output
+    // DMA handler would, and start a new input frame.
+    if (line_ring_should_resync()) {
+        const signal_gen_timing_t *t = &st->config->source->timing;
+        st->in_frame = true;
+        st->emitted = false;
+        st->committed = 0;
+        st->frame.vsync_cycle = cycle;
+        st->frame.source_frame =
+            (cycle * t->dot_clock_hz) / ((uint64_t)st->config->source->sys_hz * signal_gen_frame_dots(t));
+        memset(st->capture_cycles, 0, sizeof st->capture_cycles);
+        memset(st->capture_ns, 0, sizeof st->capture_ns);
+    }
+    if (!st->in_frame) {
+        return;
+    }
+
+    uint32_t written = g_line_ring.write_idx - g_line_ring.frame_base_idx;
+    if (written > SOURCE_HEIGHT) {
+        written = SOURCE_HEIGHT;
+    }
+    if (written > st->committed) {
+        // The capture loop commits once per DMA wait; should it ever batch,
+        // the time is shared out evenly.
+        const uint32_t lines = written - st->committed;
+        for (uint32_t line = st->committed; line < written; line++) {
+            st->capture_cycles[line] = cycle - st->frame.vsync_cycle;
+            st->capture_ns[line] = firmware_ns / lines;
+        }
+        st->committed = written;
+    }
+    if (st->committed == SOURCE_HEIGHT && !st->emitted) {
+        st->emitted = true;
+        scan_out(st);
+    }
+}
+
+static bool replay_wait_hook(pico_host_wait_reason_t reason, uint64_t deadline_us, void *ctx)
+{
+    replay_state_t *st = ctx;
+    (void)deadline_us;
+    const uint64_t cycle = pico_host_sys_cycles();
+    if (cycle >= st->cycle_limit) {
+        longjmp(st->exit, 1);
+    }
+    track_capture(st, cycle, host_ns());
+
+#if NEOPICO_CAPTURE_TARGET == NEOPICO_CAPTURE_TARGET_SNES
+    // Warmup frames only wait for the VBLANK SM's IRQ while the pixel SM
+    // idles on IRQ 4; skip to a few lines before the next VBLANK fall and
+    // step the SMs only from there.
+    if (reason == PICO_HOST_WAIT_SEM && video_capture_get_frame_count() < REPLAY_SNES_WARMUP_FRAMES) {
+        const signal_gen_timing_t *t = &st->config->source->timing;
+        const uint64_t frame_cycles = (signal_gen_frame_dots(t) * st->config->source->sys_hz) / t->dot_clock_hz;
+        const uint64_t next_fall = ((cycle / frame_cycles) + 1U) * frame_cycles;
+        const uint64_t resume = next_fall - (frame_cycles / 64U);
+        if (cycle < resume) {
+            pico_host_advance_cycles(resume - cycle);
+            st->hook_exit_ns = host_ns();
+            return true;
+        }
+    }
+#else
+    (void)reason;
+#endif
+    pio_emu_run(REPLAY_EMU_STEP_CYCLES);
+    st->hook_exit_ns = host_ns();
+    return true;
+}
+
+uint32_t replay_run(const replay_config_t *config)
+{
+    // Static: the state must survive the longjmp() out of the capture loop.
+    static replay_state_t st;
+    memset(&st, 0, sizeof st);
+    st.config = config;
+
+    const video_mode_t *timing = mode_timing(config->mode);
+    replay_frame_t *frame = &st.frame;
+    frame->width = timing->h_active_pixels;
+    frame->height = timing->v_active_lines;
+#if NEOPICO_EXP_RGB888_SCANOUT
+    frame->words_per_line = frame->width;
+#else
+    frame->words_per_line = frame->width / 2U;
+#endif
+    st.row = calloc(frame->words_per_line, sizeof *st.row);
+    st.words = calloc((size_t)frame->words_per_line * frame->height, sizeof *st.words);
+    st.rgb = calloc((size_t)frame->width * frame->height, sizeof *st.rgb);
+    st.scanout_ns = calloc(frame->height, sizeof *st.scanout_ns);
+    if (st.row == NULL || st.words == NULL || st.rgb == NULL || st.scanout_ns == NULL || config->frames == 0U) {
+        goto done;
+    }
+    frame->words = st.words;
+    frame->rgb = st.rgb;
+    frame->capture_cycles = st.capture_cycles;
+    frame->capture_ns = st.capture_ns;
+    frame->scanout_ns = st.scanout_ns;
+
+    signal_gen_t *source = config->source;
+    uint64_t stream_frames = config->source_frames;
+#if NEOPICO_CAPTURE_TARGET == NEOPICO_CAPTURE_TARGET_SNES
+    stream_frames += REPLAY_SNES_WARMUP_FRAMES;
+#endif
+    st.cycle_limit = (signal_gen_frame_dots(&source->timing) * source->sys_hz * stream_frames) /
+                     source->timing.dot_clock_hz;
+
+    pico_host_reset();
+    pico_host_set_sys_clock_hz(source->sys_hz);
+    pico_host_set_pin_source(signal_gen_pin_levels, source);
+    memset(&g_line_ring, 0, sizeof g_line_ring);
+    line_ring_init();
+    video_output_set_mode(timing);
+    video_pipeline_init(frame->width, frame->height);
+    video_pipeline_set_scanline_level(config->scanline_level);
+    video_capture_init(SOURCE_HEIGHT);
+
+    pico_host_set_wait_hook(replay_wait_hook, &st);
+    st.hook_exit_ns = host_ns();
+    if (setjmp(st.exit) == 0) {
+        video_capture_run();
+    }
+    pico_host_set_wait_hook(NULL, NULL);
+
+done:
+    free(st.row);
+    free(st.words);
+    free(st.rgb);
+    free(st.scanout_ns);
+    return st.delivered;
+}
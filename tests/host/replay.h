@@ -0,0 +1,82 @@
+// Offline replay of a capture source through the unmodified firmware.
+//
+// A signal_gen_t (rendered frames or recorded raw words) drives the emulated
+// pads, the real PIO programs sample them (pio_emu.c), and the firmware's own
+// capture loop -- sync_irq_handler(), convert_active_pixels(), line_ring_*()
+// -- fills the line ring exactly as on Core 0. Each time a frame lands, the
+// registered scanline callback (video_pipeline_scanline_callback_reboot_modes)
+// renders every active output line of the chosen mode, as Core 1 would.
+//
+// The engine is compiled into each host executable against that executable's
+// firmware library, so the build flags under test (RGB888 vs RGB565 scanout,
+// capture target, colour model) are the firmware's, not the engine's.
+//
+// Like every host entry point into video_capture_run(), replay leaves the
+// capture loop with longjmp(); it owns the HAL for its duration and resets it
+// on entry.
+#ifndef NEOPICO_HOST_REPLAY_H
+#define NEOPICO_HOST_REPLAY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "signal_gen.h"
+
+typedef enum {
+    REPLAY_MODE_480P,
+    REPLAY_MODE_240P,
+    REPLAY_MODE_720P,
+} replay_mode_t;
+
+typedef struct {
+    uint32_t index;        // delivered frames so far, from 0
+    uint64_t source_frame; // stream frame the capture started in
+    uint64_t vsync_cycle;  // system clock the capture loop left its vsync wait
+
+    // Output raster as the scanline callback wrote it: `words_per_line`
+    // 32-bit words per line (one 0x00RRGGBB pixel per word in RGB888 builds,
+    // two RGB565 pixels per word, low half first, otherwise), plus the same
+    // raster widened to 0x00RRGGBB per pixel.
+    uint32_t width;
+    uint32_t height;
+    uint32_t words_per_line;
+    const uint32_t *words;
+    const uint32_t *rgb;
+
+    // Per ring line (SOURCE_HEIGHT entries): system clocks from the vsync
+    // wait to the line's commit, to the resolution of the engine's PIO step,
+    // and host nanoseconds from the line's DMA completion to its commit.
+    const uint64_t *capture_cycles;
+    const uint64_t *capture_ns;
+
+    // Per output line (`height` entries): host nanoseconds in the scanline
+    // callback. Rows the callback leaves to the output library (two of
+    // every three at 720p) repeat the previous row and cost next to nothing.
+    const uint64_t *scanout_ns;
+} replay_frame_t;
+
+// Returns false to stop the replay after this frame.
+typedef bool (*replay_frame_fn_t)(const replay_frame_t *frame, void *ctx);
+
+typedef struct {
+    signal_gen_t *source;   // its sys_hz is the emulated system clock
+    replay_mode_t mode;
+    uint8_t scanline_level; // video_pipeline_set_scanline_level()
+    uint32_t frames;        // stop after this many delivered frames
+    uint64_t source_frames; // give up after this many stream frames
+    replay_frame_fn_t on_frame;
+    void *ctx;
+} replay_config_t;
+
+// Output geometry of `mode`.
+void replay_mode_size(replay_mode_t mode, uint32_t *width, uint32_t *height);
+
+// System clock main.c runs `mode` at (SYS_CLK_*_KHZ there); the capture PIO
+// divides it down to 126 MHz.
+uint32_t replay_mode_sys_hz(replay_mode_t mode);
+
+// Runs the capture loop until `frames` frames were delivered, the callback
+// returns false or the stream runs out. Returns the number delivered.
+uint32_t replay_run(const replay_config_t *config);
+
+#endif // NEOPICO_HOST_REPLAY_H
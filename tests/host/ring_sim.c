@@ -0,0 +1,336 @@
+// Line ring concurrency simulator: see ring_sim.h.
+
+#include "ring_sim.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+
+#include "hardware/timer.h"
+#include "line_ring.h"
+#include "signal_gen.h"
+#include "video_config.h"
+
+#if !NEOPICO_DIAG_COUNTERS
+#error "ring_sim.c reads g_line_ring_diag: build it with NEOPICO_DIAG_COUNTERS=1"
+#endif
+#if !NEOPICO_DIAG_LINE_LATENCY
+#error "ring_sim.c reads the latency histogram: build it with NEOPICO_DIAG_LINE_LATENCY=1"
+#endif
+
+// The simulator is its own firmware image as far as the ring is concerned.
+line_ring_t g_line_ring;
+line_ring_diag_t g_line_ring_diag;
+
+// Rows the output library asks for ahead of the one on the wire: pico_hdmi
+// renders into one buffer while the DMA streams the other.
+#define RING_SIM_SCANLINE_LEAD_LINES 1U
+
+#define RING_SIM_PS_PER_US 1000000.0
+#define RING_SIM_DONE UINT64_MAX
+
+enum {
+    RING_SIM_PRODUCER,
+    RING_SIM_CONSUMER,
+};
+
+typedef struct {
+    const ring_sim_config_t *config;
+    ring_sim_result_t *result;
+    uint64_t end_ps;
+    uint64_t slack_ps;
+
+    // Virtual time of each thread's next event. The thread that runs an event
+    // also sets timer_hw->timerawl to it, for the ring's latency stamps.
+    uint64_t next_ps[2];
+
+    // Input timeline.
+    double in_line_ps;
+    uint32_t in_vsync_line; // frame line the capture loop calls line_ring_vsync() on
+    uint32_t in_active_line;
+    uint32_t in_v_total;
+    double convert_ps;
+
+    // Output timeline.
+    double out_frame_ps;
+    double out_line_ps;
+    double out_first_ps;
+    uint32_t out_v_total;
+    uint32_t out_v_active;
+    uint32_t v_scale;
+} ring_sim_t;
+
+void ring_sim_config_init(ring_sim_config_t *config)
+{
+    memset(config, 0, sizeof *config);
+    config->mode = &video_mode_480_p;
+    config->seconds = 10.0;
+    config->convert_us = 8.0;
+}
+
+// The firmware's timer_hw->timerawl on the virtual clock.
+static uint32_t to_us(uint64_t t_ps)
+{
+    return (uint32_t)(t_ps / (uint64_t)RING_SIM_PS_PER_US);
+}
+
+// Publishes `t_ps` as this side's next event and blocks until the other side
+// has nothing earlier pending. The producer wins ties, as Core 0's commit of
+// a line lands before a Core 1 read that happens on the same tick.
+static void wait_turn(ring_sim_t *sim, int side, uint64_t t_ps)
+{
+    __atomic_store_n(&sim->next_ps[side], t_ps, __ATOMIC_SEQ_CST);
+    for (;;) {
+        const uint64_t other = __atomic_load_n(&sim->next_ps[!side], __ATOMIC_SEQ_CST);
+        const uint64_t due = t_ps > sim->slack_ps ? t_ps - sim->slack_ps : 0U;
+        if (other > due || (side == RING_SIM_PRODUCER && other == due)) {
+            __atomic_store_n(&timer_hw->timerawl, to_us(t_ps), __ATOMIC_RELAXED);
+            return;
+        }
+        sched_yield();
+    }
+}
+
+static uint64_t to_ps(double t)
+{
+    return (uint64_t)llround(t);
+}
+
+
+// Core 0: per input frame, line_ring_vsync() when the capture loop leaves
+// its VSYNC wait, then for each active line the conversion into the ring at
+// the end of the line's DMA and the commit after it.
+static void *producer_main(void *arg)
+{
+    ring_sim_t *sim = arg;
+    const double in_frame_ps = sim->in_line_ps * sim->in_v_total;
+
+    for (uint32_t frame = 0;; frame++) {
+        const double frame_ps = frame * in_frame_ps;
+        uint64_t t = to_ps(frame_ps + (sim->in_vsync_line * sim->in_line_ps));
+        if (t >= sim->end_ps) {
+            break;
+        }
+        wait_turn(sim, RING_SIM_PRODUCER, t);
+        line_ring_vsync_at(to_us(t));
+
+        for (uint16_t line = 0; line < LINES_PER_FRAME; line++) {
+            const double line_end_ps = frame_ps + ((sim->in_active_line + line + 1U) * sim->in_line_ps);
+            wait_turn(sim, RING_SIM_PRODUCER, to_ps(line_end_ps));
+            uint16_t *dst = line_ring_write_ptr(line);
+            const uint32_t index = g_line_ring.frame_base_idx + line;
+            dst[0] = (uint16_t)index;
+            dst[1] = (uint16_t)(index >> 16);
+            dst[2] = (uint16_t)frame;
+            dst[3] = (uint16_t)(frame >> 16);
+
+            wait_turn(sim, RING_SIM_PRODUCER, to_ps(line_end_ps + sim->convert_ps));
+            line_ring_commit(line + 1U);
+        }
+        sim->result->in_frames = frame + 1U;
+    }
+    __atomic_store_n(&sim->next_ps[RING_SIM_PRODUCER], RING_SIM_DONE, __ATOMIC_SEQ_CST);
+    return NULL;
+}
+
+typedef struct {
+    bool shown;
+    bool glitched;
+    bool not_written;
+    uint32_t torn;
+    uint32_t input_frame;
+    uint32_t depth;
+} out_frame_t;
+
+static void account_frame(ring_sim_result_t *result, const out_frame_t *frame, out_frame_t *last_shown)
+{
+    result->out_frames++;
+    result->torn_lines += frame->torn;
+    result->glitched_frames += frame->glitched ? 1U : 0U;
+    if (frame->not_written) {
+        result->not_written_frames++;
+    } else {
+        result->frames_by_depth[frame->depth < RING_SIM_MAX_DEPTH ? frame->depth : RING_SIM_MAX_DEPTH]++;
+    }
+    if (frame->depth > result->max_depth) {
+        result->max_depth = frame->depth;
+    }
+    if (!frame->shown) {
+        result->blank_frames++;
+        return;
+    }
+    if (last_shown->shown) {
+        if (frame->input_frame == last_shown->input_frame) {
+            result->duplicated_frames++;
+        } else if (frame->input_frame > last_shown->input_frame + 1U) {
+            result->skipped_frames += frame->input_frame - last_shown->input_frame - 1U;
+        }
+    }
+    *last_shown = *frame;
+}
+
+static void read_line(out_frame_t *frame, uint16_t line)
+{
+    const uint32_t target = g_line_ring.read_frame_start + line;
+    const uint32_t write_pos = g_line_ring.write_idx;
+    if (target < write_pos) {
+        const uint32_t depth = write_pos - target + 1U;
+        frame->depth = depth > frame->depth ? depth : frame->depth;
+    }
+    if (!line_ring_ready(line)) {
+        frame->glitched = true;
+        frame->not_written = frame->not_written || target >= write_pos;
+        return;
+    }
+
+    const uint16_t *src = line_ring_read_ptr(line);
+    const uint32_t index = src[0] | ((uint32_t)src[1] << 16);
+    const uint32_t input_frame = src[2] | ((uint32_t)src[3] << 16);
+    if (index != target) {
+        frame->torn++;
+        frame->glitched = true;
+        return;
+    }
+    if (!frame->shown) {
+        frame->shown = true;
+        frame->input_frame = input_frame;
+    }
+}
+
+// Core 1: line_ring_output_vsync() from the vsync callback at the start of
+// each output frame, then the ring reads of every active row the scanline
+// callback renders (all of them up to 2x, one row in three at 3x).
+static void *consumer_main(void *arg)
+{
+    ring_sim_t *sim = arg;
+    ring_sim_result_t *result = sim->result;
+    const uint32_t v_blank = sim->out_v_total - sim->out_v_active;
+    out_frame_t last_shown = {0};
+
+    for (uint32_t frame = 0;; frame++) {
+        const double frame_ps = sim->out_first_ps + (frame * sim->out_frame_ps);
+        if (to_ps(frame_ps) >= sim->end_ps) {
+            break;
+        }
+        wait_turn(sim, RING_SIM_CONSUMER, to_ps(frame_ps));
+        if (frame == RING_SIM_WARMUP_FRAMES) {
+            memset(&g_line_ring_diag, 0, sizeof g_line_ring_diag);
+            for (uint32_t i = 0; i < LINE_RING_LATENCY_BUCKETS; i++) {
+                g_line_ring.latency_hist[i] = 0;
+            }
+        }
+        if (sim->config->race) {
+            (void)line_ring_output_vsync_race(to_us(to_ps(frame_ps)));
+        } else {
+            line_ring_output_vsync();
+        }
+
+        out_frame_t out = {0};
+        for (uint32_t row = 0; row < sim->out_v_active; row++) {
+            if (sim->v_scale == 3U && (row % 3U) != 0U) {
+                continue;
+            }
+            const uint32_t ring_line = (row / sim->v_scale) - V_OFFSET;
+            if (ring_line >= MVS_HEIGHT) {
+                continue;
+            }
+            const double row_ps = frame_ps + ((v_blank + row - RING_SIM_SCANLINE_LEAD_LINES) * sim->out_line_ps);
+            wait_turn(sim, RING_SIM_CONSUMER, to_ps(row_ps));
+            read_line(&out, (uint16_t)ring_line);
+        }
+        if (frame >= RING_SIM_WARMUP_FRAMES) {
+            account_frame(result, &out, &last_shown);
+        }
+    }
+    result->not_written = g_line_ring_diag.not_written;
+    result->overrun = g_line_ring_diag.overrun;
+    result->raced_frames = g_line_ring_diag.raced;
+    result->diag_repeated_frames = g_line_ring_diag.repeated_frames;
+    result->diag_skipped_frames = g_line_ring_diag.skipped_frames;
+    result->pace_events = g_line_ring_diag.pace_events;
+    result->beat_frames = g_line_ring_diag.beat_frames;
+    result->last_run_frames = g_line_ring_diag.last_run_frames;
+    for (uint32_t i = 0; i < LINE_RING_LATENCY_BUCKETS; i++) {
+        result->latency_hist[i] = g_line_ring.latency_hist[i];
+    }
+    result->latency_p50_us = line_ring_latency_percentile_us(500U);
+    result->latency_p99_us = line_ring_latency_percentile_us(990U);
+    __atomic_store_n(&sim->next_ps[RING_SIM_CONSUMER], RING_SIM_DONE, __ATOMIC_SEQ_CST);
+    return NULL;
+}
+
+bool ring_sim_run(const ring_sim_config_t *config, ring_sim_result_t *result)
+{
+    memset(result, 0, sizeof *result);
+    memset(&g_line_ring, 0, sizeof g_line_ring);
+    line_ring_init_shallow(config->depth != 0U ? config->depth : LINE_RING_SIZE);
+    memset(&g_line_ring_diag, 0, sizeof g_line_ring_diag);
+
+    signal_gen_timing_t in;
+    signal_gen_timing_mvs(&in);
+    if (config->in_hz > 0.0) {
+        signal_gen_set_frame_rate(&in, config->in_hz);
+    }
+
+    ring_sim_t sim = {
+        .config = config,
+        .result = result,
+        .end_ps = to_ps(config->seconds * 1e6 * RING_SIM_PS_PER_US),
+        .slack_ps = to_ps(config->slack_us * RING_SIM_PS_PER_US),
+        .in_line_ps = (in.h_total * 1e6 * RING_SIM_PS_PER_US) / in.dot_clock_hz,
+        // sync_irq_handler() releases the frame at the second normal line
+        // after the vertical interval (see signal_gen_timing_mvs()).
+        .in_vsync_line = (2U * in.eq_lines) + in.serration_lines + 2U,
+        .in_active_line = in.active_y,
+        .in_v_total = in.v_total,
+        .convert_ps = config->convert_us * RING_SIM_PS_PER_US,
+        .out_v_total = config->mode->v_total_lines,
+        .out_v_active = config->mode->v_active_lines,
+        .v_scale = config->mode->v_active_lines / FRAME_HEIGHT,
+    };
+    if (config->genlock) {
+        sim.out_frame_ps = sim.in_line_ps * sim.in_v_total;
+    } else if (config->out_hz > 0.0) {
+        sim.out_frame_ps = (1e6 * RING_SIM_PS_PER_US) / config->out_hz;
+    } else {
+        sim.out_frame_ps = ((double)config->mode->h_total_pixels * config->mode->v_total_lines * 1e6 *
+                            RING_SIM_PS_PER_US) /
+                           config->mode->pixel_clock_hz;
+    }
+    sim.out_line_ps = sim.out_frame_ps / sim.out_v_total;
+    sim.out_first_ps = config->phase * sim.out_frame_ps;
+    if (sim.v_scale == 0U) {
+        sim.v_scale = 1U;
+    }
+
+    // The firmware's slack (video_pipeline.c) less the genlock pull-back row
+    // it reserves: the simulated output runs exactly this timeline.
+    const uint32_t lead_rows = (sim.out_v_total - sim.out_v_active) + (V_OFFSET * sim.v_scale) -
+                               RING_SIM_SCANLINE_LEAD_LINES;
+    const double row_ns = sim.out_line_ps / 1000.0;
+    line_ring_race_init(line_ring_race_slack_us((uint32_t)((lead_rows * row_ns) / 1000.0),
+                                                (uint32_t)(sim.v_scale * row_ns)));
+
+    pthread_t threads[2];
+    if (pthread_create(&threads[RING_SIM_PRODUCER], NULL, producer_main, &sim) != 0) {
+        return false;
+    }
+    if (pthread_create(&threads[RING_SIM_CONSUMER], NULL, consumer_main, &sim) != 0) {
+        __atomic_store_n(&sim.next_ps[RING_SIM_CONSUMER], RING_SIM_DONE, __ATOMIC_SEQ_CST);
+        pthread_join(threads[RING_SIM_PRODUCER], NULL);
+        return false;
+    }
+    pthread_join(threads[RING_SIM_PRODUCER], NULL);
+    pthread_join(threads[RING_SIM_CONSUMER], NULL);
+    return true;
+}
+
+uint32_t ring_sim_frames_over(const ring_sim_result_t *result, uint32_t depth)
+{
+    uint32_t frames = result->not_written_frames;
+    for (uint32_t d = depth + 1U; d <= RING_SIM_MAX_DEPTH; d++) {
+        frames += result->frames_by_depth[d];
+    }
+    return frames;
+}
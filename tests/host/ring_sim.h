@@ -0,0 +1,102 @@
+// Concurrency simulator for the line ring (src/video/line_ring.h).
+//
+// Two host threads stand in for the two cores and run the ring's own inline
+// API against a shared g_line_ring: a producer that calls line_ring_vsync(),
+// writes each active line through line_ring_write_ptr() and publishes it with
+// line_ring_commit() on the MVS input timeline, and a consumer that calls
+// line_ring_output_vsync() once per output frame and line_ring_ready() /
+// line_ring_read_ptr() for every row the scanline callback would fetch on
+// the HDMI timeline.
+//
+// Both threads follow one virtual clock: a thread only runs an event once
+// the other has nothing pending more than `slack_us` earlier, so with zero
+// slack the interleaving is exactly the two timelines merged (the producer
+// wins ties) and runs are repeatable; a positive slack lets the threads race
+// within that window. The host barriers are real fences (hardware/sync.h).
+//
+// Each ring line carries its global ring index and input frame number, so
+// the consumer can tell a line that was overwritten while it was being read
+// from a good one, and which input frame each output frame showed.
+//
+// The ring runs at `depth` (line_ring_init_shallow(), a power of two), but
+// the distance from every read to the producer's write position is
+// recorded, which gives the outcome for any smaller ring from the same run
+// (ring_sim_frames_over()).
+#ifndef NEOPICO_HOST_RING_SIM_H
+#define NEOPICO_HOST_RING_SIM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "line_ring.h"
+#include "pico_hdmi/video_output_rt.h"
+
+// Deepest ring the per-frame depth histogram resolves; deeper needs land in
+// the last bucket.
+#define RING_SIM_MAX_DEPTH 512U
+
+typedef struct {
+    const video_mode_t *mode; // output timing (video_mode_480_p, ...)
+    double in_hz;             // input frame rate; 0 for the MVS's 59.185 Hz
+    double out_hz;            // output frame rate; 0 for the mode's nominal rate
+    bool genlock;             // output frame period locked to the input's (out_hz ignored)
+    double phase;             // first output VSYNC after the first input frame starts, in output frames
+    double seconds;           // simulated time
+    double convert_us;        // line DMA completion to its commit: the capture loop's conversion
+    double slack_us;          // virtual time the threads may run apart
+    uint32_t depth;           // line_ring_init_shallow() depth; 0 for LINE_RING_SIZE
+    bool race;                // line_ring_output_vsync_race() instead of line_ring_output_vsync()
+} ring_sim_config_t;
+
+typedef struct {
+    uint32_t in_frames;
+    uint32_t out_frames; // counted after the warmup frames below
+
+    // g_line_ring_diag after warmup.
+    uint32_t not_written;
+    uint32_t overrun;
+    uint32_t diag_repeated_frames; // the ring's own frame-pacing classification,
+    uint32_t diag_skipped_frames;  // from frame bases rather than line content
+    uint32_t pace_events;
+    uint32_t beat_frames;
+    uint32_t last_run_frames;
+
+    uint32_t torn_lines;         // read lines whose content was not the requested ring index
+    uint32_t glitched_frames;    // output frames with any not_written, overrun or torn line
+    uint32_t duplicated_frames;  // output frames showing the same input frame as the previous one
+    uint32_t skipped_frames;     // input frames never shown between two output frames
+    uint32_t blank_frames;       // output frames that could not show any input line
+    uint32_t not_written_frames; // output frames that asked for a line before its commit
+    uint32_t raced_frames;       // output frames the beam-racing policy moved to a newer input frame
+
+    // Lines the ring must hold for every read of the run to find its line
+    // intact: the largest write-position-to-read distance, plus the slot the
+    // producer is converting into. frames_by_depth[d] counts output frames
+    // whose worst read needed exactly d.
+    uint32_t max_depth;
+    uint32_t frames_by_depth[RING_SIM_MAX_DEPTH + 1U];
+
+    // The ring's own commit-to-first-fetch histogram after warmup
+    // (NEOPICO_DIAG_LINE_LATENCY) and its median and 99th percentile bounds.
+    uint32_t latency_hist[LINE_RING_LATENCY_BUCKETS];
+    uint32_t latency_p50_us;
+    uint32_t latency_p99_us;
+} ring_sim_result_t;
+
+// Output frames the simulator discards before counting: the ring starts
+// empty and the first frames are fallback colour by design.
+#define RING_SIM_WARMUP_FRAMES 3U
+
+// Defaults: 480p, free-running, phase 0, 10 s, 8 us conversion, no slack,
+// full depth, default read policy.
+void ring_sim_config_init(ring_sim_config_t *config);
+
+// Runs both threads to the end of the simulated time. Returns false if a
+// thread could not be started.
+bool ring_sim_run(const ring_sim_config_t *config, ring_sim_result_t *result);
+
+// Output frames of the run that would have glitched with a ring of `depth`
+// lines, from frames_by_depth (not_written frames count at every depth).
+uint32_t ring_sim_frames_over(const ring_sim_result_t *result, uint32_t depth);
+
+#endif // NEOPICO_HOST_RING_SIM_H
@@ -0,0 +1,346 @@
+// Synthetic MVS and SNES raster and pad waveforms. See signal_gen.h.
+
+#include "signal_gen.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "mvs_color.h"
+#include "mvs_pins.h"
+#include "snes_pins.h"
+
+// Mirrors of the private capture constants in video_capture_mvs.c.
+#define MVS_H_TOTAL 384U
+#define MVS_V_TOTAL 264U
+#define MVS_H_SKIP_START 28U
+#define MVS_V_SKIP_LINES 16U
+#define MVS_PCLK_HZ 6000000U
+#define MVS_HSYNC_HIGH 355U
+#define MVS_CAPTURE_MASK ((1U << 19) - 1U)
+
+// ... and of video_capture_snes.c / snes_hard_sync.
+#define SNES_H_TOTAL 341U
+#define SNES_V_TOTAL 262U
+#define SNES_DOT_CLOCK_HZ 5369318U     // 21.477 MHz master clock / 4
+#define SNES_PAL_DOT_CLOCK_HZ 5320342U // 21.281 MHz master clock / 4
+#define SNES_SKIP_PCLKS 20U
+#define SNES_HBLANK_START 300U
+#define SNES_CAPTURE_MASK ((1U << SNES_CAPTURE_BITS) - 1U)
+
+// Both targets' 50 Hz raster.
+#define PAL_V_TOTAL 312U
+
+#define ACTIVE_HEIGHT 224U
+
+// =============================================================================
+// Timing
+// =============================================================================
+
+void signal_gen_timing_mvs(signal_gen_timing_t *timing)
+{
+    memset(timing, 0, sizeof *timing);
+    timing->system = SIGNAL_GEN_MVS;
+    timing->h_total = MVS_H_TOTAL;
+    timing->v_total = MVS_V_TOTAL;
+    timing->dot_clock_hz = MVS_PCLK_HZ;
+    timing->hsync_high = MVS_HSYNC_HIGH;
+    timing->eq_lines = 3U;
+    timing->serration_lines = 3U;
+    timing->eq_pulse = 14U;
+    timing->active_x = MVS_H_SKIP_START;
+    timing->active_width = 320U;
+    timing->active_height = ACTIVE_HEIGHT;
+    // sync_irq_handler() releases the frame on the second long pulse after
+    // the vertical interval, i.e. at the CSYNC fall of the second normal
+    // line. The pixel SM then starts on the next line and the capture loop
+    // drops V_SKIP_LINES of it before the first active line.
+    timing->active_y = (2U * timing->eq_lines) + timing->serration_lines + 2U + MVS_V_SKIP_LINES;
+}
+
+void signal_gen_timing_snes(signal_gen_timing_t *timing)
+{
+    memset(timing, 0, sizeof *timing);
+    timing->system = SIGNAL_GEN_SNES;
+    timing->h_total = SNES_H_TOTAL;
+    timing->v_total = SNES_V_TOTAL;
+    timing->dot_clock_hz = SNES_DOT_CLOCK_HZ;
+    timing->hblank_start = SNES_HBLANK_START;
+    timing->active_height = ACTIVE_HEIGHT;
+    timing->vblank_start = 1U + ACTIVE_HEIGHT;
+    // The capture loop triggers on the VBLANK fall at the top of line 0; the
+    // SM then waits for the next HBLANK fall (line 1) and skips 20 PCLKs.
+    timing->active_x = SNES_SKIP_PCLKS;
+    timing->active_y = 1U;
+    timing->active_width = 256U;
+}
+
+void signal_gen_set_50hz(signal_gen_timing_t *timing)
+{
+    timing->v_total = PAL_V_TOTAL;
+    if (timing->system == SIGNAL_GEN_SNES) {
+        timing->dot_clock_hz = SNES_PAL_DOT_CLOCK_HZ;
+    }
+}
+
+void signal_gen_set_frame_rate(signal_gen_timing_t *timing, double frame_hz)
+{
+    timing->dot_clock_hz = (uint32_t)((frame_hz * (double)signal_gen_frame_dots(timing)) + 0.5);
+}
+
+double signal_gen_frame_rate(const signal_gen_timing_t *timing)
+{
+    return (double)timing->dot_clock_hz / (double)signal_gen_frame_dots(timing);
+}
+
+void signal_gen_init(signal_gen_t *gen, signal_gen_system_t system, uint32_t sys_hz)
+{
+    memset(gen, 0, sizeof *gen);
+    if (system == SIGNAL_GEN_SNES) {
+        signal_gen_timing_snes(&gen->timing);
+    } else {
+        signal_gen_timing_mvs(&gen->timing);
+    }
+    gen->sys_hz = sys_hz;
+    gen->lead = (sys_hz / gen->timing.dot_clock_hz) / 2U;
+}
+
+// =============================================================================
+// Pixel encoding
+// =============================================================================
+
+uint32_t signal_gen_mvs_encode(uint8_t r, uint8_t g, uint8_t b, uint8_t effects)
+{
+    // mvs_correct_5bit() reverses then inverts, so encode inverts first.
+    const uint32_t r_field = mvs_correct_5bit((r >> 3) ^ (MVS_INVERT_R ? 0x1FU : 0U), 0, MVS_REVERSE_R);
+    const uint32_t g_field = mvs_correct_5bit((g >> 3) ^ (MVS_INVERT_G ? 0x1FU : 0U), 0, MVS_REVERSE_G);
+    const uint32_t b_field = mvs_correct_5bit((b >> 3) ^ (MVS_INVERT_B ? 0x1FU : 0U), 0, MVS_REVERSE_B);
+    uint32_t color15 = (r_field << 10) | (g_field << 5) | b_field;
+#if MVS_REVERSE_15BIT
+    color15 = mvs_reverse_15(color15);
+#endif
+    color15 ^= MVS_RAW_COLOR_MASK & 0x7FFFU;
+
+    const uint32_t shadow = (effects & SIGNAL_GEN_SHADOW) ? 1U : 0U;
+    const uint32_t dark = (effects & SIGNAL_GEN_DARK) ? 1U : 0U;
+    return (color15 << 2) | (shadow << 17) | (dark << 18);
+}
+
+static uint32_t reverse_5bit(uint32_t x)
+{
+    return ((x & 1U) << 4) | ((x & 2U) << 2) | (x & 4U) | ((x & 8U) >> 2) | ((x & 16U) >> 4);
+}
+
+uint32_t signal_gen_snes_encode(uint8_t r, uint8_t g, uint8_t b)
+{
+    const uint32_t color15 =
+        (reverse_5bit(r >> 3) << 10) | (reverse_5bit(g >> 3) << 5) | reverse_5bit(b >> 3);
+    return color15 << 2;
+}
+
+// =============================================================================
+// Raster
+// =============================================================================
+
+bool signal_gen_mvs_csync(const signal_gen_timing_t *timing, uint32_t line, uint32_t dot)
+{
+    const uint32_t eq_end = timing->eq_lines;
+    const uint32_t serration_end = eq_end + timing->serration_lines;
+    const uint32_t vsync_end = serration_end + timing->eq_lines;
+    if (line >= vsync_end) {
+        return dot < timing->hsync_high;
+    }
+
+    // Vertical interval lines are two half-lines, each ending in a pulse.
+    const uint32_t half = timing->h_total / 2U;
+    const uint32_t len = dot < half ? half : timing->h_total - half;
+    const uint32_t pos = dot < half ? dot : dot - half;
+    const uint32_t p = timing->eq_pulse;
+    if (line >= eq_end && line < serration_end) {
+        // Serration: low except a short high just before the half-line end.
+        return pos + (2U * p) >= len && pos + p < len;
+    }
+    // Equalization: high except a short low at the half-line end.
+    return pos + p < len;
+}
+
+static uint32_t active_pixel(const signal_gen_t *gen, uint64_t frame, uint32_t line, uint32_t dot, bool second_half)
+{
+    const signal_gen_timing_t *t = &gen->timing;
+    const bool mvs = t->system == SIGNAL_GEN_MVS;
+    const uint32_t black = mvs ? signal_gen_mvs_encode(0, 0, 0, 0) : signal_gen_snes_encode(0, 0, 0);
+    if (gen->frame_count == 0U || line < t->active_y || dot < t->active_x) {
+        return black;
+    }
+    const uint32_t y = line - t->active_y;
+    const uint32_t x = dot - t->active_x;
+    const signal_gen_frame_t *f = &gen->frames[frame % gen->frame_count];
+    const bool hires = !mvs && f->width == 2U * t->active_width;
+    const uint32_t fx = hires ? (2U * x) + (second_half ? 1U : 0U) : x;
+    if (y >= t->active_height || x >= t->active_width || y >= f->height || fx >= f->width) {
+        return black;
+    }
+    const size_t i = ((size_t)y * f->width) + fx;
+    const uint8_t *rgb = &f->rgb[i * 3U];
+    if (mvs) {
+        return signal_gen_mvs_encode(rgb[0], rgb[1], rgb[2], f->effects ? f->effects[i] : 0U);
+    }
+    return signal_gen_snes_encode(rgb[0], rgb[1], rgb[2]);
+}
+
+static uint32_t line_shadow(const signal_gen_t *gen, uint64_t frame, uint32_t line, uint32_t dot)
+{
+    const signal_gen_timing_t *t = &gen->timing;
+    if (gen->frame_count == 0U) {
+        return 0U;
+    }
+    const signal_gen_frame_t *f = &gen->frames[frame % gen->frame_count];
+    const uint32_t held = dot >= t->active_x ? line : line - 1U;
+    if (f->shadow_lines == NULL || line == 0U || held < t->active_y) {
+        return 0U;
+    }
+    const uint32_t y = held - t->active_y;
+    return y < t->active_height && y < f->height && f->shadow_lines[y] != 0U ? 1U : 0U;
+}
+
+// `second_half`: from the dot's PCLK rising edge on, where a hires frame
+// shows the dot's second pixel.
+static uint32_t raster_word(const signal_gen_t *gen, uint64_t dot, bool pclk, bool second_half)
+{
+    if (gen->word_count != 0U) {
+        return (gen->words[dot % gen->word_count] & ~2U) | (pclk ? 2U : 0U);
+    }
+
+    const signal_gen_timing_t *t = &gen->timing;
+    const uint64_t frame_dots = signal_gen_frame_dots(t);
+    uint64_t frame = dot / frame_dots;
+    uint32_t pos = (uint32_t)(dot % frame_dots);
+    if (t->interlace) {
+        // Long field then short field, 2 * v_total + 1 lines a pair.
+        const uint64_t pair_dots = (2U * frame_dots) + t->h_total;
+        const uint64_t in_pair = dot % pair_dots;
+        const bool second_field = in_pair >= frame_dots + t->h_total;
+        frame = (2U * (dot / pair_dots)) + (second_field ? 1U : 0U);
+        pos = (uint32_t)(second_field ? in_pair - frame_dots - t->h_total : in_pair);
+    }
+    const uint32_t line = pos / t->h_total;
+    const uint32_t x = pos % t->h_total;
+
+    uint32_t word = active_pixel(gen, frame, line, x, second_half) | (pclk ? 2U : 0U);
+    if (t->system == SIGNAL_GEN_MVS) {
+        word |= signal_gen_mvs_csync(t, line, x) ? 1U : 0U;
+        word |= line_shadow(gen, frame, line, x) << 17;
+    } else {
+        word |= line >= t->vblank_start ? 1U : 0U;
+        word |= (x >= t->hblank_start ? 1U : 0U) << 17;
+    }
+    return word;
+}
+
+uint32_t signal_gen_word(const signal_gen_t *gen, uint64_t dot)
+{
+    return raster_word(gen, dot, true, true);
+}
+
+void signal_gen_render_frame(const signal_gen_t *gen, uint32_t frame, uint32_t *dst)
+{
+    const uint64_t frame_dots = signal_gen_frame_dots(&gen->timing);
+    const uint64_t base = signal_gen_frame_start(&gen->timing, frame);
+    for (uint64_t i = 0; i < frame_dots; i++) {
+        dst[i] = raster_word(gen, base + i, true, true);
+    }
+}
+
+// =============================================================================
+// Pad waveform
+// =============================================================================
+
+// Deterministic displacement in [-peak, peak] for one dot.
+static int64_t jitter(uint32_t peak, uint32_t seed, uint64_t dot)
+{
+    if (peak == 0U) {
+        return 0;
+    }
+    uint64_t h = dot ^ ((uint64_t)seed << 32);
+    h += 0x9E3779B97F4A7C15ULL;
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+    h ^= h >> 31;
+    return (int64_t)(h % ((2U * (uint64_t)peak) + 1U)) - (int64_t)peak;
+}
+
+int64_t signal_gen_edge_cycle(const signal_gen_t *gen, uint64_t dot)
+{
+    // Nominal edge k is the first system clock at or after k * sys / pclk.
+    const uint64_t clk = gen->timing.dot_clock_hz;
+    const uint64_t nominal = ((dot * gen->sys_hz) + clk - 1U) / clk;
+    return (int64_t)nominal + jitter(gen->edge_jitter, gen->jitter_seed, dot);
+}
+
+static int64_t launch_cycle(const signal_gen_t *gen, uint64_t dot)
+{
+    return signal_gen_edge_cycle(gen, dot) - (int64_t)gen->lead +
+           jitter(gen->skew_jitter, gen->jitter_seed ^ 0x5BD1E995U, dot);
+}
+
+// Last dot whose `event` is at or before `cycle`, searched around the
+// unjittered estimate `guess`. Returns false before the first dot.
+static bool last_dot_at(const signal_gen_t *gen, int64_t (*event)(const signal_gen_t *, uint64_t), uint64_t guess,
+                        uint64_t cycle, uint64_t *dot)
+{
+    const uint64_t reach = 2U + (((uint64_t)gen->edge_jitter + gen->skew_jitter + gen->lead) * gen->timing.dot_clock_hz /
+                                 gen->sys_hz);
+    const uint64_t lo = guess > reach ? guess - reach : 0U;
+    for (uint64_t k = guess + reach + 1U; k-- > lo;) {
+        if (event(gen, k) <= (int64_t)cycle) {
+            *dot = k;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool in_dropout(const signal_gen_t *gen, uint64_t dot)
+{
+    for (uint32_t i = 0; i < gen->dropout_count; i++) {
+        const signal_gen_dropout_t *d = &gen->dropouts[i];
+        if (dot >= d->start && dot - d->start < d->dots) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint64_t signal_gen_pin_levels(uint64_t cycle, void *ctx)
+{
+    const signal_gen_t *gen = ctx;
+    const uint64_t clk = gen->timing.dot_clock_hz;
+    const uint64_t guess = (cycle * clk) / gen->sys_hz;
+    if (in_dropout(gen, guess)) {
+        return 0;
+    }
+
+    bool pclk = false;
+    uint64_t edge_dot;
+    if (last_dot_at(gen, signal_gen_edge_cycle, guess, cycle, &edge_dot)) {
+        // High for the first half of the period after each edge.
+        const uint64_t since = cycle - (uint64_t)signal_gen_edge_cycle(gen, edge_dot);
+        pclk = (since * 2U * clk) < gen->sys_hz;
+    }
+    uint64_t data_dot = 0;
+    (void)last_dot_at(gen, launch_cycle, ((cycle + gen->lead) * clk) / gen->sys_hz, cycle, &data_dot);
+
+    const uint32_t base = gen->timing.system == SIGNAL_GEN_MVS ? PIN_MVS_BASE : PIN_SNES_BASE;
+    const bool second_half = (int64_t)cycle >= signal_gen_edge_cycle(gen, data_dot);
+    return (uint64_t)raster_word(gen, data_dot, pclk, second_half) << base;
+}
+
+uint32_t signal_gen_sample_word(const signal_gen_t *gen, uint64_t dot)
+{
+    const int64_t edge = signal_gen_edge_cycle(gen, dot);
+    const int64_t sample = edge + (int64_t)SIGNAL_GEN_SAMPLE_CYCLES;
+    const uint64_t cycle = sample > 0 ? (uint64_t)sample : 0U;
+    if (gen->timing.system == SIGNAL_GEN_MVS) {
+        return (uint32_t)(signal_gen_pin_levels(cycle, (void *)gen) >> PIN_MVS_BASE) & MVS_CAPTURE_MASK;
+    }
+    return (uint32_t)(signal_gen_pin_levels(cycle, (void *)gen) >> PIN_SNES_BASE) & SNES_CAPTURE_MASK;
+}
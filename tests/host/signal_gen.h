@@ -0,0 +1,176 @@
+// Synthetic MVS and SNES video sources for the host build.
+//
+// Renders RGB888 frames into the raw words the capture PIO programs sample:
+// for MVS the 19-bit `mvs_pixel_capture_dark19` word (CSYNC/PCLK in bits 1:0,
+// BGR fields encoded through the MVS_INVERT_*/MVS_REVERSE_* wiring macros in
+// mvs_color.h, SHADOW on bit 17, DARK on bit 18), for SNES the 18-bit
+// `snes_hard_sync` word (VBLANK/PCLK in bits 1:0, bit-reversed BGR, HBLANK on
+// bit 17).
+//
+// The same raster is available two ways:
+//   - per dot, as the word the pixel SM pushes for that PCLK rising edge
+//     (signal_gen_word(), signal_gen_render_frame());
+//   - per system clock, as pad levels for pico_host_set_pin_source()
+//     (signal_gen_pin_levels()), with the data launch offset, PCLK edge
+//     jitter and data-to-clock skew jitter a test asks for.
+//
+// Default timings put the active window exactly where the firmware's capture
+// loop looks for it, so a frame rendered here lands unshifted in the line
+// ring.
+#ifndef NEOPICO_HOST_SIGNAL_GEN_H
+#define NEOPICO_HOST_SIGNAL_GEN_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Per-pixel MVS palette effect flags (signal_gen_frame_t.effects).
+#define SIGNAL_GEN_DARK 0x01U
+#define SIGNAL_GEN_SHADOW 0x02U
+
+// Pads are sampled this many system clocks after the PCLK rising edge at
+// clkdiv 1 (wait 1 pin through the input synchronizer, two nops, `in`), as
+// measured by host_pio_emu.
+#define SIGNAL_GEN_SAMPLE_CYCLES 3U
+
+typedef enum {
+    SIGNAL_GEN_MVS,
+    SIGNAL_GEN_SNES,
+} signal_gen_system_t;
+
+// A SNES frame twice the active width is hires: each dot shows pixel 2x up to
+// its PCLK rising edge and pixel 2x + 1 from it, as the PPU does in its 512-dot
+// modes. A lores line in such a frame simply repeats each pixel.
+typedef struct {
+    uint32_t width;
+    uint32_t height;
+    const uint8_t *rgb;     // width * height * 3, row-major RGB888
+    const uint8_t *effects; // optional width * height SIGNAL_GEN_DARK/SHADOW (MVS only)
+    // Optional per-line SHADOW (MVS only), driven the way the MVS's screen-wide
+    // register does: held from a line's first active dot to the next line's,
+    // across the horizontal blanking between them.
+    const uint8_t *shadow_lines;
+} signal_gen_frame_t;
+
+typedef struct {
+    signal_gen_system_t system;
+    uint32_t h_total;       // dots per line
+    uint32_t v_total;       // lines per frame
+    uint32_t active_x;      // first active dot of a line
+    uint32_t active_y;      // first active line of a frame
+    uint32_t active_width;  // frame pixels beyond the window are cropped,
+    uint32_t active_height; // window pixels beyond the frame are black
+    uint32_t dot_clock_hz;
+
+    // MVS composite sync. A frame opens with eq_lines of equalization,
+    // serration_lines of serrations and eq_lines of equalization again; every
+    // other line has CSYNC high for dots [0, hsync_high).
+    uint32_t hsync_high;
+    uint32_t eq_lines;
+    uint32_t serration_lines;
+    uint32_t eq_pulse; // dots of each half-line equalization/serration pulse
+
+    // SNES blanking. HBLANK is high for dots [hblank_start, h_total); VBLANK
+    // is high for whole lines [vblank_start, v_total) and falls at dot 0.
+    uint32_t hblank_start;
+    uint32_t vblank_start;
+    // SNES interlace: frames (fields) alternate v_total + 1 and v_total
+    // lines, starting with the long one; the extra line is vertical blank.
+    bool interlace;
+} signal_gen_timing_t;
+
+// One signal loss: from stream dot `start`, for `dots` dots, every pad is
+// held low, as with the cable pulled. The raster carries on where it would
+// have been, so the signal comes back mid-frame.
+typedef struct {
+    uint64_t start;
+    uint64_t dots;
+} signal_gen_dropout_t;
+
+typedef struct {
+    signal_gen_timing_t timing;
+    const signal_gen_frame_t *frames; // played in order, looping
+    uint32_t frame_count;
+
+    // Recorded raw words (e.g. neopico_signal_gen output) to play instead of
+    // `frames`, looping; PCLK (bit 1) is regenerated, every other bit is taken
+    // as recorded. word_count should be a whole number of frames.
+    const uint32_t *words;
+    uint64_t word_count;
+
+    // Pad-level waveform (signal_gen_pin_levels() and signal_gen_sample_word()).
+    uint32_t sys_hz;
+    uint32_t lead;          // system clocks the outputs change before the PCLK rising edge
+    uint32_t edge_jitter;   // peak PCLK edge displacement in system clocks; outputs follow it
+    uint32_t skew_jitter;   // peak extra displacement of the output launch against its edge
+    uint32_t jitter_seed;
+
+    // Signal losses on the pads (signal_gen_pin_levels() only), in stream
+    // order.
+    const signal_gen_dropout_t *dropouts;
+    uint32_t dropout_count;
+} signal_gen_t;
+
+// Default raster for each target. MVS: 384 x 264 dots at 6 MHz, 3+3+3 lines
+// of vertical sync, 320 x 224 active starting at dot 28 of line 27 (the line
+// the capture loop reaches after its V_SKIP_LINES border skip). SNES: 341 x
+// 262 dots at 5.369318 MHz, 256 x 224 active starting 20 dots into line 1.
+void signal_gen_timing_mvs(signal_gen_timing_t *timing);
+void signal_gen_timing_snes(signal_gen_timing_t *timing);
+
+// 50 Hz raster: 312 lines, the extra ones below the active window (MVS
+// border, SNES vertical blank), and for SNES the PAL dot clock (21.281 MHz
+// master / 4, 50.007 Hz). MVS keeps its 6 MHz dot clock, 50.08 Hz.
+void signal_gen_set_50hz(signal_gen_timing_t *timing);
+
+// Retune the dot clock for a frame rate; the raster is unchanged.
+void signal_gen_set_frame_rate(signal_gen_timing_t *timing, double frame_hz);
+double signal_gen_frame_rate(const signal_gen_timing_t *timing);
+
+// Zeroes the generator and loads the target's default timing, with outputs
+// launched on the PCLK falling edge at `sys_hz`.
+void signal_gen_init(signal_gen_t *gen, signal_gen_system_t system, uint32_t sys_hz);
+
+// Bits 2 and up of a raw word for one RGB888 pixel: the exact inverse of the
+// firmware's capture-side decode.
+uint32_t signal_gen_mvs_encode(uint8_t r, uint8_t g, uint8_t b, uint8_t effects);
+uint32_t signal_gen_snes_encode(uint8_t r, uint8_t g, uint8_t b);
+
+// MVS CSYNC level at `dot` of frame line `line`.
+bool signal_gen_mvs_csync(const signal_gen_timing_t *timing, uint32_t line, uint32_t dot);
+
+static inline uint64_t signal_gen_frame_dots(const signal_gen_timing_t *timing)
+{
+    return (uint64_t)timing->h_total * timing->v_total;
+}
+
+// Stream dot at which frame `frame` starts, long interlaced fields included.
+static inline uint64_t signal_gen_frame_start(const signal_gen_timing_t *timing, uint64_t frame)
+{
+    const uint64_t long_fields = timing->interlace ? (frame + 1U) / 2U : 0U;
+    return (frame * signal_gen_frame_dots(timing)) + (long_fields * timing->h_total);
+}
+
+// Word the pixel SM pushes for stream dot `dot` (frame-major, then line, then
+// dot): sync bits, PCLK high, colour and flags; for a hires frame, the dot's
+// second pixel. With recorded words loaded this is the recording with PCLK
+// forced high.
+uint32_t signal_gen_word(const signal_gen_t *gen, uint64_t dot);
+
+// One frame of signal_gen_word(), h_total * v_total words (a long
+// interlaced field's extra blank line is left out).
+void signal_gen_render_frame(const signal_gen_t *gen, uint32_t frame, uint32_t *dst);
+
+// System clock of stream dot `dot`'s PCLK rising edge, jitter included.
+int64_t signal_gen_edge_cycle(const signal_gen_t *gen, uint64_t dot);
+
+// pico_host_pin_source_t over a signal_gen_t: GPIO levels at system clock
+// `cycle`, the capture word placed at the target's pin base, or all low
+// inside a dropout.
+uint64_t signal_gen_pin_levels(uint64_t cycle, void *ctx);
+
+// The word a clkdiv-1 pixel SM would capture for `dot` from the pads above:
+// equal to signal_gen_word() unless the jitter pushes a launch past the
+// sample point.
+uint32_t signal_gen_sample_word(const signal_gen_t *gen, uint64_t dot);
+
+#endif // NEOPICO_HOST_SIGNAL_GEN_H
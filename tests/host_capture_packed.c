@@ -0,0 +1,117 @@
+// Checks the packed capture conversion (convert_active_pixels_packed(), two
+// [DARK][RGB555] pixels per word from mvs_pixel_capture_packed16) against the
+// one-pixel-per-word conversion, bit for bit: every RGB555 value with and
+// without DARK, on SHADOW and non-SHADOW lines, with noise in the CSYNC/PCLK
+// bits the packed words drop. The one-pixel conversion must also return the
+// AND of those CSYNC/PCLK bits for the line check, and both must return the
+// ring line's capture_hash_line(). Built once per conversion
+// variant against the benchmark's kernel-access firmware (tests/CMakeLists.txt).
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench_kernels.h"
+#include "capture_line.h"
+
+static unsigned g_check_failures;
+
+#define CHECK(condition, ...)                                                                                          \
+    do {                                                                                                               \
+        if (!(condition)) {                                                                                            \
+            fprintf(stderr, "CHECK FAILED: ");                                                                         \
+            fprintf(stderr, __VA_ARGS__);                                                                              \
+            fputc('\n', stderr);                                                                                       \
+            g_check_failures++;                                                                                        \
+        }                                                                                                              \
+    } while (0)
+
+// Mirror of NEO_H_ACTIVE in video_capture_mvs.c.
+#define LINE_PIXELS 320U
+// Every RGB555 value, with and without DARK.
+#define PIXEL_VALUES 65536U
+
+// One-pixel capture word (mvs_pixel_capture_dark19): CSYNC/PCLK in 1:0,
+// RGB555 in 16:2, SHADOW on 17, DARK on 18.
+static uint32_t raw_word(uint32_t value, uint32_t shadow, uint32_t noise)
+{
+    return (noise & 3U) | ((value & 0x7FFFU) << 2) | (shadow << 17) | (((value >> 15) & 1U) << 18);
+}
+
+// The packed program's halfword for that sample (host_pio_emu checks the
+// program against this layout).
+static uint32_t packed_half(uint32_t raw)
+{
+    return ((raw >> 2) & 0x7FFFU) | (((raw >> 18) & 1U) << 15);
+}
+
+int main(void)
+{
+    static uint32_t raw[LINE_PIXELS];
+    static uint32_t packed[LINE_PIXELS / 2U];
+    static uint16_t want[LINE_PIXELS];
+    static uint16_t got[LINE_PIXELS];
+
+    bench_capture_prepare();
+
+    uint32_t lines = 0;
+    uint32_t pixel_mismatches = 0;
+    uint32_t shadow_mismatches = 0;
+    uint32_t sync_mismatches = 0;
+    uint32_t hash_mismatches = 0;
+    for (uint32_t shadow = 0; shadow < 2U; shadow++) {
+        for (uint32_t first = 0; first < PIXEL_VALUES; first += LINE_PIXELS) {
+            // Most lines keep CSYNC and PCLK high throughout; every third
+            // has noise in them.
+            uint32_t want_sync = 3U;
+            for (uint32_t x = 0; x < LINE_PIXELS; x++) {
+                const uint32_t value = (first + x) % PIXEL_VALUES;
+                const uint32_t noise = lines % 3U == 0U ? (value * 0x9E3779B1U) >> 30 : 3U;
+                raw[x] = raw_word(value, shadow, noise);
+                want_sync &= noise;
+            }
+            for (uint32_t i = 0; i < LINE_PIXELS / 2U; i++) {
+                packed[i] = packed_half(raw[2U * i]) | (packed_half(raw[(2U * i) + 1U]) << 16);
+            }
+
+            if ((bench_convert_active_pixels(want, raw, (int)LINE_PIXELS) & 3U) != want_sync) {
+                sync_mismatches++;
+            }
+            const uint32_t want_shadow = bench_capture_line_shadow();
+            const uint32_t want_hash = capture_hash_line(want, (int)LINE_PIXELS);
+            hash_mismatches += bench_capture_line_hash() != want_hash ? 1U : 0U;
+            memset(got, 0, sizeof got);
+            bench_convert_active_pixels_packed(got, packed, (int)(LINE_PIXELS / 2U), shadow);
+            if (bench_capture_line_shadow() != want_shadow) {
+                shadow_mismatches++;
+            }
+            hash_mismatches += bench_capture_line_hash() != want_hash ? 1U : 0U;
+            for (uint32_t x = 0; x < LINE_PIXELS; x++) {
+                if (got[x] != want[x] && pixel_mismatches++ < 4U) {
+                    fprintf(stderr, "  raw 0x%05" PRIx32 ": packed 0x%04x, one-pixel 0x%04x\n", raw[x], got[x],
+                            want[x]);
+                }
+            }
+            lines++;
+        }
+    }
+
+    CHECK(pixel_mismatches == 0U, "%" PRIu32 " of %" PRIu32 " pixels convert differently from packed words",
+          pixel_mismatches, lines * LINE_PIXELS);
+    CHECK(sync_mismatches == 0U, "%" PRIu32 " of %" PRIu32 " lines report the wrong CSYNC/PCLK AND", sync_mismatches,
+          lines);
+    CHECK(hash_mismatches == 0U, "%" PRIu32 " of %" PRIu32 " conversions return a hash other than the ring line's",
+          hash_mismatches, 2U * lines);
+    CHECK(shadow_mismatches == 0U, "%" PRIu32 " of %" PRIu32 " lines latch a different SHADOW", shadow_mismatches,
+          lines);
+
+    if (g_check_failures != 0U) {
+        fprintf(stderr, "\nFAIL: %u packed capture checks failed.\n", g_check_failures);
+        return EXIT_FAILURE;
+    }
+    printf("PASS: packed capture words convert bit for bit like one-pixel words (%" PRIu32 " lines).\n", lines);
+    return EXIT_SUCCESS;
+}
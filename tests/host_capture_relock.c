@@ -0,0 +1,308 @@
+// Replays MVS signal dropouts through the emulated pads, PIO and the
+// unmodified capture loop, with I2S words arriving at the audio DMA unless
+// the trace stops the audio clock too. Every trace must relock within a
+// frame or two of the signal's return, through the tier it calls for:
+// - short losses, mid-frame or in the vertical gap, relock without a
+//   capture hardware reset, and a frame cut short is finished from the
+//   previous one so the ring always holds a whole picture, once Core 1 has
+//   left any earlier frame the copies land on;
+// - only a loss that outlasts the fast relock tries resets the hardware;
+// - audio is re-armed only when its clock stopped.
+//
+// Built for the default MVS flag set.
+
+#include <inttypes.h>
+#include <setjmp.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "audio_subsystem.h"
+#include "line_ring.h"
+#include "mvs_effect_lut.h"
+#include "pico/time.h"
+#include "pico_host.h"
+#include "pio_emu.h"
+#include "signal_gen.h"
+#include "test_frame.h"
+#include "video_capture.h"
+#include "video_config.h"
+
+static unsigned g_check_failures;
+
+#define CHECK(condition, ...)                                                                                          \
+    do {                                                                                                               \
+        if (!(condition)) {                                                                                            \
+            fprintf(stderr, "CHECK FAILED: ");                                                                         \
+            fprintf(stderr, __VA_ARGS__);                                                                              \
+            fputc('\n', stderr);                                                                                       \
+            g_check_failures++;                                                                                        \
+        }                                                                                                              \
+    } while (0)
+
+#define SYS_CLOCK_HZ 126000000U
+#define EMU_STEP_CYCLES 64U
+
+// NEO-YSA2 words per second: two per stereo sample.
+#define I2S_WORDS_PER_S 111112U
+
+#define MAX_VSYNCS 64U
+
+typedef struct {
+    const char *name;
+    uint32_t start_line;    // stream line the pads drop at
+    uint32_t lost_us;       // how long they stay low
+    uint32_t audio_lost_us; // how long the I2S clock stops with them; 0: it keeps running
+    bool reader_behind;     // Core 1 is still on the previous frame when this one is cut
+
+    // Expected outcome.
+    bool aborts_frame;
+    bool resets_hardware;
+    bool rearms_audio;
+} dropout_trace_t;
+
+typedef struct {
+    jmp_buf exit;
+    const dropout_trace_t *trace;
+    uint64_t cycle_limit;
+    uint64_t audio_stop_us;
+    uint64_t audio_restart_us;
+    uint64_t i2s_words; // pushed or skipped so far
+
+    uint64_t vsync_us[MAX_VSYNCS];
+    uint32_t vsyncs;
+
+    // The ring when the frame was cut short, and the cut frame as it was
+    // left when the next one replaced it.
+    uint32_t aborts_seen;
+    uint32_t abort_lines; // lines of the cut frame committed
+    uint32_t cut_base;
+    uint32_t cut_lines;
+    uint32_t cut_mismatches;
+    bool cut_replaced;
+
+    // Core 1's next output VSYNC after the cut, for reader_behind traces.
+    uint64_t reader_vsync_us;
+    bool reader_moved;
+
+    // Complete frames in the ring once the signal is back.
+    uint64_t back_us;
+    uint32_t checked_base;
+    uint32_t frames_back;
+    uint32_t bad_frames_back;
+} relock_driver_t;
+
+static signal_gen_t g_gen;
+static signal_gen_dropout_t g_dropout;
+static uint8_t g_rgb[CAPTURE_ACTIVE_HEIGHT][CAPTURE_ACTIVE_WIDTH][3];
+
+static uint64_t dot_us(uint64_t dot)
+{
+    return (dot * 1000000U) / g_gen.timing.dot_clock_hz;
+}
+
+// Lines of the frame at `base` in the ring that differ from the rendered
+// frame.
+static uint32_t ring_mismatches(uint32_t base)
+{
+    const signal_gen_timing_t *t = &g_gen.timing;
+    uint32_t bad_lines = 0;
+    for (uint32_t y = 0; y < SOURCE_HEIGHT; y++) {
+        const uint16_t *ring_line = g_line_ring.lines[LINE_RING_SLOT(base + y)];
+        for (uint32_t x = 0; x < t->active_width; x++) {
+            const uint32_t raw = signal_gen_word(&g_gen, ((uint64_t)(t->active_y + y) * t->h_total) + t->active_x + x);
+            if (ring_line[x] != mvs_entropy_pack_raw(raw)) {
+                bad_lines++;
+                break;
+            }
+        }
+    }
+    return bad_lines;
+}
+
+// The audio clock as the trace runs it: I2S words reach the capture DMA at
+// the NEO-YSA2 rate except while it is stopped.
+static void feed_i2s(relock_driver_t *drv)
+{
+    const uint64_t now = time_us_64();
+    const uint64_t due = (now * I2S_WORDS_PER_S) / 1000000U;
+    const bool stopped = now >= drv->audio_stop_us && now < drv->audio_restart_us;
+    while (drv->i2s_words < due) {
+        if (!stopped) {
+            (void)pico_host_pio_push_rx(pio2, 0, (uint16_t)drv->i2s_words);
+        }
+        drv->i2s_words++;
+    }
+}
+
+static bool relock_wait_hook(pico_host_wait_reason_t reason, uint64_t deadline_us, void *ctx)
+{
+    relock_driver_t *drv = ctx;
+    (void)reason;
+    (void)deadline_us;
+    if (pico_host_sys_cycles() >= drv->cycle_limit) {
+        longjmp(drv->exit, 1);
+    }
+
+    // line_ring_vsync() raised the resync request: a frame started.
+    if (line_ring_should_resync() && drv->vsyncs < MAX_VSYNCS) {
+        drv->vsync_us[drv->vsyncs++] = time_us_64();
+    }
+
+    video_capture_relock_stats_t stats;
+    video_capture_get_relock_stats(&stats);
+    if (stats.aborted_frames != drv->aborts_seen) {
+        drv->aborts_seen = stats.aborted_frames;
+        drv->abort_lines = g_line_ring.write_idx - g_line_ring.frame_base_idx;
+        drv->cut_base = g_line_ring.frame_base_idx;
+        drv->reader_vsync_us = time_us_64() + 5000U;
+    }
+    // The next frame starts where the cut one ends.
+    if (drv->aborts_seen != 0U && !drv->cut_replaced && g_line_ring.frame_base_idx != drv->cut_base) {
+        drv->cut_replaced = true;
+        drv->cut_lines = g_line_ring.frame_base_idx - drv->cut_base;
+        drv->cut_mismatches = ring_mismatches(drv->cut_base);
+    }
+
+    // Core 1 on the frame being written, or a frame behind (its output
+    // VSYNC landed just before line 0) until its next output VSYNC after
+    // the cut.
+    if (!drv->trace->reader_behind) {
+        g_line_ring.read_frame_start = g_line_ring.frame_base_idx;
+    } else if (drv->aborts_seen == 0U && g_line_ring.frame_base_idx >= SOURCE_HEIGHT) {
+        g_line_ring.read_frame_start = g_line_ring.frame_base_idx - SOURCE_HEIGHT;
+    } else if (drv->aborts_seen != 0U && !drv->reader_moved && time_us_64() >= drv->reader_vsync_us) {
+        line_ring_output_vsync();
+        drv->reader_moved = true;
+    }
+
+    const uint32_t base = g_line_ring.frame_base_idx;
+    if (g_line_ring.write_idx - base == SOURCE_HEIGHT && base != drv->checked_base) {
+        drv->checked_base = base;
+        if (time_us_64() >= drv->back_us) {
+            drv->frames_back++;
+            drv->bad_frames_back += ring_mismatches(base) != 0U ? 1U : 0U;
+        }
+    }
+
+    feed_i2s(drv);
+    pio_emu_run(EMU_STEP_CYCLES);
+    return true;
+}
+
+static void run_trace(const dropout_trace_t *trace)
+{
+    static relock_driver_t drv;
+    memset(&drv, 0, sizeof drv);
+    drv.trace = trace;
+
+    const signal_gen_timing_t *t = &g_gen.timing;
+    const uint64_t frame_dots = signal_gen_frame_dots(t);
+    const uint64_t frame_us = dot_us(frame_dots);
+    g_dropout.start = (uint64_t)trace->start_line * t->h_total;
+    g_dropout.dots = ((uint64_t)trace->lost_us * t->dot_clock_hz) / 1000000U;
+    g_gen.dropouts = &g_dropout;
+    g_gen.dropout_count = 1;
+    const uint64_t lost_us = dot_us(g_dropout.start);
+    const uint64_t back_us = dot_us(g_dropout.start + g_dropout.dots);
+    drv.back_us = back_us;
+    drv.checked_base = UINT32_MAX;
+    drv.audio_stop_us = trace->audio_lost_us != 0U ? lost_us : UINT64_MAX;
+    drv.audio_restart_us = lost_us + trace->audio_lost_us;
+    // Three frames after the signal comes back.
+    drv.cycle_limit = ((back_us + (3U * frame_us)) * SYS_CLOCK_HZ) / 1000000U;
+
+    pico_host_reset();
+    pico_host_set_sys_clock_hz(SYS_CLOCK_HZ);
+    pico_host_set_pin_source(signal_gen_pin_levels, &g_gen);
+    memset(&g_line_ring, 0, sizeof g_line_ring);
+    line_ring_init();
+    audio_subsystem_init();
+    audio_subsystem_start();
+    video_capture_init(SOURCE_HEIGHT);
+
+    pico_host_set_wait_hook(relock_wait_hook, &drv);
+    if (setjmp(drv.exit) == 0) {
+        video_capture_run();
+    }
+    pico_host_set_wait_hook(NULL, NULL);
+    pico_host_set_pin_source(NULL, NULL);
+    audio_subsystem_stop();
+
+    video_capture_relock_stats_t stats;
+    video_capture_get_relock_stats(&stats);
+    CHECK(stats.losses == 1U, "%s: %" PRIu32 " losses, want 1", trace->name, stats.losses);
+    CHECK((stats.aborted_frames != 0U) == trace->aborts_frame, "%s: %" PRIu32 " frames cut short", trace->name,
+          stats.aborted_frames);
+    CHECK((stats.hardware_resets != 0U) == trace->resets_hardware, "%s: %" PRIu32 " hardware resets", trace->name,
+          stats.hardware_resets);
+    CHECK(stats.fast_relocks == (trace->resets_hardware ? 0U : 1U), "%s: %" PRIu32 " fast relocks", trace->name,
+          stats.fast_relocks);
+    CHECK(stats.audio_rearms == (trace->rearms_audio ? 1U : 0U), "%s: %" PRIu32 " audio re-arms", trace->name,
+          stats.audio_rearms);
+
+    if (trace->aborts_frame) {
+        CHECK(drv.cut_lines == SOURCE_HEIGHT && drv.cut_mismatches == 0U,
+              "%s: the cut frame holds %" PRIu32 " lines, %" PRIu32 " of them wrong", trace->name, drv.cut_lines,
+              drv.cut_mismatches);
+        // With Core 1 still on the previous frame the copies wait for it.
+        CHECK((drv.abort_lines == SOURCE_HEIGHT) == !trace->reader_behind,
+              "%s: %" PRIu32 " lines committed when the frame was cut", trace->name, drv.abort_lines);
+    }
+
+    // The first frame after the signal is back: its next vertical interval
+    // ends within a frame, the frame after that one more frame on.
+    uint32_t first = 0;
+    while (first < drv.vsyncs && drv.vsync_us[first] < back_us) {
+        first++;
+    }
+    const uint64_t relock_us = first < drv.vsyncs ? drv.vsync_us[first] - back_us : UINT64_MAX;
+    CHECK(relock_us <= frame_us + 1000U, "%s: first vsync %" PRIu64 "us after the signal came back", trace->name,
+          relock_us);
+    CHECK(drv.vsyncs - first >= 3U, "%s: %" PRIu32 " frames in the three after relock", trace->name,
+          drv.vsyncs - first);
+    CHECK(drv.frames_back >= 2U && drv.bad_frames_back == 0U,
+          "%s: %" PRIu32 " of %" PRIu32 " frames after the signal came back do not match the source", trace->name,
+          drv.bad_frames_back, drv.frames_back);
+
+    printf("%-28s relocked %5" PRIu64 "us after the signal returned (%" PRIu32 "us after the loss was noticed); "
+           "aborted %" PRIu32 ", resets %" PRIu32 ", audio re-arms %" PRIu32 "\n",
+           trace->name, relock_us, stats.last_relock_us, stats.aborted_frames, stats.hardware_resets,
+           stats.audio_rearms);
+}
+
+int main(void)
+{
+    static signal_gen_frame_t frame;
+    make_test_frame(&frame, g_rgb);
+    signal_gen_init(&g_gen, SIGNAL_GEN_MVS, SYS_CLOCK_HZ);
+    g_gen.frames = &frame;
+    g_gen.frame_count = 1;
+
+    const uint32_t v_total = g_gen.timing.v_total;
+    const uint32_t mid_frame = (2U * v_total) + g_gen.timing.active_y + 100U;
+    const uint32_t v_gap = (3U * v_total) - 8U;
+    static const uint32_t fast_limit_us = 4U * 25000U; // MVS_RELOCK_FAST_TRIES waits in video_capture_mvs.c
+    const dropout_trace_t traces[] = {
+        {"mid-frame glitch", mid_frame, 2000U, 0U, false, true, false, false},
+        {"mid-frame, Core 1 behind", mid_frame, 2000U, 0U, true, true, false, false},
+        {"vertical gap, 60 ms", v_gap, 60000U, 0U, false, false, false, false},
+        {"mid-frame, audio stops", mid_frame, 2000U, 60000U, false, true, false, true},
+        {"cable pulled, 180 ms", mid_frame, fast_limit_us + 80000U, fast_limit_us + 80000U, false, true, true, true},
+        {"cable pulled, Core 1 behind", mid_frame, fast_limit_us + 80000U, fast_limit_us + 80000U, true, true, true,
+         true},
+        {"long loss, audio runs", v_gap, fast_limit_us + 80000U, 0U, false, false, true, false},
+    };
+    for (size_t i = 0; i < sizeof traces / sizeof traces[0]; i++) {
+        run_trace(&traces[i]);
+    }
+
+    if (g_check_failures != 0U) {
+        fprintf(stderr, "\nFAIL: %u relock checks failed.\n", g_check_failures);
+        return EXIT_FAILURE;
+    }
+    printf("PASS: every dropout trace relocked through its tier, audio re-armed only when its clock stopped.\n");
+    return EXIT_SUCCESS;
+}
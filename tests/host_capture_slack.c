@@ -0,0 +1,248 @@
+// Runs the MVS capture loop against a paced line clock: the host DMA finishes
+// a line every MVS line period of virtual time, and Core 0's WFE lets time
+// move. Background tasks must start only when their budget fits before the
+// line Core 0 is waiting for, every line must still reach the ring, and the
+// slack accounting must add up to the wait the clock implies. A task that
+// outruns its budget must be reported late rather than go unnoticed.
+//
+// Built for the default MVS flag set plus NEOPICO_EXP_CAPTURE_SLACK_TASKS.
+
+#include <inttypes.h>
+#include <setjmp.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "line_ring.h"
+#include "mvs_sync_decoder.h"
+#include "pico/time.h"
+#include "pico_host.h"
+#include "video_capture.h"
+#include "video_config.h"
+#include "video_pipeline.h"
+
+// Mirrors of the private capture constants in video_capture_mvs.c.
+#define NEO_H_ACTIVE 320U
+#define LINE_PULSE 356U // a normal line's CSYNC high count
+#define V_SKIP_LINES 16U
+#define FRAME_PERIOD_US 16896U
+#define MVS_LINE_PERIOD_US 64U
+#define MVS_SLACK_GUARD_US 4U
+#define USB_TASK_BUDGET_US 20U
+#define FRAME_LINES (V_SKIP_LINES + SOURCE_HEIGHT)
+
+#define SYNC_SM 0U
+#define PIXEL_SM 1U
+
+// Virtual time one WFE lets pass.
+#define WFE_STEP_US 8U
+
+static unsigned g_check_failures;
+
+#define CHECK(condition, ...)                                                                                          \
+    do {                                                                                                               \
+        if (!(condition)) {                                                                                            \
+            fprintf(stderr, "CHECK FAILED: ");                                                                         \
+            fprintf(stderr, __VA_ARGS__);                                                                              \
+            fputc('\n', stderr);                                                                                       \
+            g_check_failures++;                                                                                        \
+        }                                                                                                              \
+    } while (0)
+
+typedef struct {
+    jmp_buf exit;
+    uint32_t frames;        // frames to capture
+    uint32_t frame;         // frames started
+    uint64_t frame_start;   // virtual time of the frame's capture trigger
+    uint32_t lines_sent;    // lines the DMA has finished this frame
+    uint32_t usb_cost_us;   // virtual time one tud_task() takes
+    uint32_t usb_runs;
+    uint32_t usb_line_runs; // runs while an active line was outstanding
+    uint32_t usb_unfit;     // runs that started with less than their budget left
+    uint32_t dropped_words;
+} slack_driver_t;
+
+static void send_sync_pulse(uint32_t h_ctr)
+{
+    (void)pico_host_pio_push_rx(pio1, SYNC_SM, h_ctr);
+}
+
+// One frame's tail as the sync decoder expects it (see
+// host_pipeline_smoke.c).
+static void send_vsync(void)
+{
+    for (uint32_t i = 0; i < MVS_SYNC_MIN_FRAME_LINES; i++) {
+        send_sync_pulse(LINE_PULSE);
+    }
+    for (int i = 0; i < 9; i++) {
+        send_sync_pulse(MVS_SYNC_SHORT_MAX - 100U);
+    }
+    send_sync_pulse(LINE_PULSE);
+    for (int i = 0; i < 3; i++) {
+        send_sync_pulse(MVS_SYNC_SHORT_MAX - 100U);
+    }
+    send_sync_pulse(LINE_PULSE);
+    send_sync_pulse(LINE_PULSE);
+}
+
+static uint64_t line_done_at(const slack_driver_t *drv, uint32_t line)
+{
+    return drv->frame_start + ((uint64_t)(line + 1U) * MVS_LINE_PERIOD_US);
+}
+
+// Finish every line whose period has elapsed. The pixel DMA's completion IRQ
+// stamps each at the current virtual time, so time is set to each line's
+// end before it is fed.
+static bool feed_due_lines(slack_driver_t *drv)
+{
+    bool fed = false;
+    const uint64_t now = time_us_64();
+    while (drv->frame > 0U && drv->lines_sent < FRAME_LINES && line_done_at(drv, drv->lines_sent) <= now) {
+        pico_host_set_time_us(line_done_at(drv, drv->lines_sent));
+        for (uint32_t x = 0; x < NEO_H_ACTIVE; x++) {
+            if (!pico_host_pio_push_rx(pio1, PIXEL_SM, 0x3U)) {
+                drv->dropped_words++;
+            }
+        }
+        drv->lines_sent++;
+        fed = true;
+    }
+    pico_host_set_time_us(now);
+    return fed;
+}
+
+static bool slack_wait_hook(pico_host_wait_reason_t reason, uint64_t deadline_us, void *ctx)
+{
+    slack_driver_t *drv = ctx;
+    (void)deadline_us;
+
+    switch (reason) {
+        case PICO_HOST_WAIT_SEM:
+            if (drv->frame == drv->frames) {
+                longjmp(drv->exit, 1);
+            }
+            pico_host_set_time_us(((uint64_t)drv->frame + 1U) * FRAME_PERIOD_US);
+            send_vsync();
+            drv->frame++;
+            drv->frame_start = time_us_64();
+            drv->lines_sent = 0;
+            return true;
+
+        case PICO_HOST_WAIT_EVENT: {
+            // Sleep until the next line ends, at most one step.
+            uint64_t wake = time_us_64() + WFE_STEP_US;
+            if (drv->lines_sent < FRAME_LINES && line_done_at(drv, drv->lines_sent) < wake) {
+                wake = line_done_at(drv, drv->lines_sent);
+            }
+            pico_host_set_time_us(wake);
+            (void)feed_due_lines(drv);
+            return true;
+    }
+
+    case PICO_HOST_WAIT_DMA:
+        return feed_due_lines(drv);
+
+    default:
+        return false;
+    }
+}
+
+static void usb_task_hook(void *ctx)
+{
+    slack_driver_t *drv = ctx;
+    const uint32_t committed = g_line_ring.write_idx - g_line_ring.frame_base_idx;
+    drv->usb_runs++;
+    if (drv->frame > 0U && committed < SOURCE_HEIGHT) {
+        // Core 0 is waiting for its next uncommitted line.
+        drv->usb_line_runs++;
+        const uint64_t deadline = line_done_at(drv, V_SKIP_LINES + committed);
+        if (time_us_64() + USB_TASK_BUDGET_US + MVS_SLACK_GUARD_US > deadline) {
+            drv->usb_unfit++;
+        }
+    }
+    pico_host_advance_us(drv->usb_cost_us);
+}
+
+static void run_capture(slack_driver_t *drv, uint32_t usb_cost_us, uint32_t frames,
+                        video_capture_slack_stats_t *stats)
+{
+    memset(drv, 0, sizeof *drv);
+    drv->usb_cost_us = usb_cost_us;
+    drv->frames = frames;
+
+    pico_host_reset();
+    video_output_set_mode(&video_mode_480_p);
+    video_pipeline_init(640, 480);
+    video_capture_init(SOURCE_HEIGHT);
+
+    pico_host_set_wait_hook(slack_wait_hook, drv);
+    pico_host_set_usb_task_hook(usb_task_hook, drv);
+    if (setjmp(drv->exit) == 0) {
+        video_capture_run();
+    }
+    pico_host_set_wait_hook(NULL, NULL);
+    pico_host_set_usb_task_hook(NULL, NULL);
+
+    video_capture_get_slack_stats(stats);
+    CHECK(drv->dropped_words == 0U, "USB cost %" PRIu32 "us: %" PRIu32 " pixel words overflowed the RX FIFO",
+          usb_cost_us, drv->dropped_words);
+    CHECK(g_line_ring.write_idx - g_line_ring.frame_base_idx == SOURCE_HEIGHT,
+          "USB cost %" PRIu32 "us: the last frame committed %" PRIu32 " lines, want %u", usb_cost_us,
+          g_line_ring.write_idx - g_line_ring.frame_base_idx, SOURCE_HEIGHT);
+}
+
+static void test_tasks_fit_the_slack(void)
+{
+    static slack_driver_t drv;
+    video_capture_slack_stats_t stats;
+    // The first VSYNC only aligns the loop, so four make three frames.
+    run_capture(&drv, 12U, 4U, &stats);
+
+    CHECK(drv.usb_line_runs > 0U, "USB must be serviced between lines, not only between frames");
+    CHECK(drv.usb_unfit == 0U, "%" PRIu32 " of %" PRIu32 " USB runs started without their budget left",
+          drv.usb_unfit, drv.usb_line_runs);
+    CHECK(stats.task_runs == drv.usb_runs, "%" PRIu32 " task runs accounted, %" PRIu32 " made", stats.task_runs,
+          drv.usb_runs);
+    CHECK(stats.task_us == drv.usb_runs * 12U, "task time %" PRIu32 "us, want %" PRIu32 "us", stats.task_us,
+          drv.usb_runs * 12U);
+    CHECK(stats.late_tasks == 0U, "%" PRIu32 " runs within budget were reported late", stats.late_tasks);
+
+    // Conversion takes no virtual time here, so Core 0 waits the whole frame
+    // up to its last active line, one line period at a time.
+    CHECK(stats.frames == 3U, "%" PRIu32 " frames accounted, want 3", stats.frames);
+    CHECK(stats.frame_slack_us == FRAME_LINES * MVS_LINE_PERIOD_US, "frame slack %" PRIu32 "us, want %u",
+          stats.frame_slack_us, FRAME_LINES * MVS_LINE_PERIOD_US);
+    CHECK(stats.min_line_slack_us == MVS_LINE_PERIOD_US, "shortest line slack %" PRIu32 "us, want %u",
+          stats.min_line_slack_us, MVS_LINE_PERIOD_US);
+}
+
+static void test_overrun_is_reported(void)
+{
+    static slack_driver_t drv;
+    video_capture_slack_stats_t stats;
+
+    // Longer than two lines: the DMA runs on into the other buffers
+    // meanwhile, and Core 0 catches up on lines that are already waiting.
+    run_capture(&drv, (2U * MVS_LINE_PERIOD_US) + 16U, 3U, &stats);
+    CHECK(drv.usb_line_runs > 0U, "the overrunning task must still be scheduled between lines");
+    // Runs while Core 0 waits out the V border still fit; the rest overrun.
+    CHECK(stats.late_tasks > 0U && stats.late_tasks <= drv.usb_line_runs,
+          "%" PRIu32 " late runs reported for %" PRIu32 " between lines", stats.late_tasks, drv.usb_line_runs);
+    CHECK(stats.min_line_slack_us == 0U, "a line ready before Core 0 asked must count as no slack (got %" PRIu32
+          "us)", stats.min_line_slack_us);
+}
+
+int main(void)
+{
+    test_tasks_fit_the_slack();
+    test_overrun_is_reported();
+
+    if (g_check_failures != 0U) {
+        fprintf(stderr, "\nFAIL: %u capture slack checks failed.\n", g_check_failures);
+        return EXIT_FAILURE;
+    }
+    printf("PASS: slack tasks run only where their budget fits and every line still reaches the ring.\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,228 @@
+// Checks content-bounds detection. The tracker on its own: all-black frames
+// change nothing, a grown edge is published at once, a shrunk one only after
+// CONTENT_BOUNDS_SHRINK_FRAMES consecutive frames and then as the widest of
+// them, and a frame back at the published bounds restarts the wait. Then end
+// to end: a picture with black borders driven onto the emulated pads
+// (tests/host/pio_emu.c) through the unmodified capture loop must publish
+// exactly its non-black rectangle.
+//
+// Built for the default MVS flag set.
+
+#include <inttypes.h>
+#include <setjmp.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "content_bounds.h"
+#include "line_ring.h"
+#include "pico_host.h"
+#include "pio_emu.h"
+#include "signal_gen.h"
+#include "video_capture.h"
+#include "video_config.h"
+
+static unsigned g_check_failures;
+
+#define CHECK(condition, ...)                                                                                          \
+    do {                                                                                                               \
+        if (!(condition)) {                                                                                            \
+            fprintf(stderr, "CHECK FAILED: ");                                                                         \
+            fprintf(stderr, __VA_ARGS__);                                                                              \
+            fputc('\n', stderr);                                                                                       \
+            g_check_failures++;                                                                                        \
+        }                                                                                                              \
+    } while (0)
+
+#define SYS_CLOCK_HZ 126000000U
+#define EMU_STEP_CYCLES 64U
+
+#define WIDTH CAPTURE_ACTIVE_WIDTH
+#define HEIGHT CAPTURE_ACTIVE_HEIGHT
+
+// The end-to-end picture: 304 columns, as many Neo Geo titles draw, and a
+// letterbox.
+static const content_bounds_t g_picture = {8U, 311U, 16U, 207U};
+
+static bool same_bounds(const content_bounds_t *a, const content_bounds_t *b)
+{
+    return a->left == b->left && a->right == b->right && a->top == b->top && a->bottom == b->bottom;
+}
+
+// Feeds one frame whose non-black pixels fill `box` (none when NULL) the way
+// the capture loop does: only lines with content, scanned with `mask`.
+// Column 0 always holds a pixel with only bits outside the mask set.
+static bool feed_frame(content_bounds_tracker_t *t, const content_bounds_t *box, uint16_t mask)
+{
+    static uint16_t line_pixels[WIDTH];
+    content_bounds_frame_start(t);
+    for (uint16_t y = 0; y < HEIGHT; y++) {
+        if (box == NULL || y < box->top || y > box->bottom) {
+            continue;
+        }
+        memset(line_pixels, 0, sizeof line_pixels);
+        line_pixels[0] = (uint16_t)~mask;
+        for (uint16_t x = box->left; x <= box->right; x++) {
+            // Only the middle line reaches the box's edges, as a picture's
+            // widest line rarely comes first.
+            const bool edge = x == box->left || x == box->right;
+            line_pixels[x] = (uint16_t)((edge && y != (box->top + box->bottom) / 2U) ? 0U : (x & 0x1FU) | 1U);
+        }
+        content_bounds_line(t, y, line_pixels, mask);
+    }
+    return content_bounds_frame_end(t);
+}
+
+static void check_published(const content_bounds_tracker_t *t, const char *step, const content_bounds_t *want,
+                            uint32_t want_changes)
+{
+    content_bounds_t got;
+    const uint32_t changes = content_bounds_read(t, &got);
+    CHECK(same_bounds(&got, want) && changes == want_changes,
+          "%s: bounds %u..%u x %u..%u after %" PRIu32 " changes, want %u..%u x %u..%u after %" PRIu32, step,
+          (unsigned)got.left, (unsigned)got.right, (unsigned)got.top, (unsigned)got.bottom, changes,
+          (unsigned)want->left, (unsigned)want->right, (unsigned)want->top, (unsigned)want->bottom, want_changes);
+}
+
+static void check_tracker(void)
+{
+    static content_bounds_tracker_t t;
+    const content_bounds_t full = {0U, WIDTH - 1U, 0U, HEIGHT - 1U};
+    const content_bounds_t inner = {40U, 279U, 32U, 191U};
+    const content_bounds_t wide_short = {4U, 315U, 64U, 159U};
+    const content_bounds_t narrow_tall = {24U, 295U, 8U, 215U};
+    const content_bounds_t union_box = {4U, 315U, 8U, 215U};
+
+    content_bounds_init(&t, WIDTH, HEIGHT);
+    check_published(&t, "init", &full, 0U);
+
+    for (uint32_t i = 0; i < 2U * CONTENT_BOUNDS_SHRINK_FRAMES; i++) {
+        CHECK(!feed_frame(&t, NULL, 0x7FFFU), "black frame %" PRIu32 " changed the bounds", i);
+    }
+    check_published(&t, "black frames", &full, 0U);
+
+    // Shrink: published on the last frame of the wait, not before.
+    for (uint32_t i = 1; i < CONTENT_BOUNDS_SHRINK_FRAMES; i++) {
+        CHECK(!feed_frame(&t, &g_picture, 0x7FFFU), "shrink published after %" PRIu32 " frames", i);
+    }
+    CHECK(feed_frame(&t, &g_picture, 0x7FFFU), "shrink not published after %u frames", CONTENT_BOUNDS_SHRINK_FRAMES);
+    check_published(&t, "shrink", &g_picture, 1U);
+
+    // A fade: darker frames inside the bounds, interrupted by one at them,
+    // never shrink; black frames in between do not interrupt the wait.
+    for (uint32_t i = 1; i < CONTENT_BOUNDS_SHRINK_FRAMES; i++) {
+        (void)feed_frame(&t, &inner, 0x7FFFU);
+        (void)feed_frame(&t, NULL, 0x7FFFU);
+    }
+    CHECK(!feed_frame(&t, &g_picture, 0x7FFFU), "a frame at the bounds changed them");
+    for (uint32_t i = 1; i < CONTENT_BOUNDS_SHRINK_FRAMES; i++) {
+        (void)feed_frame(&t, &inner, 0x7FFFU);
+    }
+    check_published(&t, "fade", &g_picture, 1U);
+
+    // Growth: published by the frame that shows it.
+    CHECK(feed_frame(&t, &full, 0xFFFFU), "growth not published at once");
+    check_published(&t, "growth", &full, 2U);
+
+    // A shrink over frames of different shapes settles on their union.
+    for (uint32_t i = 0; i < CONTENT_BOUNDS_SHRINK_FRAMES; i++) {
+        (void)feed_frame(&t, (i & 1U) != 0U ? &wide_short : &narrow_tall, 0xFFFFU);
+    }
+    check_published(&t, "union", &union_box, 3U);
+
+    printf("tracker  %u-frame shrink hysteresis, growth at once, union of shapes\n", CONTENT_BOUNDS_SHRINK_FRAMES);
+}
+
+static signal_gen_t g_gen;
+static uint8_t g_rgb[HEIGHT][WIDTH][3];
+
+static void make_test_frame(signal_gen_frame_t *frame)
+{
+    memset(g_rgb, 0, sizeof g_rgb);
+    for (uint32_t y = g_picture.top; y <= g_picture.bottom; y++) {
+        for (uint32_t x = g_picture.left; x <= g_picture.right; x++) {
+            // Every pixel at least one RGB555 step above black.
+            g_rgb[y][x][0] = (uint8_t)(0x08U | (x << 3));
+            g_rgb[y][x][1] = (uint8_t)(y << 2);
+            g_rgb[y][x][2] = (uint8_t)((x ^ y) << 1);
+        }
+    }
+    frame->width = WIDTH;
+    frame->height = HEIGHT;
+    frame->rgb = &g_rgb[0][0][0];
+}
+
+typedef struct {
+    jmp_buf exit;
+    uint64_t cycle_limit;
+    bool timed_out;
+} capture_driver_t;
+
+static bool emu_wait_hook(pico_host_wait_reason_t reason, uint64_t deadline_us, void *ctx)
+{
+    capture_driver_t *drv = ctx;
+    (void)reason;
+    (void)deadline_us;
+    content_bounds_t bounds;
+    if (video_capture_get_content_bounds(&bounds) != 0U) {
+        longjmp(drv->exit, 1);
+    }
+    if (pico_host_sys_cycles() >= drv->cycle_limit) {
+        drv->timed_out = true;
+        longjmp(drv->exit, 1);
+    }
+    pio_emu_run(EMU_STEP_CYCLES);
+    return true;
+}
+
+static void check_capture(void)
+{
+    static signal_gen_frame_t frame;
+    static capture_driver_t drv;
+    make_test_frame(&frame);
+    signal_gen_init(&g_gen, SIGNAL_GEN_MVS, SYS_CLOCK_HZ);
+    g_gen.frames = &frame;
+    g_gen.frame_count = 1;
+
+    pico_host_reset();
+    pico_host_set_sys_clock_hz(SYS_CLOCK_HZ);
+    pico_host_set_pin_source(signal_gen_pin_levels, &g_gen);
+    memset(&g_line_ring, 0, sizeof g_line_ring);
+    line_ring_init();
+    video_capture_init(SOURCE_HEIGHT);
+
+    const uint64_t frame_cycles = (signal_gen_frame_dots(&g_gen.timing) * SYS_CLOCK_HZ) / g_gen.timing.dot_clock_hz;
+    drv.cycle_limit = frame_cycles * (CONTENT_BOUNDS_SHRINK_FRAMES + 4U);
+    pico_host_set_wait_hook(emu_wait_hook, &drv);
+    if (setjmp(drv.exit) == 0) {
+        video_capture_run();
+    }
+    pico_host_set_wait_hook(NULL, NULL);
+    pico_host_set_pin_source(NULL, NULL);
+
+    content_bounds_t got;
+    const uint32_t changes = video_capture_get_content_bounds(&got);
+    CHECK(!drv.timed_out, "capture: no bounds published within %u frames", CONTENT_BOUNDS_SHRINK_FRAMES + 4U);
+    CHECK(changes == 1U && same_bounds(&got, &g_picture),
+          "capture: bounds %u..%u x %u..%u after %" PRIu32 " changes, want %u..%u x %u..%u", (unsigned)got.left,
+          (unsigned)got.right, (unsigned)got.top, (unsigned)got.bottom, changes, (unsigned)g_picture.left,
+          (unsigned)g_picture.right, (unsigned)g_picture.top, (unsigned)g_picture.bottom);
+
+    printf("capture  %u..%u x %u..%u after %" PRIu32 " frames\n", (unsigned)got.left, (unsigned)got.right,
+           (unsigned)got.top, (unsigned)got.bottom, video_capture_get_frame_count());
+}
+
+int main(void)
+{
+    check_tracker();
+    check_capture();
+
+    if (g_check_failures != 0U) {
+        fprintf(stderr, "\nFAIL: %u content bounds checks failed.\n", g_check_failures);
+        return EXIT_FAILURE;
+    }
+    printf("PASS: content bounds follow the picture with shrink hysteresis.\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,207 @@
+// Checks the host interpolator model (tests/host/include/hardware/interp.h)
+// against the SIO lane semantics the capture backend relies on, then the
+// build's NEOPICO_EXP_INTERP_LUT conversion against the software table
+// lookup it replaces, bit for bit: every 19-bit capture word, with noise in
+// the CSYNC/PCLK bits. Built once per interpolator variant against the
+// benchmark's kernel-access firmware (tests/CMakeLists.txt).
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench_kernels.h"
+#include "capture_line.h"
+#include "hardware/interp.h"
+#include "mvs_color.h"
+
+#if NEOPICO_MVS_COLOR_MODEL_MENU
+#include "mvs_color_model.h"
+#elif ENABLE_DARK_SHADOW
+#include "mvs_effect_lut.h"
+#endif
+
+#if !NEOPICO_EXP_INTERP_LUT
+#error "host_interp checks an interpolator LUT build"
+#endif
+
+static unsigned g_check_failures;
+
+#define CHECK(condition, ...)                                                                                          \
+    do {                                                                                                               \
+        if (!(condition)) {                                                                                            \
+            fprintf(stderr, "CHECK FAILED: ");                                                                         \
+            fprintf(stderr, __VA_ARGS__);                                                                              \
+            fputc('\n', stderr);                                                                                       \
+            g_check_failures++;                                                                                        \
+        }                                                                                                              \
+    } while (0)
+
+#define CHECK_EQ(got, want, what)                                                                                      \
+    CHECK((uint32_t)(got) == (uint32_t)(want), "%s: got 0x%08" PRIx32 ", want 0x%08" PRIx32, what, (uint32_t)(got),  \
+          (uint32_t)(want))
+
+// Mirror of NEO_H_ACTIVE in video_capture_mvs.c.
+#define LINE_PIXELS 320U
+// RGB555, SHADOW and DARK: every capture word the conversion can see.
+#define RAW_VALUES (1U << 17)
+
+// =============================================================================
+// Lane model
+// =============================================================================
+
+// interp0 and interp1 are Core 0's; the conversion check below configures
+// them afresh, so these checks leave them however they end.
+static void test_lane_model(void)
+{
+    interp_config cfg = interp_default_config();
+    interp_set_config(interp0, 0, &cfg);
+    interp_set_config(interp0, 1, &cfg);
+    interp_set_base(interp0, 0, 0x100U);
+    interp_set_base(interp0, 1, 0U);
+    interp_set_base(interp0, 2, 0x10000U);
+    interp_set_accumulator(interp0, 0, 0xDEADBEEFU);
+    interp_set_accumulator(interp0, 1, 0x12345678U);
+    CHECK_EQ(interp_peek_lane_result(interp0, 0), 0xDEADBFEFU, "default config: accumulator plus base");
+
+    // Shift right, then keep MASK_LSB..MASK_MSB.
+    interp_config_set_shift(&cfg, 4);
+    interp_config_set_mask(&cfg, 4, 11);
+    interp_set_config(interp0, 0, &cfg);
+    CHECK_EQ(interp_get_raw(interp0, 0), 0xBE0U, "shift 4, mask 11:4");
+    CHECK_EQ(interp_peek_lane_result(interp0, 0), 0xCE0U, "shift 4, mask 11:4, plus base");
+
+    // The full result adds both lanes' masked values to BASE2, never the
+    // lane bases.
+    interp_config lane1 = interp_default_config();
+    interp_config_set_mask(&lane1, 0, 7);
+    interp_set_config(interp0, 1, &lane1);
+    CHECK_EQ(interp_peek_full_result(interp0), 0x10000U + 0xBE0U + 0x78U, "full result");
+
+    // CROSS_INPUT reads the other lane's accumulator.
+    interp_config_set_cross_input(&lane1, true);
+    interp_set_config(interp0, 1, &lane1);
+    CHECK_EQ(interp_get_raw(interp0, 1), 0xEFU, "cross input");
+
+    // SIGNED extends from MASK_MSB, in the lane and the full result.
+    interp_config_set_signed(&lane1, true);
+    interp_set_config(interp0, 1, &lane1);
+    CHECK_EQ(interp_peek_lane_result(interp0, 1), 0xFFFFFFEFU, "signed, negative");
+    CHECK_EQ(interp_peek_full_result(interp0), 0x10000U + 0xBE0U - 0x11U, "signed full result");
+    interp_set_accumulator(interp0, 0, 0x7FU);
+    CHECK_EQ(interp_peek_lane_result(interp0, 1), 0x7FU, "signed, positive");
+
+    // An empty mask (MSB below LSB) passes nothing.
+    interp_config empty = interp_default_config();
+    interp_config_set_mask(&empty, 8, 3);
+    interp_set_config(interp0, 1, &empty);
+    CHECK_EQ(interp_get_raw(interp0, 1), 0U, "empty mask");
+
+    // ADD_RAW adds the unshifted input to the base but leaves the full
+    // result on the masked value.
+    interp_set_accumulator(interp0, 0, 0xDEADBEEFU);
+    interp_config raw = cfg;
+    interp_config_set_add_raw(&raw, true);
+    interp_set_config(interp0, 0, &raw);
+    interp_set_config(interp0, 1, &empty);
+    CHECK_EQ(interp_peek_lane_result(interp0, 0), 0xDEADBFEFU, "add raw");
+    CHECK_EQ(interp_peek_full_result(interp0), 0x10000U + 0xBE0U, "add raw, full result");
+
+    // FORCE_MSB shows on the bus only; POP writes back the unforced result.
+    interp_config forced = interp_default_config();
+    interp_config_set_force_bits(&forced, 2);
+    interp_set_config(interp0, 0, &forced);
+    interp_set_accumulator(interp0, 0, 0x10U);
+    interp_set_base(interp0, 0, 1U);
+    CHECK_EQ(interp_pop_lane_result(interp0, 0), 0x20000011U, "force bits");
+    CHECK_EQ(interp_get_accumulator(interp0, 0), 0x11U, "force bits are not written back");
+
+    // POP steps every lane; CROSS_RESULT swaps which result a lane keeps.
+    interp_config step = interp_default_config();
+    interp_set_config(interp0, 0, &step);
+    interp_set_config(interp0, 1, &step);
+    interp_set_accumulator(interp0, 0, 0U);
+    interp_set_accumulator(interp0, 1, 100U);
+    interp_set_base(interp0, 0, 1U);
+    interp_set_base(interp0, 1, 10U);
+    CHECK_EQ(interp_pop_full_result(interp0), 0x10000U + 100U, "pop full result");
+    CHECK_EQ(interp_get_accumulator(interp0, 0), 1U, "pop steps lane 0");
+    CHECK_EQ(interp_get_accumulator(interp0, 1), 110U, "pop steps lane 1");
+    interp_config_set_cross_result(&step, true);
+    interp_set_config(interp0, 0, &step);
+    (void)interp_pop_lane_result(interp0, 1);
+    CHECK_EQ(interp_get_accumulator(interp0, 0), 120U, "cross result takes lane 1's result");
+    CHECK_EQ(interp_get_accumulator(interp0, 1), 120U, "lane 1 keeps its own");
+}
+
+// =============================================================================
+// Conversion
+// =============================================================================
+
+#if NEOPICO_MVS_COLOR_MODEL_MENU
+// generate_color_correct_lut()'s Digital entry, from the raw word.
+static uint16_t reference_pixel(uint32_t raw)
+{
+    uint32_t r5;
+    uint32_t g5;
+    uint32_t b5;
+    mvs_correct_color_idx((raw >> 2) & MVS_CAPTURE_COLOR_MASK, &r5, &g5, &b5);
+    return mvs_is_clamped_black(r5, g5, b5) ? 0U : mvs_color_model_pack_rgb565(MVS_COLOR_MODEL_DIGITAL, r5, g5, b5);
+}
+#elif ENABLE_DARK_SHADOW
+static uint16_t reference_pixel(uint32_t raw)
+{
+    static mvs_effect_lut_t lut;
+    static bool generated;
+    if (!generated) {
+        mvs_effect_lut_generate(&lut);
+        generated = true;
+    }
+    return mvs_effect_lut_lookup_raw(&lut, raw);
+}
+#endif
+
+static void test_conversion(void)
+{
+    static uint32_t raw[LINE_PIXELS];
+    static uint16_t got[LINE_PIXELS];
+
+    bench_capture_prepare();
+
+    uint32_t mismatches = 0;
+    for (uint32_t first = 0; first < RAW_VALUES; first += LINE_PIXELS) {
+        for (uint32_t x = 0; x < LINE_PIXELS; x++) {
+            const uint32_t value = (first + x) % RAW_VALUES;
+            raw[x] = (value << 2) | ((value * 0x9E3779B1U) >> 30);
+        }
+        bench_convert_active_pixels(got, raw, (int)LINE_PIXELS);
+        for (uint32_t x = 0; x < LINE_PIXELS; x++) {
+            const uint16_t want = reference_pixel(raw[x]);
+            if (got[x] != want && mismatches++ < 4U) {
+                fprintf(stderr, "  raw 0x%05" PRIx32 ": interp 0x%04x, table 0x%04x\n", raw[x], got[x], want);
+            }
+        }
+    }
+    CHECK(mismatches == 0U, "%" PRIu32 " pixels differ from the software lookup", mismatches);
+
+    // An odd count ends on a single-lane pixel.
+    got[7] = 0xFFFFU;
+    bench_convert_active_pixels(got, raw, 7);
+    CHECK(got[6] == reference_pixel(raw[6]) && got[7] == 0xFFFFU, "odd line length");
+    CHECK(bench_capture_line_hash() == capture_hash_line(got, 7), "odd line length hash");
+}
+
+int main(void)
+{
+    test_lane_model();
+    test_conversion();
+
+    if (g_check_failures != 0U) {
+        fprintf(stderr, "\nFAIL: %u interpolator checks failed.\n", g_check_failures);
+        return EXIT_FAILURE;
+    }
+    printf("PASS: interpolator lane model, and %u capture words convert through it as through the table.\n",
+           RAW_VALUES);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,216 @@
+// Checks the per-line CSYNC/PCLK integrity flags end to end: a frame driven
+// onto the emulated pads (tests/host/pio_emu.c) through the unmodified capture
+// loop, clean and then with faults the picture itself cannot show. A PCLK
+// runt, high for fewer cycles than the pixel SM's sample delay, must flag its
+// line as sampled with PCLK low; a CSYNC glitch inside the active window must
+// flag its line as CSYNC low. Every other line must stay clean, each flagged
+// line position must count once per frame, and the ring must still hold the
+// picture unchanged.
+//
+// Built for the default MVS flag set (19-bit capture words).
+
+#include <inttypes.h>
+#include <setjmp.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "line_ring.h"
+#include "mvs_effect_lut.h"
+#include "mvs_pins.h"
+#include "pico_host.h"
+#include "pio_emu.h"
+#include "signal_gen.h"
+#include "test_frame.h"
+#include "video_capture.h"
+#include "video_config.h"
+
+static unsigned g_check_failures;
+
+#define CHECK(condition, ...)                                                                                          \
+    do {                                                                                                               \
+        if (!(condition)) {                                                                                            \
+            fprintf(stderr, "CHECK FAILED: ");                                                                         \
+            fprintf(stderr, __VA_ARGS__);                                                                              \
+            fputc('\n', stderr);                                                                                       \
+            g_check_failures++;                                                                                        \
+        }                                                                                                              \
+    } while (0)
+
+#define SYS_CLOCK_HZ 126000000U
+#define EMU_STEP_CYCLES 64U
+#define CHECKED_FRAMES 4U
+
+// System clocks a PCLK runt stays high: the SM's `wait 1 pin` still sees it,
+// the `in` SIGNAL_GEN_SAMPLE_CYCLES after the edge does not.
+#define RUNT_HIGH_CYCLES 2U
+// Dots a CSYNC glitch holds the line low.
+#define GLITCH_DOTS 2U
+
+typedef struct {
+    uint32_t line; // active line
+    uint32_t x;    // active pixel
+    uint8_t flag;  // VIDEO_CAPTURE_LINE_*
+} line_fault_t;
+
+// Top, middle and bottom of the picture, where the bottom-screen pixel jitter
+// was reported.
+static const line_fault_t g_faults[] = {
+    {5U, 10U, VIDEO_CAPTURE_LINE_PCLK_LOW},
+    {100U, 150U, VIDEO_CAPTURE_LINE_CSYNC_LOW},
+    {200U, 300U, VIDEO_CAPTURE_LINE_PCLK_LOW},
+    {201U, 0U, VIDEO_CAPTURE_LINE_CSYNC_LOW},
+};
+#define FAULT_COUNT (sizeof g_faults / sizeof g_faults[0])
+
+static signal_gen_t g_gen;
+static bool g_inject;
+static uint8_t g_rgb[CAPTURE_ACTIVE_HEIGHT][CAPTURE_ACTIVE_WIDTH][3];
+
+// signal_gen's pads with the faults applied in every frame.
+static uint64_t faulty_pin_levels(uint64_t cycle, void *ctx)
+{
+    const signal_gen_t *gen = ctx;
+    uint64_t pins = signal_gen_pin_levels(cycle, ctx);
+    if (!g_inject) {
+        return pins;
+    }
+
+    const signal_gen_timing_t *t = &gen->timing;
+    const uint64_t frame_dots = signal_gen_frame_dots(t);
+    const uint64_t guess = (cycle * t->dot_clock_hz) / gen->sys_hz;
+    const uint64_t frame_start = guess - (guess % frame_dots);
+    for (size_t i = 0; i < FAULT_COUNT; i++) {
+        const line_fault_t *f = &g_faults[i];
+        const uint64_t dot = frame_start + ((uint64_t)(t->active_y + f->line) * t->h_total) + t->active_x + f->x;
+        const int64_t edge = signal_gen_edge_cycle(gen, dot);
+        const int64_t c = (int64_t)cycle;
+        if (f->flag == VIDEO_CAPTURE_LINE_PCLK_LOW) {
+            if (c >= edge + (int64_t)RUNT_HIGH_CYCLES && c < signal_gen_edge_cycle(gen, dot + 1U)) {
+                pins &= ~(1ULL << PIN_MVS_PCLK);
+            }
+        } else if (c >= edge && c < signal_gen_edge_cycle(gen, dot + GLITCH_DOTS)) {
+            pins &= ~(1ULL << PIN_MVS_CSYNC);
+        }
+    }
+    return pins;
+}
+
+typedef struct {
+    jmp_buf exit;
+    uint64_t cycle_limit;
+    bool timed_out;
+} capture_driver_t;
+
+static bool emu_wait_hook(pico_host_wait_reason_t reason, uint64_t deadline_us, void *ctx)
+{
+    capture_driver_t *drv = ctx;
+    (void)reason;
+    (void)deadline_us;
+    video_capture_line_stats_t stats;
+    video_capture_get_line_stats(&stats);
+    if (stats.frames >= CHECKED_FRAMES) {
+        longjmp(drv->exit, 1);
+    }
+    if (pico_host_sys_cycles() >= drv->cycle_limit) {
+        drv->timed_out = true;
+        longjmp(drv->exit, 1);
+    }
+    pio_emu_run(EMU_STEP_CYCLES);
+    return true;
+}
+
+static uint32_t ring_mismatches(void)
+{
+    const signal_gen_timing_t *t = &g_gen.timing;
+    uint32_t mismatches = 0;
+    for (uint32_t y = 0; y < SOURCE_HEIGHT; y++) {
+        const uint16_t *ring_line = g_line_ring.lines[LINE_RING_SLOT(g_line_ring.frame_base_idx + y)];
+        for (uint32_t x = 0; x < t->active_width; x++) {
+            const uint32_t raw = signal_gen_word(&g_gen, ((uint64_t)(t->active_y + y) * t->h_total) + t->active_x + x);
+            mismatches += ring_line[x] != mvs_entropy_pack_raw(raw) ? 1U : 0U;
+        }
+    }
+    return mismatches;
+}
+
+static void capture_frames(const char *name, bool inject)
+{
+    static capture_driver_t drv;
+    memset(&drv, 0, sizeof drv);
+    g_inject = inject;
+
+    pico_host_reset();
+    pico_host_set_sys_clock_hz(SYS_CLOCK_HZ);
+    pico_host_set_pin_source(faulty_pin_levels, &g_gen);
+    memset(&g_line_ring, 0, sizeof g_line_ring);
+    line_ring_init();
+    video_capture_init(SOURCE_HEIGHT);
+
+    const uint64_t frame_cycles = (signal_gen_frame_dots(&g_gen.timing) * SYS_CLOCK_HZ) / g_gen.timing.dot_clock_hz;
+    drv.cycle_limit = frame_cycles * (CHECKED_FRAMES + 3U);
+    pico_host_set_wait_hook(emu_wait_hook, &drv);
+    if (setjmp(drv.exit) == 0) {
+        video_capture_run();
+    }
+    pico_host_set_wait_hook(NULL, NULL);
+    pico_host_set_pin_source(NULL, NULL);
+
+    video_capture_line_stats_t stats;
+    video_capture_get_line_stats(&stats);
+    CHECK(!drv.timed_out, "%s: %" PRIu32 " of %u frames captured", name, stats.frames, CHECKED_FRAMES);
+    CHECK(stats.frame_lines == SOURCE_HEIGHT, "%s: %" PRIu32 " lines checked per frame", name, stats.frame_lines);
+
+    uint32_t want_pclk = 0;
+    uint32_t want_csync = 0;
+    uint32_t wrong_lines = 0;
+    for (uint16_t line = 0; line < SOURCE_HEIGHT; line++) {
+        uint8_t want_flags = 0;
+        for (size_t i = 0; inject && i < FAULT_COUNT; i++) {
+            want_flags |= g_faults[i].line == line ? g_faults[i].flag : 0U;
+        }
+        want_pclk += (want_flags & VIDEO_CAPTURE_LINE_PCLK_LOW) != 0U ? 1U : 0U;
+        want_csync += (want_flags & VIDEO_CAPTURE_LINE_CSYNC_LOW) != 0U ? 1U : 0U;
+
+        uint32_t errors;
+        const uint8_t flags = video_capture_get_line_flags(line, &errors);
+        const uint32_t want_errors = want_flags != 0U ? stats.frames : 0U;
+        if (flags != want_flags || errors != want_errors) {
+            if (wrong_lines++ < 4U) {
+                fprintf(stderr, "  %s: line %u flags 0x%02x in %" PRIu32 " frames, want 0x%02x in %" PRIu32 "\n", name,
+                        (unsigned)line, flags, errors, want_flags, want_errors);
+            }
+        }
+    }
+    CHECK(wrong_lines == 0U, "%s: %" PRIu32 " line positions flagged wrongly", name, wrong_lines);
+    CHECK(stats.pclk_lines == want_pclk * stats.frames && stats.csync_lines == want_csync * stats.frames,
+          "%s: %" PRIu32 " PCLK and %" PRIu32 " CSYNC lines over %" PRIu32 " frames", name, stats.pclk_lines,
+          stats.csync_lines, stats.frames);
+    CHECK(stats.frame_flagged == (inject ? FAULT_COUNT : 0U), "%s: %" PRIu32 " lines flagged in the last frame", name,
+          stats.frame_flagged);
+    CHECK(ring_mismatches() == 0U, "%s: the ring does not hold the source picture", name);
+
+    printf("%-8s %" PRIu32 " frames: %" PRIu32 " PCLK lines, %" PRIu32 " CSYNC lines, %" PRIu32 " in the last\n", name,
+           stats.frames, stats.pclk_lines, stats.csync_lines, stats.frame_flagged);
+}
+
+int main(void)
+{
+    static signal_gen_frame_t frame;
+    make_test_frame(&frame, g_rgb);
+    signal_gen_init(&g_gen, SIGNAL_GEN_MVS, SYS_CLOCK_HZ);
+    g_gen.frames = &frame;
+    g_gen.frame_count = 1;
+
+    capture_frames("clean", false);
+    capture_frames("faulted", true);
+
+    if (g_check_failures != 0U) {
+        fprintf(stderr, "\nFAIL: %u line integrity checks failed.\n", g_check_failures);
+        return EXIT_FAILURE;
+    }
+    printf("PASS: PCLK runts and CSYNC glitches flag exactly their lines, once per frame.\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,614 @@
+// Runs the shipped PIO programs in the host PIO emulator (tests/host/pio_emu.c)
+// against synthetic pin waveforms, using the firmware's own SM configuration.
+//
+// MVS build: mvs_sync_4a pulse counts against the sync decoder's windows, IRQ 4 gating and
+// mvs_pixel_capture_dark19 (mvs_pixel_capture_packed16 in the packed build)
+// sample phase, timing window and horizontal active window against a 6 MHz
+// PCLK at 126 MHz and with a 2x clock divider, plus both I2S programs.
+// SNES build: snes_hard_sync's HBLANK-relative capture window.
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/pio.h"
+
+#include "capture_profile.h"
+#include "pico_host.h"
+#include "pio_emu.h"
+#include "video_capture.h"
+#include "video_config.h"
+
+#if NEOPICO_CAPTURE_TARGET == NEOPICO_CAPTURE_TARGET_SNES
+#include "snes_pins.h"
+#else
+#include "i2s_capture.pio.h"
+#include "mvs_pins.h"
+#include "mvs_sync_decoder.h"
+#endif
+
+static unsigned g_check_failures;
+
+#define CHECK(condition, ...)                                                                                          \
+    do {                                                                                                               \
+        if (!(condition)) {                                                                                            \
+            fprintf(stderr, "CHECK FAILED: ");                                                                         \
+            fprintf(stderr, __VA_ARGS__);                                                                              \
+            fputc('\n', stderr);                                                                                       \
+            g_check_failures++;                                                                                        \
+        }                                                                                                              \
+    } while (0)
+
+#define SYS_CLOCK_HZ 126000000U
+
+// =============================================================================
+// Clock-domain helpers
+// =============================================================================
+// A source clock of `clk_hz` has its k-th rising edge on the first system
+// cycle at or after k * sys_hz / clk_hz, and is high for the first half of
+// each period. Signals clocked out by the source change `lead` system cycles
+// before the edge that samples them.
+
+typedef struct {
+    uint32_t sys_hz;
+    uint32_t clk_hz;
+    uint32_t lead;
+} source_clock_t;
+
+static bool clock_level(const source_clock_t *clk, uint64_t cycle)
+{
+    return ((cycle * clk->clk_hz) % clk->sys_hz) < (clk->sys_hz / 2U);
+}
+
+// Index of the source period whose data is on the pins at `cycle`.
+static uint64_t clock_data_index(const source_clock_t *clk, uint64_t cycle)
+{
+    return ((cycle + clk->lead) * clk->clk_hz) / clk->sys_hz;
+}
+
+// Index of the last rising edge at or before `cycle`, and that edge's cycle.
+static uint64_t clock_last_edge(const source_clock_t *clk, uint64_t cycle, uint64_t *edge_cycle)
+{
+    const uint64_t k = (cycle * clk->clk_hz) / clk->sys_hz;
+    *edge_cycle = ((k * clk->sys_hz) + clk->clk_hz - 1U) / clk->clk_hz;
+    return k;
+}
+
+static uint32_t test_pattern(uint32_t line, uint32_t dot, uint32_t bits)
+{
+    uint32_t h = (line * 0x9E3779B1U) ^ (dot * 0x85EBCA77U);
+    h ^= h >> 15;
+    h *= 0x2C1B3C6DU;
+    h ^= h >> 12;
+    return h & ((1U << bits) - 1U);
+}
+
+// Captures the source cycle of every `in pins` (or `mov osr, pins`, the packed
+// MVS program's sample) an SM executes.
+typedef struct {
+    uint32_t pio;
+    uint32_t sm;
+    const source_clock_t *clk;
+    uint64_t samples;
+    uint64_t min_phase;
+    uint64_t max_phase;
+} sample_phase_t;
+
+static void sample_phase_trace(const pio_emu_event_t *event, void *ctx)
+{
+    sample_phase_t *phase = ctx;
+    const bool samples_pins = (event->instr & 0xE0E0U) == 0x4000U || (event->instr & 0xE0FFU) == 0xA0E0U;
+    if (event->pio != phase->pio || event->sm != phase->sm || !samples_pins) {
+        return;
+    }
+    // The value `in pins` shifts in left the pad this many cycles earlier.
+    const uint64_t pad_cycle = event->cycle - PIO_EMU_INPUT_SYNC_CYCLES;
+    uint64_t edge;
+    (void)clock_last_edge(phase->clk, pad_cycle, &edge);
+    const uint64_t offset = pad_cycle - edge;
+    if (phase->samples == 0U || offset < phase->min_phase) {
+        phase->min_phase = offset;
+    }
+    if (phase->samples == 0U || offset > phase->max_phase) {
+        phase->max_phase = offset;
+    }
+    phase->samples++;
+}
+
+#if NEOPICO_CAPTURE_TARGET == NEOPICO_CAPTURE_TARGET_MVS
+
+// =============================================================================
+// MVS
+// =============================================================================
+
+// Mirrors of the private capture constants in video_capture_mvs.c.
+#define NEO_H_TOTAL 384U
+#define NEO_H_ACTIVE 320U
+#define H_SKIP_START 28U
+#define MVS_PCLK_HZ 6000000U
+#define MVS_HSYNC_HIGH 355U // PCLKs of CSYNC high on a normal line
+
+#define MVS_PIXEL_SM 1U
+#define MVS_SYNC_SM 0U
+#define MVS_DMA_CHANNEL 0U
+
+typedef struct {
+    source_clock_t clk;
+    const uint32_t *csync_high; // per-line CSYNC high width in PCLKs
+    uint32_t lines;
+} mvs_wave_t;
+
+static uint32_t mvs_line_high(const mvs_wave_t *wave, uint32_t line)
+{
+    return wave->csync_high ? wave->csync_high[line % wave->lines] : MVS_HSYNC_HIGH;
+}
+
+// Raw 19-bit word the pads carry for one PCLK period (CSYNC/PCLK in 1:0).
+static uint32_t mvs_raw_word(const mvs_wave_t *wave, uint32_t line, uint32_t dot, bool pclk)
+{
+    const uint32_t csync = dot < mvs_line_high(wave, line) ? 1U : 0U;
+    return csync | (pclk ? 2U : 0U) | (test_pattern(line, dot, 17U) << 2);
+}
+
+static uint64_t mvs_levels(uint64_t cycle, void *ctx)
+{
+    const mvs_wave_t *wave = ctx;
+    const uint64_t k = clock_data_index(&wave->clk, cycle);
+    const uint32_t line = (uint32_t)(k / NEO_H_TOTAL);
+    const uint32_t dot = (uint32_t)(k % NEO_H_TOTAL);
+    return (uint64_t)mvs_raw_word(wave, line, dot, clock_level(&wave->clk, cycle)) << PIN_MVS_BASE;
+}
+
+// Capture word `word` of a line whose active window starts at dot `skip`, as
+// the pixel SM pushes it: the raw 19-bit sample, or with
+// NEOPICO_EXP_MVS_PACKED_CAPTURE two [DARK][RGB555] halfwords, the earlier
+// pixel low.
+#if NEOPICO_EXP_MVS_PACKED_CAPTURE
+#define MVS_LINE_WORDS (NEO_H_ACTIVE / 2U)
+
+static uint32_t mvs_packed_half(uint32_t raw)
+{
+    return ((raw >> 2) & 0x7FFFU) | (((raw >> 18) & 1U) << 15);
+}
+
+static uint32_t mvs_capture_word(const mvs_wave_t *wave, uint32_t line, uint32_t skip, uint32_t word)
+{
+    return mvs_packed_half(mvs_raw_word(wave, line, skip + (2U * word), true)) |
+           (mvs_packed_half(mvs_raw_word(wave, line, skip + (2U * word) + 1U, true)) << 16);
+}
+#else
+#define MVS_LINE_WORDS NEO_H_ACTIVE
+
+static uint32_t mvs_capture_word(const mvs_wave_t *wave, uint32_t line, uint32_t skip, uint32_t word)
+{
+    return mvs_raw_word(wave, line, skip + word, true);
+}
+#endif
+
+// Bring up the real capture configuration, with the sync IRQ masked so the
+// test reads the sync FIFO itself.
+static void mvs_start(mvs_wave_t *wave, uint32_t sys_hz)
+{
+    pico_host_reset();
+    pico_host_set_sys_clock_hz(sys_hz);
+    wave->clk.sys_hz = sys_hz;
+    pico_host_set_pin_source(mvs_levels, wave);
+    video_capture_init(SOURCE_HEIGHT);
+    irq_set_enabled(PIO1_IRQ_0, false);
+}
+
+// Run to `dot` of `line` (pad time).
+static void mvs_run_to(const mvs_wave_t *wave, uint32_t line, uint32_t dot)
+{
+    const uint64_t target = ((((uint64_t)line * NEO_H_TOTAL) + dot) * wave->clk.sys_hz) / wave->clk.clk_hz;
+    const uint64_t now = pico_host_sys_cycles();
+    if (target > now) {
+        pio_emu_run(target - now);
+    }
+}
+
+static void test_mvs_sync_pulse_counts(void)
+{
+    // Normal lines, equalization and serration pulses, and the window edges.
+    static const uint32_t widths[] = {
+        MVS_HSYNC_HIGH, MVS_HSYNC_HIGH, 178U, 14U, 178U, 286U, 287U, 288U, 289U, 383U, 1U, MVS_HSYNC_HIGH,
+    };
+    const uint32_t line_count = sizeof widths / sizeof widths[0];
+    static mvs_wave_t wave;
+    memset(&wave, 0, sizeof wave);
+    wave.clk.clk_hz = MVS_PCLK_HZ;
+    wave.clk.lead = (SYS_CLOCK_HZ / MVS_PCLK_HZ) / 2U;
+    wave.csync_high = widths;
+    wave.lines = line_count;
+    mvs_start(&wave, SYS_CLOCK_HZ);
+
+    const uint32_t sync_depth = 8U;
+    uint32_t counts[16];
+    uint32_t received = 0;
+    for (uint32_t line = 1; line <= line_count + 1U; line++) {
+        mvs_run_to(&wave, line, 0);
+        while (!pio_sm_is_rx_fifo_empty(pio1, MVS_SYNC_SM) && received < 16U) {
+            counts[received++] = pio_sm_get(pio1, MVS_SYNC_SM);
+        }
+        CHECK(pio_sm_get_rx_fifo_level(pio1, MVS_SYNC_SM) < sync_depth, "sync FIFO backed up");
+    }
+
+    // The SM starts mid-pulse on line 0; every later pulse is counted whole.
+    // Counting includes the PCLK edge on which CSYNC is seen low, so a pulse
+    // of w PCLKs reports w + 1.
+    CHECK(received == line_count + 1U, "sync SM pushed %" PRIu32 " counts, want %" PRIu32, received,
+          line_count + 1U);
+    for (uint32_t i = 1; i < received && i <= line_count; i++) {
+        const uint32_t width = widths[i % line_count];
+        CHECK(counts[i] == width + 1U, "CSYNC high for %" PRIu32 " PCLKs reported %" PRIu32, width, counts[i]);
+        mvs_sync_pulse_t want = MVS_SYNC_PULSE_GLITCH;
+        if (width + 1U >= MVS_SYNC_SHORT_MIN && width < MVS_SYNC_SHORT_MAX) {
+            want = MVS_SYNC_PULSE_SHORT;
+        } else if (width + 1U >= MVS_SYNC_LINE_MIN && width < MVS_SYNC_LINE_MAX) {
+            want = MVS_SYNC_PULSE_LINE;
+        }
+        CHECK(mvs_sync_classify(counts[i]) == want, "%" PRIu32 "-PCLK pulse misclassified by the sync decoder",
+              width);
+    }
+    printf("MVS sync: normal line %u PCLKs high reports %u, %u inside the line window; "
+           "equalization pulses report %u, %u below the half-line limit.\n",
+           MVS_HSYNC_HIGH, MVS_HSYNC_HIGH + 1U, MVS_HSYNC_HIGH + 1U - MVS_SYNC_LINE_MIN, 179U,
+           MVS_SYNC_SHORT_MAX - 179U);
+}
+
+typedef struct {
+    uint32_t lines_checked;
+    uint32_t mismatched_words;
+    uint32_t first_bad_line;
+    uint32_t first_bad_word;
+} mvs_capture_result_t;
+
+// Trigger the pixel SM part-way through line 2, exactly as the capture loop
+// does, then DMA `lines` lines and compare them to the pad contents of the
+// active window the capture was asked for (video_capture_set_h_offset()).
+static mvs_capture_result_t mvs_capture_lines(mvs_wave_t *wave, uint32_t sys_hz, uint32_t lines,
+                                             sample_phase_t *phase)
+{
+    const uint32_t skip = (uint32_t)((int32_t)H_SKIP_START + video_capture_get_h_offset());
+    static uint32_t buffer[4U * MVS_LINE_WORDS];
+    mvs_capture_result_t result = {0U, 0U, UINT32_MAX, UINT32_MAX};
+    memset(buffer, 0, sizeof buffer);
+
+    mvs_start(wave, sys_hz);
+    mvs_run_to(wave, 2, 100);
+    CHECK(pio_emu_sm(pio1, MVS_PIXEL_SM)->rx_pushes == 0U, "pixel SM pushed data before IRQ 4");
+
+    dma_channel_set_trans_count(MVS_DMA_CHANNEL, lines * MVS_LINE_WORDS, false);
+    dma_channel_set_write_addr(MVS_DMA_CHANNEL, buffer, true);
+    pio_interrupt_clear(pio1, 4);
+    pio_sm_exec(pio1, MVS_SYNC_SM, pio_encode_irq_set(false, 4));
+
+    if (phase) {
+        pio_emu_set_trace(sample_phase_trace, phase);
+    }
+    mvs_run_to(wave, 3U + lines, 10);
+    pio_emu_set_trace(NULL, NULL);
+
+    // Capture begins on the first line start after the trigger (line 3).
+    for (uint32_t l = 0; l < lines; l++) {
+        for (uint32_t word = 0; word < MVS_LINE_WORDS; word++) {
+            const uint32_t want = mvs_capture_word(wave, 3U + l, skip, word);
+            if (buffer[(l * MVS_LINE_WORDS) + word] != want) {
+                if (result.mismatched_words == 0U) {
+                    result.first_bad_line = l;
+                    result.first_bad_word = word;
+                }
+                result.mismatched_words++;
+            }
+        }
+        result.lines_checked++;
+    }
+    return result;
+}
+
+static void test_mvs_pixel_sample_phase(void)
+{
+    static mvs_wave_t wave;
+    memset(&wave, 0, sizeof wave);
+    wave.clk.clk_hz = MVS_PCLK_HZ;
+    const uint32_t period = SYS_CLOCK_HZ / MVS_PCLK_HZ;
+    wave.clk.lead = period / 2U; // MVS drives data and CSYNC on the PCLK falling edge
+    wave.clk.sys_hz = SYS_CLOCK_HZ;
+
+    sample_phase_t phase = {1U, MVS_PIXEL_SM, &wave.clk, 0U, 0U, 0U};
+    const mvs_capture_result_t nominal = mvs_capture_lines(&wave, SYS_CLOCK_HZ, 3U, &phase);
+    CHECK(nominal.mismatched_words == 0U,
+          "nominal-phase capture: %" PRIu32 " words differ (first at line %" PRIu32 " word %" PRIu32 ")",
+          nominal.mismatched_words, nominal.first_bad_line, nominal.first_bad_word);
+    CHECK(phase.samples >= 3U * NEO_H_ACTIVE, "only %" PRIu64 " pixel samples traced", phase.samples);
+
+    // wait 1 pin (sees the edge 2 cycles late) + nop + nop, then `in` latches
+    // the synchronizer output: the pads are sampled 3 cycles after the edge.
+    CHECK(phase.min_phase == 3U && phase.max_phase == 3U,
+          "pixel sample point must sit 3 cycles after PCLK rise (saw %" PRIu64 "..%" PRIu64 ")", phase.min_phase,
+          phase.max_phase);
+
+    // Sweep where the MVS changes its outputs relative to the PCLK rising
+    // edge and record the lead times the program still captures correctly.
+    int32_t window_lo = -1;
+    int32_t window_hi = -1;
+    for (uint32_t lead = 0; lead < period; lead++) {
+        wave.clk.lead = lead;
+        const mvs_capture_result_t r = mvs_capture_lines(&wave, SYS_CLOCK_HZ, 2U, NULL);
+        if (r.mismatched_words != 0U) {
+            continue;
+        }
+        CHECK(window_hi < 0 || window_hi + 1 == (int32_t)lead, "capture window must be contiguous (lead %" PRIu32 ")",
+              lead);
+        if (window_lo < 0) {
+            window_lo = (int32_t)lead;
+        }
+        window_hi = (int32_t)lead;
+    }
+    const int32_t nominal_lead = (int32_t)(period / 2U);
+    CHECK(window_lo >= 0 && window_lo + 3 <= nominal_lead && nominal_lead + 3 <= window_hi,
+          "falling-edge launch must have >= 3 cycles of margin inside the capture window [%d, %d]", (int)window_lo,
+          (int)window_hi);
+    const double ns_per_cycle = 1e9 / (double)SYS_CLOCK_HZ;
+    printf("MVS pixel: pads sampled %.1f ns after PCLK rise; outputs may change %d..%d cycles "
+           "(%.1f..%.1f ns) before the edge; falling-edge launch is %d cycles from the late limit and %d "
+           "from the early limit.\n",
+           3.0 * ns_per_cycle, (int)window_lo, (int)window_hi, window_lo * ns_per_cycle, window_hi * ns_per_cycle,
+           (int)(nominal_lead - window_lo), (int)(window_hi - nominal_lead));
+}
+
+static void test_mvs_clkdiv(void)
+{
+    // At 252 MHz the firmware divides the capture SMs by 2 to stay at 126 MHz.
+    static mvs_wave_t wave;
+    memset(&wave, 0, sizeof wave);
+    const uint32_t sys_hz = 2U * SYS_CLOCK_HZ;
+    wave.clk.clk_hz = MVS_PCLK_HZ;
+    wave.clk.sys_hz = sys_hz;
+    wave.clk.lead = (sys_hz / MVS_PCLK_HZ) / 2U;
+
+    sample_phase_t phase = {1U, MVS_PIXEL_SM, &wave.clk, 0U, 0U, 0U};
+    const mvs_capture_result_t r = mvs_capture_lines(&wave, sys_hz, 2U, &phase);
+    CHECK(pio1->sm[MVS_PIXEL_SM].clkdiv == (2U << PIO_SM0_CLKDIV_INT_LSB),
+          "pixel SM clkdiv 0x%08" PRIx32 ", want 2.0", pio1->sm[MVS_PIXEL_SM].clkdiv);
+    CHECK(r.mismatched_words == 0U, "clkdiv 2 capture: %" PRIu32 " words differ", r.mismatched_words);
+    // Each SM tick spans two system clocks, so the sample point jitters by one.
+    CHECK(phase.min_phase >= 4U && phase.max_phase <= 7U && phase.max_phase - phase.min_phase <= 1U,
+          "clkdiv 2 sample point %" PRIu64 "..%" PRIu64 " cycles after PCLK rise", phase.min_phase,
+          phase.max_phase);
+}
+
+static void test_mvs_h_window(void)
+{
+    static mvs_wave_t wave;
+    memset(&wave, 0, sizeof wave);
+    wave.clk.clk_hz = MVS_PCLK_HZ;
+    const uint32_t period = SYS_CLOCK_HZ / MVS_PCLK_HZ;
+    wave.clk.sys_hz = SYS_CLOCK_HZ;
+
+    // Requests beyond the spare border clamp to the first dot after the
+    // CSYNC rise and to a window ending two dots before the line does.
+    static const struct {
+        int request;
+        int offset;
+    } trims[] = {
+        {-1, -1},
+        {5, 5},
+        {-100, 1 - (int)H_SKIP_START},
+        {100, (int)(NEO_H_TOTAL - 2U - NEO_H_ACTIVE - H_SKIP_START)},
+    };
+    for (uint32_t i = 0; i < sizeof trims / sizeof trims[0]; i++) {
+        video_capture_set_h_offset(trims[i].request);
+        CHECK(video_capture_get_h_offset() == trims[i].offset, "h offset %d reads back %d, want %d",
+              trims[i].request, video_capture_get_h_offset(), trims[i].offset);
+
+        // The window must not narrow the launch margin the default one has.
+        for (int32_t delta = -3; delta <= 3; delta++) {
+            wave.clk.lead = (uint32_t)((int32_t)(period / 2U) + delta);
+            const mvs_capture_result_t r = mvs_capture_lines(&wave, SYS_CLOCK_HZ, 2U, NULL);
+            CHECK(r.mismatched_words == 0U,
+                  "h offset %d, lead %" PRIu32 ": %" PRIu32 " words differ (first at line %" PRIu32 " word %" PRIu32
+                  ")",
+                  trims[i].offset, wave.clk.lead, r.mismatched_words, r.first_bad_line, r.first_bad_word);
+        }
+    }
+    video_capture_set_h_offset(0);
+
+    // With no trim the pixel SM is primed with the nominal window.
+    wave.clk.lead = period / 2U;
+    mvs_start(&wave, SYS_CLOCK_HZ);
+    mvs_run_to(&wave, 1, 0);
+    CHECK(pio_emu_sm(pio1, MVS_PIXEL_SM)->y == (((NEO_H_ACTIVE - 1U) << 16) | (H_SKIP_START - 1U)),
+          "pixel SM window 0x%08" PRIx32 ", want %u active pixels after %u dots", pio_emu_sm(pio1, MVS_PIXEL_SM)->y,
+          NEO_H_ACTIVE, H_SKIP_START);
+}
+
+// =============================================================================
+// I2S
+// =============================================================================
+
+#define I2S_SAMPLE_RATE_HZ 55556U
+#define I2S_BITS_PER_HALF 32U
+#define I2S_DATA_BITS 24U
+
+typedef struct {
+    source_clock_t bck;
+    uint32_t delay_bits; // BCKs between the WS edge and the data MSB
+} i2s_wave_t;
+
+static uint32_t i2s_sample(uint32_t frame, uint32_t half)
+{
+    return test_pattern(frame, half + 7U, I2S_DATA_BITS);
+}
+
+static uint64_t i2s_levels(uint64_t cycle, void *ctx)
+{
+    const i2s_wave_t *wave = ctx;
+    const uint64_t bit = clock_data_index(&wave->bck, cycle);
+    const uint32_t frame = (uint32_t)(bit / (2U * I2S_BITS_PER_HALF));
+    const uint32_t slot = (uint32_t)(bit % (2U * I2S_BITS_PER_HALF));
+    const uint32_t half = slot / I2S_BITS_PER_HALF;
+    const uint32_t pos = slot % I2S_BITS_PER_HALF;
+    uint32_t dat = 0;
+    if (pos >= wave->delay_bits && pos < wave->delay_bits + I2S_DATA_BITS) {
+        dat = (i2s_sample(frame, half) >> (I2S_DATA_BITS - 1U - (pos - wave->delay_bits))) & 1U;
+    }
+    const bool ws = half != 0U;
+    const bool bck = clock_level(&wave->bck, cycle);
+    return ((uint64_t)dat << PIN_I2S_DAT) | ((uint64_t)ws << PIN_I2S_WS) | ((uint64_t)bck << PIN_I2S_BCK);
+}
+
+static void test_i2s_program(const char *name, const pio_program_t *program,
+                             void (*init)(PIO, uint, uint, uint, uint, uint), uint32_t delay_bits)
+{
+    static i2s_wave_t wave;
+    wave.bck.sys_hz = SYS_CLOCK_HZ;
+    wave.bck.clk_hz = I2S_SAMPLE_RATE_HZ * 2U * I2S_BITS_PER_HALF;
+    wave.bck.lead = (SYS_CLOCK_HZ / wave.bck.clk_hz) / 2U;
+    wave.delay_bits = delay_bits;
+
+    pico_host_reset();
+    pico_host_set_pin_source(i2s_levels, &wave);
+    const uint offset = pio_add_program(pio2, program);
+    init(pio2, 0, offset, PIN_I2S_DAT, PIN_I2S_WS, PIN_I2S_BCK);
+    pio_sm_set_enabled(pio2, 0, true);
+
+    enum { WORDS = 64 };
+    uint32_t words[WORDS];
+    uint32_t count = 0;
+    const uint64_t frame_cycles = ((uint64_t)SYS_CLOCK_HZ / I2S_SAMPLE_RATE_HZ) + 1U;
+    for (uint32_t step = 0; step < (2U * WORDS) + 8U && count < WORDS; step++) {
+        pio_emu_run(frame_cycles / 4U);
+        while (!pio_sm_is_rx_fifo_empty(pio2, 0) && count < WORDS) {
+            words[count++] = pio_sm_get(pio2, 0);
+        }
+    }
+    CHECK(count == WORDS, "%s: only %" PRIu32 " words captured", name, count);
+    CHECK(pio_emu_sm(pio2, 0)->rx_dropped == 0U, "%s: RX overflow", name);
+
+    // The program resynchronizes on the first full WS-low half it sees; find
+    // that frame and require every later word in order.
+    uint32_t first_frame = UINT32_MAX;
+    for (uint32_t f = 0; f < 4U; f++) {
+        if (count > 0U && words[0] == i2s_sample(f, 0)) {
+            first_frame = f;
+            break;
+        }
+    }
+    CHECK(first_frame != UINT32_MAX, "%s: first word 0x%06" PRIx32 " matches no WS-low sample", name,
+          count > 0U ? words[0] : 0U);
+    if (first_frame == UINT32_MAX) {
+        return;
+    }
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (words[i] != i2s_sample(first_frame + (i / 2U), i % 2U)) {
+            mismatches++;
+        }
+    }
+    CHECK(mismatches == 0U, "%s: %" PRIu32 " of %" PRIu32 " samples differ", name, mismatches, count);
+}
+
+#else // NEOPICO_CAPTURE_TARGET_SNES
+
+// =============================================================================
+// SNES
+// =============================================================================
+
+#define SNES_H_TOTAL 341U
+#define SNES_DOT_CLOCK_HZ 5369318U // 21.477 MHz master clock / 4
+#define SNES_HBLANK_START 300U    // dot at which this test raises HBLANK
+#define SNES_SKIP_PCLKS 20U       // `set x, 19` back-porch loop in snes_hard_sync
+#define SNES_PIXEL_SM 0U
+#define SNES_DMA_CHANNEL 0U
+
+static source_clock_t g_snes_clk;
+
+static uint32_t snes_raw_word(uint32_t line, uint32_t dot, bool pclk)
+{
+    const uint32_t hblank = dot >= SNES_HBLANK_START ? 1U : 0U;
+    return (pclk ? 2U : 0U) | (test_pattern(line, dot, 15U) << 2) | (hblank << 17);
+}
+
+static uint64_t snes_levels(uint64_t cycle, void *ctx)
+{
+    (void)ctx;
+    const uint64_t k = clock_data_index(&g_snes_clk, cycle);
+    const uint32_t line = (uint32_t)(k / SNES_H_TOTAL);
+    const uint32_t dot = (uint32_t)(k % SNES_H_TOTAL);
+    return (uint64_t)snes_raw_word(line, dot, clock_level(&g_snes_clk, cycle)) << PIN_SNES_BASE;
+}
+
+static void test_snes_capture_window(void)
+{
+    static uint32_t buffer[3U * CAPTURE_ACTIVE_WIDTH];
+    memset(buffer, 0, sizeof buffer);
+    g_snes_clk.sys_hz = SYS_CLOCK_HZ;
+    g_snes_clk.clk_hz = SNES_DOT_CLOCK_HZ;
+    g_snes_clk.lead = (SYS_CLOCK_HZ / SNES_DOT_CLOCK_HZ) / 2U;
+
+    pico_host_reset();
+    pico_host_set_pin_source(snes_levels, NULL);
+    video_capture_init(SOURCE_HEIGHT);
+
+    const uint64_t line_cycles = ((uint64_t)SNES_H_TOTAL * SYS_CLOCK_HZ) / SNES_DOT_CLOCK_HZ;
+    pio_emu_run(line_cycles / 2U);
+    CHECK(pio_emu_sm(pio1, SNES_PIXEL_SM)->rx_pushes == 0U, "pixel SM pushed data before IRQ 4");
+
+    dma_channel_set_trans_count(SNES_DMA_CHANNEL, 3U * CAPTURE_ACTIVE_WIDTH, false);
+    dma_channel_set_write_addr(SNES_DMA_CHANNEL, buffer, true);
+    pio_interrupt_clear(pio1, 4);
+    pio_sm_exec(pio1, SNES_PIXEL_SM, pio_encode_irq_set(false, 4));
+
+    sample_phase_t phase = {1U, SNES_PIXEL_SM, &g_snes_clk, 0U, 0U, 0U};
+    pio_emu_set_trace(sample_phase_trace, &phase);
+    pio_emu_run(line_cycles * 4U);
+    pio_emu_set_trace(NULL, NULL);
+
+    // Triggered mid-line 0: HBLANK falls at the start of line 1, the SM skips
+    // SNES_SKIP_PCLKS edges, then takes CAPTURE_ACTIVE_WIDTH pixels per line.
+    uint32_t mismatches = 0;
+    for (uint32_t l = 0; l < 3U; l++) {
+        for (uint32_t x = 0; x < CAPTURE_ACTIVE_WIDTH; x++) {
+            const uint32_t want = snes_raw_word(1U + l, SNES_SKIP_PCLKS + x, true);
+            if (buffer[(l * CAPTURE_ACTIVE_WIDTH) + x] != want && mismatches++ == 0U) {
+                fprintf(stderr, "  line %" PRIu32 " x %" PRIu32 ": 0x%05" PRIx32 " want 0x%05" PRIx32 "\n", l, x,
+                        buffer[(l * CAPTURE_ACTIVE_WIDTH) + x], want);
+            }
+        }
+    }
+    CHECK(mismatches == 0U, "%" PRIu32 " SNES pixels differ from dots %u..%u of each line", mismatches,
+          SNES_SKIP_PCLKS, SNES_SKIP_PCLKS + CAPTURE_ACTIVE_WIDTH - 1U);
+    CHECK(phase.min_phase == 3U && phase.max_phase == 3U,
+          "SNES sample point must sit 3 cycles after PCLK rise (saw %" PRIu64 "..%" PRIu64 ")", phase.min_phase,
+          phase.max_phase);
+}
+
+#endif
+
+int main(void)
+{
+#if NEOPICO_CAPTURE_TARGET == NEOPICO_CAPTURE_TARGET_MVS
+    test_mvs_sync_pulse_counts();
+    test_mvs_pixel_sample_phase();
+    test_mvs_clkdiv();
+    test_mvs_h_window();
+    test_i2s_program("i2s_capture_frame_resync", &i2s_capture_frame_resync_program,
+                     i2s_capture_frame_resync_program_init, 0U);
+    test_i2s_program("i2s_capture_pcm1802", &i2s_capture_pcm1802_program, i2s_capture_pcm1802_program_init, 1U);
+#else
+    test_snes_capture_window();
+#endif
+
+    if (g_check_failures != 0U) {
+        fprintf(stderr, "\nFAIL: %u PIO emulation checks failed.\n", g_check_failures);
+        return EXIT_FAILURE;
+    }
+    printf("PASS: %s PIO programs capture correctly in the cycle-level emulator.\n", CAPTURE_TARGET_NAME);
+    return EXIT_SUCCESS;
+}
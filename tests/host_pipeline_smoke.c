@@ -0,0 +1,393 @@
+// End-to-end smoke test of the host build: the unmodified MVS capture loop,
+// line ring, 480p scanout callback and audio chain, driven through the Pico
+// HAL shim in tests/host. Built once per firmware flag set by CMakeLists.txt.
+
+#include <inttypes.h>
+#include <setjmp.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "audio_subsystem.h"
+#include "line_ring.h"
+#include "mvs_effect_lut.h"
+#include "mvs_pins.h"
+#include "mvs_sync_decoder.h"
+#include "pico_host.h"
+#include "video_capture.h"
+#include "video_config.h"
+#include "video_pipeline.h"
+
+#if NEOPICO_MVS_DIGITAL_EFFECT_PROCESSING
+#include "mvs_digital_effect.h"
+#endif
+
+// Mirrors of the private capture constants in video_capture_mvs.c.
+#define LINE_PULSE 356U // a normal line's CSYNC high count
+#define NEO_H_ACTIVE 320U
+#define H_SKIP_START 28U
+#define V_SKIP_LINES 16U
+#define FRAME_PERIOD_US 16896U
+
+// The capture init claims PIO1 SM0 (sync) and SM1 (pixels) in that order.
+#define SYNC_SM 0U
+#define PIXEL_SM 1U
+
+static unsigned g_check_failures;
+
+#define CHECK(condition, ...)                                                                                          \
+    do {                                                                                                               \
+        if (!(condition)) {                                                                                            \
+            fprintf(stderr, "CHECK FAILED: ");                                                                         \
+            fprintf(stderr, __VA_ARGS__);                                                                              \
+            fputc('\n', stderr);                                                                                       \
+            g_check_failures++;                                                                                        \
+        }                                                                                                              \
+    } while (0)
+
+// =============================================================================
+// Synthetic MVS input
+// =============================================================================
+
+static uint32_t test_raw_pixel(uint32_t line, uint32_t x)
+{
+    const uint32_t color15 = ((x * 97U) + (line * 131U)) & 0x7FFFU;
+    const uint32_t dark = ((x % 5U) == 0U) ? 1U : 0U;
+    const uint32_t shadow = ((line % 3U) == 0U) ? 1U : 0U;
+    // CSYNC high, PCLK high at the sample point.
+    return 0x3U | (color15 << 2) | (shadow << 17) | (dark << 18);
+}
+
+typedef struct {
+    jmp_buf exit;
+    uint32_t frames_to_capture;
+    uint32_t vsyncs_sent;
+    uint32_t dma_lines_sent;
+    uint32_t dropped_words;
+} capture_driver_t;
+
+static void send_sync_pulse(uint32_t h_ctr)
+{
+    (void)pico_host_pio_push_rx(pio1, SYNC_SM, h_ctr);
+}
+
+// One frame's tail as the sync SM reports it: the normal lines of the last
+// frame, a run of equalization (short) pulses with a lone long pulse inside
+// it, then the two long pulses that the sync decoder takes as the start of
+// the next frame (mvs_sync_decoder.h).
+static void send_vsync(void)
+{
+    for (uint32_t i = 0; i < MVS_SYNC_MIN_FRAME_LINES; i++) {
+        send_sync_pulse(LINE_PULSE);
+    }
+    for (int i = 0; i < 9; i++) {
+        send_sync_pulse(MVS_SYNC_SHORT_MAX - 100U);
+    }
+    send_sync_pulse(LINE_PULSE);
+    for (int i = 0; i < 3; i++) {
+        send_sync_pulse(MVS_SYNC_SHORT_MAX - 100U);
+    }
+    send_sync_pulse(LINE_PULSE);
+    send_sync_pulse(LINE_PULSE);
+}
+
+static bool capture_wait_hook(pico_host_wait_reason_t reason, uint64_t deadline_us, void *ctx)
+{
+    capture_driver_t *drv = ctx;
+    (void)deadline_us;
+
+    switch (reason) {
+        case PICO_HOST_WAIT_SEM:
+            if (drv->vsyncs_sent > drv->frames_to_capture) {
+                longjmp(drv->exit, 1);
+            }
+            pico_host_advance_us(FRAME_PERIOD_US);
+            send_vsync();
+            drv->vsyncs_sent++;
+            drv->dma_lines_sent = 0;
+            return true;
+
+        case PICO_HOST_WAIT_DMA: {
+            // The pixel SM pushes only the active window.
+            const uint32_t line = drv->dma_lines_sent++;
+            for (uint32_t x = H_SKIP_START; x < H_SKIP_START + NEO_H_ACTIVE; x++) {
+                if (!pico_host_pio_push_rx(pio1, PIXEL_SM, test_raw_pixel(line, x))) {
+                    drv->dropped_words++;
+                }
+            }
+            return true;
+        }
+
+        default:
+            return false;
+    }
+}
+
+// =============================================================================
+// Scanout before capture
+// =============================================================================
+
+static void test_scanout_no_signal(void)
+{
+    static uint32_t dst[640];
+    video_output_scanline_cb_t scanline = pico_host_video_scanline_callback();
+    CHECK(scanline != NULL, "video_pipeline_init must register a scanline callback");
+    if (scanline == NULL) {
+        return;
+    }
+
+    // Nothing has been captured yet, so every active line is unready.
+    scanline(0, V_OFFSET * 2U, dst);
+#if NEOPICO_EXP_RGB888_SCANOUT
+    CHECK(dst[0] == 0x00FF4D00U, "unready line must show the no-signal colour 0xFA60 widened (got 0x%08" PRIx32 ")", dst[0]);
+#else
+    CHECK(dst[0] == 0xFA60FA60U, "unready line must show the no-signal colour (got 0x%08" PRIx32 ")", dst[0]);
+#endif
+}
+
+// =============================================================================
+// Capture + ring
+// =============================================================================
+
+static uint16_t expected_ring_pixel(uint32_t raw)
+{
+#if NEOPICO_EXP_RGB888_SCANOUT
+    return mvs_entropy_pack_raw(raw);
+#elif NEOPICO_MVS_DIGITAL_EFFECT_PROCESSING
+    return mvs_digital_effect_rgb565_raw(raw);
+#else
+#error "host_pipeline_smoke covers the DARK/SHADOW capture builds"
+#endif
+}
+
+static void test_capture_into_ring(void)
+{
+    static capture_driver_t drv;
+    memset(&drv, 0, sizeof drv);
+    drv.frames_to_capture = 1;
+
+    video_capture_init(SOURCE_HEIGHT);
+    CHECK(pico_host_pio_sm_enabled(pio1, SYNC_SM) && pico_host_pio_sm_enabled(pio1, PIXEL_SM),
+          "capture init must leave both PIO1 state machines running");
+
+    uint32_t window_word = 0;
+    CHECK(pico_host_pio_pop_tx(pio1, PIXEL_SM, &window_word) &&
+              window_word == (((NEO_H_ACTIVE - 1U) << 16) | (H_SKIP_START - 1U)),
+          "pixel SM must be primed with the active window (got 0x%08" PRIx32 ")", window_word);
+
+    pico_host_set_wait_hook(capture_wait_hook, &drv);
+    if (setjmp(drv.exit) == 0) {
+        video_capture_run();
+    }
+    pico_host_set_wait_hook(NULL, NULL);
+
+    CHECK(drv.dropped_words == 0U, "%" PRIu32 " pixel words overflowed the RX FIFO", drv.dropped_words);
+    CHECK(drv.dma_lines_sent == V_SKIP_LINES + SOURCE_HEIGHT, "capture consumed %" PRIu32 " DMA lines, want %u",
+          drv.dma_lines_sent, V_SKIP_LINES + SOURCE_HEIGHT);
+    CHECK(g_line_ring.write_idx == SOURCE_HEIGHT, "ring write_idx %" PRIu32 " after one frame", g_line_ring.write_idx);
+    CHECK(g_line_ring.resync_pending, "input vsync must request an output resync");
+    CHECK(video_capture_get_frame_count() >= 1U, "frame counter did not advance");
+
+    uint32_t pixel_mismatches = 0;
+    uint32_t shadow_mismatches = 0;
+    for (uint32_t line = 0; line < SOURCE_HEIGHT; line++) {
+        const uint32_t input_line = V_SKIP_LINES + line;
+        const uint16_t *ring_line = g_line_ring.lines[LINE_RING_SLOT(line)];
+        for (uint32_t x = 0; x < NEO_H_ACTIVE; x++) {
+            const uint32_t raw = test_raw_pixel(input_line, H_SKIP_START + x);
+            if (ring_line[x] != expected_ring_pixel(raw)) {
+                if (pixel_mismatches++ < 4U) {
+                    fprintf(stderr, "  line %" PRIu32 " x %" PRIu32 ": ring 0x%04x want 0x%04x\n", line, x,
+                            ring_line[x], expected_ring_pixel(raw));
+                }
+            }
+        }
+#if NEOPICO_EXP_RGB888_SCANOUT
+        const uint32_t want_shadow = ((input_line % 3U) == 0U) ? 1U : 0U;
+        if (g_line_ring.line_shadow[LINE_RING_SLOT(line)] != want_shadow) {
+            shadow_mismatches++;
+        }
+#endif
+    }
+    CHECK(pixel_mismatches == 0U, "%" PRIu32 " ring pixels differ from the conversion reference", pixel_mismatches);
+    CHECK(shadow_mismatches == 0U, "%" PRIu32 " ring lines carry the wrong SHADOW latch", shadow_mismatches);
+}
+
+// =============================================================================
+// 480p scanout
+// =============================================================================
+
+static uint32_t expected_output_word(const uint16_t *ring_line, uint32_t word, uint32_t shadow,
+                                     const void *lut_context)
+{
+#if NEOPICO_EXP_RGB888_SCANOUT
+    // One RGB888 word per output pixel, each source pixel doubled.
+    return mvs_effect_lut888_lookup_entropy(lut_context, ring_line[word / 2U], shadow);
+#else
+    (void)shadow;
+    (void)lut_context;
+    const uint32_t pixel = ring_line[word];
+    return pixel | (pixel << 16);
+#endif
+}
+
+static void test_scanout_480p(void)
+{
+    static uint32_t dst[640];
+#if NEOPICO_EXP_RGB888_SCANOUT
+    static mvs_effect_lut888_t lut;
+    mvs_effect_lut888_generate(&lut);
+    const void *lut_context = &lut;
+    const uint32_t words_per_line = 640U;
+#else
+    const void *lut_context = NULL;
+    const uint32_t words_per_line = 320U;
+#endif
+
+    video_output_scanline_cb_t scanline = pico_host_video_scanline_callback();
+    video_output_vsync_cb_t vsync = pico_host_video_vsync_callback();
+    CHECK(scanline != NULL && vsync != NULL, "video_pipeline_init must register both callbacks");
+    if (scanline == NULL || vsync == NULL) {
+        return;
+    }
+
+    vsync();
+
+    scanline(0, 0, dst);
+    CHECK(dst[0] == 0U && dst[words_per_line - 1U] == 0U, "overscan rows must be black");
+
+    uint32_t mismatches = 0;
+    for (uint32_t line = 0; line < SOURCE_HEIGHT; line++) {
+        const uint16_t *ring_line = g_line_ring.lines[LINE_RING_SLOT(line)];
+#if NEOPICO_EXP_RGB888_SCANOUT
+        const uint32_t shadow = g_line_ring.line_shadow[LINE_RING_SLOT(line)];
+#else
+        const uint32_t shadow = 0;
+#endif
+        for (uint32_t repeat = 0; repeat < 2U; repeat++) {
+            memset(dst, 0xA5, sizeof dst);
+            scanline(0, ((V_OFFSET + line) * 2U) + repeat, dst);
+            for (uint32_t w = 0; w < words_per_line; w++) {
+                if (dst[w] != expected_output_word(ring_line, w, shadow, lut_context)) {
+                    if (mismatches++ < 4U) {
+                        fprintf(stderr, "  line %" PRIu32 "/%" PRIu32 " word %" PRIu32 ": 0x%08" PRIx32 "\n", line,
+                                repeat, w, dst[w]);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+    CHECK(mismatches == 0U, "%" PRIu32 " 480p output lines differ from the doubled ring content", mismatches);
+}
+
+// A 50 Hz input retimes every output mode to 50 Hz on its own pixel clock
+// and line, and a 60 Hz one restores the mode's v_total.
+static void test_output_standard(void)
+{
+    static const video_mode_t *const modes[] = {&video_mode_480_p, &video_mode_240_p, &video_mode_240_p_genlock,
+                                                &video_mode_720_p};
+    for (size_t i = 0; i < sizeof modes / sizeof modes[0]; i++) {
+        const video_mode_t *mode = modes[i];
+        video_output_set_mode(mode);
+        video_pipeline_set_standard(VIDEO_STANDARD_50HZ);
+        CHECK(video_pipeline_get_standard() == VIDEO_STANDARD_60HZ && rt_v_total_lines == mode->v_total_lines,
+              "%ux%u: a standard change waits for the output VSYNC", mode->h_active_pixels, mode->v_active_lines);
+        video_pipeline_vsync_callback();
+        const double hz = (double)mode->pixel_clock_hz / ((double)mode->h_total_pixels * rt_v_total_lines);
+        CHECK(video_pipeline_get_standard() == VIDEO_STANDARD_50HZ && hz > 49.9 && hz < 50.1,
+              "%ux%u at 50 Hz: %u lines, %.3f Hz", mode->h_active_pixels, mode->v_active_lines,
+              (unsigned)rt_v_total_lines, hz);
+        video_pipeline_set_standard(VIDEO_STANDARD_60HZ);
+        video_pipeline_vsync_callback();
+        CHECK(rt_v_total_lines == mode->v_total_lines, "%ux%u back at 60 Hz: %u lines", mode->h_active_pixels,
+              mode->v_active_lines, (unsigned)rt_v_total_lines);
+    }
+    video_output_set_mode(&video_mode_480_p);
+}
+
+// =============================================================================
+// Audio
+// =============================================================================
+
+#define AUDIO_TEST_RATE_HZ 55556U
+#define AUDIO_TEST_STEP_US 1000U
+#define AUDIO_TEST_DURATION_US 3000000U
+
+static void test_audio_chain(void)
+{
+    // Buttons idle high through their pull-ups.
+    pico_host_gpio_put(PIN_OSD_BTN_MENU, true);
+    pico_host_gpio_put(PIN_OSD_BTN_BACK, true);
+
+    audio_subsystem_init();
+    audio_subsystem_start();
+    CHECK(pico_host_pio_sm_enabled(pio2, 0), "I2S capture SM must be running after start");
+
+    uint64_t sample_clock = 0;
+    uint32_t phase = 0;
+    uint32_t islands = 0;
+    uint32_t nonsilent_islands = 0;
+    int last_frame_counter = -1;
+    bool frame_counter_ok = true;
+
+    pico_host_set_time_us(1);
+    for (uint32_t t = 0; t < AUDIO_TEST_DURATION_US; t += AUDIO_TEST_STEP_US) {
+        // NEO-YSA2 order: right word, then left word, 16-bit data in bits 15:0.
+        sample_clock += (uint64_t)AUDIO_TEST_RATE_HZ * AUDIO_TEST_STEP_US;
+        while (sample_clock >= 1000000U) {
+            sample_clock -= 1000000U;
+            const int16_t value = ((phase++ / 50U) & 1U) ? 6000 : -6000;
+            (void)pico_host_pio_push_rx(pio2, 0, (uint16_t)value);
+            (void)pico_host_pio_push_rx(pio2, 0, (uint16_t)value);
+        }
+
+        audio_subsystem_core0_poll();
+        pico_host_advance_us(AUDIO_TEST_STEP_US);
+
+        hstx_data_island_t island;
+        while (pico_host_di_queue_pop(&island)) {
+            islands++;
+            // A capture re-arm restarts the block at frame 0.
+            if (last_frame_counter >= 0 && island.packet.frame_counter != 0 &&
+                island.packet.frame_counter != ((last_frame_counter + 4) % 192)) {
+                frame_counter_ok = false;
+            }
+            last_frame_counter = island.packet.frame_counter;
+            for (uint32_t i = 0; i < island.packet.sample_count; i++) {
+                if (island.packet.samples[i].left != 0 || island.packet.samples[i].right != 0) {
+                    nonsilent_islands++;
+                    break;
+                }
+            }
+        }
+    }
+
+    // ~48 kHz out for 3 s, four samples per island.
+    CHECK(islands > 30000U, "only %" PRIu32 " audio data islands produced", islands);
+    CHECK(nonsilent_islands > 1000U, "audio never unmuted (%" PRIu32 " non-silent islands)", nonsilent_islands);
+    CHECK(frame_counter_ok, "IEC 60958 frame counter must advance by 4 per island");
+}
+
+int main(void)
+{
+    pico_host_reset();
+    video_output_set_mode(&video_mode_480_p);
+    video_pipeline_init(640, 480);
+    video_pipeline_set_scanline_level(VIDEO_PIPELINE_SCANLINE_OFF);
+
+    test_scanout_no_signal();
+    test_capture_into_ring();
+    test_scanout_480p();
+    test_output_standard();
+    test_audio_chain();
+
+    if (g_check_failures != 0U) {
+        fprintf(stderr, "\nFAIL: %u host pipeline checks failed.\n", g_check_failures);
+        return EXIT_FAILURE;
+    }
+    printf("PASS: host capture, scanout and audio pipeline smoke test.\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,311 @@
+// Drives the line ring simulator (tests/host/ring_sim.c): the real
+// line_ring.h producer and consumer on two threads, checked against what the
+// frame-rate relationship implies. A free-running 480p output beats against
+// the 59.185 Hz MVS and repeats one frame per beat; an input faster than the
+// output drops one per beat instead; a genlocked output does neither and
+// needs only the phase lag in ring lines. A 50 Hz input repeats one frame in
+// five on the 60 Hz output, and none once the output runs its 50 Hz timing.
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "line_ring.h"
+#include "ring_sim.h"
+
+static unsigned g_check_failures;
+
+#define CHECK(condition, ...)                                                                                          \
+    do {                                                                                                               \
+        if (!(condition)) {                                                                                            \
+            fprintf(stderr, "CHECK FAILED: ");                                                                         \
+            fprintf(stderr, __VA_ARGS__);                                                                              \
+            fputc('\n', stderr);                                                                                       \
+            g_check_failures++;                                                                                        \
+        }                                                                                                              \
+    } while (0)
+
+#define MVS_FRAME_HZ 59.185
+#define OUT_480P_HZ (25200000.0 / (800.0 * 525.0))
+// A 312-line raster of 64 us lines.
+#define PAL_FRAME_HZ 50.08
+
+static ring_sim_result_t g_result;
+static ring_sim_result_t g_repeat;
+
+static void check_reads(const char *name, const ring_sim_result_t *r)
+{
+    CHECK(r->out_frames > 0U, "%s: no output frames", name);
+    CHECK(r->not_written == 0U, "%s: %" PRIu32 " reads of uncommitted lines", name, r->not_written);
+    CHECK(r->overrun == 0U, "%s: %" PRIu32 " reads of overwritten lines", name, r->overrun);
+    CHECK(r->torn_lines == 0U, "%s: %" PRIu32 " torn lines", name, r->torn_lines);
+    CHECK(r->glitched_frames == 0U && r->blank_frames == 0U, "%s: %" PRIu32 " glitched, %" PRIu32 " blank frames",
+          name, r->glitched_frames, r->blank_frames);
+
+    // The depth curve must agree with the run itself: clean at the depth it
+    // reports, not one line below it.
+    CHECK(ring_sim_frames_over(r, r->max_depth) == 0U, "%s: frames glitch at the reported depth", name);
+    CHECK(ring_sim_frames_over(r, r->max_depth - 1U) > 0U, "%s: reported depth %" PRIu32 " is not the minimum", name,
+          r->max_depth);
+}
+
+static void check_clean(const char *name, const ring_sim_result_t *r)
+{
+    check_reads(name, r);
+    CHECK(r->max_depth <= LINE_RING_SIZE, "%s: needed %" PRIu32 " lines of a %u-line ring", name, r->max_depth,
+          LINE_RING_SIZE);
+}
+
+static void expect_beats(const char *name, uint32_t got, double seconds, double beat_hz)
+{
+    const double expected = seconds * beat_hz;
+    CHECK(fabs(got - expected) <= 1.5, "%s: %" PRIu32 " frames, expected about %.1f", name, got, expected);
+}
+
+// The ring's frame-pacing counters classify from frame bases alone; they
+// must agree with what the line content says each frame showed, and their
+// beat with the rates.
+static void check_pacing(const char *name, const ring_sim_result_t *r, double out_hz, double beat_hz)
+{
+    CHECK(r->diag_repeated_frames == r->duplicated_frames && r->diag_skipped_frames == r->skipped_frames,
+          "%s: pacing counted %" PRIu32 " repeated, %" PRIu32 " skipped; the content %" PRIu32 ", %" PRIu32, name,
+          r->diag_repeated_frames, r->diag_skipped_frames, r->duplicated_frames, r->skipped_frames);
+    if (beat_hz == 0.0) {
+        CHECK(r->pace_events == 0U, "%s: %" PRIu32 " pacing events", name, r->pace_events);
+        return;
+    }
+    const double beat = out_hz / beat_hz;
+    CHECK(fabs(r->beat_frames - beat) <= 2.0, "%s: beat of %" PRIu32 " frames, expected about %.1f", name,
+          r->beat_frames, beat);
+    CHECK(r->last_run_frames + 2U >= r->beat_frames && r->last_run_frames < r->beat_frames,
+          "%s: cadence run of %" PRIu32 " frames in a %" PRIu32 "-frame beat", name, r->last_run_frames,
+          r->beat_frames);
+}
+
+static void test_free_running(void)
+{
+    ring_sim_config_t config;
+    ring_sim_config_init(&config);
+    CHECK(ring_sim_run(&config, &g_result), "free-running: threads did not start");
+    check_clean("free-running", &g_result);
+    expect_beats("free-running repeats", g_result.duplicated_frames, config.seconds, OUT_480P_HZ - MVS_FRAME_HZ);
+    CHECK(g_result.skipped_frames == 0U, "free-running: %" PRIu32 " input frames dropped", g_result.skipped_frames);
+    check_pacing("free-running", &g_result, OUT_480P_HZ, OUT_480P_HZ - MVS_FRAME_HZ);
+
+    // The output sweeps every phase, so a ring much shorter than a frame
+    // must glitch somewhere.
+    CHECK(ring_sim_frames_over(&g_result, 128U) > 0U, "free-running: a 128-line ring should not have been enough");
+}
+
+// An input faster than the output (a 60.1 Hz SNES-rate source) lets the
+// output fall behind by up to a frame before it drops one. The lag peaks at
+// the ring's full depth: line_ring_ready() still accepts a line whose slot
+// the producer converts into next, and at 60.5 Hz such reads come back torn,
+// so only the frame accounting is checked here, not the depth.
+static void test_fast_input(void)
+{
+    ring_sim_config_t config;
+    ring_sim_config_init(&config);
+    config.in_hz = 60.1;
+    config.seconds = 20.0;
+    CHECK(ring_sim_run(&config, &g_result), "fast input: threads did not start");
+    check_reads("fast input", &g_result);
+    expect_beats("fast input drops", g_result.skipped_frames, config.seconds, config.in_hz - OUT_480P_HZ);
+    CHECK(g_result.duplicated_frames == 0U, "fast input: %" PRIu32 " frames repeated", g_result.duplicated_frames);
+    check_pacing("fast input", &g_result, OUT_480P_HZ, config.in_hz - OUT_480P_HZ);
+    CHECK(g_result.max_depth > LINES_PER_FRAME, "fast input: lag never reached a frame (%" PRIu32 " lines)",
+          g_result.max_depth);
+}
+
+// 480p retimed for a 50 Hz input, as video_pipeline_set_standard() does:
+// same pixel clock and line, vertical blanking stretched to 630 lines.
+static const video_mode_t k_480p_50hz = {640, 480, 800, 630, 25200000U};
+
+// A 50 Hz input's lines arrive a fifth slower than a 60 Hz output reads
+// them, so besides repeating every fifth frame the output overtakes the
+// producer inside a frame and reads lines not yet written. Retimed to 50 Hz
+// it never does, and the input's 0.08 Hz lead drops at most one frame; that
+// lead lets the lag reach the ring's full depth as in test_fast_input(), so
+// overwritten reads are not checked here.
+static void test_50hz_input(void)
+{
+    ring_sim_config_t config;
+    ring_sim_config_init(&config);
+    config.in_hz = PAL_FRAME_HZ;
+    CHECK(ring_sim_run(&config, &g_result), "50 Hz input: threads did not start");
+    CHECK(g_result.not_written > 0U, "50 Hz input: a 60 Hz output never overtook the producer");
+    expect_beats("50 Hz input repeats", g_result.duplicated_frames, config.seconds, OUT_480P_HZ - PAL_FRAME_HZ);
+
+    config.mode = &k_480p_50hz;
+    CHECK(ring_sim_run(&config, &g_repeat), "50 Hz output: threads did not start");
+    CHECK(g_repeat.not_written == 0U, "50 Hz output: %" PRIu32 " reads of uncommitted lines", g_repeat.not_written);
+    CHECK(g_repeat.duplicated_frames == 0U && g_repeat.skipped_frames <= 1U,
+          "50 Hz output: %" PRIu32 " repeated, %" PRIu32 " dropped frames", g_repeat.duplicated_frames,
+          g_repeat.skipped_frames);
+    printf("50 Hz input: %" PRIu32 " of %" PRIu32 " frames repeated at 60 Hz out, %" PRIu32 " at 50 Hz out.\n",
+           g_result.duplicated_frames, g_result.out_frames, g_repeat.duplicated_frames);
+}
+
+static void test_genlock(void)
+{
+    ring_sim_config_t config;
+    ring_sim_config_init(&config);
+    config.genlock = true;
+    config.phase = 0.25;
+    config.seconds = 5.0;
+    CHECK(ring_sim_run(&config, &g_result), "genlock: threads did not start");
+    check_clean("genlock", &g_result);
+    CHECK(g_result.duplicated_frames == 0U && g_result.skipped_frames == 0U,
+          "genlock: %" PRIu32 " repeated, %" PRIu32 " dropped frames", g_result.duplicated_frames,
+          g_result.skipped_frames);
+    check_pacing("genlock", &g_result, MVS_FRAME_HZ, 0.0);
+    CHECK(g_result.max_depth < 128U, "genlock: phase 0.25 needed %" PRIu32 " lines", g_result.max_depth);
+
+    // The ring's latency stamps: every line of every locked frame is fetched
+    // first exactly once, no later than the depth the run needed.
+    uint64_t fetched = 0;
+    for (uint32_t i = 0; i < LINE_RING_LATENCY_BUCKETS; i++) {
+        fetched += g_result.latency_hist[i];
+    }
+    CHECK(fetched == (uint64_t)g_result.out_frames * LINES_PER_FRAME,
+          "genlock: %" PRIu64 " first fetches for %" PRIu32 " frames", fetched, g_result.out_frames);
+    const uint32_t depth_us = g_result.max_depth * 64U;
+    CHECK(g_result.latency_p99_us >= depth_us / 2U && g_result.latency_p99_us <= depth_us * 2U,
+          "genlock: p99 latency bound %" PRIu32 " us for a %" PRIu32 "-line lag", g_result.latency_p99_us,
+          g_result.max_depth);
+
+    // Zero slack merges the two timelines deterministically.
+    CHECK(ring_sim_run(&config, &g_repeat), "genlock repeat: threads did not start");
+    CHECK(memcmp(&g_result, &g_repeat, sizeof g_result) == 0, "genlock: a zero-slack run must be repeatable");
+
+    // Letting the threads race by a few lines must not break the ring.
+    config.slack_us = 100.0;
+    CHECK(ring_sim_run(&config, &g_repeat), "genlock slack: threads did not start");
+    CHECK(g_repeat.torn_lines == 0U && g_repeat.overrun == 0U && g_repeat.not_written == 0U,
+          "genlock slack: %" PRIu32 " torn, %" PRIu32 " overrun, %" PRIu32 " not written", g_repeat.torn_lines,
+          g_repeat.overrun, g_repeat.not_written);
+}
+
+// A shallow ring (line_ring_init_shallow()): 128 lines hold a 480p output locked at
+// the early phase zone's far edge (~7.6 ms after the input frame starts), and
+// a free-running output at the same depth glitches exactly where the
+// full-depth run's histogram said it would. The firmware runs the full ring
+// regardless: a genlocked output runs free until it acquires and after it
+// loses lock.
+#define EARLY_LOCK_DEPTH 128U
+
+static void test_shallow_ring(void)
+{
+    ring_sim_config_t config;
+    ring_sim_config_init(&config);
+    config.genlock = true;
+    config.phase = 0.45;
+    config.seconds = 5.0;
+    config.depth = EARLY_LOCK_DEPTH;
+    CHECK(ring_sim_run(&config, &g_result), "shallow genlock: threads did not start");
+    check_clean("shallow genlock", &g_result);
+    CHECK(g_result.max_depth <= EARLY_LOCK_DEPTH, "shallow genlock: needed %" PRIu32 " lines of %u",
+          g_result.max_depth, EARLY_LOCK_DEPTH);
+
+    ring_sim_config_init(&config);
+    CHECK(ring_sim_run(&config, &g_result), "full ring: threads did not start");
+    config.depth = 128U;
+    CHECK(ring_sim_run(&config, &g_repeat), "shallow free-running: threads did not start");
+    CHECK(g_repeat.overrun > 0U && g_repeat.glitched_frames > 0U,
+          "shallow free-running: a 128-line ring never overran");
+    // Torn lines are expected here too: line_ring_ready() passes a read at
+    // exactly `depth` lines, whose slot the producer is converting into (see
+    // test_fast_input()). The histogram counts those frames as over depth.
+    CHECK(g_repeat.glitched_frames <= ring_sim_frames_over(&g_result, config.depth),
+          "shallow free-running: %" PRIu32 " glitched frames, the full-depth run predicts %" PRIu32,
+          g_repeat.glitched_frames, ring_sim_frames_over(&g_result, config.depth));
+}
+
+// Beam racing: free-running, the frames whose output VSYNC lands just before
+// the input's (or just after it, before line 0 is in) show the frame being
+// written instead of the one before it, and no read may come up short. A
+// genlock held in that window races every frame, a few lines behind.
+static void test_race(void)
+{
+    ring_sim_config_t config;
+    ring_sim_config_init(&config);
+    CHECK(ring_sim_run(&config, &g_result), "race baseline: threads did not start");
+    config.race = true;
+    CHECK(ring_sim_run(&config, &g_repeat), "race: threads did not start");
+    check_clean("race", &g_repeat);
+    CHECK(g_repeat.raced_frames > 0U, "race: no frame raced the input");
+    CHECK(g_result.raced_frames == 0U, "race baseline: %" PRIu32 " frames raced", g_result.raced_frames);
+    CHECK(g_repeat.duplicated_frames == g_result.duplicated_frames,
+          "race: %" PRIu32 " repeated frames, the default policy %" PRIu32, g_repeat.duplicated_frames,
+          g_result.duplicated_frames);
+    CHECK(ring_sim_frames_over(&g_repeat, LINES_PER_FRAME) + g_repeat.raced_frames ==
+              ring_sim_frames_over(&g_result, LINES_PER_FRAME),
+          "race: %" PRIu32 " frames over a frame old with %" PRIu32 " raced, the default policy %" PRIu32,
+          ring_sim_frames_over(&g_repeat, LINES_PER_FRAME), g_repeat.raced_frames,
+          ring_sim_frames_over(&g_result, LINES_PER_FRAME));
+
+    config.genlock = true;
+    config.phase = 0.02;
+    config.seconds = 2.0;
+    CHECK(ring_sim_run(&config, &g_result), "race genlock: threads did not start");
+    check_clean("race genlock", &g_result);
+    CHECK(g_result.raced_frames == g_result.out_frames, "race genlock: %" PRIu32 " of %" PRIu32 " frames raced",
+          g_result.raced_frames, g_result.out_frames);
+    CHECK(g_result.max_depth < 32U, "race genlock: lag of %" PRIu32 " lines", g_result.max_depth);
+    CHECK(g_result.latency_p99_us <= 2048U, "race genlock: p99 latency bound %" PRIu32 " us", g_result.latency_p99_us);
+}
+
+// The input stops right after a VSYNC, before line 0 is committed (the
+// relock's line-0 abort leaves the same empty frame base). Racing may take
+// that base only while its first commit is due; for the rest of the outage
+// the output must keep the last complete frame, as line_ring_output_vsync()
+// does. Driven directly, single-threaded, on the ring the runs above used.
+static void test_race_stall(void)
+{
+    const uint32_t in_period_us = 16896U;
+    const uint32_t out_period_us = 16683U;
+    uint32_t t_us = 1000000U;
+    line_ring_init_shallow(LINE_RING_SIZE);
+    line_ring_race_init(2000);
+    for (uint32_t frame = 0; frame < 3U; frame++) {
+        line_ring_vsync_at(t_us);
+        line_ring_commit(LINES_PER_FRAME);
+        t_us += in_period_us;
+    }
+    const uint32_t last_complete = g_line_ring.frame_base_idx;
+    line_ring_vsync_at(t_us);
+
+    CHECK(line_ring_output_vsync_race(t_us + 500U) && g_line_ring.read_frame_start == g_line_ring.frame_base_idx,
+          "race stall: a frame base 0.5 ms old was not raced");
+    uint32_t stale = 0;
+    for (uint32_t out = 1; out <= 120U; out++) {
+        const bool raced = line_ring_output_vsync_race(t_us + 500U + (out * out_period_us));
+        if (raced || g_line_ring.read_frame_start != last_complete) {
+            stale++;
+        }
+    }
+    CHECK(stale == 0U, "race stall: %" PRIu32 " of 120 output frames during the outage left the last frame", stale);
+}
+
+int main(void)
+{
+    test_free_running();
+    test_fast_input();
+    test_50hz_input();
+    test_genlock();
+    test_shallow_ring();
+    test_race();
+    test_race_stall();
+
+    if (g_check_failures != 0U) {
+        fprintf(stderr, "\nFAIL: %u ring simulator checks failed.\n", g_check_failures);
+        return EXIT_FAILURE;
+    }
+    printf("PASS: line ring producer/consumer threads: free-running, fast input, 50 Hz, genlock, shallow rings, "
+           "racing.\n");
+    return EXIT_SUCCESS;
+}
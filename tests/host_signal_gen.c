@@ -0,0 +1,341 @@
+// Checks tests/host/signal_gen.c against the firmware: every encoded colour
+// decodes back through the capture-side wiring model, and a rendered frame
+// driven onto the emulated pads (tests/host/pio_emu.c) comes out of the
+// unmodified capture loop into the line ring unshifted, at the nominal rate
+// and at 60 Hz with PCLK and data jitter.
+
+#include <inttypes.h>
+#include <setjmp.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "line_ring.h"
+#include "pico_host.h"
+#include "pio_emu.h"
+#include "signal_gen.h"
+#include "test_frame.h"
+#include "video_capture.h"
+#include "video_config.h"
+
+#if NEOPICO_CAPTURE_TARGET == NEOPICO_CAPTURE_TARGET_MVS
+#include "mvs_color.h"
+#include "mvs_effect_lut.h"
+#endif
+
+static unsigned g_check_failures;
+
+#define CHECK(condition, ...)                                                                                          \
+    do {                                                                                                               \
+        if (!(condition)) {                                                                                            \
+            fprintf(stderr, "CHECK FAILED: ");                                                                         \
+            fprintf(stderr, __VA_ARGS__);                                                                              \
+            fputc('\n', stderr);                                                                                       \
+            g_check_failures++;                                                                                        \
+        }                                                                                                              \
+    } while (0)
+
+#define SYS_CLOCK_HZ 126000000U
+#define EMU_STEP_CYCLES 64U
+
+#if NEOPICO_CAPTURE_TARGET == NEOPICO_CAPTURE_TARGET_MVS
+#define SYSTEM SIGNAL_GEN_MVS
+#else
+#define SYSTEM SIGNAL_GEN_SNES
+// Mirror of the default in video_capture_snes.c.
+#define SNES_CAPTURE_WARMUP_FRAMES 60U
+#endif
+
+static uint8_t g_rgb[CAPTURE_ACTIVE_HEIGHT][CAPTURE_ACTIVE_WIDTH][3];
+static uint8_t g_effects[CAPTURE_ACTIVE_HEIGHT][CAPTURE_ACTIVE_WIDTH];
+#if NEOPICO_EXP_MVS_PACKED_CAPTURE
+static uint8_t g_shadow_lines[CAPTURE_ACTIVE_HEIGHT];
+#endif
+
+// The test picture with DARK on every seventh dot and SHADOW on every third
+// line: one dot of it, or the whole line with packed capture.
+static void make_effects_frame(signal_gen_frame_t *frame)
+{
+    make_test_frame(frame, g_rgb);
+    for (uint32_t y = 0; y < CAPTURE_ACTIVE_HEIGHT; y++) {
+        for (uint32_t x = 0; x < CAPTURE_ACTIVE_WIDTH; x++) {
+#if NEOPICO_EXP_MVS_PACKED_CAPTURE
+            g_effects[y][x] = (uint8_t)((x % 7U) == 0U ? SIGNAL_GEN_DARK : 0U);
+#else
+            g_effects[y][x] = (uint8_t)(((x % 7U) == 0U ? SIGNAL_GEN_DARK : 0U) |
+                                        ((y % 3U) == 0U && x == y ? SIGNAL_GEN_SHADOW : 0U));
+#endif
+        }
+#if NEOPICO_EXP_MVS_PACKED_CAPTURE
+        g_shadow_lines[y] = (uint8_t)((y % 3U) == 0U ? 1U : 0U);
+#endif
+    }
+    frame->effects = &g_effects[0][0];
+#if NEOPICO_EXP_MVS_PACKED_CAPTURE
+    // Packed capture reads SHADOW from its pin once per line, so drive it for
+    // whole lines, as the MVS does, instead of on single pixels.
+    frame->shadow_lines = g_shadow_lines;
+#endif
+}
+
+// =============================================================================
+// Colour encoding
+// =============================================================================
+
+#if NEOPICO_CAPTURE_TARGET == NEOPICO_CAPTURE_TARGET_MVS
+
+static void test_encode_roundtrip(void)
+{
+    uint32_t failures = 0;
+    for (uint32_t rgb = 0; rgb < 32768U; rgb++) {
+        const uint32_t r5 = (rgb >> 10) & 0x1FU;
+        const uint32_t g5 = (rgb >> 5) & 0x1FU;
+        const uint32_t b5 = rgb & 0x1FU;
+        for (uint8_t effects = 0; effects < 4U; effects++) {
+            const uint32_t word =
+                signal_gen_mvs_encode((uint8_t)(r5 << 3), (uint8_t)(g5 << 3), (uint8_t)((b5 << 3) | 7U), effects);
+            uint32_t r;
+            uint32_t g;
+            uint32_t b;
+            mvs_correct_color_idx((word >> 2) & 0x7FFFU, &r, &g, &b);
+            const bool shadow = ((word >> 17) & 1U) != 0U;
+            const bool dark = ((word >> 18) & 1U) != 0U;
+            if (r != r5 || g != g5 || b != b5 || (word & 3U) != 0U || (word >> 19) != 0U ||
+                shadow != ((effects & SIGNAL_GEN_SHADOW) != 0U) || dark != ((effects & SIGNAL_GEN_DARK) != 0U)) {
+                failures++;
+            }
+        }
+    }
+    CHECK(failures == 0U, "%" PRIu32 " MVS encodings do not decode back through mvs_correct_color_idx()", failures);
+}
+
+// Ring content for one raw word in the DARK/SHADOW RGB888 build.
+static uint16_t expected_ring_pixel(uint32_t raw)
+{
+    return mvs_entropy_pack_raw(raw);
+}
+
+#else
+
+static uint32_t reverse_5bit(uint32_t x)
+{
+    return ((x & 1U) << 4) | ((x & 2U) << 2) | (x & 4U) | ((x & 8U) >> 2) | ((x & 16U) >> 4);
+}
+
+static void test_encode_roundtrip(void)
+{
+    uint32_t failures = 0;
+    for (uint32_t rgb = 0; rgb < 32768U; rgb++) {
+        const uint32_t word = signal_gen_snes_encode((uint8_t)(((rgb >> 10) & 0x1FU) << 3),
+                                                     (uint8_t)(((rgb >> 5) & 0x1FU) << 3), (uint8_t)((rgb & 0x1FU) << 3));
+        const uint32_t idx = (word >> 2) & 0x7FFFU;
+        const uint32_t decoded =
+            (reverse_5bit((idx >> 10) & 0x1FU) << 10) | (reverse_5bit((idx >> 5) & 0x1FU) << 5) | reverse_5bit(idx & 0x1FU);
+        if (decoded != rgb || (word & ~(0x7FFFU << 2)) != 0U) {
+            failures++;
+        }
+    }
+    CHECK(failures == 0U, "%" PRIu32 " SNES encodings do not decode back through the SuperPico wiring", failures);
+}
+
+// RGB565 the SNES capture LUT produces for a source pixel.
+static uint16_t snes_rgb565(const uint8_t *rgb)
+{
+    const uint32_t r5 = rgb[0] >> 3;
+    const uint32_t g5 = rgb[1] >> 3;
+    const uint32_t b5 = rgb[2] >> 3;
+    return (uint16_t)((r5 << 11) | (g5 << 6) | (g5 >> 4) | b5);
+}
+
+#endif
+
+// =============================================================================
+// Pads -> PIO -> capture loop -> ring
+// =============================================================================
+
+typedef struct {
+    jmp_buf exit;
+    uint64_t cycle_limit;
+    uint64_t frame_cycles;
+    uint32_t gpio_waits;
+    bool timed_out;
+} capture_driver_t;
+
+static bool frame_committed(void)
+{
+    return g_line_ring.write_idx - g_line_ring.frame_base_idx >= SOURCE_HEIGHT;
+}
+
+static bool emu_wait_hook(pico_host_wait_reason_t reason, uint64_t deadline_us, void *ctx)
+{
+    capture_driver_t *drv = ctx;
+    (void)deadline_us;
+    if (frame_committed()) {
+        longjmp(drv->exit, 1);
+    }
+    if (pico_host_sys_cycles() >= drv->cycle_limit) {
+        drv->timed_out = true;
+        longjmp(drv->exit, 1);
+    }
+#if NEOPICO_CAPTURE_TARGET == NEOPICO_CAPTURE_TARGET_SNES
+    drv->gpio_waits += reason == PICO_HOST_WAIT_GPIO ? 1U : 0U;
+    // Warmup frames only wait for the VBLANK SM's IRQ while the pixel SM
+    // idles on IRQ 4; skip to a few lines before the next VBLANK fall and
+    // step the SMs only from there.
+    if (reason == PICO_HOST_WAIT_SEM && video_capture_get_frame_count() < SNES_CAPTURE_WARMUP_FRAMES) {
+        const uint64_t now = pico_host_sys_cycles();
+        const uint64_t next_fall = ((now / drv->frame_cycles) + 1U) * drv->frame_cycles;
+        const uint64_t resume = next_fall - (drv->frame_cycles / 64U);
+        if (now < resume) {
+            pico_host_advance_cycles(resume - now);
+            return true;
+        }
+    }
+#else
+    (void)reason;
+#endif
+    pio_emu_run(EMU_STEP_CYCLES);
+    return true;
+}
+
+static void capture_one_frame(const char *name, signal_gen_t *gen, uint32_t frames_allowed)
+{
+    static capture_driver_t drv;
+    memset(&drv, 0, sizeof drv);
+
+    pico_host_reset();
+    pico_host_set_sys_clock_hz(SYS_CLOCK_HZ);
+    pico_host_set_pin_source(signal_gen_pin_levels, gen);
+    memset(&g_line_ring, 0, sizeof g_line_ring);
+    line_ring_init();
+    video_capture_init(SOURCE_HEIGHT);
+
+    drv.frame_cycles = (signal_gen_frame_dots(&gen->timing) * SYS_CLOCK_HZ) / gen->timing.dot_clock_hz;
+    drv.cycle_limit = drv.frame_cycles * frames_allowed;
+    pico_host_set_wait_hook(emu_wait_hook, &drv);
+    if (setjmp(drv.exit) == 0) {
+        video_capture_run();
+    }
+    pico_host_set_wait_hook(NULL, NULL);
+    pico_host_set_pin_source(NULL, NULL);
+
+    CHECK(!drv.timed_out && frame_committed(), "%s: no frame committed within %" PRIu32 " source frames", name,
+          frames_allowed);
+#if NEOPICO_CAPTURE_TARGET == NEOPICO_CAPTURE_TARGET_SNES
+    // VBLANK reaches Core 0 through the VBLANK SM's IRQ, never by polling.
+    CHECK(drv.gpio_waits == 0U, "%s: Core 0 polled a pin %" PRIu32 " times", name, drv.gpio_waits);
+#endif
+    if (!frame_committed()) {
+        return;
+    }
+
+    const signal_gen_timing_t *t = &gen->timing;
+    const signal_gen_frame_t *frame = &gen->frames[0];
+    uint32_t mismatches = 0;
+    uint32_t shadow_mismatches = 0;
+    for (uint32_t y = 0; y < SOURCE_HEIGHT; y++) {
+        const uint16_t *ring_line = g_line_ring.lines[LINE_RING_SLOT(g_line_ring.frame_base_idx + y)];
+#if NEOPICO_CAPTURE_TARGET == NEOPICO_CAPTURE_TARGET_MVS
+        uint32_t want_shadow = 0;
+        for (uint32_t x = 0; x < t->active_width; x++) {
+            const uint32_t raw = signal_gen_word(gen, ((uint64_t)(t->active_y + y) * t->h_total) + t->active_x + x);
+            want_shadow |= (raw >> 17) & 1U;
+            const uint16_t want = expected_ring_pixel(raw);
+            if (ring_line[x] != want && mismatches++ < 4U) {
+                fprintf(stderr, "  %s: line %" PRIu32 " x %" PRIu32 ": ring 0x%04x want 0x%04x\n", name, y, x,
+                        ring_line[x], want);
+            }
+        }
+        const uint32_t ring_shadow = g_line_ring.line_shadow[LINE_RING_SLOT(g_line_ring.frame_base_idx + y)];
+        if (ring_shadow != want_shadow) {
+            shadow_mismatches++;
+        }
+#else
+        (void)t;
+        for (uint32_t x = 0; x < CAPTURE_FRAME_WIDTH; x++) {
+            const bool active = x >= CAPTURE_ACTIVE_X_OFFSET && x < CAPTURE_ACTIVE_X_OFFSET + CAPTURE_ACTIVE_WIDTH;
+            const uint16_t want =
+                active ? snes_rgb565(&frame->rgb[(((size_t)y * frame->width) + x - CAPTURE_ACTIVE_X_OFFSET) * 3U])
+                       : 0U;
+            if (ring_line[x] != want && mismatches++ < 4U) {
+                fprintf(stderr, "  %s: line %" PRIu32 " x %" PRIu32 ": ring 0x%04x want 0x%04x\n", name, y, x,
+                        ring_line[x], want);
+            }
+        }
+#endif
+    }
+    (void)frame;
+    CHECK(mismatches == 0U, "%s: %" PRIu32 " ring pixels differ from the rendered frame", name, mismatches);
+    CHECK(shadow_mismatches == 0U, "%s: %" PRIu32 " ring lines carry the wrong SHADOW latch", name,
+          shadow_mismatches);
+}
+
+static void test_capture_nominal(const signal_gen_frame_t *frame)
+{
+    static signal_gen_t gen;
+    signal_gen_init(&gen, SYSTEM, SYS_CLOCK_HZ);
+    gen.frames = frame;
+    gen.frame_count = 1;
+#if NEOPICO_CAPTURE_TARGET == NEOPICO_CAPTURE_TARGET_MVS
+    capture_one_frame("nominal", &gen, 4U);
+#else
+    capture_one_frame("nominal", &gen, SNES_CAPTURE_WARMUP_FRAMES + 3U);
+#endif
+}
+
+static void test_capture_jittered(const signal_gen_frame_t *frame)
+{
+    static signal_gen_t gen;
+    signal_gen_init(&gen, SYSTEM, SYS_CLOCK_HZ);
+    signal_gen_set_frame_rate(&gen.timing, 60.0);
+    gen.lead = (SYS_CLOCK_HZ / gen.timing.dot_clock_hz) / 2U;
+    // At ~20.7 cycles per PCLK the tightest limit is at the end of each line:
+    // `wait 0 pin 0` after the last sample must still see CSYNC low, which
+    // leaves about 4 cycles for two edge displacements plus one skew. Beyond
+    // that the pixel SM misses the next line start and the frame slips a line.
+    gen.edge_jitter = 1U;
+    gen.skew_jitter = 2U;
+    gen.jitter_seed = 7U;
+    gen.frames = frame;
+    gen.frame_count = 1;
+
+    // Inside the PIO's launch window the sampled words are the ideal ones.
+    uint32_t disturbed = 0;
+    for (uint64_t dot = 0; dot < signal_gen_frame_dots(&gen.timing); dot++) {
+        disturbed += signal_gen_sample_word(&gen, dot) != signal_gen_word(&gen, dot) ? 1U : 0U;
+    }
+    CHECK(disturbed == 0U, "60 Hz, jitter inside the window: %" PRIu32 " sampled words disturbed", disturbed);
+
+#if NEOPICO_CAPTURE_TARGET == NEOPICO_CAPTURE_TARGET_MVS
+    capture_one_frame("60 Hz jittered", &gen, 4U);
+#else
+    capture_one_frame("60 Hz jittered", &gen, SNES_CAPTURE_WARMUP_FRAMES + 3U);
+#endif
+
+    // Launches pushed past the sample point must show up as wrong words.
+    gen.skew_jitter = gen.lead + 2U;
+    disturbed = 0;
+    for (uint64_t dot = 0; dot < signal_gen_frame_dots(&gen.timing); dot++) {
+        disturbed += signal_gen_sample_word(&gen, dot) != signal_gen_word(&gen, dot) ? 1U : 0U;
+    }
+    CHECK(disturbed > 0U, "skew jitter beyond the sample point left every sampled word intact");
+}
+
+int main(void)
+{
+    static signal_gen_frame_t frame;
+    make_effects_frame(&frame);
+
+    test_encode_roundtrip();
+    test_capture_nominal(&frame);
+    test_capture_jittered(&frame);
+
+    if (g_check_failures != 0U) {
+        fprintf(stderr, "\nFAIL: %u signal generator checks failed.\n", g_check_failures);
+        return EXIT_FAILURE;
+    }
+    printf("PASS: %s signal generator frames capture unshifted through the emulated pads.\n", CAPTURE_TARGET_NAME);
+    return EXIT_SUCCESS;
+}
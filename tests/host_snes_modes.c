@@ -0,0 +1,331 @@
+// Checks the SNES capture's mode handling end to end with hires capture on
+// (NEOPICO_EXP_SNES_HIRES_CAPTURE): synthetic sources driven onto the
+// emulated pads (tests/host/pio_emu.c) through the unmodified capture loop.
+// A 512-dot frame with one hires line in three must land in the ring as each
+// dot pair's 2:1 average and count exactly those lines; the same picture at
+// 256 dots must land as it is and count none. Either way the border columns
+// must hold the colour line_ring_init() painted. An interlaced source, whose
+// fields alternate one line long and short, must be reported interlaced with
+// alternating fields; the progressive ones must not. A 312-line PAL source
+// must be reported as 50 Hz once its VBLANK periods have held for
+// VIDEO_STANDARD_CONFIRM_FRAMES fields, and the 262/263-line NTSC ones as
+// 60 Hz.
+//
+// Built for the SNES hires flag set.
+
+#include <inttypes.h>
+#include <setjmp.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "line_ring.h"
+#include "pico_host.h"
+#include "pio_emu.h"
+#include "signal_gen.h"
+#include "video_capture.h"
+#include "video_config.h"
+
+static unsigned g_check_failures;
+
+#define CHECK(condition, ...)                                                                                          \
+    do {                                                                                                               \
+        if (!(condition)) {                                                                                            \
+            fprintf(stderr, "CHECK FAILED: ");                                                                         \
+            fprintf(stderr, __VA_ARGS__);                                                                              \
+            fputc('\n', stderr);                                                                                       \
+            g_check_failures++;                                                                                        \
+        }                                                                                                              \
+    } while (0)
+
+#define SYS_CLOCK_HZ 126000000U
+#define EMU_STEP_CYCLES 64U
+// Mirror of the default in video_capture_snes.c.
+#define SNES_CAPTURE_WARMUP_FRAMES 60U
+// Detection takes SNES_INTERLACE_FIELDS alternations after a first step, so
+// fields are reported from the sixth on.
+#define INTERLACED_FRAMES 10U
+#define INTERLACED_DETECT_FRAMES 6U
+// The first VBLANK period after init has no edge before it.
+#define PAL_FRAMES (VIDEO_STANDARD_CONFIRM_FRAMES + 2U)
+
+#define WIDTH CAPTURE_ACTIVE_WIDTH
+#define HEIGHT CAPTURE_ACTIVE_HEIGHT
+
+static uint8_t g_hires_rgb[HEIGHT][2U * WIDTH][3];
+static uint8_t g_lores_rgb[HEIGHT][WIDTH][3];
+
+static bool hires_line(uint32_t y)
+{
+    return y % 3U == 0U;
+}
+
+// One picture twice: 512 dots wide, where only the hires lines have two
+// different pixels per dot, and 256 wide with each dot's first pixel.
+static void make_test_frames(signal_gen_frame_t *hires, signal_gen_frame_t *lores)
+{
+    for (uint32_t y = 0; y < HEIGHT; y++) {
+        for (uint32_t fx = 0; fx < 2U * WIDTH; fx++) {
+            const uint32_t source_x = hires_line(y) ? fx : fx & ~1U;
+            uint32_t h = (y * 0x9E3779B1U) ^ (source_x * 0x85EBCA77U);
+            h ^= h >> 15;
+            h *= 0x2C1B3C6DU;
+            g_hires_rgb[y][fx][0] = (uint8_t)h;
+            g_hires_rgb[y][fx][1] = (uint8_t)(h >> 8);
+            g_hires_rgb[y][fx][2] = (uint8_t)(h >> 16);
+        }
+        for (uint32_t x = 0; x < WIDTH; x++) {
+            memcpy(g_lores_rgb[y][x], g_hires_rgb[y][2U * x], 3U);
+        }
+    }
+    hires->width = 2U * WIDTH;
+    hires->height = HEIGHT;
+    hires->rgb = &g_hires_rgb[0][0][0];
+    lores->width = WIDTH;
+    lores->height = HEIGHT;
+    lores->rgb = &g_lores_rgb[0][0][0];
+}
+
+static uint16_t snes_rgb565(const uint8_t *rgb)
+{
+    const uint32_t r5 = rgb[0] >> 3;
+    const uint32_t g5 = rgb[1] >> 3;
+    const uint32_t b5 = rgb[2] >> 3;
+    return (uint16_t)((r5 << 11) | (g5 << 6) | (g5 >> 4) | b5);
+}
+
+// Per channel, rounded down, as the capture averages RGB565.
+static uint16_t average565(uint16_t a, uint16_t b)
+{
+    const uint32_t r = (((a >> 11) & 0x1FU) + ((b >> 11) & 0x1FU)) / 2U;
+    const uint32_t g = (((a >> 5) & 0x3FU) + ((b >> 5) & 0x3FU)) / 2U;
+    const uint32_t bl = ((a & 0x1FU) + (b & 0x1FU)) / 2U;
+    return (uint16_t)((r << 11) | (g << 5) | bl);
+}
+
+typedef struct {
+    jmp_buf exit;
+    const signal_gen_timing_t *timing;
+    uint64_t frame_cycles;
+    uint64_t cycle_limit;
+    uint32_t frames_wanted;
+    uint32_t last_frames;
+    uint32_t fields_seen;
+    uint8_t fields[INTERLACED_FRAMES];
+    bool timed_out;
+} capture_driver_t;
+
+// Warmup frames only wait for the VBLANK SM's IRQ: skip to a few lines
+// before the next VBLANK fall, interlaced fields included.
+static bool skip_to_vblank(const capture_driver_t *drv)
+{
+    const signal_gen_timing_t *t = drv->timing;
+    const uint64_t now = pico_host_sys_cycles();
+    const uint64_t dot = (now * t->dot_clock_hz) / SYS_CLOCK_HZ;
+    uint64_t frame = dot / signal_gen_frame_dots(t);
+    while (signal_gen_frame_start(t, frame) <= dot) {
+        frame++;
+    }
+    // Not in the line after a fall: the VBLANK SM may not have seen it yet,
+    // and a missed edge would double the field period.
+    if (dot < signal_gen_frame_start(t, frame - 1U) + t->h_total) {
+        return false;
+    }
+    const uint64_t fall = (signal_gen_frame_start(t, frame) * SYS_CLOCK_HZ) / t->dot_clock_hz;
+    const uint64_t resume = fall - (drv->frame_cycles / 64U);
+    if (now >= resume) {
+        return false;
+    }
+    pico_host_advance_cycles(resume - now);
+    return true;
+}
+
+static bool emu_wait_hook(pico_host_wait_reason_t reason, uint64_t deadline_us, void *ctx)
+{
+    capture_driver_t *drv = ctx;
+    (void)deadline_us;
+    video_capture_snes_mode_t mode;
+    video_capture_get_snes_mode(&mode);
+    if (mode.frames != drv->last_frames) {
+        drv->last_frames = mode.frames;
+        if (mode.interlaced && drv->fields_seen < INTERLACED_FRAMES) {
+            drv->fields[drv->fields_seen++] = mode.field;
+        }
+        if (mode.frames >= drv->frames_wanted) {
+            longjmp(drv->exit, 1);
+        }
+    }
+    if (pico_host_sys_cycles() >= drv->cycle_limit) {
+        drv->timed_out = true;
+        longjmp(drv->exit, 1);
+    }
+    if (reason == PICO_HOST_WAIT_SEM && video_capture_get_frame_count() < SNES_CAPTURE_WARMUP_FRAMES &&
+        skip_to_vblank(drv)) {
+        return true;
+    }
+    pio_emu_run(EMU_STEP_CYCLES);
+    return true;
+}
+
+// Runs the capture until `frames` complete frames past warmup; returns the
+// mode it reports then.
+static video_capture_snes_mode_t capture(const char *name, signal_gen_t *gen, uint32_t frames,
+                                         capture_driver_t *drv)
+{
+    memset(drv, 0, sizeof *drv);
+    drv->timing = &gen->timing;
+    drv->frame_cycles = (signal_gen_frame_dots(&gen->timing) * SYS_CLOCK_HZ) / gen->timing.dot_clock_hz;
+    drv->cycle_limit = drv->frame_cycles * (SNES_CAPTURE_WARMUP_FRAMES + frames + 3U);
+    drv->frames_wanted = frames;
+
+    pico_host_reset();
+    pico_host_set_sys_clock_hz(SYS_CLOCK_HZ);
+    pico_host_set_pin_source(signal_gen_pin_levels, gen);
+    memset(&g_line_ring, 0, sizeof g_line_ring);
+    // Capture writes only the active window; the border must come from
+    // line_ring_init(), not from whatever the ring held before.
+    memset(g_line_ring.lines, 0xA5, sizeof g_line_ring.lines);
+    line_ring_init();
+    video_capture_init(SOURCE_HEIGHT);
+
+    pico_host_set_wait_hook(emu_wait_hook, drv);
+    if (setjmp(drv->exit) == 0) {
+        video_capture_run();
+    }
+    pico_host_set_wait_hook(NULL, NULL);
+    pico_host_set_pin_source(NULL, NULL);
+
+    video_capture_snes_mode_t mode;
+    video_capture_get_snes_mode(&mode);
+    CHECK(!drv->timed_out, "%s: %" PRIu32 " of %" PRIu32 " frames captured", name, mode.frames, frames);
+    return mode;
+}
+
+// The ring's last frame against the picture: averaged dot pairs for `hires`.
+static uint32_t ring_mismatches(const char *name, const signal_gen_frame_t *frame)
+{
+    const bool hires = frame->width == 2U * WIDTH;
+    uint32_t mismatches = 0;
+    for (uint32_t y = 0; y < SOURCE_HEIGHT; y++) {
+        const uint16_t *ring_line = g_line_ring.lines[LINE_RING_SLOT(g_line_ring.frame_base_idx + y)];
+        for (uint32_t x = 0; x < WIDTH; x++) {
+            const uint8_t *rgb = &frame->rgb[(((size_t)y * frame->width) + (hires ? 2U * x : x)) * 3U];
+            const uint16_t want = hires ? average565(snes_rgb565(rgb), snes_rgb565(rgb + 3)) : snes_rgb565(rgb);
+            const uint16_t got = ring_line[LINE_ACTIVE_X + x];
+            if (got != want && mismatches++ < 4U) {
+                fprintf(stderr, "  %s: line %" PRIu32 " x %" PRIu32 ": ring 0x%04x want 0x%04x\n", name, y, x, got,
+                        want);
+            }
+        }
+        for (uint32_t x = 0; x < LINE_WIDTH; x++) {
+            const bool border = x < LINE_ACTIVE_X || x >= LINE_ACTIVE_X + LINE_ACTIVE_WIDTH;
+            if (border && ring_line[x] != LINE_BORDER_COLOR && mismatches++ < 4U) {
+                fprintf(stderr, "  %s: line %" PRIu32 " border x %" PRIu32 ": ring 0x%04x\n", name, y, x,
+                        ring_line[x]);
+            }
+        }
+    }
+    return mismatches;
+}
+
+static void check_hires(const signal_gen_frame_t *hires, const signal_gen_frame_t *lores)
+{
+    static signal_gen_t gen;
+    static capture_driver_t drv;
+    uint32_t want_lines = 0;
+    for (uint32_t y = 0; y < SOURCE_HEIGHT; y++) {
+        want_lines += hires_line(y) ? 1U : 0U;
+    }
+
+    signal_gen_init(&gen, SIGNAL_GEN_SNES, SYS_CLOCK_HZ);
+    gen.frames = hires;
+    gen.frame_count = 1;
+    video_capture_snes_mode_t mode = capture("hires", &gen, 1U, &drv);
+    uint32_t mismatches = ring_mismatches("hires", hires);
+    CHECK(mismatches == 0U, "hires: %" PRIu32 " ring pixels are not their dot pair's average", mismatches);
+    CHECK(mode.hires_lines == want_lines && mode.hires_frames == 1U,
+          "hires: %u hires lines in %" PRIu32 " frames, want %" PRIu32 " in 1", (unsigned)mode.hires_lines,
+          mode.hires_frames, want_lines);
+    CHECK(!mode.interlaced, "hires: a progressive source reported interlaced");
+    printf("hires       %u of %u lines hires, stored 2:1 averaged\n", (unsigned)mode.hires_lines, SOURCE_HEIGHT);
+
+    gen.frames = lores;
+    mode = capture("lores", &gen, 1U, &drv);
+    mismatches = ring_mismatches("lores", lores);
+    CHECK(mismatches == 0U, "lores: %" PRIu32 " ring pixels differ from the source", mismatches);
+    CHECK(mode.hires_lines == 0U && mode.hires_frames == 0U, "lores: %u hires lines counted",
+          (unsigned)mode.hires_lines);
+    printf("lores       no hires lines, stored as captured\n");
+}
+
+static void check_interlace(const signal_gen_frame_t *lores)
+{
+    static signal_gen_t gen;
+    static capture_driver_t drv;
+    signal_gen_init(&gen, SIGNAL_GEN_SNES, SYS_CLOCK_HZ);
+    gen.timing.interlace = true;
+    gen.frames = lores;
+    gen.frame_count = 1;
+    const video_capture_snes_mode_t mode = capture("interlaced", &gen, INTERLACED_FRAMES, &drv);
+    CHECK(mode.interlaced && drv.fields_seen >= INTERLACED_FRAMES - INTERLACED_DETECT_FRAMES,
+          "interlaced: reported for %" PRIu32 " of %u fields", drv.fields_seen, INTERLACED_FRAMES);
+
+    uint32_t alternations = 0;
+    for (uint32_t i = 1; i < drv.fields_seen; i++) {
+        alternations += drv.fields[i] != drv.fields[i - 1U] ? 1U : 0U;
+    }
+    CHECK(drv.fields_seen != 0U && alternations == drv.fields_seen - 1U,
+          "interlaced: fields alternated %" PRIu32 " times over %" PRIu32 " frames", alternations, drv.fields_seen);
+    const uint32_t mismatches = ring_mismatches("interlaced", lores);
+    CHECK(mismatches == 0U, "interlaced: %" PRIu32 " ring pixels differ from the source", mismatches);
+    printf("interlaced  detected, fields alternate over %" PRIu32 " frames, last %" PRIu32 " us\n", drv.fields_seen,
+           mode.field_us);
+
+    uint16_t lines = 0;
+    const video_standard_t standard = video_capture_get_standard(&lines);
+    CHECK(standard == VIDEO_STANDARD_60HZ && (lines == 262U || lines == 263U),
+          "interlaced: reported %s with %u lines per field", standard == VIDEO_STANDARD_50HZ ? "50 Hz" : "60 Hz",
+          (unsigned)lines);
+}
+
+static void check_50hz(const signal_gen_frame_t *lores)
+{
+    static signal_gen_t gen;
+    static capture_driver_t drv;
+    signal_gen_init(&gen, SIGNAL_GEN_SNES, SYS_CLOCK_HZ);
+    signal_gen_set_50hz(&gen.timing);
+    gen.frames = lores;
+    gen.frame_count = 1;
+    const video_capture_snes_mode_t mode = capture("50 Hz", &gen, PAL_FRAMES, &drv);
+
+    // VBLANK periods are counted in NTSC lines, 1% shorter than PAL ones.
+    uint16_t lines = 0;
+    const video_standard_t standard = video_capture_get_standard(&lines);
+    CHECK(standard == VIDEO_STANDARD_50HZ && lines >= gen.timing.v_total && lines <= gen.timing.v_total + 4U,
+          "50 Hz: reported %s with %u lines per frame", standard == VIDEO_STANDARD_50HZ ? "50 Hz" : "60 Hz",
+          (unsigned)lines);
+    CHECK(!mode.interlaced, "50 Hz: a progressive source reported interlaced");
+    const uint32_t mismatches = ring_mismatches("50 Hz", lores);
+    CHECK(mismatches == 0U, "50 Hz: %" PRIu32 " ring pixels differ from the source", mismatches);
+    printf("50 Hz       detected from a %" PRIu32 " us VBLANK period, %u lines\n", mode.field_us, (unsigned)lines);
+}
+
+int main(void)
+{
+    static signal_gen_frame_t hires;
+    static signal_gen_frame_t lores;
+    make_test_frames(&hires, &lores);
+
+    check_hires(&hires, &lores);
+    check_interlace(&lores);
+    check_50hz(&lores);
+
+    if (g_check_failures != 0U) {
+        fprintf(stderr, "\nFAIL: %u SNES mode checks failed.\n", g_check_failures);
+        return EXIT_FAILURE;
+    }
+    printf("PASS: SNES hires lines are averaged and counted, and interlace and 50 Hz are detected.\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,92 @@
+// Checks the SNES capture conversion exhaustively: every RGB555 value, with
+// noise in the capture bits around it, through convert_active_pixels() against
+// a reference built from the SuperPico wiring (each channel bit-reversed), bit
+// for bit. Built once per SNES conversion: register-only RBIT (shipped), the
+// RGB565 table, and the table through the interpolators (tests/CMakeLists.txt).
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench_kernels.h"
+#include "capture_line.h"
+
+static unsigned g_check_failures;
+
+#define CHECK(condition, ...)                                                                                          \
+    do {                                                                                                               \
+        if (!(condition)) {                                                                                            \
+            fprintf(stderr, "CHECK FAILED: ");                                                                         \
+            fprintf(stderr, __VA_ARGS__);                                                                              \
+            fputc('\n', stderr);                                                                                       \
+            g_check_failures++;                                                                                        \
+        }                                                                                                              \
+    } while (0)
+
+// Mirror of CAPTURE_ACTIVE_WIDTH for the SNES target.
+#define LINE_PIXELS 256U
+#define COLOR_VALUES 32768U
+
+static uint32_t reverse5(uint32_t x)
+{
+    uint32_t reversed = 0;
+    for (uint32_t bit = 0; bit < 5U; bit++) {
+        reversed |= ((x >> bit) & 1U) << (4U - bit);
+    }
+    return reversed;
+}
+
+// Raw bits 16:2 are B, G, R from the low end, each MSB first.
+static uint16_t reference_pixel(uint32_t raw)
+{
+    const uint32_t color = (raw >> 2) & 0x7FFFU;
+    const uint32_t b5 = reverse5(color & 0x1FU);
+    const uint32_t g5 = reverse5((color >> 5) & 0x1FU);
+    const uint32_t r5 = reverse5((color >> 10) & 0x1FU);
+    return (uint16_t)((r5 << 11) | (g5 << 6) | (g5 >> 4) | b5);
+}
+
+int main(void)
+{
+    static uint32_t raw[LINE_PIXELS];
+    static uint16_t got[LINE_PIXELS];
+
+    bench_capture_prepare();
+
+    uint32_t mismatches = 0;
+    uint32_t hash_mismatches = 0;
+    for (uint32_t first = 0; first < COLOR_VALUES; first += LINE_PIXELS) {
+        for (uint32_t x = 0; x < LINE_PIXELS; x++) {
+            const uint32_t color = first + x;
+            // Capture bits 1:0 and 17 (HBLANK), and junk above the capture
+            // width, must not reach the pixel.
+            const uint32_t noise = (color * 0x9E3779B1U) & 0xFFFC0003U;
+            raw[x] = (color << 2) | noise | ((x & 1U) << 17);
+        }
+        bench_convert_active_pixels(got, raw, (int)LINE_PIXELS);
+        for (uint32_t x = 0; x < LINE_PIXELS; x++) {
+            const uint16_t want = reference_pixel(raw[x]);
+            if (got[x] != want && mismatches++ < 4U) {
+                fprintf(stderr, "  raw 0x%08" PRIx32 ": 0x%04x, reference 0x%04x\n", raw[x], got[x], want);
+            }
+        }
+        hash_mismatches += bench_capture_line_hash() != capture_hash_line(got, (int)LINE_PIXELS) ? 1U : 0U;
+    }
+    CHECK(mismatches == 0U, "%" PRIu32 " of %u colours differ from the reference", mismatches, COLOR_VALUES);
+    CHECK(hash_mismatches == 0U, "%" PRIu32 " lines return a hash other than their pixels'", hash_mismatches);
+
+    // A length that ends off the four-pixel stride.
+    got[7] = 0xFFFFU;
+    bench_convert_active_pixels(got, raw, 7);
+    CHECK(got[6] == reference_pixel(raw[6]) && got[7] == 0xFFFFU, "odd line length");
+    CHECK(bench_capture_line_hash() == capture_hash_line(got, 7), "odd line length hash");
+
+    if (g_check_failures != 0U) {
+        fprintf(stderr, "\nFAIL: %u SNES pixel checks failed.\n", g_check_failures);
+        return EXIT_FAILURE;
+    }
+    printf("PASS: all %u SNES colours convert bit for bit.\n", COLOR_VALUES);
+    return EXIT_SUCCESS;
+}
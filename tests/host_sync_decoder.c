@@ -0,0 +1,467 @@
+// Checks the MVS sync decoder (src/video/mvs_sync_decoder.h) on the pulse
+// stream the sync SM reports for the signal_gen raster: clean, it must take
+// every frame at the second normal line after the vertical interval and
+// histogram the three pulse lengths. Then it replays the same stream with one
+// corrupted pulse at a time -- split by a CSYNC spike, run into its
+// neighbour, dropped, or replaced by noise -- and no single bad pulse may add
+// a vsync or lose one. The decoder this replaced (8 shorts, then the next two
+// long pulses) is run over the same trials for comparison. Every vsync must
+// also count the lines of the frame it ends, 264 here and 312 in the 50 Hz
+// raster, and the rate detector (src/video/video_standard.h) fed those counts
+// must move to 50 Hz and back only after a run of frames at the new rate.
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mvs_sync_decoder.h"
+#include "signal_gen.h"
+#include "video_standard.h"
+
+static unsigned g_check_failures;
+
+#define CHECK(condition, ...)                                                                                          \
+    do {                                                                                                               \
+        if (!(condition)) {                                                                                            \
+            fprintf(stderr, "CHECK FAILED: ");                                                                         \
+            fprintf(stderr, __VA_ARGS__);                                                                              \
+            fputc('\n', stderr);                                                                                       \
+            g_check_failures++;                                                                                        \
+        }                                                                                                              \
+    } while (0)
+
+#define STREAM_FRAMES 6U
+#define MAX_PULSES (STREAM_FRAMES * 330U)
+#define MAX_VSYNCS 16U
+#define FUZZ_TRIALS 20000U
+
+// A vsync may come this many pulses late when the glitch hits one of the
+// pulses that confirm it; never early, never twice, never not at all.
+#define MAX_LATE_PULSES 2U
+
+typedef struct {
+    uint32_t h_ctr; // as the sync SM reports it: PCLKs high, plus one
+    uint32_t low;   // PCLKs low after it
+    uint32_t src;   // index of the clean pulse it came from
+} pulse_t;
+
+typedef struct {
+    pulse_t pulses[MAX_PULSES + 1U];
+    uint32_t count;
+} pulse_stream_t;
+
+typedef struct {
+    uint32_t src[MAX_VSYNCS];
+    uint32_t count;
+} vsync_list_t;
+
+static signal_gen_t g_gen;
+static signal_gen_t g_gen_50hz;
+static pulse_stream_t g_clean;
+static pulse_stream_t g_clean_50hz;
+static vsync_list_t g_clean_vsyncs;
+static uint32_t g_clean_lines; // normal-line pulses in the clean stream
+
+// =============================================================================
+// Pulse streams
+// =============================================================================
+
+// The sync SM's view of STREAM_FRAMES frames of raw words: one count per
+// CSYNC high period, pushed when CSYNC falls. The stream starts on the
+// rising edge that opens frame 0, as after a restart.
+static void extract_pulses(const signal_gen_t *gen, pulse_stream_t *out)
+{
+    const uint64_t dots = signal_gen_frame_dots(&gen->timing) * STREAM_FRAMES;
+    uint32_t high = 0;
+    uint32_t low = 0;
+    bool level = false;
+    out->count = 0;
+    for (uint64_t dot = 0; dot < dots; dot++) {
+        const bool csync = (signal_gen_word(gen, dot) & 1U) != 0U;
+        if (csync && !level && out->count > 0U) {
+            out->pulses[out->count - 1U].low = low;
+        }
+        if (csync) {
+            if (!level) {
+                high = 0;
+                low = 0;
+            }
+            high++;
+        } else {
+            if (level && out->count < MAX_PULSES) {
+                out->pulses[out->count] = (pulse_t){high + 1U, 0U, out->count};
+                out->count++;
+            }
+            low++;
+        }
+        level = csync;
+    }
+}
+
+static void decode(const pulse_stream_t *stream, vsync_list_t *vsyncs, mvs_sync_decoder_t *dec)
+{
+    mvs_sync_decoder_init(dec);
+    vsyncs->count = 0;
+    for (uint32_t i = 0; i < stream->count; i++) {
+        if (mvs_sync_decoder_push(dec, stream->pulses[i].h_ctr) && vsyncs->count < MAX_VSYNCS) {
+            vsyncs->src[vsyncs->count++] = stream->pulses[i].src;
+        }
+    }
+}
+
+// sync_irq_handler() before the decoder: a long pulse after at least eight
+// short ones arms it, the next long pulse releases the frame.
+static void decode_legacy(const pulse_stream_t *stream, vsync_list_t *vsyncs)
+{
+    uint32_t equ_count = 0;
+    bool in_vsync = false;
+    vsyncs->count = 0;
+    for (uint32_t i = 0; i < stream->count; i++) {
+        const bool is_short = stream->pulses[i].h_ctr <= MVS_SYNC_SHORT_MAX;
+        if (is_short) {
+            equ_count++;
+        } else if (in_vsync) {
+            equ_count = 0;
+            in_vsync = false;
+            if (vsyncs->count < MAX_VSYNCS) {
+                vsyncs->src[vsyncs->count++] = stream->pulses[i].src;
+            }
+        } else {
+            in_vsync = equ_count >= 8U;
+            equ_count = 0;
+        }
+    }
+}
+
+// =============================================================================
+// Clean stream
+// =============================================================================
+
+static void test_clean_stream(void)
+{
+    const signal_gen_timing_t *t = &g_gen.timing;
+    // The second normal line after the interval.
+    const uint32_t vsync_line = (2U * t->eq_lines) + t->serration_lines + 1U;
+    const uint32_t interval_lines = (2U * t->eq_lines) + t->serration_lines;
+
+    mvs_sync_decoder_t dec;
+    decode(&g_clean, &g_clean_vsyncs, &dec);
+
+    CHECK(g_clean_vsyncs.count == STREAM_FRAMES, "%" PRIu32 " vsyncs in %u frames", g_clean_vsyncs.count,
+          STREAM_FRAMES);
+    // Pulses per frame: the normal lines, two per interval line.
+    const uint32_t frame_pulses = (t->v_total - interval_lines) + (2U * interval_lines);
+    for (uint32_t f = 0; f < g_clean_vsyncs.count && f < STREAM_FRAMES; f++) {
+        const uint32_t want = (f * frame_pulses) + (2U * interval_lines) + (vsync_line - interval_lines);
+        CHECK(g_clean_vsyncs.src[f] == want, "frame %" PRIu32 ": vsync at pulse %" PRIu32 ", want %" PRIu32, f,
+              g_clean_vsyncs.src[f], want);
+    }
+    CHECK(dec.glitches == 0U && dec.absorbed == 0U && dec.early == 0U,
+          "clean stream: %" PRIu32 " glitches, %" PRIu32 " absorbed, %" PRIu32 " early", dec.glitches, dec.absorbed,
+          dec.early);
+    CHECK(dec.frame_lines == t->v_total, "clean stream: last frame counted %" PRIu32 " lines, want %" PRIu32,
+          dec.frame_lines, t->v_total);
+
+    // Normal lines, equalization half-lines, serration half-lines.
+    const uint32_t line_bucket = (t->hsync_high + 1U) / MVS_SYNC_HIST_BUCKET_PCLKS;
+    const uint32_t eq_bucket = ((t->h_total / 2U) - t->eq_pulse + 1U) / MVS_SYNC_HIST_BUCKET_PCLKS;
+    const uint32_t serration_bucket = (t->eq_pulse + 1U) / MVS_SYNC_HIST_BUCKET_PCLKS;
+    g_clean_lines = STREAM_FRAMES * (t->v_total - interval_lines);
+    CHECK(dec.hist[line_bucket] == g_clean_lines, "line bucket %" PRIu32 " holds %" PRIu32 ", want %" PRIu32,
+          line_bucket, dec.hist[line_bucket], g_clean_lines);
+    CHECK(dec.hist[eq_bucket] == STREAM_FRAMES * 4U * t->eq_lines, "equalization bucket holds %" PRIu32,
+          dec.hist[eq_bucket]);
+    CHECK(dec.hist[serration_bucket] == STREAM_FRAMES * 2U * t->serration_lines, "serration bucket holds %" PRIu32,
+          dec.hist[serration_bucket]);
+    uint32_t total = 0;
+    for (uint32_t b = 0; b < MVS_SYNC_HIST_BUCKETS; b++) {
+        total += dec.hist[b];
+    }
+    CHECK(total == g_clean.count, "histogram holds %" PRIu32 " pulses, %" PRIu32 " pushed", total, g_clean.count);
+
+    vsync_list_t legacy;
+    decode_legacy(&g_clean, &legacy);
+    CHECK(legacy.count == g_clean_vsyncs.count && memcmp(legacy.src, g_clean_vsyncs.src,
+                                                         legacy.count * sizeof legacy.src[0]) == 0,
+          "the decoder must take the clean raster where the old one did");
+}
+
+// =============================================================================
+// Single-pulse faults
+// =============================================================================
+
+typedef enum {
+    FAULT_SPLIT,   // a CSYNC low spike inside the high period
+    FAULT_MERGE,   // the low period lost: the pulse runs into the next
+    FAULT_DROP,    // the count never reaches the IRQ
+    FAULT_NOISE,   // any count at all
+    FAULT_COUNT,
+} fault_t;
+
+static const char *const k_fault_names[FAULT_COUNT] = {"split", "merge", "drop", "noise"};
+
+static uint32_t g_rng = 0x6D2B79F5U;
+
+static uint32_t next_random(void)
+{
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 17;
+    g_rng ^= g_rng << 5;
+    return g_rng;
+}
+
+static void apply_fault(pulse_stream_t *out, uint32_t at, fault_t fault)
+{
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < g_clean.count; i++) {
+        const pulse_t p = g_clean.pulses[i];
+        if (i != at) {
+            out->pulses[n++] = p;
+            continue;
+        }
+        switch (fault) {
+            case FAULT_SPLIT: {
+                const uint32_t first = 1U + (next_random() % (p.h_ctr - 1U));
+                out->pulses[n++] = (pulse_t){first, 1U, p.src};
+                out->pulses[n++] = (pulse_t){p.h_ctr - first, p.low, p.src};
+                break;
+        }
+        case FAULT_MERGE:
+            if (i + 1U < g_clean.count) {
+                const pulse_t next = g_clean.pulses[++i];
+                out->pulses[n++] = (pulse_t){p.h_ctr + p.low + next.h_ctr - 1U, next.low, next.src};
+            }
+            break;
+        case FAULT_DROP:
+            break;
+        default:
+            out->pulses[n++] = (pulse_t){next_random() % 1024U, p.low, p.src};
+            break;
+        }
+    }
+    out->count = n;
+}
+
+static void test_single_faults(void)
+{
+    static pulse_stream_t faulty;
+    uint32_t extra[FAULT_COUNT] = {0};
+    uint32_t missed[FAULT_COUNT] = {0};
+    uint32_t moved[FAULT_COUNT] = {0};
+    uint32_t late = 0;
+    uint32_t legacy_extra = 0;
+    uint32_t legacy_missed = 0;
+    uint32_t legacy_moved = 0;
+
+    for (uint32_t trial = 0; trial < FUZZ_TRIALS; trial++) {
+        // Leave the first frame alone: it only locks the decoder.
+        const uint32_t first = g_clean_vsyncs.src[0] + 1U;
+        const uint32_t at = first + (next_random() % (g_clean.count - first));
+        const fault_t fault = (fault_t)(trial % FAULT_COUNT);
+        apply_fault(&faulty, at, fault);
+
+        vsync_list_t got;
+        mvs_sync_decoder_t dec;
+        decode(&faulty, &got, &dec);
+        if (got.count > g_clean_vsyncs.count) {
+            extra[fault]++;
+        } else if (got.count < g_clean_vsyncs.count) {
+            missed[fault]++;
+        } else {
+            for (uint32_t f = 0; f < got.count; f++) {
+                const uint32_t want = g_clean_vsyncs.src[f];
+                if (got.src[f] == want) {
+                    continue;
+                }
+                // Late only when the fault hit the interval's last short or
+                // one of the two line pulses that confirm it.
+                if (got.src[f] > want && got.src[f] - want <= MAX_LATE_PULSES && at + 2U >= want && at <= want) {
+                    late++;
+                } else {
+                    moved[fault]++;
+                }
+            }
+        }
+
+        vsync_list_t legacy;
+        decode_legacy(&faulty, &legacy);
+        if (legacy.count > g_clean_vsyncs.count) {
+            legacy_extra++;
+        } else if (legacy.count < g_clean_vsyncs.count) {
+            legacy_missed++;
+        } else if (memcmp(legacy.src, g_clean_vsyncs.src, legacy.count * sizeof legacy.src[0]) != 0) {
+            legacy_moved++;
+        }
+    }
+
+    for (uint32_t f = 0; f < FAULT_COUNT; f++) {
+        CHECK(extra[f] == 0U && missed[f] == 0U && moved[f] == 0U,
+              "%s faults: %" PRIu32 " false vsyncs, %" PRIu32 " missed, %" PRIu32 " moved", k_fault_names[f],
+              extra[f], missed[f], moved[f]);
+    }
+    printf("Sync decoder: %u single-pulse faults, %" PRIu32 " vsyncs up to %u pulses late, none false or missed.\n",
+           FUZZ_TRIALS, late, MAX_LATE_PULSES);
+    printf("Previous decoder on the same faults: %" PRIu32 " false vsyncs, %" PRIu32 " missed, %" PRIu32
+           " moved.\n",
+           legacy_extra, legacy_missed, legacy_moved);
+}
+
+// =============================================================================
+// Frame length
+// =============================================================================
+
+// An interval-shaped burst in the middle of a frame -- nine half-lines, then
+// normal lines -- is too soon after the last vsync and must be rejected;
+// the real one after it must still be taken. After a restart the first
+// interval is taken wherever it falls.
+static void test_frame_length(void)
+{
+    static pulse_stream_t stream;
+    const uint32_t fake_at = g_clean_vsyncs.src[1] + 100U;
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < g_clean.count; i++) {
+        if (i == fake_at) {
+            for (uint32_t k = 0; k < MVS_SYNC_MIN_SHORTS + 1U; k++) {
+                stream.pulses[n++] = (pulse_t){MVS_SYNC_SHORT_MAX - 100U, 14U, i};
+            }
+        }
+        stream.pulses[n++] = g_clean.pulses[i];
+    }
+    stream.count = n;
+
+    vsync_list_t got;
+    mvs_sync_decoder_t dec;
+    decode(&stream, &got, &dec);
+    CHECK(got.count == g_clean_vsyncs.count && memcmp(got.src, g_clean_vsyncs.src,
+                                                      got.count * sizeof got.src[0]) == 0,
+          "a mid-frame burst moved the frame starts (%" PRIu32 " vsyncs)", got.count);
+    CHECK(dec.early == 1U, "%" PRIu32 " early vsyncs rejected, want 1", dec.early);
+
+    vsync_list_t legacy;
+    decode_legacy(&stream, &legacy);
+    CHECK(legacy.count == g_clean_vsyncs.count + 1U, "the previous decoder takes the burst as a frame");
+
+    // Restart just before the burst: it is the first interval seen.
+    mvs_sync_decoder_init(&dec);
+    for (uint32_t i = 0; i < n; i++) {
+        if (stream.pulses[i].src == fake_at) {
+            mvs_sync_decoder_restart(&dec);
+            uint32_t vsyncs = 0;
+            for (uint32_t k = i; k < i + MVS_SYNC_MIN_SHORTS + 3U; k++) {
+                vsyncs += mvs_sync_decoder_push(&dec, stream.pulses[k].h_ctr) ? 1U : 0U;
+            }
+            CHECK(vsyncs == 1U, "after a restart the first interval must be taken");
+            break;
+        }
+        (void)mvs_sync_decoder_push(&dec, stream.pulses[i].h_ctr);
+    }
+}
+
+// =============================================================================
+// Frame rate
+// =============================================================================
+
+typedef struct {
+    mvs_sync_decoder_t dec;
+    video_standard_detector_t det;
+    uint32_t frames;     // vsyncs since the start
+    uint32_t changed_at; // vsync the last rate change was published at
+    uint32_t bad_counts; // vsyncs whose line count was not the raster's
+} rate_run_t;
+
+// Feeds `stream` on from wherever the run left off, as one raster; streams
+// start and end on a frame boundary.
+static void run_rate(rate_run_t *run, const pulse_stream_t *stream, uint32_t v_total)
+{
+    for (uint32_t i = 0; i < stream->count; i++) {
+        if (!mvs_sync_decoder_push(&run->dec, stream->pulses[i].h_ctr)) {
+            continue;
+        }
+        // The first vsync after a restart has no frame behind it; the first
+        // of a new raster ends a frame of the old one.
+        const uint32_t lines = run->dec.frame_lines;
+        if (run->frames != 0U && i != g_clean_vsyncs.src[0] && lines != v_total) {
+            run->bad_counts++;
+        }
+        if (video_standard_push(&run->det, lines)) {
+            run->changed_at = run->frames;
+        }
+        run->frames++;
+    }
+}
+
+// A 60 Hz source switching to 50 Hz and back, through the decoder: each rate
+// is published VIDEO_STANDARD_CONFIRM_FRAMES frames into it. Counts fed
+// directly: one frame at the other rate, or a streak broken by an
+// implausible count, changes nothing.
+static void test_frame_rate(void)
+{
+    static rate_run_t run;
+    mvs_sync_decoder_init(&run.dec);
+    video_standard_init(&run.det);
+
+    run_rate(&run, &g_clean, g_gen.timing.v_total);
+    CHECK(run.det.standard == VIDEO_STANDARD_60HZ && run.det.changes == 0U, "60 Hz raster: published as 50 Hz");
+    const uint32_t switch_frame = run.frames;
+    while (run.frames < switch_frame + VIDEO_STANDARD_CONFIRM_FRAMES + 2U) {
+        run_rate(&run, &g_clean_50hz, g_gen_50hz.timing.v_total);
+    }
+    CHECK(run.det.standard == VIDEO_STANDARD_50HZ && run.det.frame_lines == g_gen_50hz.timing.v_total,
+          "50 Hz raster: published %s with %u lines", run.det.standard == VIDEO_STANDARD_50HZ ? "50 Hz" : "60 Hz",
+          (unsigned)run.det.frame_lines);
+    // The first vsync of the new raster still ends a 60 Hz frame.
+    CHECK(run.changed_at == switch_frame + VIDEO_STANDARD_CONFIRM_FRAMES,
+          "50 Hz published at vsync %" PRIu32 ", want %" PRIu32, run.changed_at,
+          switch_frame + VIDEO_STANDARD_CONFIRM_FRAMES);
+    const uint32_t back_frame = run.frames;
+    while (run.frames < back_frame + VIDEO_STANDARD_CONFIRM_FRAMES + 2U) {
+        run_rate(&run, &g_clean, g_gen.timing.v_total);
+    }
+    CHECK(run.det.standard == VIDEO_STANDARD_60HZ && run.det.changes == 2U,
+          "back to 60 Hz: %" PRIu32 " rate changes", run.det.changes);
+    CHECK(run.bad_counts == 0U, "%" PRIu32 " frames miscounted", run.bad_counts);
+
+    video_standard_detector_t det;
+    video_standard_init(&det);
+    uint32_t changes = 0;
+    for (uint32_t f = 0; f < 40U; f++) {
+        changes += video_standard_push(&det, f % 10U == 5U ? 312U : 263U) ? 1U : 0U;
+    }
+    for (uint32_t f = 0; f < 3U * VIDEO_STANDARD_CONFIRM_FRAMES; f++) {
+        const uint32_t lines = f % VIDEO_STANDARD_CONFIRM_FRAMES == VIDEO_STANDARD_CONFIRM_FRAMES - 1U ? 0U : 312U;
+        changes += video_standard_push(&det, lines) ? 1U : 0U;
+    }
+    CHECK(changes == 0U && det.standard == VIDEO_STANDARD_60HZ,
+          "lone 50 Hz frames or broken streaks changed the rate %" PRIu32 " times", changes);
+    for (uint32_t f = 0; f < VIDEO_STANDARD_CONFIRM_FRAMES; f++) {
+        changes += video_standard_push(&det, 313U) ? 1U : 0U;
+    }
+    CHECK(changes == 1U && det.standard == VIDEO_STANDARD_50HZ, "an unbroken 50 Hz streak was not published");
+    printf("Frame rate: %u and %u lines per frame, each rate published %u frames in.\n",
+           (unsigned)g_gen.timing.v_total, (unsigned)g_gen_50hz.timing.v_total, VIDEO_STANDARD_CONFIRM_FRAMES);
+}
+
+int main(void)
+{
+    signal_gen_init(&g_gen, SIGNAL_GEN_MVS, 126000000U);
+    extract_pulses(&g_gen, &g_clean);
+    signal_gen_init(&g_gen_50hz, SIGNAL_GEN_MVS, 126000000U);
+    signal_gen_set_50hz(&g_gen_50hz.timing);
+    extract_pulses(&g_gen_50hz, &g_clean_50hz);
+
+    test_clean_stream();
+    test_single_faults();
+    test_frame_length();
+    test_frame_rate();
+
+    if (g_check_failures != 0U) {
+        fprintf(stderr, "\nFAIL: %u sync decoder checks failed.\n", g_check_failures);
+        return EXIT_FAILURE;
+    }
+    printf("PASS: %" PRIu32 " vsyncs in the replayed raster, %u single faults absorbed.\n", g_clean_vsyncs.count,
+           FUZZ_TRIALS);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,31 @@
+#ifndef NEOPICO_HD_TEST_TEST_FRAME_H
+#define NEOPICO_HD_TEST_TEST_FRAME_H
+
+#include <stdint.h>
+
+#include "signal_gen.h"
+#include "video_config.h"
+
+// The host tests' source picture: every pixel's colour is a hash of its
+// position, so a line or dot out of place cannot pass for the right one.
+// Fills `rgb` and points `frame` at it; DARK/SHADOW effects are up to the
+// test.
+static inline void make_test_frame(signal_gen_frame_t *frame, uint8_t rgb[][CAPTURE_ACTIVE_WIDTH][3])
+{
+    for (uint32_t y = 0; y < CAPTURE_ACTIVE_HEIGHT; y++) {
+        for (uint32_t x = 0; x < CAPTURE_ACTIVE_WIDTH; x++) {
+            uint32_t h = (y * 0x9E3779B1U) ^ (x * 0x85EBCA77U);
+            h ^= h >> 15;
+            h *= 0x2C1B3C6DU;
+            h ^= h >> 12;
+            rgb[y][x][0] = (uint8_t)h;
+            rgb[y][x][1] = (uint8_t)(h >> 8);
+            rgb[y][x][2] = (uint8_t)(h >> 16);
+        }
+    }
+    frame->width = CAPTURE_ACTIVE_WIDTH;
+    frame->height = CAPTURE_ACTIVE_HEIGHT;
+    frame->rgb = &rgb[0][0][0];
+}
+
+#endif // NEOPICO_HD_TEST_TEST_FRAME_H
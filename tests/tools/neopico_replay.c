@@ -0,0 +1,480 @@
+// Replays raw capture words or image frames through the firmware's capture
+// loop and scanline callback (tests/host/replay.h) and writes the output
+// rasters plus per-line timing. One executable per firmware flag set:
+// neopico_replay_mvs (RGB888 scanout), neopico_replay_mvs_rgb565 and
+// neopico_replay_snes.
+//
+//   neopico_replay_mvs [options] -o OUT INPUT.raw
+//   neopico_replay_mvs [options] -o OUT FRAME.png [FRAME.png ...]
+//
+// INPUT.raw is neopico_signal_gen output. OUT is chosen by extension:
+//   .raw  the scanout words exactly as the callback wrote them, little-endian,
+//         frames back to back (bit-exact; compare with cmp(1));
+//   .y4m  YUV4MPEG2 4:4:4, full-range BT.601 (for video players; lossy);
+//   .png/.ppm  one image per frame; OUT must contain a printf %u for the
+//         frame number when more than one frame is written.
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "image_io.h"
+#include "replay.h"
+#include "signal_gen.h"
+#include "video_config.h"
+#include "video_pipeline.h"
+
+#if NEOPICO_CAPTURE_TARGET == NEOPICO_CAPTURE_TARGET_SNES
+#define TOOL_SYSTEM SIGNAL_GEN_SNES
+#else
+#define TOOL_SYSTEM SIGNAL_GEN_MVS
+#endif
+
+// Stream frames allowed per delivered frame before giving up: the capture
+// loop needs one to lock onto vsync.
+#define SOURCE_FRAME_SLACK 2U
+
+typedef enum {
+    OUTPUT_RAW,
+    OUTPUT_Y4M,
+    OUTPUT_IMAGE,
+} output_kind_t;
+
+typedef struct {
+    output_kind_t kind;
+    const char *path;
+    FILE *file; // .raw and .y4m
+    uint32_t fps_milli;
+    FILE *timing;
+    bool failed;
+
+    // Summary over every delivered frame.
+    uint64_t capture_ns_total;
+    uint64_t capture_ns_max;
+    uint64_t scanout_ns_total;
+    uint64_t scanout_ns_max;
+    uint64_t last_line_cycles_max;
+    uint32_t frames;
+} tool_output_t;
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr,
+            "usage: %s [options] -o OUT.raw|OUT.y4m|OUT.png INPUT.raw|FRAME.png ...\n"
+            "  --mode 480p|240p|720p  output mode (default 480p)\n"
+            "  --frames N             output frames (default: one per input frame)\n"
+            "  --scanlines LEVEL      scanline level 0-4 (default 0, off)\n"
+            "  --timing FILE.csv      per-line capture and scanout timing\n"
+            "  --sys-hz HZ            emulated system clock (default: the mode's, as main.c sets it)\n"
+            "  --fps HZ               retune the source dot clock for this frame rate\n"
+            "  --dark, --shadow       set the MVS DARK/SHADOW flag on every active pixel\n"
+            "  --lead CYCLES          output launch before the PCLK rise (default: falling edge)\n"
+            "  --edge-jitter CYCLES   peak PCLK edge jitter; outputs follow the edge\n"
+            "  --skew-jitter CYCLES   peak output launch jitter against PCLK\n"
+            "  --seed N               jitter sequence seed (default 1)\n",
+            argv0);
+}
+
+static bool parse_u32(const char *text, uint32_t *value)
+{
+    char *end = NULL;
+    const unsigned long v = strtoul(text, &end, 0);
+    if (end == text || *end != '\0' || v > UINT32_MAX) {
+        return false;
+    }
+    *value = (uint32_t)v;
+    return true;
+}
+
+static bool has_suffix(const char *text, const char *suffix)
+{
+    const size_t n = strlen(text);
+    const size_t m = strlen(suffix);
+    return n >= m && strcmp(text + n - m, suffix) == 0;
+}
+
+// Image names are printf patterns: no conversions at all, or exactly one %u.
+static bool frame_pattern_ok(const char *pattern, uint32_t frames)
+{
+    const char *first = strchr(pattern, '%');
+    if (first == NULL) {
+        return frames <= 1U;
+    }
+    return first[1] == 'u' && strchr(first + 2, '%') == NULL;
+}
+
+static bool load_words(const char *path, uint32_t **words, uint64_t *count)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return false;
+    }
+    size_t capacity = 0;
+    size_t n = 0;
+    uint32_t *buf = NULL;
+    uint8_t bytes[4];
+    while (fread(bytes, 1, sizeof bytes, f) == sizeof bytes) {
+        if (n == capacity) {
+            capacity = capacity != 0U ? capacity * 2U : 1U << 20;
+            uint32_t *grown = realloc(buf, capacity * sizeof *buf);
+            if (grown == NULL) {
+                fprintf(stderr, "%s: out of memory\n", path);
+                free(buf);
+                fclose(f);
+                return false;
+            }
+            buf = grown;
+        }
+        buf[n++] = (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) |
+                   ((uint32_t)bytes[3] << 24);
+    }
+    fclose(f);
+    if (n == 0U) {
+        fprintf(stderr, "%s: no words\n", path);
+        free(buf);
+        return false;
+    }
+    *words = buf;
+    *count = n;
+    return true;
+}
+
+static bool write_words(FILE *f, const uint32_t *words, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t bytes[4] = {(uint8_t)words[i], (uint8_t)(words[i] >> 8), (uint8_t)(words[i] >> 16),
+                                  (uint8_t)(words[i] >> 24)};
+        if (fwrite(bytes, 1, sizeof bytes, f) != sizeof bytes) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static uint8_t clamp_u8(int32_t v)
+{
+    return (uint8_t)(v < 0 ? 0 : v > 255 ? 255 : v);
+}
+
+static bool write_y4m_frame(FILE *f, const replay_frame_t *frame)
+{
+    const size_t pixels = (size_t)frame->width * frame->height;
+    uint8_t *planes = malloc(pixels * 3U);
+    if (planes == NULL) {
+        return false;
+    }
+    // Full-range BT.601 in 16.16 fixed point.
+    for (size_t i = 0; i < pixels; i++) {
+        const int32_t r = (int32_t)((frame->rgb[i] >> 16) & 0xFFU);
+        const int32_t g = (int32_t)((frame->rgb[i] >> 8) & 0xFFU);
+        const int32_t b = (int32_t)(frame->rgb[i] & 0xFFU);
+        planes[i] = clamp_u8(((19595 * r) + (38470 * g) + (7471 * b) + 32768) >> 16);
+        planes[pixels + i] = clamp_u8(((-11059 * r) - (21709 * g) + (32768 * b) + (128 << 16) + 32768) >> 16);
+        planes[(2U * pixels) + i] = clamp_u8(((32768 * r) - (27439 * g) - (5329 * b) + (128 << 16) + 32768) >> 16);
+    }
+    const bool ok = fputs("FRAME\n", f) >= 0 && fwrite(planes, 1, pixels * 3U, f) == pixels * 3U;
+    free(planes);
+    return ok;
+}
+
+static bool write_image(const char *pattern, const replay_frame_t *frame)
+{
+    char path[4096];
+    // The pattern is the -o argument, vetted by frame_pattern_ok().
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+    snprintf(path, sizeof path, pattern, frame->index);
+#pragma GCC diagnostic pop
+    host_image_t image;
+    if (!host_image_alloc(&image, frame->width, frame->height)) {
+        return false;
+    }
+    for (size_t i = 0; i < (size_t)frame->width * frame->height; i++) {
+        image.rgb[(i * 3U)] = (uint8_t)(frame->rgb[i] >> 16);
+        image.rgb[(i * 3U) + 1U] = (uint8_t)(frame->rgb[i] >> 8);
+        image.rgb[(i * 3U) + 2U] = (uint8_t)frame->rgb[i];
+    }
+    const bool ok = host_image_save(path, &image);
+    host_image_free(&image);
+    return ok;
+}
+
+static bool on_frame(const replay_frame_t *frame, void *ctx)
+{
+    tool_output_t *out = ctx;
+    bool ok = true;
+    switch (out->kind) {
+    case OUTPUT_RAW:
+        ok = write_words(out->file, frame->words, (size_t)frame->words_per_line * frame->height);
+        break;
+    case OUTPUT_Y4M:
+        if (frame->index == 0U) {
+            ok = fprintf(out->file,
+                         "YUV4MPEG2 W%" PRIu32 " H%" PRIu32 " F%" PRIu32 ":1000 Ip A1:1 C444 XCOLORRANGE=FULL\n",
+                         frame->width, frame->height, out->fps_milli) > 0;
+        }
+        ok = ok && write_y4m_frame(out->file, frame);
+        break;
+    case OUTPUT_IMAGE:
+        ok = write_image(out->path, frame);
+        break;
+    }
+    if (!ok) {
+        fprintf(stderr, "%s: write failed\n", out->path);
+        out->failed = true;
+        return false;
+    }
+
+    for (uint32_t line = 0; line < SOURCE_HEIGHT; line++) {
+        out->capture_ns_total += frame->capture_ns[line];
+        if (frame->capture_ns[line] > out->capture_ns_max) {
+            out->capture_ns_max = frame->capture_ns[line];
+        }
+        if (out->timing != NULL) {
+            fprintf(out->timing, "%" PRIu32 ",capture,%" PRIu32 ",%" PRIu64 ",%" PRIu64 "\n", frame->index, line,
+                    frame->capture_cycles[line], frame->capture_ns[line]);
+        }
+    }
+    const uint64_t last = frame->capture_cycles[SOURCE_HEIGHT - 1U];
+    out->last_line_cycles_max = last > out->last_line_cycles_max ? last : out->last_line_cycles_max;
+    for (uint32_t line = 0; line < frame->height; line++) {
+        out->scanout_ns_total += frame->scanout_ns[line];
+        if (frame->scanout_ns[line] > out->scanout_ns_max) {
+            out->scanout_ns_max = frame->scanout_ns[line];
+        }
+        if (out->timing != NULL) {
+            fprintf(out->timing, "%" PRIu32 ",scanout,%" PRIu32 ",,%" PRIu64 "\n", frame->index, line,
+                    frame->scanout_ns[line]);
+        }
+    }
+    out->frames++;
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    replay_mode_t mode = REPLAY_MODE_480P;
+    const char *out_path = NULL;
+    const char *timing_path = NULL;
+    double fps = 0.0;
+    uint32_t frames_out = 0;
+    uint32_t scanlines = VIDEO_PIPELINE_SCANLINE_OFF;
+    uint8_t effects = 0;
+    uint32_t sys_hz = 0;
+    uint32_t lead = UINT32_MAX;
+    uint32_t edge_jitter = 0;
+    uint32_t skew_jitter = 0;
+    uint32_t seed = 1;
+    int first_input = argc;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *val = i + 1 < argc ? argv[i + 1] : NULL;
+        bool ok = true;
+        if (strcmp(arg, "-o") == 0 && val) {
+            out_path = val;
+            i++;
+        } else if (strcmp(arg, "--mode") == 0 && val) {
+            ok = strcmp(val, "480p") == 0 || strcmp(val, "240p") == 0 || strcmp(val, "720p") == 0;
+            mode = strcmp(val, "240p") == 0   ? REPLAY_MODE_240P
+                   : strcmp(val, "720p") == 0 ? REPLAY_MODE_720P
+                                              : REPLAY_MODE_480P;
+            i++;
+        } else if (strcmp(arg, "--frames") == 0 && val) {
+            ok = parse_u32(val, &frames_out);
+            i++;
+        } else if (strcmp(arg, "--scanlines") == 0 && val) {
+            ok = parse_u32(val, &scanlines) && scanlines <= VIDEO_PIPELINE_SCANLINE_100;
+            i++;
+        } else if (strcmp(arg, "--timing") == 0 && val) {
+            timing_path = val;
+            i++;
+        } else if (strcmp(arg, "--sys-hz") == 0 && val) {
+            ok = parse_u32(val, &sys_hz) && sys_hz > 0U;
+            i++;
+        } else if (strcmp(arg, "--fps") == 0 && val) {
+            fps = strtod(val, NULL);
+            ok = fps > 0.0;
+            i++;
+        } else if (strcmp(arg, "--dark") == 0) {
+            effects |= SIGNAL_GEN_DARK;
+        } else if (strcmp(arg, "--shadow") == 0) {
+            effects |= SIGNAL_GEN_SHADOW;
+        } else if (strcmp(arg, "--lead") == 0 && val) {
+            ok = parse_u32(val, &lead);
+            i++;
+        } else if (strcmp(arg, "--edge-jitter") == 0 && val) {
+            ok = parse_u32(val, &edge_jitter);
+            i++;
+        } else if (strcmp(arg, "--skew-jitter") == 0 && val) {
+            ok = parse_u32(val, &skew_jitter);
+            i++;
+        } else if (strcmp(arg, "--seed") == 0 && val) {
+            ok = parse_u32(val, &seed);
+            i++;
+        } else if (arg[0] == '-') {
+            ok = false;
+        } else {
+            first_input = i;
+            break;
+        }
+        if (!ok) {
+            fprintf(stderr, "%s: bad argument '%s'\n", argv[0], arg);
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    const uint32_t input_count = (uint32_t)(argc - first_input);
+    if (out_path == NULL || input_count == 0U) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    tool_output_t out = {.path = out_path};
+    out.kind = has_suffix(out_path, ".raw") ? OUTPUT_RAW : has_suffix(out_path, ".y4m") ? OUTPUT_Y4M : OUTPUT_IMAGE;
+    const bool raw_input = input_count == 1U && has_suffix(argv[first_input], ".raw");
+
+    host_image_t *images = calloc(input_count, sizeof *images);
+    signal_gen_frame_t *frames = calloc(input_count, sizeof *frames);
+    uint8_t *effect_plane = NULL;
+    uint32_t *words = NULL;
+    int status = EXIT_FAILURE;
+    if (images == NULL || frames == NULL) {
+        fprintf(stderr, "%s: out of memory\n", argv[0]);
+        goto done;
+    }
+
+    signal_gen_t gen;
+    signal_gen_init(&gen, TOOL_SYSTEM, sys_hz != 0U ? sys_hz : replay_mode_sys_hz(mode));
+    if (fps > 0.0) {
+        signal_gen_set_frame_rate(&gen.timing, fps);
+        gen.lead = (gen.sys_hz / gen.timing.dot_clock_hz) / 2U;
+    }
+    if (lead != UINT32_MAX) {
+        gen.lead = lead;
+    }
+    gen.edge_jitter = edge_jitter;
+    gen.skew_jitter = skew_jitter;
+    gen.jitter_seed = seed;
+
+    uint64_t input_frames = input_count;
+    if (raw_input) {
+        if (!load_words(argv[first_input], &words, &gen.word_count)) {
+            goto done;
+        }
+        gen.words = words;
+        const uint64_t frame_dots = signal_gen_frame_dots(&gen.timing);
+        if (gen.word_count % frame_dots != 0U) {
+            fprintf(stderr, "%s: %" PRIu64 " words is not a whole number of %" PRIu64 "-word frames\n",
+                    argv[first_input], gen.word_count, frame_dots);
+        }
+        input_frames = gen.word_count / frame_dots != 0U ? gen.word_count / frame_dots : 1U;
+    } else {
+        // One flag plane covers every input; it is sized for the largest.
+        size_t max_pixels = 0;
+        for (uint32_t i = 0; i < input_count; i++) {
+            if (!host_image_load(argv[first_input + (int)i], &images[i])) {
+                goto done;
+            }
+            const size_t pixels = (size_t)images[i].width * images[i].height;
+            max_pixels = pixels > max_pixels ? pixels : max_pixels;
+            frames[i].width = images[i].width;
+            frames[i].height = images[i].height;
+            frames[i].rgb = images[i].rgb;
+        }
+        if (effects != 0U && TOOL_SYSTEM == SIGNAL_GEN_MVS) {
+            effect_plane = malloc(max_pixels);
+            if (effect_plane == NULL) {
+                fprintf(stderr, "%s: out of memory\n", argv[0]);
+                goto done;
+            }
+            memset(effect_plane, effects, max_pixels);
+            for (uint32_t i = 0; i < input_count; i++) {
+                frames[i].effects = effect_plane;
+            }
+        }
+        gen.frames = frames;
+        gen.frame_count = input_count;
+    }
+    if (frames_out == 0U) {
+        frames_out = (uint32_t)input_frames;
+    }
+    if (out.kind == OUTPUT_IMAGE && !frame_pattern_ok(out_path, frames_out)) {
+        fprintf(stderr, "%s: the output name needs one %%u (and no other %%) to write %" PRIu32 " frames\n", out_path,
+                frames_out);
+        goto done;
+    }
+    out.fps_milli = (uint32_t)((signal_gen_frame_rate(&gen.timing) * 1000.0) + 0.5);
+
+    if (out.kind != OUTPUT_IMAGE) {
+        out.file = fopen(out_path, "wb");
+        if (out.file == NULL) {
+            fprintf(stderr, "%s: cannot create\n", out_path);
+            goto done;
+        }
+    }
+    if (timing_path != NULL) {
+        out.timing = fopen(timing_path, "w");
+        if (out.timing == NULL) {
+            fprintf(stderr, "%s: cannot create\n", timing_path);
+            goto done;
+        }
+        fprintf(out.timing, "frame,side,line,cycles,ns\n");
+    }
+
+    const replay_config_t config = {
+        .source = &gen,
+        .mode = mode,
+        .scanline_level = (uint8_t)scanlines,
+        .frames = frames_out,
+        .source_frames = (uint64_t)frames_out + SOURCE_FRAME_SLACK,
+        .on_frame = on_frame,
+        .ctx = &out,
+    };
+    const uint32_t delivered = replay_run(&config);
+    if (out.failed) {
+        goto done;
+    }
+
+    uint32_t width;
+    uint32_t height;
+    replay_mode_size(mode, &width, &height);
+    printf("%s: %" PRIu32 " of %" PRIu32 " frames, %" PRIu32 "x%" PRIu32 " at %" PRIu32 " Hz system clock\n", out_path,
+           delivered, frames_out, width, height, gen.sys_hz);
+    if (out.frames != 0U) {
+        printf("capture: %.1f ns/line mean, %" PRIu64 " ns max; last line committed %" PRIu64
+               " cycles after vsync (max)\n",
+               (double)out.capture_ns_total / ((double)out.frames * SOURCE_HEIGHT), out.capture_ns_max,
+               out.last_line_cycles_max);
+        printf("scanout: %.1f ns/line mean, %" PRIu64 " ns max\n",
+               (double)out.scanout_ns_total / ((double)out.frames * height), out.scanout_ns_max);
+    }
+    status = delivered == frames_out ? EXIT_SUCCESS : EXIT_FAILURE;
+    if (status != EXIT_SUCCESS) {
+        fprintf(stderr, "%s: the capture loop did not lock onto the stream\n", argv[0]);
+    }
+
+done:
+    if (out.file != NULL && fclose(out.file) != 0) {
+        fprintf(stderr, "%s: write failed\n", out_path);
+        status = EXIT_FAILURE;
+    }
+    if (out.timing != NULL && fclose(out.timing) != 0) {
+        fprintf(stderr, "%s: write failed\n", timing_path);
+        status = EXIT_FAILURE;
+    }
+    free(words);
+    free(effect_plane);
+    if (images != NULL) {
+        for (uint32_t i = 0; i < input_count; i++) {
+            host_image_free(&images[i]);
+        }
+    }
+    free(images);
+    free(frames);
+    return status;
+}
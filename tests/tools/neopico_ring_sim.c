@@ -0,0 +1,200 @@
+// Runs the line ring's producer and consumer on two threads against MVS input
+// and HDMI output timelines (tests/host/ring_sim.h) and reports ring events,
+// repeated and dropped frames, and the ring depth the run needed.
+//
+//   neopico_ring_sim [--mode 480p|240p|720p] [--genlock] [--phases N] ...
+//
+// With --phases N the run is repeated at N evenly spaced output phases and
+// the depth table shows the worst phase, which is the number to size the ring
+// by: a free-running output sweeps through every phase on its own, a
+// genlocked one holds whichever it locked at.
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "line_ring.h"
+#include "ring_sim.h"
+
+#define MAX_DEPTHS 16U
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  --mode 480p|240p|720p  output mode (default 480p)\n"
+            "  --in-hz HZ             input frame rate (default: MVS 59.185)\n"
+            "  --out-hz HZ            free-running output frame rate (default: the mode's)\n"
+            "  --genlock              lock the output frame period to the input's\n"
+            "  --race                 beam-racing read policy (line_ring_output_vsync_race())\n"
+            "  --phase F              first output VSYNC, in output frames (default 0)\n"
+            "  --phases N             sweep N phases in [0, 1) instead of one --phase\n"
+            "  --seconds S            simulated time per run (default 10)\n"
+            "  --convert-us US        capture conversion time per line (default 8)\n"
+            "  --slack-us US          virtual time the two threads may race apart (default 0)\n"
+            "  --depth D              ring depth the run uses, a power of two (default LINE_RING_SIZE)\n"
+            "  --depths D,D,...       ring depths to tabulate (default 40,64,80,96,128,160,192,224,256)\n",
+            argv0);
+}
+
+static bool parse_u32(const char *text, uint32_t *value)
+{
+    char *end = NULL;
+    const unsigned long v = strtoul(text, &end, 0);
+    if (end == text || *end != '\0' || v > UINT32_MAX) {
+        return false;
+    }
+    *value = (uint32_t)v;
+    return true;
+}
+
+static bool parse_double(const char *text, double *value)
+{
+    char *end = NULL;
+    *value = strtod(text, &end);
+    return end != text && *end == '\0';
+}
+
+static bool parse_depths(const char *text, uint32_t *depths, uint32_t *count)
+{
+    char buf[256];
+    if (strlen(text) >= sizeof buf) {
+        return false;
+    }
+    strcpy(buf, text);
+    *count = 0;
+    for (char *tok = strtok(buf, ","); tok != NULL; tok = strtok(NULL, ",")) {
+        if (*count == MAX_DEPTHS || !parse_u32(tok, &depths[*count]) || depths[*count] > RING_SIM_MAX_DEPTH) {
+            return false;
+        }
+        (*count)++;
+    }
+    return *count > 0U;
+}
+
+int main(int argc, char **argv)
+{
+    ring_sim_config_t config;
+    ring_sim_config_init(&config);
+    uint32_t phases = 0;
+    uint32_t depths[MAX_DEPTHS] = {40, 64, 80, 96, 128, 160, 192, 224, 256};
+    uint32_t depth_count = 9;
+    const char *mode_name = "480p";
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *val = i + 1 < argc ? argv[i + 1] : NULL;
+        bool ok = true;
+        if (strcmp(arg, "--mode") == 0 && val) {
+            ok = strcmp(val, "480p") == 0 || strcmp(val, "240p") == 0 || strcmp(val, "720p") == 0;
+            config.mode = strcmp(val, "240p") == 0   ? &video_mode_240_p
+                          : strcmp(val, "720p") == 0 ? &video_mode_720_p
+                                                     : &video_mode_480_p;
+            mode_name = val;
+            i++;
+        } else if (strcmp(arg, "--in-hz") == 0 && val) {
+            ok = parse_double(val, &config.in_hz) && config.in_hz > 0.0;
+            i++;
+        } else if (strcmp(arg, "--out-hz") == 0 && val) {
+            ok = parse_double(val, &config.out_hz) && config.out_hz > 0.0;
+            i++;
+        } else if (strcmp(arg, "--genlock") == 0) {
+            config.genlock = true;
+        } else if (strcmp(arg, "--race") == 0) {
+            config.race = true;
+        } else if (strcmp(arg, "--phase") == 0 && val) {
+            ok = parse_double(val, &config.phase) && config.phase >= 0.0;
+            i++;
+        } else if (strcmp(arg, "--phases") == 0 && val) {
+            ok = parse_u32(val, &phases) && phases > 0U;
+            i++;
+        } else if (strcmp(arg, "--seconds") == 0 && val) {
+            ok = parse_double(val, &config.seconds) && config.seconds > 0.0;
+            i++;
+        } else if (strcmp(arg, "--convert-us") == 0 && val) {
+            ok = parse_double(val, &config.convert_us) && config.convert_us >= 0.0;
+            i++;
+        } else if (strcmp(arg, "--slack-us") == 0 && val) {
+            ok = parse_double(val, &config.slack_us) && config.slack_us >= 0.0;
+            i++;
+        } else if (strcmp(arg, "--depth") == 0 && val) {
+            ok = parse_u32(val, &config.depth) && config.depth >= LINE_RING_MIN_DEPTH &&
+                 config.depth <= LINE_RING_SIZE && (config.depth & (config.depth - 1U)) == 0U;
+            i++;
+        } else if (strcmp(arg, "--depths") == 0 && val) {
+            ok = parse_depths(val, depths, &depth_count);
+            i++;
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            fprintf(stderr, "%s: bad argument '%s'\n", argv[0], arg);
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf("%s %s%s, %.1f s per run, %.1f us conversion, %.1f us slack, %" PRIu32 "-line ring\n", mode_name,
+           config.genlock ? "genlocked" : "free-running", config.race ? ", racing" : "", config.seconds,
+           config.convert_us, config.slack_us, config.depth != 0U ? config.depth : LINE_RING_SIZE);
+    printf("%8s %7s %7s %11s %8s %6s %6s %6s %6s %8s %6s %6s %8s %8s %6s\n", "phase", "in", "out", "not_written",
+           "overrun", "torn", "dup", "skip", "blank", "glitched", "raced", "depth", "p50<=us", "p99<=us", "beat");
+
+    const uint32_t runs = phases != 0U ? phases : 1U;
+    uint32_t worst[MAX_DEPTHS] = {0};
+    uint32_t out_frames = 0;
+    uint32_t worst_depth = 0;
+    uint32_t best_depth = UINT32_MAX;
+    double best_phase = 0.0;
+    bool always_glitched = false;
+    for (uint32_t run = 0; run < runs; run++) {
+        if (phases != 0U) {
+            config.phase = (double)run / phases;
+        }
+        static ring_sim_result_t r;
+        if (!ring_sim_run(&config, &r)) {
+            fprintf(stderr, "%s: could not start the simulator threads\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+        printf("%8.4f %7" PRIu32 " %7" PRIu32 " %11" PRIu32 " %8" PRIu32 " %6" PRIu32 " %6" PRIu32 " %6" PRIu32
+               " %6" PRIu32 " %8" PRIu32 " %6" PRIu32 " %6" PRIu32 " %8" PRIu32 " %8" PRIu32 " %6" PRIu32 "\n",
+               config.phase, r.in_frames, r.out_frames, r.not_written, r.overrun, r.torn_lines, r.duplicated_frames,
+               r.skipped_frames, r.blank_frames, r.glitched_frames, r.raced_frames, r.max_depth, r.latency_p50_us,
+               r.latency_p99_us, r.beat_frames);
+        for (uint32_t d = 0; d < depth_count; d++) {
+            const uint32_t over = ring_sim_frames_over(&r, depths[d]);
+            worst[d] = over > worst[d] ? over : worst[d];
+        }
+        out_frames = r.out_frames > out_frames ? r.out_frames : out_frames;
+        worst_depth = r.max_depth > worst_depth ? r.max_depth : worst_depth;
+        if (r.not_written_frames == 0U && r.max_depth < best_depth) {
+            best_depth = r.max_depth;
+            best_phase = config.phase;
+        }
+        always_glitched = always_glitched || r.not_written_frames != 0U;
+    }
+
+    printf("\n%6s %8s %16s\n", "depth", "KiB", "glitched frames");
+    for (uint32_t d = 0; d < depth_count; d++) {
+        const double kib = ((double)depths[d] * LINE_WIDTH * sizeof(uint16_t)) / 1024.0;
+        printf("%6" PRIu32 " %8.1f %8" PRIu32, depths[d], kib, worst[d]);
+        if (worst[d] != 0U && out_frames != 0U) {
+            printf(" (%.2f%%)", (100.0 * worst[d]) / out_frames);
+        }
+        printf("%s\n", depths[d] == LINE_RING_SIZE ? "  <- LINE_RING_SIZE" : "");
+    }
+    if (always_glitched) {
+        printf("\nno depth is clean: the output asked for lines before the input committed them\n");
+    } else {
+        printf("\nminimum clean depth, every phase: %" PRIu32 " lines (%.1f KiB)\n", worst_depth,
+               ((double)worst_depth * LINE_WIDTH * sizeof(uint16_t)) / 1024.0);
+    }
+    if (config.genlock && runs > 1U && best_depth != UINT32_MAX) {
+        printf("best locked phase: %.4f, %" PRIu32 " lines (%.1f KiB)\n", best_phase, best_depth,
+               ((double)best_depth * LINE_WIDTH * sizeof(uint16_t)) / 1024.0);
+    }
+    return EXIT_SUCCESS;
+}
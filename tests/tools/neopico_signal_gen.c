@@ -0,0 +1,243 @@
+// Renders an image sequence into the raw capture words an MVS or SNES would
+// present to the pixel SM (tests/host/signal_gen.h), one little-endian 32-bit
+// word per dot, h_total * v_total words per frame, frames back to back.
+//
+//   neopico_signal_gen [options] -o OUT.raw FRAME.png [FRAME.png ...]
+//
+// With jitter options the words are the ones a clkdiv-1 SM samples from the
+// jittered pads, so dots whose launch crosses the sample point come out as
+// their neighbour's value.
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "image_io.h"
+#include "signal_gen.h"
+
+#define DEFAULT_SYS_HZ 126000000U
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: neopico_signal_gen [options] -o OUT.raw FRAME.png|FRAME.ppm ...\n"
+            "  --target mvs|snes     raster and word layout (default mvs)\n"
+            "  --fps HZ              retune the dot clock for this frame rate\n"
+            "  --frames N            frames to write (default: one per input, inputs loop)\n"
+            "  --dark, --shadow      set the MVS DARK/SHADOW flag on every active pixel\n"
+            "  --sys-hz HZ           capture system clock for jitter sampling (default %u)\n"
+            "  --lead CYCLES         output launch before the PCLK rise (default: falling edge)\n"
+            "  --edge-jitter CYCLES  peak PCLK edge jitter; outputs follow the edge\n"
+            "  --skew-jitter CYCLES  peak output launch jitter against PCLK\n"
+            "  --seed N              jitter sequence seed (default 1)\n",
+            DEFAULT_SYS_HZ);
+}
+
+static bool parse_u32(const char *text, uint32_t *value)
+{
+    char *end = NULL;
+    const unsigned long v = strtoul(text, &end, 0);
+    if (end == text || *end != '\0' || v > UINT32_MAX) {
+        return false;
+    }
+    *value = (uint32_t)v;
+    return true;
+}
+
+static bool write_words(FILE *f, const uint32_t *words, uint64_t count)
+{
+    uint8_t bytes[4096];
+    uint64_t i = 0;
+    while (i < count) {
+        size_t n = 0;
+        for (; n + 4U <= sizeof bytes && i < count; i++, n += 4U) {
+            bytes[n] = (uint8_t)words[i];
+            bytes[n + 1U] = (uint8_t)(words[i] >> 8);
+            bytes[n + 2U] = (uint8_t)(words[i] >> 16);
+            bytes[n + 3U] = (uint8_t)(words[i] >> 24);
+        }
+        if (fwrite(bytes, 1, n, f) != n) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    signal_gen_system_t system = SIGNAL_GEN_MVS;
+    const char *out_path = NULL;
+    double fps = 0.0;
+    uint32_t frames_out = 0;
+    uint8_t effects = 0;
+    uint32_t sys_hz = DEFAULT_SYS_HZ;
+    uint32_t lead = UINT32_MAX;
+    uint32_t edge_jitter = 0;
+    uint32_t skew_jitter = 0;
+    uint32_t seed = 1;
+    int first_input = argc;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *val = i + 1 < argc ? argv[i + 1] : NULL;
+        bool ok = true;
+        if (strcmp(arg, "-o") == 0 && val) {
+            out_path = val;
+            i++;
+        } else if (strcmp(arg, "--target") == 0 && val) {
+            ok = strcmp(val, "mvs") == 0 || strcmp(val, "snes") == 0;
+            system = strcmp(val, "snes") == 0 ? SIGNAL_GEN_SNES : SIGNAL_GEN_MVS;
+            i++;
+        } else if (strcmp(arg, "--fps") == 0 && val) {
+            fps = strtod(val, NULL);
+            ok = fps > 0.0;
+            i++;
+        } else if (strcmp(arg, "--frames") == 0 && val) {
+            ok = parse_u32(val, &frames_out);
+            i++;
+        } else if (strcmp(arg, "--dark") == 0) {
+            effects |= SIGNAL_GEN_DARK;
+        } else if (strcmp(arg, "--shadow") == 0) {
+            effects |= SIGNAL_GEN_SHADOW;
+        } else if (strcmp(arg, "--sys-hz") == 0 && val) {
+            ok = parse_u32(val, &sys_hz) && sys_hz > 0U;
+            i++;
+        } else if (strcmp(arg, "--lead") == 0 && val) {
+            ok = parse_u32(val, &lead);
+            i++;
+        } else if (strcmp(arg, "--edge-jitter") == 0 && val) {
+            ok = parse_u32(val, &edge_jitter);
+            i++;
+        } else if (strcmp(arg, "--skew-jitter") == 0 && val) {
+            ok = parse_u32(val, &skew_jitter);
+            i++;
+        } else if (strcmp(arg, "--seed") == 0 && val) {
+            ok = parse_u32(val, &seed);
+            i++;
+        } else if (arg[0] == '-') {
+            ok = false;
+        } else {
+            first_input = i;
+            break;
+        }
+        if (!ok) {
+            fprintf(stderr, "neopico_signal_gen: bad argument '%s'\n", arg);
+            usage();
+            return EXIT_FAILURE;
+        }
+    }
+    const uint32_t input_count = (uint32_t)(argc - first_input);
+    if (out_path == NULL || input_count == 0U) {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    host_image_t *images = calloc(input_count, sizeof *images);
+    signal_gen_frame_t *frames = calloc(input_count, sizeof *frames);
+    uint8_t *effect_plane = NULL;
+    uint32_t *words = NULL;
+    FILE *out = NULL;
+    int status = EXIT_FAILURE;
+    if (images == NULL || frames == NULL) {
+        fprintf(stderr, "neopico_signal_gen: out of memory\n");
+        goto done;
+    }
+
+    signal_gen_t gen;
+    signal_gen_init(&gen, system, sys_hz);
+    if (fps > 0.0) {
+        signal_gen_set_frame_rate(&gen.timing, fps);
+        gen.lead = (sys_hz / gen.timing.dot_clock_hz) / 2U;
+    }
+    if (lead != UINT32_MAX) {
+        gen.lead = lead;
+    }
+    gen.edge_jitter = edge_jitter;
+    gen.skew_jitter = skew_jitter;
+    gen.jitter_seed = seed;
+
+    // One flag plane covers every input; it is sized for the largest.
+    size_t max_pixels = 0;
+    for (uint32_t i = 0; i < input_count; i++) {
+        if (!host_image_load(argv[first_input + (int)i], &images[i])) {
+            goto done;
+        }
+        const size_t pixels = (size_t)images[i].width * images[i].height;
+        max_pixels = pixels > max_pixels ? pixels : max_pixels;
+        frames[i].width = images[i].width;
+        frames[i].height = images[i].height;
+        frames[i].rgb = images[i].rgb;
+    }
+    if (effects != 0U && system == SIGNAL_GEN_MVS) {
+        effect_plane = malloc(max_pixels);
+        if (effect_plane == NULL) {
+            fprintf(stderr, "neopico_signal_gen: out of memory\n");
+            goto done;
+        }
+        memset(effect_plane, effects, max_pixels);
+        for (uint32_t i = 0; i < input_count; i++) {
+            frames[i].effects = effect_plane;
+        }
+    }
+    gen.frames = frames;
+    gen.frame_count = input_count;
+    if (frames_out == 0U) {
+        frames_out = input_count;
+    }
+
+    const uint64_t frame_dots = signal_gen_frame_dots(&gen.timing);
+    const bool jittered = edge_jitter != 0U || skew_jitter != 0U || lead != UINT32_MAX;
+    words = malloc(frame_dots * sizeof *words);
+    out = fopen(out_path, "wb");
+    if (words == NULL || out == NULL) {
+        fprintf(stderr, "%s: cannot create\n", out_path);
+        goto done;
+    }
+
+    uint64_t disturbed = 0;
+    for (uint32_t f = 0; f < frames_out; f++) {
+        signal_gen_render_frame(&gen, f, words);
+        if (jittered) {
+            for (uint64_t i = 0; i < frame_dots; i++) {
+                const uint32_t sampled = signal_gen_sample_word(&gen, ((uint64_t)f * frame_dots) + i);
+                disturbed += sampled != words[i] ? 1U : 0U;
+                words[i] = sampled;
+            }
+        }
+        if (!write_words(out, words, frame_dots)) {
+            fprintf(stderr, "%s: write failed\n", out_path);
+            goto done;
+        }
+    }
+
+    const signal_gen_timing_t *t = &gen.timing;
+    printf("%s: %" PRIu32 "x%" PRIu32 " dots, %" PRIu32 " Hz dot clock, %.3f Hz; active %" PRIu32 "x%" PRIu32
+           " at dot %" PRIu32 " line %" PRIu32 "\n",
+           system == SIGNAL_GEN_MVS ? "mvs" : "snes", t->h_total, t->v_total, t->dot_clock_hz,
+           signal_gen_frame_rate(t), t->active_width, t->active_height, t->active_x, t->active_y);
+    printf("%s: %" PRIu32 " frames, %" PRIu64 " words", out_path, frames_out, frame_dots * frames_out);
+    if (jittered) {
+        printf(", %" PRIu64 " disturbed by jitter", disturbed);
+    }
+    printf("\n");
+    status = EXIT_SUCCESS;
+
+done:
+    if (out != NULL && fclose(out) != 0) {
+        fprintf(stderr, "%s: write failed\n", out_path);
+        status = EXIT_FAILURE;
+    }
+    free(words);
+    free(effect_plane);
+    if (images != NULL) {
+        for (uint32_t i = 0; i < input_count; i++) {
+            host_image_free(&images[i]);
+        }
+    }
+    free(images);
+    free(frames);
+    return status;
+}